@@ -40,4 +40,186 @@
 /// @param reply Callback with success status
 - (void)resetAWDLInterventionCountWithReply:(void (^_Nonnull)(BOOL success))reply NS_SWIFT_NAME(resetAWDLInterventionCount(reply:));
 
+/// Get intervention reaction-time histograms, measured on the helper's monotonic clock.
+/// Keys are the stages "receiveToDecision", "decisionToActuation" and "receiveToActuation"
+/// (routing message received, decision made, SIOCSIFFLAGS returned), plus "eventToWakeup"
+/// (message queued to enforcement thread running; empty when the event source cannot
+/// timestamp arrivals, as with the kernel routing socket). Each value is a dictionary
+/// with "count", "p50", "p99" and "max" in nanoseconds, and "buckets": an array of
+/// [upperBoundNanos, count] pairs for every non-empty histogram bucket.
+/// @param reply Callback with the histogram dictionary (empty if the monitor is not running)
+- (void)getAWDLReactionHistogramWithReply:(void (^_Nonnull)(NSDictionary<NSString *, id> *_Nonnull histogram))reply NS_SWIFT_NAME(getAWDLReactionHistogram(reply:));
+
+/// Get the interventions recorded after a cursor, oldest first. The helper keeps the most
+/// recent 256; a cursor older than that resumes at the oldest one still retained.
+/// Each event is a dictionary with "sequence", "timestamp" (helper monotonic clock, nanoseconds),
+/// "flags" (interface flags that triggered it), "trigger" (0 = system raised the interface,
+/// 1 = interface arrived already UP, 2 = a direct flags read after dropped routing messages found it UP)
+/// and "interface" (the interface's position in getInterfacePolicyWithReply:'s table; 0 = awdl0).
+/// @param cursor Sequence of the last event already seen, or 0 for everything retained
+/// @param reply Callback with the events, the newest sequence the helper has recorded (lower than
+///        cursor if the helper restarted), the helper's current monotonic time in nanoseconds for
+///        converting timestamps, and the intervention count
+- (void)getAWDLInterventionEventsAfterCursor:(uint64_t)cursor
+                                   withReply:(void (^_Nonnull)(NSArray<NSDictionary<NSString *, NSNumber *> *> *_Nonnull events,
+                                                               uint64_t latestSequence,
+                                                               uint64_t nowNanos,
+                                                               NSInteger interventionCount))reply
+    NS_SWIFT_NAME(getAWDLInterventionEvents(after:reply:));
+
+/// Get the routing socket's overflow recovery counters. When a storm fills the socket's receive
+/// buffer the kernel drops messages (ENOBUFS); the enforcement thread then re-reads the interface
+/// flags instead of waiting for the next event. Keys: "overflows" (drains that lost messages),
+/// "resyncs" (direct flag reads), "resyncInterventions" (interventions only a resync revealed)
+/// and "receiveBufferBytes" (SO_RCVBUF as granted by the kernel; set with the helper's
+/// EventReceiveBufferSize preference).
+/// @param reply Callback with the counters (empty if the monitor is not running)
+- (void)getEventSourceCountersWithReply:(void (^_Nonnull)(NSDictionary<NSString *, NSNumber *> *_Nonnull counters))reply NS_SWIFT_NAME(getEventSourceCounters(reply:));
+
+/// Get the intervention rate and the most recent intervention storms: bursts in which the system
+/// raised the interfaces faster than 2 per second for longer than a 10-intervention allowance.
+/// Keys: "rate" (EWMA interventions per second, about a 0.8 s time constant), "peakRate" (busiest
+/// 100 ms window since the helper started, per second), "episodeCount" (storms since start),
+/// "storming" (a storm is in progress), "nowNanos" (helper monotonic clock, for converting
+/// timestamps) and "episodes": up to 32 dictionaries, oldest first, with "sequence", "startedAt"
+/// (monotonic nanoseconds of the burst's first intervention), "durationNanos" (first to latest
+/// intervention), "interventions", "peakRate" and "active" (YES until the storm has subsided).
+/// @param reply Callback with the statistics (empty if the monitor is not running)
+- (void)getInterventionStormsWithReply:(void (^_Nonnull)(NSDictionary<NSString *, id> *_Nonnull storms))reply NS_SWIFT_NAME(getInterventionStorms(reply:));
+
+/// Get the helper's interface policy table: one dictionary per controlled interface, in a fixed
+/// order (awdl0, then llw0), with "name", "allowed" (YES if the interface may be UP), "ifindex"
+/// (0 while the interface does not exist), "interventions" and "resyncInterventions" (this
+/// interface's share of the intervention counters).
+/// @param reply Callback with the table (empty if the monitor is not running)
+- (void)getInterfacePolicyWithReply:(void (^_Nonnull)(NSArray<NSDictionary<NSString *, id> *> *_Nonnull table))reply NS_SWIFT_NAME(getInterfacePolicy(reply:));
+
+/// Allow or block several interfaces in one atomic update; interfaces not named keep their state.
+/// setAWDLEnabled:withReply: is the same as @{ @"awdl0": @(enable) }.
+/// @param policy Interface name -> YES to allow UP, NO to keep DOWN
+/// @param reply Callback with success status (NO, changing nothing, if a name is not in the table)
+- (void)setInterfacePolicy:(NSDictionary<NSString *, NSNumber *> *_Nonnull)policy
+                 withReply:(void (^_Nonnull)(BOOL success))reply NS_SWIFT_NAME(setInterfacePolicy(_:reply:));
+
+/// Opt the enforcement thread in or out of realtime scheduling (a Mach time-constraint
+/// policy), which keeps its wakeup latency low while other processes saturate every core.
+/// Persisted with the interface policy; the app also re-applies its preference after each connection.
+/// @param enable YES for realtime scheduling, NO for the default timesharing policy
+/// @param reply Callback with success status (NO if the kernel refused the policy)
+- (void)setRealtimeSchedulingEnabled:(BOOL)enable withReply:(void (^_Nonnull)(BOOL success))reply NS_SWIFT_NAME(setRealtimeSchedulingEnabled(_:reply:));
+
+/// Lock the enforcement loop's working set in RAM (the enforcer, the routing socket's buffers
+/// and the loop thread's stack, which are prefaulted at start either way), so a long session
+/// that pushes everything else out cannot make an intervention wait for a page fault. macOS
+/// does not implement mlockall, so only these pages are locked, not the whole helper.
+/// Persisted with the interface policy; the app also re-applies its preference after each connection.
+/// @param enable YES to lock, NO to unlock
+/// @param reply Callback with success status (NO if the kernel refused to lock the pages)
+- (void)setMemoryLockingEnabled:(BOOL)enable withReply:(void (^_Nonnull)(BOOL success))reply NS_SWIFT_NAME(setMemoryLockingEnabled(_:reply:));
+
+/// Get the enforcement loop's memory residency and page faults.
+/// Keys: "locked" (setMemoryLockingEnabled: is in effect), "lockedBytes", "prefaultedBytes"
+/// (faulted in before the first event), "faultsAvailable" (NO until the loop has started),
+/// "faultsPerThread" (YES if the counts are the loop thread's own; on macOS they are the whole
+/// helper's), "minorFaults" and "majorFaults" (since the loop started; major faults needed disk I/O).
+/// @param reply Callback with the statistics (empty if the monitor is not running)
+- (void)getEnforcementMemoryStatsWithReply:(void (^_Nonnull)(NSDictionary<NSString *, NSNumber *> *_Nonnull stats))reply NS_SWIFT_NAME(getEnforcementMemoryStats(reply:));
+
+/// Dump the enforcement loop's binary trace after a cursor, oldest first. The loop records what
+/// it does (wakeups, link messages for controlled interfaces, interventions, state changes...)
+/// into a 1024-record ring instead of logging it; os_log only carries lifecycle events.
+/// Each record is an array [sequence, timestamp (helper monotonic clock, nanoseconds), event, arg0,
+/// arg1]. Events and their arguments: 1 wakeup (routing socket readable, mailbox readable),
+/// 2 link (interface, flags), 3 arrival (interface, ifindex), 4 departure (interface, ifindex),
+/// 5 overflow (overflows so far, 0), 6 resync (interface, flags), 7 intervention (interface,
+/// receive-to-SIOCSIFFLAGS nanoseconds), 8 write failed (interface, errno), 9 control (allow
+/// mask, superseded commands), 10 applied (interface, flags written). Interfaces are positions
+/// in getInterfacePolicyWithReply:'s table.
+/// @param cursor Sequence of the last record already seen, or 0 for everything retained
+/// @param reply Callback with the records, the newest sequence the helper has recorded, and the
+///        helper's current monotonic time in nanoseconds for converting timestamps
+- (void)getEnforcementTraceAfterCursor:(uint64_t)cursor
+                             withReply:(void (^_Nonnull)(NSArray<NSArray<NSNumber *> *> *_Nonnull records,
+                                                         uint64_t latestSequence,
+                                                         uint64_t nowNanos))reply
+    NS_SWIFT_NAME(getEnforcementTrace(after:reply:));
+
+/// Get the helper's launch instrumentation. The helper keeps the interface policy and the loop
+/// opt-ins in a crash-safe state file and restores them before accepting connections.
+/// Keys: "restoredState" (YES if this launch started from the state file), "stateFileAvailable",
+/// "processStartToFirstEnforcementNanos" (kernel process start to the enforcement loop applying
+/// its first state; 0 until it has) and "uptimeNanos" (since process start).
+/// @param reply Callback with the statistics (empty if the monitor is not running)
+- (void)getStartupStatisticsWithReply:(void (^_Nonnull)(NSDictionary<NSString *, NSNumber *> *_Nonnull stats))reply NS_SWIFT_NAME(getStartupStatistics(reply:));
+
+/// Get intervention statistics that survive helper restarts and crashes. The enforcement thread
+/// keeps them in a memory-mapped file; this reads the mapping without involving the thread.
+/// Keys: "createdAt" (seconds since 1970 when the counters started), "launches" (helper
+/// processes since then), "interventions", "lastInterventionAt" (seconds since 1970, 0 if none),
+/// "maxBurstRate" (busiest 100 ms window ever, interventions per second), "maxBurstAt",
+/// "upNanos" (time the controlled interfaces were seen UP, summed over interfaces) and "days"
+/// (newest first, up to 32 dictionaries with "day", UTC days since 1970, and "interventions";
+/// days without interventions are omitted).
+/// @param reply Callback with the statistics (empty if the counter file could not be opened)
+- (void)getLifetimeStatisticsWithReply:(void (^_Nonnull)(NSDictionary<NSString *, id> *_Nonnull stats))reply NS_SWIFT_NAME(getLifetimeStatistics(reply:));
+
+/// Get everything a health check or diagnostics export needs in one round trip, instead of one
+/// call per statistic. Keys: "version", "awdlEnabled" (desired state), "interventionCount",
+/// "interfaces" (getInterfacePolicyWithReply:'s table, each entry with "flags" added: the
+/// interface's flags from a SIOCGIFFLAGS the helper issues while building the reply, absent if
+/// the interface does not exist), and the replies of the other getters under "reactionTimes",
+/// "eventSource", "storms", "memory", "startup" (which carries "uptimeNanos") and "lifetime".
+/// None of it involves the enforcement thread.
+/// @param reply Callback with the snapshot (only "version" if the monitor is not running)
+- (void)getHelperSnapshotWithReply:(void (^_Nonnull)(NSDictionary<NSString *, id> *_Nonnull snapshot))reply NS_SWIFT_NAME(getHelperSnapshot(reply:));
+
+/// Measure the enforcement loop end to end: raise a blocked interface with SIOCSIFFLAGS rounds
+/// times and, for each raise, find the loop's intervention in its trace. Every time is taken in
+/// the helper on one monotonic clock, so neither XPC nor process spawns are in the numbers.
+/// The interface is left DOWN and the raises count as interventions. One test runs at a time;
+/// others queue behind it.
+/// Keys: "rounds" (raises made), "lowered" (of which the loop brought back DOWN within a second),
+/// "raiseToSeen" (raise to the loop receiving the UP) and "raiseToDown" (raise to the loop's
+/// SIOCSIFFLAGS(DOWN) returning), histograms in the stage format of
+/// getAWDLReactionHistogramWithReply:, "samples" ([raiseToSeen, raiseToDown] nanoseconds per
+/// round, 0 if the loop missed it) and "error" (why the test refused or stopped early).
+/// @param interfaceName An interface in getInterfacePolicyWithReply:'s table that is being kept DOWN
+/// @param rounds Raises to make, clamped to 1...1000
+/// @param reply Callback with the results
+- (void)runSelfTestOnInterface:(NSString *_Nonnull)interfaceName
+                        rounds:(NSUInteger)rounds
+                     withReply:(void (^_Nonnull)(NSDictionary<NSString *, id> *_Nonnull result))reply
+    NS_SWIFT_NAME(runSelfTest(interface:rounds:reply:));
+
+/// Register the calling connection for pushed updates through PingWardenHelperClientProtocol,
+/// which the caller must export on the same connection. The helper immediately pushes the current
+/// AWDL state and any interventions after cursor, then pushes coalesced batches as they happen.
+/// Registration ends when the connection is invalidated.
+/// @param cursor Sequence of the last intervention event already seen, or 0
+/// @param maxFlushesPerSecond Upper bound on intervention batches per second (0 for the default of 10)
+/// @param reply Callback with success status
+- (void)registerForUpdatesAfterCursor:(uint64_t)cursor
+                  maxFlushesPerSecond:(double)maxFlushesPerSecond
+                            withReply:(void (^_Nonnull)(BOOL success))reply
+    NS_SWIFT_NAME(registerForUpdates(after:maxFlushesPerSecond:reply:));
+
+@end
+
+/// Reverse XPC protocol exported by clients that register for pushed updates.
+/// Calls arrive on the connection's queue and may be coalesced.
+@protocol PingWardenHelperClientProtocol <NSObject>
+
+/// New interventions since the previous batch, oldest first, in the event format of
+/// getAWDLInterventionEventsAfterCursor:withReply:. Batches for a client are at least
+/// 1/maxFlushesPerSecond apart; interventions in between are delivered together.
+- (void)helperDidRecordInterventions:(NSArray<NSDictionary<NSString *, NSNumber *> *> *_Nonnull)events
+                      latestSequence:(uint64_t)latestSequence
+                            nowNanos:(uint64_t)nowNanos
+                   interventionCount:(NSInteger)interventionCount
+    NS_SWIFT_NAME(helperDidRecordInterventions(_:latestSequence:nowNanos:interventionCount:));
+
+/// The desired AWDL state changed (from any client), or the client just registered.
+/// @param enabled YES if AWDL is allowed UP, NO if it is being kept DOWN
+- (void)helperDidChangeAWDLEnabled:(BOOL)enabled NS_SWIFT_NAME(helperDidChangeAWDLEnabled(_:));
+
 @end
@@ -0,0 +1,100 @@
+//
+//  DefaultGateway.swift
+//  PingWarden
+//
+//  The default gateway read from the routing table (PWDefaultGateway.h), cached
+//  and kept current by a route-change socket instead of spawning route(8).
+//
+
+import Foundation
+
+/// Caches the IPv4 default gateway and refreshes it when the routing socket reports a
+/// change that can move the default route. Reads cost a lock, never a system call.
+final class DefaultGateway {
+    static let shared = DefaultGateway()
+
+    private let queue = DispatchQueue(label: "com.amesvt.pingwarden.gateway")
+    private let lock = NSLock()
+    private var cachedAddress: String?
+    private var observers: [UUID: (String?) -> Void] = [:]
+    private var changeSource: DispatchSourceRead?
+
+    private init() {
+        // Subscribe before the first lookup so a change in between is not lost
+        let fd = PWRouteChangeOpenSocket()
+        if fd >= 0 {
+            let source = DispatchSource.makeReadSource(fileDescriptor: fd, queue: queue)
+            source.setEventHandler { [weak self] in
+                self?.routesChanged(fd)
+            }
+            source.setCancelHandler {
+                close(fd)
+            }
+            source.resume()
+            changeSource = source
+        }
+        cachedAddress = Self.lookUp()
+    }
+
+    deinit {
+        changeSource?.cancel()
+    }
+
+    /// The default gateway's address, or nil if there is no default route or it points at
+    /// an interface rather than a router (e.g. a VPN tunnel). Without a route-change
+    /// socket every read queries the routing table, which still costs only microseconds.
+    var address: String? {
+        guard changeSource != nil else { return Self.lookUp() }
+        lock.lock()
+        defer { lock.unlock() }
+        return cachedAddress
+    }
+
+    /// Called on the main queue with the new address whenever it changes.
+    @discardableResult
+    func addObserver(_ observer: @escaping (String?) -> Void) -> UUID {
+        let token = UUID()
+        lock.lock()
+        observers[token] = observer
+        lock.unlock()
+        return token
+    }
+
+    /// Remove a previously registered observer.
+    func removeObserver(_ token: UUID) {
+        lock.lock()
+        observers.removeValue(forKey: token)
+        lock.unlock()
+    }
+
+    /// One RTM_GET (RTM_GETROUTE dump on Linux); nil without a default router.
+    private static func lookUp() -> String? {
+        var gateway = PWDefaultGateway()
+        guard PWDefaultGatewayRead(&gateway) else { return nil }
+        let address = withUnsafeBytes(of: &gateway.address) { bytes in
+            String(decoding: bytes.prefix { $0 != 0 }, as: UTF8.self)
+        }
+        return address.isEmpty ? nil : address
+    }
+
+    private func routesChanged(_ fd: Int32) {
+        // -1 (e.g. ENOBUFS) means messages were lost; look the gateway up regardless
+        guard PWRouteChangeDrain(fd) != 0 else { return }
+        let address = Self.lookUp()
+
+        lock.lock()
+        guard address != cachedAddress else {
+            lock.unlock()
+            return
+        }
+        cachedAddress = address
+        let observers = Array(self.observers.values)
+        lock.unlock()
+
+        DispatchQueue.main.async {
+            for observer in observers {
+                observer(address)
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+//
+//  EnforcementMemoryStats.swift
+//  PingWarden
+//
+//  Residency of the helper's enforcement loop and the page faults it has taken.
+//
+
+import Foundation
+
+struct EnforcementMemoryStats: Equatable {
+    /// The working set is locked in RAM.
+    var locked: Bool
+    var lockedBytes: UInt64
+    /// Faulted in before the first event, locked or not.
+    var prefaultedBytes: UInt64
+    /// False until the enforcement loop has started.
+    var faultsAvailable: Bool
+    /// True if the fault counts are the loop thread's own; on macOS they cover the whole helper.
+    var faultsPerThread: Bool
+    /// Faults resolved without I/O since the loop started.
+    var minorFaults: UInt64
+    /// Faults that waited for disk since the loop started.
+    var majorFaults: UInt64
+
+    static let empty = EnforcementMemoryStats(
+        locked: false, lockedBytes: 0, prefaultedBytes: 0,
+        faultsAvailable: false, faultsPerThread: false, minorFaults: 0, majorFaults: 0
+    )
+
+    init(locked: Bool, lockedBytes: UInt64, prefaultedBytes: UInt64,
+         faultsAvailable: Bool, faultsPerThread: Bool, minorFaults: UInt64, majorFaults: UInt64) {
+        self.locked = locked
+        self.lockedBytes = lockedBytes
+        self.prefaultedBytes = prefaultedBytes
+        self.faultsAvailable = faultsAvailable
+        self.faultsPerThread = faultsPerThread
+        self.minorFaults = minorFaults
+        self.majorFaults = majorFaults
+    }
+
+    /// Parses the dictionary returned by `getEnforcementMemoryStats(reply:)`.
+    init(dictionary: [String: NSNumber]) {
+        self.init(
+            locked: dictionary["locked"]?.boolValue ?? false,
+            lockedBytes: dictionary["lockedBytes"]?.uint64Value ?? 0,
+            prefaultedBytes: dictionary["prefaultedBytes"]?.uint64Value ?? 0,
+            faultsAvailable: dictionary["faultsAvailable"]?.boolValue ?? false,
+            faultsPerThread: dictionary["faultsPerThread"]?.boolValue ?? false,
+            minorFaults: dictionary["minorFaults"]?.uint64Value ?? 0,
+            majorFaults: dictionary["majorFaults"]?.uint64Value ?? 0
+        )
+    }
+}
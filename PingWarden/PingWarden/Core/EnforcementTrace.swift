@@ -0,0 +1,99 @@
+//
+//  EnforcementTrace.swift
+//  PingWarden
+//
+//  The helper enforcement loop's binary trace, decoded for diagnostics.
+//
+
+import Foundation
+
+struct EnforcementTraceRecord: Equatable {
+    /// Event ids as recorded by the helper (Core/PWTrace.h).
+    enum Event: Int {
+        case wakeup = 1
+        case link
+        case arrival
+        case departure
+        case overflow
+        case resync
+        case intervention
+        case writeFailed
+        case control
+        case applied
+
+        var name: String {
+            switch self {
+            case .wakeup: return "wakeup"
+            case .link: return "link"
+            case .arrival: return "arrival"
+            case .departure: return "departure"
+            case .overflow: return "overflow"
+            case .resync: return "resync"
+            case .intervention: return "intervention"
+            case .writeFailed: return "write-failed"
+            case .control: return "control"
+            case .applied: return "applied"
+            }
+        }
+    }
+
+    let sequence: UInt64
+    /// Helper monotonic clock, nanoseconds.
+    let timestamp: UInt64
+    /// nil for ids this build does not know.
+    let event: Event?
+    let arg0: UInt64
+    let arg1: UInt64
+
+    /// One line per record: the arguments are labelled by event, flags in hex.
+    var description: String {
+        let detail: String
+        switch event {
+        case .wakeup:
+            detail = "routing=\(arg0) mailbox=\(arg1)"
+        case .link, .resync, .applied:
+            detail = "interface=\(arg0) flags=0x\(String(arg1, radix: 16))"
+        case .arrival, .departure:
+            detail = "interface=\(arg0) ifindex=\(arg1)"
+        case .overflow:
+            detail = "overflows=\(arg0)"
+        case .intervention:
+            detail = "interface=\(arg0) reaction_ns=\(arg1)"
+        case .writeFailed:
+            detail = "interface=\(arg0) errno=\(arg1)"
+        case .control:
+            detail = "allow_mask=0x\(String(arg0, radix: 16)) superseded=\(arg1)"
+        case nil:
+            detail = "arg0=\(arg0) arg1=\(arg1)"
+        }
+        return "\(sequence) t=\(timestamp) \(event?.name ?? "unknown") \(detail)"
+    }
+}
+
+struct EnforcementTrace: Equatable {
+    let records: [EnforcementTraceRecord]
+    /// Helper monotonic time when the trace was read, for ageing the timestamps.
+    let nowNanos: UInt64
+
+    static let empty = EnforcementTrace(records: [], nowNanos: 0)
+
+    init(records: [EnforcementTraceRecord], nowNanos: UInt64) {
+        self.records = records
+        self.nowNanos = nowNanos
+    }
+
+    /// Parses a `getEnforcementTrace(after:reply:)` reply.
+    init(rawRecords: [[NSNumber]], nowNanos: UInt64) {
+        self.records = rawRecords.compactMap { raw in
+            guard raw.count >= 5 else { return nil }
+            return EnforcementTraceRecord(
+                sequence: raw[0].uint64Value,
+                timestamp: raw[1].uint64Value,
+                event: EnforcementTraceRecord.Event(rawValue: raw[2].intValue),
+                arg0: raw[3].uint64Value,
+                arg1: raw[4].uint64Value
+            )
+        }
+        self.nowNanos = nowNanos
+    }
+}
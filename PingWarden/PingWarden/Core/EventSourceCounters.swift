@@ -0,0 +1,38 @@
+//
+//  EventSourceCounters.swift
+//  PingWarden
+//
+//  Routing socket overflow and resync counters reported by the helper.
+//
+
+import Foundation
+
+struct EventSourceCounters: Equatable {
+    /// Drains in which the kernel dropped routing messages (receive buffer full).
+    var overflows: UInt64
+    /// Direct interface flag reads standing in for messages that may have been lost.
+    var resyncs: UInt64
+    /// Interventions on an UP that only a resync revealed.
+    var resyncInterventions: UInt64
+    /// Routing socket receive buffer as granted by the kernel; -1 if unknown.
+    var receiveBufferBytes: Int
+
+    static let empty = EventSourceCounters(overflows: 0, resyncs: 0, resyncInterventions: 0, receiveBufferBytes: -1)
+
+    init(overflows: UInt64, resyncs: UInt64, resyncInterventions: UInt64, receiveBufferBytes: Int) {
+        self.overflows = overflows
+        self.resyncs = resyncs
+        self.resyncInterventions = resyncInterventions
+        self.receiveBufferBytes = receiveBufferBytes
+    }
+
+    /// Parses the dictionary returned by `getEventSourceCounters(reply:)`.
+    init(dictionary: [String: NSNumber]) {
+        self.init(
+            overflows: dictionary["overflows"]?.uint64Value ?? 0,
+            resyncs: dictionary["resyncs"]?.uint64Value ?? 0,
+            resyncInterventions: dictionary["resyncInterventions"]?.uint64Value ?? 0,
+            receiveBufferBytes: dictionary["receiveBufferBytes"]?.intValue ?? -1
+        )
+    }
+}
@@ -0,0 +1,69 @@
+//
+//  HelperSelfTest.swift
+//  PingWarden
+//
+//  Result of the helper's enforcement self-test: raises of a blocked interface
+//  timed against the loop lowering it again, all on the helper's clock.
+//
+
+import Foundation
+
+struct HelperSelfTest: Equatable {
+    struct Sample: Equatable {
+        /// Raise -> the loop received the UP; 0 if missed.
+        var raiseToSeenNanos: UInt64
+        /// Raise -> the loop's SIOCSIFFLAGS(DOWN) returned; 0 if missed.
+        var raiseToDownNanos: UInt64
+
+        var lowered: Bool { raiseToDownNanos > 0 }
+    }
+
+    var rounds: Int
+    var lowered: Int
+    var raiseToSeen: ReactionTimeHistogram.Stage
+    var raiseToDown: ReactionTimeHistogram.Stage
+    /// One entry per raise, in order.
+    var samples: [Sample]
+    /// Why the helper refused the test or stopped early.
+    var error: String?
+
+    var passed: Bool { error == nil && rounds > 0 && lowered == rounds }
+
+    static let empty = HelperSelfTest(
+        rounds: 0,
+        lowered: 0,
+        raiseToSeen: .empty,
+        raiseToDown: .empty,
+        samples: [],
+        error: nil
+    )
+
+    init(rounds: Int, lowered: Int, raiseToSeen: ReactionTimeHistogram.Stage,
+         raiseToDown: ReactionTimeHistogram.Stage, samples: [Sample], error: String?) {
+        self.rounds = rounds
+        self.lowered = lowered
+        self.raiseToSeen = raiseToSeen
+        self.raiseToDown = raiseToDown
+        self.samples = samples
+        self.error = error
+    }
+
+    /// Parses the dictionary returned by `runSelfTest(interface:rounds:reply:)`.
+    init(dictionary: [String: Any]) {
+        func stage(_ key: String) -> ReactionTimeHistogram.Stage {
+            (dictionary[key] as? [String: Any]).map(ReactionTimeHistogram.Stage.init(dictionary:)) ?? .empty
+        }
+        let rawSamples = dictionary["samples"] as? [[NSNumber]] ?? []
+        self.init(
+            rounds: (dictionary["rounds"] as? NSNumber)?.intValue ?? 0,
+            lowered: (dictionary["lowered"] as? NSNumber)?.intValue ?? 0,
+            raiseToSeen: stage("raiseToSeen"),
+            raiseToDown: stage("raiseToDown"),
+            samples: rawSamples.compactMap { pair in
+                guard pair.count == 2 else { return nil }
+                return Sample(raiseToSeenNanos: pair[0].uint64Value, raiseToDownNanos: pair[1].uint64Value)
+            },
+            error: dictionary["error"] as? String
+        )
+    }
+}
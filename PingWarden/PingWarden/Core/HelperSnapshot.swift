@@ -0,0 +1,74 @@
+//
+//  HelperSnapshot.swift
+//  PingWarden
+//
+//  Everything the helper reports, fetched in a single round trip.
+//
+
+import Foundation
+
+struct HelperSnapshot: Equatable {
+    struct Interface: Equatable {
+        let policy: InterfacePolicyEntry
+        /// Flags the helper read with SIOCGIFFLAGS while replying; nil if the interface does not exist.
+        let flags: UInt32?
+
+        var name: String { policy.name }
+
+        /// nil if the interface does not exist.
+        var isUp: Bool? {
+            flags.map { $0 & UInt32(IFF_UP) != 0 }
+        }
+
+        /// One-line description for logs and diagnostics, e.g. "flags=0x8843 UP".
+        var statusDescription: String {
+            guard let flags else { return "absent" }
+            return "flags=0x\(String(flags, radix: 16)) \(isUp == true ? "UP" : "DOWN")"
+        }
+    }
+
+    var version: String
+    /// Desired state: AWDL may come UP.
+    var awdlEnabled: Bool
+    var interventionCount: Int
+    /// In the helper's slot order (awdl0, then llw0).
+    var interfaces: [Interface]
+    var reactionTimes: ReactionTimeHistogram
+    var eventSource: EventSourceCounters
+    var storms: InterventionStorms
+    var memory: EnforcementMemoryStats
+    var startup: HelperStartupStatistics
+    var lifetime: LifetimeStatistics
+
+    var awdl: Interface? {
+        interfaces.first { $0.name == "awdl0" }
+    }
+
+    var uptime: TimeInterval {
+        TimeInterval(startup.uptimeNanos) / 1_000_000_000
+    }
+
+    /// Human-readable desired state, as `getAWDLStatus(reply:)` words it.
+    var statusDescription: String {
+        awdlEnabled ? "AWDL Enabled (allowing UP)" : "AWDL Disabled (keeping DOWN)"
+    }
+
+    /// Parses the dictionary returned by `getHelperSnapshot(reply:)`.
+    init(dictionary: [String: Any], receivedAt: Date = Date()) {
+        let rawInterfaces = dictionary["interfaces"] as? [[String: Any]] ?? []
+        version = dictionary["version"] as? String ?? "Unknown"
+        awdlEnabled = (dictionary["awdlEnabled"] as? NSNumber)?.boolValue ?? true
+        interventionCount = (dictionary["interventionCount"] as? NSNumber)?.intValue ?? 0
+        interfaces = rawInterfaces.compactMap { raw in
+            InterfacePolicyEntry(dictionary: raw).map {
+                Interface(policy: $0, flags: (raw["flags"] as? NSNumber)?.uint32Value)
+            }
+        }
+        reactionTimes = ReactionTimeHistogram(dictionary: dictionary["reactionTimes"] as? [String: Any] ?? [:])
+        eventSource = EventSourceCounters(dictionary: dictionary["eventSource"] as? [String: NSNumber] ?? [:])
+        storms = InterventionStorms(dictionary: dictionary["storms"] as? [String: Any] ?? [:], receivedAt: receivedAt)
+        memory = EnforcementMemoryStats(dictionary: dictionary["memory"] as? [String: NSNumber] ?? [:])
+        startup = HelperStartupStatistics(dictionary: dictionary["startup"] as? [String: NSNumber] ?? [:])
+        lifetime = LifetimeStatistics(dictionary: dictionary["lifetime"] as? [String: Any] ?? [:])
+    }
+}
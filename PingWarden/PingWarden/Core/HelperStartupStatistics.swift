@@ -0,0 +1,38 @@
+//
+//  HelperStartupStatistics.swift
+//  PingWarden
+//
+//  How quickly the helper enforced its persisted state after launch.
+//
+
+import Foundation
+
+struct HelperStartupStatistics: Equatable {
+    /// This helper process started from its persisted state file.
+    var restoredState: Bool
+    var stateFileAvailable: Bool
+    /// Kernel process start to the enforcement loop applying its first state; 0 until it has.
+    var processStartToFirstEnforcementNanos: UInt64
+    var uptimeNanos: UInt64
+
+    static let empty = HelperStartupStatistics(
+        restoredState: false, stateFileAvailable: false, processStartToFirstEnforcementNanos: 0, uptimeNanos: 0
+    )
+
+    init(restoredState: Bool, stateFileAvailable: Bool, processStartToFirstEnforcementNanos: UInt64, uptimeNanos: UInt64) {
+        self.restoredState = restoredState
+        self.stateFileAvailable = stateFileAvailable
+        self.processStartToFirstEnforcementNanos = processStartToFirstEnforcementNanos
+        self.uptimeNanos = uptimeNanos
+    }
+
+    /// Parses the dictionary returned by `getStartupStatistics(reply:)`.
+    init(dictionary: [String: NSNumber]) {
+        self.init(
+            restoredState: dictionary["restoredState"]?.boolValue ?? false,
+            stateFileAvailable: dictionary["stateFileAvailable"]?.boolValue ?? false,
+            processStartToFirstEnforcementNanos: dictionary["processStartToFirstEnforcementNanos"]?.uint64Value ?? 0,
+            uptimeNanos: dictionary["uptimeNanos"]?.uint64Value ?? 0
+        )
+    }
+}
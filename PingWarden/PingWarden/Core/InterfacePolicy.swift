@@ -0,0 +1,35 @@
+//
+//  InterfacePolicy.swift
+//  PingWarden
+//
+//  The helper's per-interface policy table (awdl0, llw0) and its counters.
+//
+
+import Foundation
+
+struct InterfacePolicyEntry: Equatable {
+    let name: String
+    /// Whether the helper lets the interface come UP.
+    let allowed: Bool
+    /// 0 while the interface does not exist.
+    let ifindex: UInt32
+    /// Times this interface was brought back DOWN.
+    let interventions: UInt64
+    /// Of which only a direct flags read after dropped routing messages revealed the UP.
+    let resyncInterventions: UInt64
+
+    /// Parses one entry of the table returned by `getInterfacePolicy(reply:)`.
+    init?(dictionary: [String: Any]) {
+        guard let name = dictionary["name"] as? String else { return nil }
+        self.name = name
+        self.allowed = (dictionary["allowed"] as? NSNumber)?.boolValue ?? true
+        self.ifindex = (dictionary["ifindex"] as? NSNumber)?.uint32Value ?? 0
+        self.interventions = (dictionary["interventions"] as? NSNumber)?.uint64Value ?? 0
+        self.resyncInterventions = (dictionary["resyncInterventions"] as? NSNumber)?.uint64Value ?? 0
+    }
+
+    /// Parses the whole table, keeping the helper's slot order.
+    static func table(from raw: [[String: Any]]) -> [InterfacePolicyEntry] {
+        raw.compactMap { InterfacePolicyEntry(dictionary: $0) }
+    }
+}
@@ -0,0 +1,38 @@
+//
+//  InterfaceStatus.swift
+//  PingWarden
+//
+//  Interface flags read in-process (SIOCGIFFLAGS), without spawning ifconfig.
+//
+
+import Foundation
+
+struct InterfaceStatus: Equatable {
+    let name: String
+    /// IFF_* flags; nil if the interface does not exist or could not be read.
+    let flags: UInt32?
+
+    var exists: Bool { flags != nil }
+
+    var isUp: Bool {
+        flags.map { $0 & UInt32(IFF_UP) != 0 } ?? false
+    }
+
+    var isRunning: Bool {
+        flags.map { $0 & UInt32(IFF_RUNNING) != 0 } ?? false
+    }
+
+    /// The flags as ifconfig prints them, e.g. "awdl0: flags=8843<UP,BROADCAST,RUNNING,SIMPLEX,MULTICAST>".
+    var description: String {
+        guard let flags else { return "\(name): does not exist" }
+        var buffer = [CChar](repeating: 0, count: 128)
+        PWInterfaceFlagsFormat(flags, &buffer, buffer.count)
+        return "\(name): flags=\(String(cString: buffer))"
+    }
+
+    /// One SIOCGIFFLAGS on a short-lived socket: a few microseconds.
+    static func read(_ name: String) -> InterfaceStatus {
+        var flags: UInt32 = 0
+        return InterfaceStatus(name: name, flags: PWInterfaceFlagsRead(name, &flags) ? flags : nil)
+    }
+}
@@ -0,0 +1,100 @@
+//
+//  InterventionEvent.swift
+//  PingWarden
+//
+//  Timestamped interventions fetched incrementally from the helper's event ring.
+//
+
+import Foundation
+
+struct InterventionEvent: Equatable {
+    enum Trigger: Int {
+        /// The system raised the interface.
+        case linkUp = 0
+        /// The interface appeared already UP.
+        case arrival = 1
+        /// Routing messages were dropped; re-reading the flags found it UP.
+        case resync = 2
+    }
+
+    let sequence: UInt64
+    let date: Date
+    let flags: UInt32
+    let trigger: Trigger
+    /// Position of the interface in the helper's policy table (0 = awdl0).
+    let interface: Int
+}
+
+struct InterventionEventBatch: Equatable {
+    let events: [InterventionEvent]
+    /// Cursor to pass on the next fetch.
+    let nextCursor: UInt64
+    let interventionCount: Int
+
+    /// Builds a batch from a `getAWDLInterventionEvents(after:reply:)` reply.
+    /// Helper timestamps are monotonic, so they are placed relative to the helper's
+    /// `nowNanos` at reply time.
+    init(rawEvents: [[String: NSNumber]],
+         cursor: UInt64,
+         latestSequence: UInt64,
+         nowNanos: UInt64,
+         interventionCount: Int,
+         receivedAt: Date = Date()) {
+        self.events = rawEvents.compactMap { raw in
+            guard let sequence = raw["sequence"]?.uint64Value,
+                  let timestamp = raw["timestamp"]?.uint64Value else {
+                return nil
+            }
+            let age = TimeInterval(nowNanos >= timestamp ? nowNanos - timestamp : 0) / 1_000_000_000
+            return InterventionEvent(
+                sequence: sequence,
+                date: receivedAt.addingTimeInterval(-age),
+                flags: raw["flags"]?.uint32Value ?? 0,
+                trigger: Trigger(rawValue: raw["trigger"]?.intValue ?? 0) ?? .linkUp,
+                interface: raw["interface"]?.intValue ?? 0
+            )
+        }
+
+        if latestSequence < cursor {
+            // The helper restarted and its sequence numbers began again; start over
+            self.nextCursor = self.events.last?.sequence ?? 0
+        } else {
+            self.nextCursor = max(cursor, self.events.last?.sequence ?? cursor)
+        }
+        self.interventionCount = interventionCount
+    }
+
+    private init(events: [InterventionEvent], nextCursor: UInt64, interventionCount: Int) {
+        self.events = events
+        self.nextCursor = nextCursor
+        self.interventionCount = interventionCount
+    }
+
+    /// The part of this batch a consumer at `cursor` has not seen yet. Useful when pushed
+    /// batches overlap a fetch. If the helper's sequence restarted below `cursor`, every
+    /// event is new.
+    func continuing(from cursor: UInt64) -> InterventionEventBatch {
+        guard nextCursor >= cursor else { return self }
+        return InterventionEventBatch(
+            events: events.filter { $0.sequence > cursor },
+            nextCursor: nextCursor,
+            interventionCount: interventionCount
+        )
+    }
+
+    /// Groups events that follow each other within `window` into one timeline entry,
+    /// dated at the first event of the run.
+    func clusters(within window: TimeInterval) -> [(date: Date, count: Int)] {
+        var result: [(date: Date, count: Int)] = []
+        var lastDate: Date?
+        for event in events {
+            if let last = lastDate, event.date.timeIntervalSince(last) < window, !result.isEmpty {
+                result[result.count - 1].count += 1
+            } else {
+                result.append((event.date, 1))
+            }
+            lastDate = event.date
+        }
+        return result
+    }
+}
@@ -0,0 +1,72 @@
+//
+//  InterventionStorms.swift
+//  PingWarden
+//
+//  Intervention rate and storm episodes reported by the helper.
+//
+
+import Foundation
+
+struct InterventionStorms: Equatable {
+    struct Episode: Equatable {
+        let sequence: UInt64
+        let startedAt: Date
+        let duration: TimeInterval
+        let interventions: UInt64
+        /// Busiest 100 ms window of the burst, interventions per second.
+        let peakRate: Double
+        /// The storm has not subsided yet.
+        let active: Bool
+    }
+
+    /// Smoothed interventions per second.
+    var rate: Double
+    /// Busiest 100 ms window since the helper started, interventions per second.
+    var peakRate: Double
+    /// Storms since the helper started; `episodes` keeps only the most recent.
+    var episodeCount: UInt64
+    var storming: Bool
+    /// Oldest first.
+    var episodes: [Episode]
+
+    static let empty = InterventionStorms(rate: 0, peakRate: 0, episodeCount: 0, storming: false, episodes: [])
+
+    init(rate: Double, peakRate: Double, episodeCount: UInt64, storming: Bool, episodes: [Episode]) {
+        self.rate = rate
+        self.peakRate = peakRate
+        self.episodeCount = episodeCount
+        self.storming = storming
+        self.episodes = episodes
+    }
+
+    /// Parses the dictionary returned by `getInterventionStorms(reply:)`. Helper timestamps
+    /// are monotonic, so they are placed relative to its `nowNanos` at reply time.
+    init(dictionary: [String: Any], receivedAt: Date = Date()) {
+        func number(_ raw: [String: Any], _ key: String) -> NSNumber? {
+            raw[key] as? NSNumber
+        }
+        let nowNanos = number(dictionary, "nowNanos")?.uint64Value ?? 0
+        let rawEpisodes = dictionary["episodes"] as? [[String: Any]] ?? []
+        self.init(
+            rate: number(dictionary, "rate")?.doubleValue ?? 0,
+            peakRate: number(dictionary, "peakRate")?.doubleValue ?? 0,
+            episodeCount: number(dictionary, "episodeCount")?.uint64Value ?? 0,
+            storming: number(dictionary, "storming")?.boolValue ?? false,
+            episodes: rawEpisodes.compactMap { raw in
+                guard let sequence = number(raw, "sequence")?.uint64Value,
+                      let startedAt = number(raw, "startedAt")?.uint64Value else {
+                    return nil
+                }
+                let age = TimeInterval(nowNanos >= startedAt ? nowNanos - startedAt : 0) / 1_000_000_000
+                return Episode(
+                    sequence: sequence,
+                    startedAt: receivedAt.addingTimeInterval(-age),
+                    duration: TimeInterval(number(raw, "durationNanos")?.uint64Value ?? 0) / 1_000_000_000,
+                    interventions: number(raw, "interventions")?.uint64Value ?? 0,
+                    peakRate: number(raw, "peakRate")?.doubleValue ?? 0,
+                    active: number(raw, "active")?.boolValue ?? false
+                )
+            }
+        )
+    }
+}
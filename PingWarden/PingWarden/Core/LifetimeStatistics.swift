@@ -0,0 +1,76 @@
+//
+//  LifetimeStatistics.swift
+//  PingWarden
+//
+//  Intervention statistics the helper keeps across restarts and crashes.
+//
+
+import Foundation
+
+struct LifetimeStatistics: Equatable {
+    struct Day: Equatable {
+        /// Midnight UTC at the start of the day.
+        let start: Date
+        let interventions: UInt64
+    }
+
+    /// When the helper started counting; nil if it has no counter file.
+    var since: Date?
+    /// Helper processes since then.
+    var launches: UInt64
+    var interventions: UInt64
+    var lastInterventionAt: Date?
+    /// Busiest 100 ms window ever, interventions per second.
+    var maxBurstRate: Double
+    var maxBurstAt: Date?
+    /// Time the controlled interfaces were seen UP, summed over interfaces.
+    var upTime: TimeInterval
+    /// Newest first; days without interventions are left out.
+    var days: [Day]
+
+    static let empty = LifetimeStatistics(
+        since: nil, launches: 0, interventions: 0, lastInterventionAt: nil,
+        maxBurstRate: 0, maxBurstAt: nil, upTime: 0, days: []
+    )
+
+    init(since: Date?, launches: UInt64, interventions: UInt64, lastInterventionAt: Date?,
+         maxBurstRate: Double, maxBurstAt: Date?, upTime: TimeInterval, days: [Day]) {
+        self.since = since
+        self.launches = launches
+        self.interventions = interventions
+        self.lastInterventionAt = lastInterventionAt
+        self.maxBurstRate = maxBurstRate
+        self.maxBurstAt = maxBurstAt
+        self.upTime = upTime
+        self.days = days
+    }
+
+    /// Parses the dictionary returned by `getLifetimeStatistics(reply:)`.
+    init(dictionary: [String: Any]) {
+        func number(_ raw: [String: Any], _ key: String) -> NSNumber? {
+            raw[key] as? NSNumber
+        }
+        // The helper reports seconds since 1970, 0 for never
+        func date(_ key: String) -> Date? {
+            guard let seconds = number(dictionary, key)?.doubleValue, seconds > 0 else { return nil }
+            return Date(timeIntervalSince1970: seconds)
+        }
+        let rawDays = dictionary["days"] as? [[String: Any]] ?? []
+        self.init(
+            since: date("createdAt"),
+            launches: number(dictionary, "launches")?.uint64Value ?? 0,
+            interventions: number(dictionary, "interventions")?.uint64Value ?? 0,
+            lastInterventionAt: date("lastInterventionAt"),
+            maxBurstRate: number(dictionary, "maxBurstRate")?.doubleValue ?? 0,
+            maxBurstAt: date("maxBurstAt"),
+            upTime: TimeInterval(number(dictionary, "upNanos")?.uint64Value ?? 0) / 1_000_000_000,
+            days: rawDays.compactMap { raw in
+                guard let day = number(raw, "day")?.doubleValue else { return nil }
+                return Day(
+                    start: Date(timeIntervalSince1970: day * 86_400),
+                    interventions: number(raw, "interventions")?.uint64Value ?? 0
+                )
+            }
+        )
+    }
+}
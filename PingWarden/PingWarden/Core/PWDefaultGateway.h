@@ -0,0 +1,299 @@
+//
+//  PWDefaultGateway.h
+//  PingWarden
+//
+//  The IPv4 default gateway read straight from the routing table, and a
+//  socket that reports when it may have changed, instead of spawning
+//  `route -n get default` and parsing its output.
+//
+//  Darwin asks the kernel with one RTM_GET on a PF_ROUTE socket, as route(8)
+//  does; Linux dumps the main table with RTM_GETROUTE and picks the default
+//  route with the lowest metric. For changes, a routing socket (Darwin) or an
+//  rtnetlink socket joined to the IPv4 route and address groups (Linux)
+//  is drained by PWRouteChangeDrain, which counts only messages that can move
+//  the default route, so ARP churn and link flaps do not cause lookups.
+//
+//  Everything is inline so the app can use it through its bridging header;
+//  only the app looks up the gateway.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWDefaultGateway_h
+#define PWDefaultGateway_h
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <net/route.h>
+#elif defined(__linux__)
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The IPv4 default route.
+typedef struct {
+    char address[INET_ADDRSTRLEN];  // numeric gateway, "" if the route points at an interface instead
+    char ifname[IFNAMSIZ];          // outgoing interface, "" if unknown
+} PWDefaultGateway;
+
+#if defined(__APPLE__)
+
+// Sockaddrs in routing messages are padded to 32-bit boundaries
+#define PW_ROUTE_SA_SIZE(length) ((length) > 0 ? (1 + (((length) - 1) | (sizeof(uint32_t) - 1))) : sizeof(uint32_t))
+
+/// Look up the default route. Returns false with errno set: ESRCH means there is none.
+static inline bool PWDefaultGatewayRead(PWDefaultGateway *gateway) {
+    memset(gateway, 0, sizeof(*gateway));
+    int fd = socket(PF_ROUTE, SOCK_RAW, AF_INET);
+    if (fd < 0) {
+        return false;
+    }
+    struct {
+        struct rt_msghdr header;
+        uint8_t addresses[512];
+    } message;
+    memset(&message, 0, sizeof(message));
+    struct sockaddr_in any = { .sin_len = sizeof(struct sockaddr_in), .sin_family = AF_INET };
+    memcpy(message.addresses, &any, sizeof(any));                     // RTA_DST 0.0.0.0
+    memcpy(message.addresses + sizeof(any), &any, sizeof(any));       // RTA_NETMASK 0.0.0.0
+    message.header.rtm_msglen = (unsigned short)(sizeof(message.header) + 2 * sizeof(any));
+    message.header.rtm_version = RTM_VERSION;
+    message.header.rtm_type = RTM_GET;
+    message.header.rtm_flags = RTF_UP | RTF_GATEWAY;
+    message.header.rtm_addrs = RTA_DST | RTA_NETMASK;
+    message.header.rtm_pid = getpid();
+    message.header.rtm_seq = 1;
+
+    if (write(fd, &message, message.header.rtm_msglen) < 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return false;
+    }
+    // The reply is queued before write returns, possibly behind other processes' messages
+    ssize_t length;
+    do {
+        length = read(fd, &message, sizeof(message));
+    } while (length > 0 && (message.header.rtm_pid != getpid() || message.header.rtm_seq != 1 ||
+                            message.header.rtm_type != RTM_GET));
+    int error = errno;
+    close(fd);
+    if (length < (ssize_t)sizeof(message.header) || message.header.rtm_errno != 0) {
+        errno = length < 0 ? error : (message.header.rtm_errno ? message.header.rtm_errno : EIO);
+        return false;
+    }
+
+    const uint8_t *cursor = message.addresses;
+    const uint8_t *end = (const uint8_t *)&message + (length < message.header.rtm_msglen ? length : message.header.rtm_msglen);
+    for (int bit = 0; bit < RTAX_MAX && cursor < end; bit++) {
+        if (!(message.header.rtm_addrs & (1 << bit))) {
+            continue;
+        }
+        const struct sockaddr *sa = (const struct sockaddr *)cursor;
+        if (bit == RTAX_GATEWAY && sa->sa_family == AF_INET && cursor + sizeof(struct sockaddr_in) <= end) {
+            // An AF_LINK gateway ("link#N") means an interface route: no address to ping
+            inet_ntop(AF_INET, &((const struct sockaddr_in *)sa)->sin_addr, gateway->address, sizeof(gateway->address));
+        }
+        cursor += PW_ROUTE_SA_SIZE(sa->sa_len);
+    }
+    if (!if_indextoname(message.header.rtm_index, gateway->ifname)) {
+        gateway->ifname[0] = '\0';
+    }
+    return true;
+}
+
+/// A non-blocking routing socket for PWRouteChangeDrain. Returns -1 on failure; close it when done.
+static inline int PWRouteChangeOpenSocket(void) {
+    int fd = socket(PF_ROUTE, SOCK_RAW, AF_INET);
+    if (fd >= 0 && (fcntl(fd, F_SETFL, O_NONBLOCK) < 0 || fcntl(fd, F_SETFD, FD_CLOEXEC) < 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// Read every queued message and count those that can move the default route: network
+/// routes added, deleted or changed. Host and ARP entries come and go constantly and
+/// are skipped. Returns -1 with errno set if the socket failed.
+static inline int PWRouteChangeDrain(int fd) {
+    uint8_t buffer[2048];
+    int changes = 0;
+    for (;;) {
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK ? changes : -1;
+        }
+        if (length < (ssize_t)sizeof(struct rt_msghdr)) {
+            continue;
+        }
+        const struct rt_msghdr *header = (const struct rt_msghdr *)buffer;
+        bool routeMessage = header->rtm_type == RTM_ADD || header->rtm_type == RTM_DELETE ||
+                            header->rtm_type == RTM_CHANGE;
+        if (routeMessage && !(header->rtm_flags & (RTF_HOST | RTF_LLINFO | RTF_WASCLONED))) {
+            changes++;
+        }
+    }
+}
+
+#elif defined(__linux__)
+
+/// Look up the default route. Returns false with errno set: ESRCH means there is none.
+static inline bool PWDefaultGatewayRead(PWDefaultGateway *gateway) {
+    memset(gateway, 0, sizeof(*gateway));
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        return false;
+    }
+    struct {
+        struct nlmsghdr header;
+        struct rtmsg route;
+    } request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    request.header.nlmsg_type = RTM_GETROUTE;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = 1;
+    request.route.rtm_family = AF_INET;
+    if (send(fd, &request, request.header.nlmsg_len, 0) < 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return false;
+    }
+
+    // Several default routes can coexist; the kernel uses the one with the lowest metric
+    bool found = false;
+    uint32_t bestMetric = UINT32_MAX;
+    uint32_t buffer[8192 / sizeof(uint32_t)];
+    bool done = false;
+    int error = 0;
+    while (!done) {
+        ssize_t length = recv(fd, buffer, sizeof(buffer), 0);
+        if (length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = errno;
+            break;
+        }
+        size_t remaining = (size_t)length;
+        for (const struct nlmsghdr *nlh = (const struct nlmsghdr *)buffer; NLMSG_OK(nlh, remaining);
+             nlh = NLMSG_NEXT(nlh, remaining)) {
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                done = true;
+                break;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                error = -((const struct nlmsgerr *)NLMSG_DATA(nlh))->error;
+                done = true;
+                break;
+            }
+            if (nlh->nlmsg_type != RTM_NEWROUTE) {
+                continue;
+            }
+            const struct rtmsg *route = (const struct rtmsg *)NLMSG_DATA(nlh);
+            if (route->rtm_family != AF_INET || route->rtm_dst_len != 0 || route->rtm_type != RTN_UNICAST) {
+                continue;
+            }
+            uint32_t table = route->rtm_table;
+            uint32_t metric = 0;
+            const void *via = NULL;
+            int oif = 0;
+            int attributesLength = (int)RTM_PAYLOAD(nlh);
+            for (const struct rtattr *rta = RTM_RTA(route); RTA_OK(rta, attributesLength);
+                 rta = RTA_NEXT(rta, attributesLength)) {
+                if (rta->rta_type == RTA_TABLE) {
+                    table = *(const uint32_t *)RTA_DATA(rta);
+                } else if (rta->rta_type == RTA_PRIORITY) {
+                    metric = *(const uint32_t *)RTA_DATA(rta);
+                } else if (rta->rta_type == RTA_GATEWAY) {
+                    via = RTA_DATA(rta);
+                } else if (rta->rta_type == RTA_OIF) {
+                    oif = *(const int *)RTA_DATA(rta);
+                }
+            }
+            if (table != RT_TABLE_MAIN || (found && metric >= bestMetric)) {
+                continue;
+            }
+            found = true;
+            bestMetric = metric;
+            memset(gateway, 0, sizeof(*gateway));
+            if (via) {
+                inet_ntop(AF_INET, via, gateway->address, sizeof(gateway->address));
+            }
+            if (oif <= 0 || !if_indextoname((unsigned int)oif, gateway->ifname)) {
+                gateway->ifname[0] = '\0';
+            }
+        }
+    }
+    close(fd);
+    if (error || !found) {
+        errno = error ? error : ESRCH;
+        return false;
+    }
+    return true;
+}
+
+/// A non-blocking rtnetlink socket for PWRouteChangeDrain. Returns -1 on failure; close it when done.
+static inline int PWRouteChangeOpenSocket(void) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (fd < 0) {
+        return -1;
+    }
+    // Address removal flushes routes through it without an RTM_DELROUTE, so watch addresses too
+    struct sockaddr_nl address = { .nl_family = AF_NETLINK, .nl_groups = RTMGRP_IPV4_ROUTE | RTMGRP_IPV4_IFADDR };
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// Read every queued message and count those that can move the default route: default
+/// routes added or removed, and addresses added or removed. Returns -1 with errno set if
+/// the socket failed; ENOBUFS means messages were lost, so look the gateway up anyway.
+static inline int PWRouteChangeDrain(int fd) {
+    uint32_t buffer[8192 / sizeof(uint32_t)];
+    int changes = 0;
+    for (;;) {
+        ssize_t length = recv(fd, buffer, sizeof(buffer), 0);
+        if (length < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK ? changes : -1;
+        }
+        size_t remaining = (size_t)length;
+        for (const struct nlmsghdr *nlh = (const struct nlmsghdr *)buffer; NLMSG_OK(nlh, remaining);
+             nlh = NLMSG_NEXT(nlh, remaining)) {
+            if (nlh->nlmsg_type == RTM_NEWADDR || nlh->nlmsg_type == RTM_DELADDR) {
+                changes++;
+            } else if ((nlh->nlmsg_type == RTM_NEWROUTE || nlh->nlmsg_type == RTM_DELROUTE) &&
+                       ((const struct rtmsg *)NLMSG_DATA(nlh))->rtm_dst_len == 0) {
+                changes++;
+            }
+        }
+    }
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWDefaultGateway_h */
@@ -0,0 +1,572 @@
+//
+//  PWProbeEngine.c
+//  PingWarden
+//
+//  TCP connect latency probes multiplexed on one thread.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWProbeEngine.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <sys/event.h>
+#elif defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+// Readiness events handled per wait
+#define PW_PROBE_EVENT_BATCH 64
+// Submissions started per pass. Small, because a probe's completion is only seen after
+// the rest of its batch has called connect(), and that delay counts toward its latency.
+#define PW_PROBE_REQUEST_BATCH 4
+// Marks the wakeup in the event list (EVFILT_USER ident / epoll data)
+#define PW_PROBE_WAKEUP_TAG UINT32_MAX
+
+typedef struct {
+    struct sockaddr_storage address;
+    socklen_t length;
+    uint64_t timeoutNanos;
+    uint64_t tag;
+} PWProbeRequest;
+
+/// A probe in flight. Engine thread only.
+typedef struct {
+    int fd;               // -1 while the slot is free
+    uint64_t tag;
+    uint64_t startedAt;
+    uint64_t deadline;
+    uint32_t heapIndex;   // position in the timer heap
+} PWProbeSlot;
+
+struct PWProbeEngine {
+    PWProbeCallback callback;
+    void *context;
+    uint32_t capacity;
+    int pollFd;           // kqueue or epoll
+#if defined(__linux__)
+    int eventFd;
+#endif
+    pthread_t thread;
+    bool threadStarted;
+
+    // Submissions, handed to the engine thread
+    pthread_mutex_t lock;
+    PWProbeRequest *requests;  // ring of capacity entries
+    uint32_t requestHead;
+    uint32_t requestCount;
+    bool stopping;
+    atomic_bool wakePending;
+
+    // Reserved by PWProbeEngineSubmit, released just before the callback
+    atomic_uint inFlight;
+    atomic_uint maxInFlight;
+
+    _Atomic uint64_t submitted;
+    _Atomic uint64_t connected;
+    _Atomic uint64_t refused;
+    _Atomic uint64_t timedOut;
+    _Atomic uint64_t failed;
+    _Atomic uint64_t wakeups;
+
+    // Engine thread only
+    PWProbeSlot *slots;
+    uint32_t *freeSlots;
+    uint32_t freeCount;
+    uint32_t *heap;            // slot indices, earliest deadline first
+    uint32_t heapCount;
+#if defined(__APPLE__)
+    struct kevent *changes;    // registrations of the probes started by one drain
+    int changeCount;
+#endif
+};
+
+uint64_t PWProbeEngineNow(void) {
+#if defined(__APPLE__)
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// MARK: - Timer heap
+
+static bool PWProbeHeapLess(const PWProbeEngine *engine, uint32_t a, uint32_t b) {
+    return engine->slots[engine->heap[a]].deadline < engine->slots[engine->heap[b]].deadline;
+}
+
+static void PWProbeHeapSwap(PWProbeEngine *engine, uint32_t a, uint32_t b) {
+    uint32_t slot = engine->heap[a];
+    engine->heap[a] = engine->heap[b];
+    engine->heap[b] = slot;
+    engine->slots[engine->heap[a]].heapIndex = a;
+    engine->slots[engine->heap[b]].heapIndex = b;
+}
+
+static void PWProbeHeapSiftUp(PWProbeEngine *engine, uint32_t index) {
+    while (index > 0) {
+        uint32_t parent = (index - 1) / 2;
+        if (!PWProbeHeapLess(engine, index, parent)) {
+            break;
+        }
+        PWProbeHeapSwap(engine, index, parent);
+        index = parent;
+    }
+}
+
+static void PWProbeHeapSiftDown(PWProbeEngine *engine, uint32_t index) {
+    for (;;) {
+        uint32_t smallest = index;
+        uint32_t left = 2 * index + 1;
+        uint32_t right = left + 1;
+        if (left < engine->heapCount && PWProbeHeapLess(engine, left, smallest)) {
+            smallest = left;
+        }
+        if (right < engine->heapCount && PWProbeHeapLess(engine, right, smallest)) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            return;
+        }
+        PWProbeHeapSwap(engine, index, smallest);
+        index = smallest;
+    }
+}
+
+static void PWProbeHeapPush(PWProbeEngine *engine, uint32_t slot) {
+    uint32_t index = engine->heapCount++;
+    engine->heap[index] = slot;
+    engine->slots[slot].heapIndex = index;
+    PWProbeHeapSiftUp(engine, index);
+}
+
+/// Remove a probe that finished before its deadline, in O(log n).
+static void PWProbeHeapRemove(PWProbeEngine *engine, uint32_t slot) {
+    uint32_t index = engine->slots[slot].heapIndex;
+    uint32_t last = --engine->heapCount;
+    if (index == last) {
+        return;
+    }
+    PWProbeHeapSwap(engine, index, last);
+    PWProbeHeapSiftDown(engine, index);
+    PWProbeHeapSiftUp(engine, index);
+}
+
+// MARK: - Probes
+
+static void PWProbeReport(PWProbeEngine *engine, uint64_t tag, PWProbeStatus status, int error,
+                          uint64_t startedAt, uint64_t completedAt) {
+    switch (status) {
+        case PWProbeStatusConnected: atomic_fetch_add_explicit(&engine->connected, 1, memory_order_relaxed); break;
+        case PWProbeStatusRefused: atomic_fetch_add_explicit(&engine->refused, 1, memory_order_relaxed); break;
+        case PWProbeStatusTimedOut: atomic_fetch_add_explicit(&engine->timedOut, 1, memory_order_relaxed); break;
+        case PWProbeStatusFailed: atomic_fetch_add_explicit(&engine->failed, 1, memory_order_relaxed); break;
+        case PWProbeStatusCancelled: break;
+    }
+    PWProbeResult result = {
+        .tag = tag,
+        .status = status,
+        .error = error,
+        .startedAt = startedAt,
+        .latencyNanos = completedAt > startedAt ? completedAt - startedAt : 0,
+    };
+    // Release first, so a callback falling back to the next address reuses this probe's capacity.
+    // The probe holds neither a slot nor a ring entry by now.
+    atomic_fetch_sub_explicit(&engine->inFlight, 1, memory_order_release);
+    engine->callback(engine->context, &result);
+}
+
+/// Close a finished probe's socket, free its slot and report it.
+static void PWProbeFinish(PWProbeEngine *engine, uint32_t slot, PWProbeStatus status, int error, uint64_t now) {
+    PWProbeSlot *probe = &engine->slots[slot];
+    PWProbeHeapRemove(engine, slot);
+    if (status == PWProbeStatusConnected) {
+        // Abort instead of a FIN exchange: nothing lingers in TIME_WAIT, however many probes run
+        struct linger linger = { .l_onoff = 1, .l_linger = 0 };
+        setsockopt(probe->fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+    }
+    close(probe->fd);
+    probe->fd = -1;
+    engine->freeSlots[engine->freeCount++] = slot;
+    PWProbeReport(engine, probe->tag, status, error, probe->startedAt, now);
+}
+
+static PWProbeStatus PWProbeStatusForError(int error) {
+    return error == 0 ? PWProbeStatusConnected : error == ECONNREFUSED ? PWProbeStatusRefused : PWProbeStatusFailed;
+}
+
+/// Open a socket and start connecting. Completes the probe at once if connect() does.
+static void PWProbeStart(PWProbeEngine *engine, const PWProbeRequest *request) {
+#if defined(SOCK_NONBLOCK)
+    int fd = socket(request->address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (fd < 0) {
+#else
+    int fd = socket(request->address.ss_family, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0 || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) < 0 || fcntl(fd, F_SETFD, FD_CLOEXEC) < 0) {
+#endif
+        int error = errno;
+        if (fd >= 0) {
+            close(fd);
+        }
+        uint64_t now = PWProbeEngineNow();
+        PWProbeReport(engine, request->tag, PWProbeStatusFailed, error, now, now);
+        return;
+    }
+
+    uint32_t slot = engine->freeSlots[--engine->freeCount];
+    PWProbeSlot *probe = &engine->slots[slot];
+    probe->fd = fd;
+    probe->tag = request->tag;
+    probe->startedAt = PWProbeEngineNow();
+    probe->deadline = probe->startedAt + request->timeoutNanos;
+    PWProbeHeapPush(engine, slot);
+
+    if (connect(fd, (const struct sockaddr *)&request->address, request->length) == 0) {
+        PWProbeFinish(engine, slot, PWProbeStatusConnected, 0, PWProbeEngineNow());
+        return;
+    }
+    if (errno != EINPROGRESS) {
+        int error = errno;
+        PWProbeFinish(engine, slot, PWProbeStatusForError(error), error, PWProbeEngineNow());
+        return;
+    }
+
+    // One-shot write readiness: the handshake finished, one way or the other
+#if defined(__APPLE__)
+    EV_SET(&engine->changes[engine->changeCount++], fd, EVFILT_WRITE, EV_ADD | EV_ONESHOT | EV_RECEIPT, 0, 0,
+           (void *)(uintptr_t)slot);
+#elif defined(__linux__)
+    struct epoll_event event = { .events = EPOLLOUT | EPOLLONESHOT, .data.u32 = slot };
+    if (epoll_ctl(engine->pollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        int error = errno;
+        PWProbeFinish(engine, slot, PWProbeStatusFailed, error, PWProbeEngineNow());
+    }
+#endif
+}
+
+/// The socket became writable: the connect finished. SO_ERROR says how.
+static void PWProbeComplete(PWProbeEngine *engine, uint32_t slot) {
+    uint64_t now = PWProbeEngineNow();
+    PWProbeSlot *probe = &engine->slots[slot];
+    if (probe->fd < 0) {
+        return;
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(probe->fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0) {
+        error = errno;
+    }
+    PWProbeFinish(engine, slot, PWProbeStatusForError(error), error, now);
+}
+
+#if defined(__APPLE__)
+/// Register the write filters of the probes just started. Done at once rather than with
+/// the next wait: a probe may expire first, and then its fd number and slot belong to
+/// someone else by the time the registration would reach the kernel.
+static void PWProbeRegister(PWProbeEngine *engine) {
+    if (engine->changeCount == 0) {
+        return;
+    }
+    // EV_RECEIPT returns one entry per change, carrying its error in data
+    struct kevent receipts[PW_PROBE_REQUEST_BATCH];
+    struct timespec immediately = { 0, 0 };
+    int count = engine->changeCount;
+    engine->changeCount = 0;
+    int n = kevent(engine->pollFd, engine->changes, count, receipts, count, &immediately);
+    if (n < 0) {
+        int error = errno;
+        for (int i = 0; i < count; i++) {
+            PWProbeFinish(engine, (uint32_t)(uintptr_t)engine->changes[i].udata, PWProbeStatusFailed, error,
+                          PWProbeEngineNow());
+        }
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        if ((receipts[i].flags & EV_ERROR) && receipts[i].data != 0) {
+            uint32_t slot = (uint32_t)(uintptr_t)receipts[i].udata;
+            PWProbeFinish(engine, slot, PWProbeStatusFailed, (int)receipts[i].data, PWProbeEngineNow());
+        }
+    }
+}
+#endif
+
+/// Start queued submissions, at most PW_PROBE_REQUEST_BATCH per pass.
+/// Returns true if the engine is stopping.
+static bool PWProbeDrainRequests(PWProbeEngine *engine) {
+    PWProbeRequest batch[PW_PROBE_REQUEST_BATCH];
+    uint32_t count = 0;
+    pthread_mutex_lock(&engine->lock);
+    while (count < PW_PROBE_REQUEST_BATCH && engine->requestCount > 0) {
+        batch[count++] = engine->requests[engine->requestHead];
+        engine->requestHead = (engine->requestHead + 1) % engine->capacity;
+        engine->requestCount--;
+    }
+    bool stopping = engine->stopping;
+    pthread_mutex_unlock(&engine->lock);
+
+    for (uint32_t i = 0; i < count; i++) {
+        PWProbeStart(engine, &batch[i]);
+    }
+#if defined(__APPLE__)
+    PWProbeRegister(engine);
+#endif
+    return stopping;
+}
+
+static void PWProbeExpire(PWProbeEngine *engine) {
+    uint64_t now = PWProbeEngineNow();
+    while (engine->heapCount > 0 && engine->slots[engine->heap[0]].deadline <= now) {
+        PWProbeFinish(engine, engine->heap[0], PWProbeStatusTimedOut, 0, now);
+    }
+}
+
+// MARK: - Loop
+
+static bool PWProbeSignal(PWProbeEngine *engine) {
+    if (atomic_exchange_explicit(&engine->wakePending, true, memory_order_acq_rel)) {
+        return true;
+    }
+#if defined(__APPLE__)
+    struct kevent trigger;
+    EV_SET(&trigger, PW_PROBE_WAKEUP_TAG, EVFILT_USER, 0, NOTE_TRIGGER, 0, NULL);
+    return kevent(engine->pollFd, &trigger, 1, NULL, 0, NULL) == 0;
+#elif defined(__linux__)
+    uint64_t one = 1;
+    return write(engine->eventFd, &one, sizeof(one)) == sizeof(one);
+#endif
+}
+
+/// Nanoseconds until the earliest deadline, or UINT64_MAX with nothing in flight.
+static uint64_t PWProbeWaitNanos(PWProbeEngine *engine, bool immediate) {
+    if (immediate) {
+        return 0;
+    }
+    if (engine->heapCount == 0) {
+        return UINT64_MAX;
+    }
+    uint64_t now = PWProbeEngineNow();
+    uint64_t deadline = engine->slots[engine->heap[0]].deadline;
+    return deadline > now ? deadline - now : 0;
+}
+
+static void *PWProbeEngineRun(void *argument) {
+    PWProbeEngine *engine = argument;
+    bool stopping = false;
+    bool immediate = false;
+    while (!stopping) {
+        uint64_t waitNanos = PWProbeWaitNanos(engine, immediate);
+        uint32_t ready[PW_PROBE_EVENT_BATCH];
+        int count = 0;
+        bool woken = false;
+#if defined(__APPLE__)
+        struct kevent events[PW_PROBE_EVENT_BATCH];
+        struct timespec timeout = { .tv_sec = (time_t)(waitNanos / 1000000000ull),
+                                    .tv_nsec = (long)(waitNanos % 1000000000ull) };
+        int n = kevent(engine->pollFd, NULL, 0, events, PW_PROBE_EVENT_BATCH,
+                       waitNanos == UINT64_MAX ? NULL : &timeout);
+        for (int i = 0; i < n; i++) {
+            if (events[i].filter == EVFILT_USER) {
+                woken = true;
+            } else {
+                ready[count++] = (uint32_t)(uintptr_t)events[i].udata;
+            }
+        }
+#elif defined(__linux__)
+        struct epoll_event events[PW_PROBE_EVENT_BATCH];
+        // epoll counts in milliseconds; round up so a deadline is never checked early
+        int timeoutMillis = waitNanos == UINT64_MAX ? -1 : (int)((waitNanos + 999999) / 1000000);
+        int n = epoll_wait(engine->pollFd, events, PW_PROBE_EVENT_BATCH, timeoutMillis);
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.u32 == PW_PROBE_WAKEUP_TAG) {
+                uint64_t value;
+                ssize_t drained = read(engine->eventFd, &value, sizeof(value));
+                (void)drained;
+                woken = true;
+            } else {
+                ready[count++] = events[i].data.u32;
+            }
+        }
+#endif
+        atomic_fetch_add_explicit(&engine->wakeups, 1, memory_order_relaxed);
+
+        for (int i = 0; i < count; i++) {
+            PWProbeComplete(engine, ready[i]);
+        }
+        if (woken || immediate) {
+            // Clear before draining so a submission racing with the drain signals again
+            atomic_store_explicit(&engine->wakePending, false, memory_order_release);
+            stopping = PWProbeDrainRequests(engine);
+            // More than a batch queued: come straight back instead of waiting
+            pthread_mutex_lock(&engine->lock);
+            immediate = engine->requestCount > 0;
+            pthread_mutex_unlock(&engine->lock);
+        }
+        PWProbeExpire(engine);
+    }
+
+    // Report everything still in flight or queued
+    uint64_t now = PWProbeEngineNow();
+    while (engine->heapCount > 0) {
+        PWProbeFinish(engine, engine->heap[0], PWProbeStatusCancelled, ECANCELED, now);
+    }
+    pthread_mutex_lock(&engine->lock);
+    while (engine->requestCount > 0) {
+        PWProbeRequest request = engine->requests[engine->requestHead];
+        engine->requestHead = (engine->requestHead + 1) % engine->capacity;
+        engine->requestCount--;
+        pthread_mutex_unlock(&engine->lock);
+        PWProbeReport(engine, request.tag, PWProbeStatusCancelled, ECANCELED, now, now);
+        pthread_mutex_lock(&engine->lock);
+    }
+    pthread_mutex_unlock(&engine->lock);
+    return NULL;
+}
+
+// MARK: - Lifecycle
+
+PWProbeEngine *PWProbeEngineCreate(uint32_t capacity, PWProbeCallback callback, void *context) {
+    if (capacity == 0 || !callback) {
+        return NULL;
+    }
+    PWProbeEngine *engine = calloc(1, sizeof(*engine));
+    if (!engine) {
+        return NULL;
+    }
+    engine->callback = callback;
+    engine->context = context;
+    engine->capacity = capacity;
+    engine->pollFd = -1;
+#if defined(__linux__)
+    engine->eventFd = -1;
+#endif
+    pthread_mutex_init(&engine->lock, NULL);
+    engine->requests = calloc(capacity, sizeof(*engine->requests));
+    engine->slots = calloc(capacity, sizeof(*engine->slots));
+    engine->freeSlots = calloc(capacity, sizeof(*engine->freeSlots));
+    engine->heap = calloc(capacity, sizeof(*engine->heap));
+#if defined(__APPLE__)
+    engine->changes = calloc(PW_PROBE_REQUEST_BATCH, sizeof(*engine->changes));
+    bool allocated = engine->changes != NULL;
+#else
+    bool allocated = true;
+#endif
+    if (!allocated || !engine->requests || !engine->slots || !engine->freeSlots || !engine->heap) {
+        PWProbeEngineDestroy(engine);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < capacity; i++) {
+        engine->slots[i].fd = -1;
+        engine->freeSlots[i] = capacity - 1 - i;
+    }
+    engine->freeCount = capacity;
+
+#if defined(__APPLE__)
+    engine->pollFd = kqueue();
+    struct kevent wakeup;
+    EV_SET(&wakeup, PW_PROBE_WAKEUP_TAG, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, NULL);
+    bool ready = engine->pollFd >= 0 && kevent(engine->pollFd, &wakeup, 1, NULL, 0, NULL) == 0;
+#elif defined(__linux__)
+    engine->pollFd = epoll_create1(EPOLL_CLOEXEC);
+    engine->eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    struct epoll_event wakeup = { .events = EPOLLIN, .data.u32 = PW_PROBE_WAKEUP_TAG };
+    bool ready = engine->pollFd >= 0 && engine->eventFd >= 0 &&
+                 epoll_ctl(engine->pollFd, EPOLL_CTL_ADD, engine->eventFd, &wakeup) == 0;
+#endif
+    engine->threadStarted = ready && pthread_create(&engine->thread, NULL, PWProbeEngineRun, engine) == 0;
+    if (!engine->threadStarted) {
+        PWProbeEngineDestroy(engine);
+        return NULL;
+    }
+    return engine;
+}
+
+void PWProbeEngineDestroy(PWProbeEngine *engine) {
+    if (!engine) {
+        return;
+    }
+    if (engine->threadStarted) {
+        pthread_mutex_lock(&engine->lock);
+        engine->stopping = true;
+        pthread_mutex_unlock(&engine->lock);
+        // Force the signal: a pending flag may belong to a wakeup already consumed
+        atomic_store(&engine->wakePending, false);
+        PWProbeSignal(engine);
+        pthread_join(engine->thread, NULL);
+    }
+    if (engine->pollFd >= 0) {
+        close(engine->pollFd);
+    }
+#if defined(__linux__)
+    if (engine->eventFd >= 0) {
+        close(engine->eventFd);
+    }
+#endif
+#if defined(__APPLE__)
+    free(engine->changes);
+#endif
+    pthread_mutex_destroy(&engine->lock);
+    free(engine->requests);
+    free(engine->slots);
+    free(engine->freeSlots);
+    free(engine->heap);
+    free(engine);
+}
+
+bool PWProbeEngineSubmit(PWProbeEngine *engine, const struct sockaddr *address, socklen_t length,
+                         uint64_t timeoutNanos, uint64_t tag) {
+    if (length > sizeof(struct sockaddr_storage) || timeoutNanos == 0) {
+        return false;
+    }
+    // Reserve capacity; the ring has room for every reservation
+    unsigned int inFlight = atomic_load_explicit(&engine->inFlight, memory_order_relaxed);
+    do {
+        if (inFlight >= engine->capacity) {
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&engine->inFlight, &inFlight, inFlight + 1,
+                                                    memory_order_acquire, memory_order_relaxed));
+    unsigned int peak = atomic_load_explicit(&engine->maxInFlight, memory_order_relaxed);
+    while (inFlight + 1 > peak && !atomic_compare_exchange_weak_explicit(&engine->maxInFlight, &peak, inFlight + 1,
+                                                                         memory_order_relaxed, memory_order_relaxed)) {
+    }
+    atomic_fetch_add_explicit(&engine->submitted, 1, memory_order_relaxed);
+
+    pthread_mutex_lock(&engine->lock);
+    PWProbeRequest *request = &engine->requests[(engine->requestHead + engine->requestCount) % engine->capacity];
+    memset(request, 0, sizeof(*request));
+    memcpy(&request->address, address, length);
+    request->length = length;
+    request->timeoutNanos = timeoutNanos;
+    request->tag = tag;
+    engine->requestCount++;
+    pthread_mutex_unlock(&engine->lock);
+    PWProbeSignal(engine);
+    return true;
+}
+
+void PWProbeEngineGetStats(PWProbeEngine *engine, PWProbeEngineStats *stats) {
+    stats->submitted = atomic_load_explicit(&engine->submitted, memory_order_relaxed);
+    stats->connected = atomic_load_explicit(&engine->connected, memory_order_relaxed);
+    stats->refused = atomic_load_explicit(&engine->refused, memory_order_relaxed);
+    stats->timedOut = atomic_load_explicit(&engine->timedOut, memory_order_relaxed);
+    stats->failed = atomic_load_explicit(&engine->failed, memory_order_relaxed);
+    stats->wakeups = atomic_load_explicit(&engine->wakeups, memory_order_relaxed);
+    stats->inFlight = atomic_load_explicit(&engine->inFlight, memory_order_relaxed);
+    stats->maxInFlight = atomic_load_explicit(&engine->maxInFlight, memory_order_relaxed);
+}
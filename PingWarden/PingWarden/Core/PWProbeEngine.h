@@ -0,0 +1,91 @@
+//
+//  PWProbeEngine.h
+//  PingWarden
+//
+//  TCP connect latency probes multiplexed on one thread. Each probe is a
+//  non-blocking connect() whose completion the engine learns from kqueue
+//  (Darwin) or epoll (Linux); deadlines live in a timer heap that sets the
+//  wait timeout, so a thousand probes in flight cost one thread and one
+//  wait per batch of completions instead of a blocked thread each.
+//
+//  Results are delivered through a callback on the engine thread. Keep it
+//  short: hand the result to a queue and return.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWProbeEngine_h
+#define PWProbeEngine_h
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct PWProbeEngine PWProbeEngine;
+
+typedef enum {
+    PWProbeStatusConnected = 0,  // the handshake completed; latencyNanos is the connect time
+    PWProbeStatusRefused,        // the host answered with a reset (ECONNREFUSED)
+    PWProbeStatusTimedOut,       // no answer before the deadline
+    PWProbeStatusFailed,         // socket(), connect() or the handshake failed; see error
+    PWProbeStatusCancelled,      // the engine was destroyed first
+} PWProbeStatus;
+
+typedef struct {
+    uint64_t tag;            // as passed to PWProbeEngineSubmit
+    PWProbeStatus status;
+    int error;               // errno for Refused and Failed, 0 otherwise
+    uint64_t startedAt;      // monotonic nanoseconds just before connect()
+    uint64_t latencyNanos;   // connect() -> completion seen by the engine
+} PWProbeResult;
+
+/// Called on the engine thread once per submitted probe.
+typedef void (*PWProbeCallback)(void *context, const PWProbeResult *result);
+
+/// Engine counters. Thread-safe to read.
+typedef struct {
+    uint64_t submitted;
+    uint64_t connected;
+    uint64_t refused;
+    uint64_t timedOut;
+    uint64_t failed;
+    uint64_t wakeups;        // kevent/epoll_wait returns
+    uint32_t inFlight;       // probes submitted and not yet reported
+    uint32_t maxInFlight;
+} PWProbeEngineStats;
+
+/// Start an engine that keeps at most capacity probes in flight, on its own thread.
+/// Returns NULL on failure.
+PWProbeEngine *PWProbeEngineCreate(uint32_t capacity, PWProbeCallback callback, void *context);
+
+/// Stop the thread, reporting every probe still in flight as cancelled, and free the engine.
+/// Must not be called from the callback.
+void PWProbeEngineDestroy(PWProbeEngine *engine);
+
+/// Queue a connect to address, reported through the callback with tag. Thread-safe and
+/// never blocks: the connect is started on the engine thread. Returns false, reporting
+/// nothing, if capacity probes are already in flight, the address is too long or
+/// timeoutNanos is 0. A probe
+/// stops counting toward capacity before its callback runs, so the callback may submit
+/// a follow-up in its place.
+bool PWProbeEngineSubmit(PWProbeEngine *engine, const struct sockaddr *address, socklen_t length,
+                         uint64_t timeoutNanos, uint64_t tag);
+
+/// Snapshot of the counters.
+void PWProbeEngineGetStats(PWProbeEngine *engine, PWProbeEngineStats *stats);
+
+/// Nanoseconds on the clock PWProbeResult.startedAt uses.
+uint64_t PWProbeEngineNow(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWProbeEngine_h */
@@ -0,0 +1,94 @@
+//
+//  ReactionTimeHistogram.swift
+//  PingWarden
+//
+//  Intervention reaction times reported by the helper.
+//
+
+import Foundation
+
+struct ReactionTimeHistogram: Equatable {
+    struct Bucket: Equatable {
+        var upperBoundNanos: UInt64
+        var count: UInt64
+    }
+
+    struct Stage: Equatable {
+        var count: Int
+        var p50Nanos: UInt64
+        var p99Nanos: UInt64
+        var maxNanos: UInt64
+        /// Every non-empty histogram bucket, in ascending order.
+        var buckets: [Bucket]
+
+        static let empty = Stage(count: 0, p50Nanos: 0, p99Nanos: 0, maxNanos: 0, buckets: [])
+
+        init(count: Int, p50Nanos: UInt64, p99Nanos: UInt64, maxNanos: UInt64, buckets: [Bucket]) {
+            self.count = count
+            self.p50Nanos = p50Nanos
+            self.p99Nanos = p99Nanos
+            self.maxNanos = maxNanos
+            self.buckets = buckets
+        }
+
+        init(dictionary: [String: Any]) {
+            func value(_ key: String) -> UInt64 {
+                (dictionary[key] as? NSNumber)?.uint64Value ?? 0
+            }
+            let rawBuckets = dictionary["buckets"] as? [[NSNumber]] ?? []
+            self.init(
+                count: Int(value("count")),
+                p50Nanos: value("p50"),
+                p99Nanos: value("p99"),
+                maxNanos: value("max"),
+                buckets: rawBuckets.compactMap { pair in
+                    guard pair.count == 2 else { return nil }
+                    return Bucket(upperBoundNanos: pair[0].uint64Value, count: pair[1].uint64Value)
+                }
+            )
+        }
+    }
+
+    /// Routing message received -> decision to intervene.
+    var receiveToDecision: Stage
+    /// Decision -> SIOCSIFFLAGS returned.
+    var decisionToActuation: Stage
+    /// Routing message received -> SIOCSIFFLAGS returned; how long AWDL stayed up.
+    var receiveToActuation: Stage
+
+    static let empty = ReactionTimeHistogram(
+        receiveToDecision: .empty,
+        decisionToActuation: .empty,
+        receiveToActuation: .empty
+    )
+
+    init(receiveToDecision: Stage, decisionToActuation: Stage, receiveToActuation: Stage) {
+        self.receiveToDecision = receiveToDecision
+        self.decisionToActuation = decisionToActuation
+        self.receiveToActuation = receiveToActuation
+    }
+
+    /// Parses the dictionary returned by `getAWDLReactionHistogram(reply:)`.
+    init(dictionary: [String: Any]) {
+        func stage(_ key: String) -> Stage {
+            (dictionary[key] as? [String: Any]).map(Stage.init(dictionary:)) ?? .empty
+        }
+        self.init(
+            receiveToDecision: stage("receiveToDecision"),
+            decisionToActuation: stage("decisionToActuation"),
+            receiveToActuation: stage("receiveToActuation")
+        )
+    }
+
+    /// Human-readable duration, e.g. "850ns", "63.5µs" or "4.20ms".
+    static func formatNanos(_ nanos: UInt64) -> String {
+        switch nanos {
+        case ..<1_000:
+            return "\(nanos)ns"
+        case ..<1_000_000:
+            return String(format: "%.1fµs", Double(nanos) / 1_000)
+        default:
+            return String(format: "%.2fms", Double(nanos) / 1_000_000)
+        }
+    }
+}
@@ -3,20 +3,100 @@
 //  PingWarden
 //
 //  Lightweight TCP connect latency probe used by dashboard and monitoring.
+//  Probes run as non-blocking connects multiplexed on the one thread of a
+//  shared PWProbeEngine (PWProbeEngine.h) rather than a blocked thread each.
 //
 
 import Foundation
 
 enum TCPProbe {
-    static func measureLatency(host: String, port: UInt16, timeoutSeconds: Int = 1) -> Double? {
-        let startTime = Date()
-        guard connect(host: host, port: port, timeoutSeconds: timeoutSeconds) else {
-            return nil
+    /// Time a TCP connect to host:port. completion gets the latency in milliseconds, or nil if
+    /// no address connects within timeoutSeconds. It runs on the probe engine's thread (or the
+    /// caller's, if the probe cannot start), so hand the result on and return.
+    static func measureLatency(
+        host: String,
+        port: UInt16,
+        timeoutSeconds: Int = 1,
+        completion: @escaping (Double?) -> Void
+    ) {
+        ProbeEngine.shared.probe(
+            ProbeEngine.resolve(host: host, port: port),
+            timeoutNanos: timeoutNanos(timeoutSeconds)
+        ) { latencyNanos in
+            completion(latencyNanos.map { Double($0) / 1_000_000.0 })
         }
-        return Date().timeIntervalSince(startTime) * 1000.0
     }
 
-    static func connect(host: String, port: UInt16, timeoutSeconds: Int = 1) -> Bool {
+    /// Time a TCP connect to every endpoint at once. Returns the latencies in milliseconds, nil
+    /// where no address connected within timeoutSeconds, in the order of endpoints.
+    static func measureLatencies(
+        _ endpoints: [(host: String, port: UInt16)],
+        timeoutSeconds: Int = 1
+    ) async -> [Double?] {
+        guard !endpoints.isEmpty else { return [] }
+
+        // getaddrinfo blocks; resolve side by side, no wider than the machine
+        var addresses = [[ProbeEngine.Address]](repeating: [], count: endpoints.count)
+        addresses.withUnsafeMutableBufferPointer { buffer in
+            DispatchQueue.concurrentPerform(iterations: endpoints.count) { index in
+                buffer[index] = ProbeEngine.resolve(host: endpoints[index].host, port: endpoints[index].port)
+            }
+        }
+
+        return await withCheckedContinuation { continuation in
+            let batch = LatencyBatch(count: endpoints.count) { latencies in
+                continuation.resume(returning: latencies)
+            }
+            for (index, candidates) in addresses.enumerated() {
+                ProbeEngine.shared.probe(candidates, timeoutNanos: timeoutNanos(timeoutSeconds)) { latencyNanos in
+                    batch.record(latencyNanos.map { Double($0) / 1_000_000.0 }, at: index)
+                }
+            }
+        }
+    }
+
+    private static func timeoutNanos(_ seconds: Int) -> UInt64 {
+        UInt64(max(seconds, 0)) * 1_000_000_000
+    }
+}
+
+// MARK: - Engine
+
+/// The process-wide PWProbeEngine, and the completions waiting on its results.
+private final class ProbeEngine {
+    static let shared = ProbeEngine()
+
+    /// Probes in flight at once: every dashboard target and resolver plus the monitor's ping,
+    /// with room to spare. The engine uses one thread however many there are.
+    private static let capacity: UInt32 = 256
+
+    struct Address {
+        var storage = sockaddr_storage()
+        var length: socklen_t = 0
+    }
+
+    private struct Pending {
+        var fallbacks: ArraySlice<Address>
+        let timeoutNanos: UInt64
+        let completion: (UInt64?) -> Void
+    }
+
+    private let lock = NSLock()
+    private var engine: OpaquePointer?
+    private var nextTag: UInt64 = 1
+    private var pending: [UInt64: Pending] = [:]
+
+    private init() {
+        // The shared instance is never released, so the engine can hold it unretained
+        let context = Unmanaged.passUnretained(self).toOpaque()
+        engine = PWProbeEngineCreate(Self.capacity, { context, result in
+            guard let context, let result else { return }
+            Unmanaged<ProbeEngine>.fromOpaque(context).takeUnretainedValue().finished(result.pointee)
+        }, context)
+    }
+
+    /// host:port's addresses in getaddrinfo's order; empty if it does not resolve.
+    static func resolve(host: String, port: UInt16) -> [Address] {
         var hints = addrinfo(
             ai_flags: AI_NUMERICSERV,
             ai_family: AF_UNSPEC,
@@ -29,90 +109,110 @@ enum TCPProbe {
         )
 
         var result: UnsafeMutablePointer<addrinfo>?
-        let status = getaddrinfo(host, String(port), &hints, &result)
-
-        guard status == 0 else {
+        guard getaddrinfo(host, String(port), &hints, &result) == 0 else {
             if let result {
                 freeaddrinfo(result)
             }
-            return false
+            return []
         }
-
         defer { freeaddrinfo(result) }
 
+        var addresses: [Address] = []
         var current = result
-        while let addrInfo = current {
-            if connectSingle(addrInfo: addrInfo.pointee, timeoutSeconds: timeoutSeconds) {
-                return true
+        while let info = current?.pointee {
+            if let source = info.ai_addr, Int(info.ai_addrlen) <= MemoryLayout<sockaddr_storage>.size {
+                var address = Address(length: info.ai_addrlen)
+                withUnsafeMutableBytes(of: &address.storage) { bytes in
+                    bytes.baseAddress?.copyMemory(from: source, byteCount: Int(info.ai_addrlen))
+                }
+                addresses.append(address)
             }
-            current = addrInfo.pointee.ai_next
+            current = info.ai_next
         }
-        return false
+        return addresses
     }
 
-    private static func connectSingle(addrInfo: addrinfo, timeoutSeconds: Int) -> Bool {
-        let socketFD = socket(addrInfo.ai_family, addrInfo.ai_socktype, addrInfo.ai_protocol)
-        guard socketFD >= 0 else {
-            return false
+    /// Connect to the first address, falling back to the next while one fails, as connect(2)
+    /// callers walking getaddrinfo do. completion gets the successful connect's latency in
+    /// nanoseconds, or nil.
+    func probe(_ addresses: [Address], timeoutNanos: UInt64, completion: @escaping (UInt64?) -> Void) {
+        guard engine != nil, let first = addresses.first else {
+            completion(nil)
+            return
         }
-        defer { close(socketFD) }
 
-        let currentFlags = fcntl(socketFD, F_GETFL, 0)
-        _ = fcntl(socketFD, F_SETFL, currentFlags | O_NONBLOCK)
+        lock.lock()
+        let tag = nextTag
+        nextTag += 1
+        pending[tag] = Pending(fallbacks: addresses.dropFirst(), timeoutNanos: timeoutNanos, completion: completion)
+        lock.unlock()
 
-        let connectResult = Darwin.connect(socketFD, addrInfo.ai_addr, addrInfo.ai_addrlen)
-        if connectResult == 0 {
-            return true
-        }
-
-        if errno != EINPROGRESS {
-            return false
-        }
-
-        var writeSet = fd_set()
-        fdZero(&writeSet)
-        guard fdSet(socketFD, set: &writeSet) else {
-            return false
+        if !submit(first, timeoutNanos: timeoutNanos, tag: tag) {
+            abandon(tag)
         }
+    }
 
-        var timeout = timeval(tv_sec: timeoutSeconds, tv_usec: 0)
-        let selectResult = select(socketFD + 1, nil, &writeSet, nil, &timeout)
-        guard selectResult > 0 else {
-            return false
+    private func submit(_ address: Address, timeoutNanos: UInt64, tag: UInt64) -> Bool {
+        var storage = address.storage
+        return withUnsafePointer(to: &storage) { pointer in
+            pointer.withMemoryRebound(to: sockaddr.self, capacity: 1) { sockaddrPointer in
+                PWProbeEngineSubmit(engine, sockaddrPointer, address.length, timeoutNanos, tag)
+            }
         }
-
-        var socketError: Int32 = 0
-        var errorLen = socklen_t(MemoryLayout<Int32>.size)
-        getsockopt(socketFD, SOL_SOCKET, SO_ERROR, &socketError, &errorLen)
-        return socketError == 0
     }
 
-    private static func fdZero(_ set: inout fd_set) {
-        set = fd_set()
+    /// The engine is full: report the probe as failed.
+    private func abandon(_ tag: UInt64) {
+        lock.lock()
+        let entry = pending.removeValue(forKey: tag)
+        lock.unlock()
+        entry?.completion(nil)
     }
 
-    private static func fdSet(_ fd: Int32, set: inout fd_set) -> Bool {
-        guard fd >= 0 else {
-            return false
+    /// Engine thread.
+    private func finished(_ result: PWProbeResult) {
+        lock.lock()
+        guard var entry = pending.removeValue(forKey: result.tag) else {
+            lock.unlock()
+            return
+        }
+        if result.status != PWProbeStatusConnected, result.status != PWProbeStatusCancelled,
+           let next = entry.fallbacks.popFirst() {
+            pending[result.tag] = entry
+            lock.unlock()
+            if !submit(next, timeoutNanos: entry.timeoutNanos, tag: result.tag) {
+                abandon(result.tag)
+            }
+            return
         }
+        lock.unlock()
 
-        let bitsPerWord = Int32(MemoryLayout<Int32>.size * 8)
-        let tupleByteCount = MemoryLayout.size(ofValue: set.fds_bits)
-        let wordCount = tupleByteCount / MemoryLayout<Int32>.size
+        entry.completion(result.status == PWProbeStatusConnected ? result.latencyNanos : nil)
+    }
+}
 
-        let intOffset = Int(fd / bitsPerWord)
-        let bitOffset = Int(fd % bitsPerWord)
+/// Gathers one batch's results and hands them over once the last arrives.
+private final class LatencyBatch {
+    private let lock = NSLock()
+    private var latencies: [Double?]
+    private var remaining: Int
+    private let finished: ([Double?]) -> Void
+
+    init(count: Int, finished: @escaping ([Double?]) -> Void) {
+        latencies = Array(repeating: nil, count: count)
+        remaining = count
+        self.finished = finished
+    }
 
-        guard intOffset >= 0, intOffset < wordCount else {
-            return false
-        }
+    func record(_ latency: Double?, at index: Int) {
+        lock.lock()
+        latencies[index] = latency
+        remaining -= 1
+        let complete = remaining == 0
+        lock.unlock()
 
-        withUnsafeMutableBytes(of: &set.fds_bits) { rawPtr in
-            guard let baseAddress = rawPtr.baseAddress else { return }
-            let ptr = baseAddress.assumingMemoryBound(to: Int32.self)
-            let bitMask = Int32(bitPattern: UInt32(1) << UInt32(bitOffset))
-            ptr[intOffset] |= bitMask
+        if complete {
+            finished(latencies)
         }
-        return true
     }
 }
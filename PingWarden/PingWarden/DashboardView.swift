@@ -85,6 +85,7 @@ private enum DashboardConfig {
     static let selectedTargetKey = "DashboardSelectedPingTargetID"
     static let updateIntervalKey = "DashboardUpdateInterval"
     static let historyRetentionSeconds: TimeInterval = 3900
+    static let interventionClusterWindowSeconds: TimeInterval = 2
     static let baselineSampleCount = 3
     static let baselineProbeTimeoutSeconds = 1
     static let baselineSampleSpacingNanoseconds: UInt64 = 100_000_000
@@ -131,50 +132,6 @@ private extension View {
     }
 }
 
-private enum NetworkGatewayResolver {
-    static func defaultGatewayAddress() -> String? {
-        let process = Process()
-        process.executableURL = URL(fileURLWithPath: "/usr/sbin/route")
-        process.arguments = ["-n", "get", "default"]
-        
-        let outputPipe = Pipe()
-        process.standardOutput = outputPipe
-        process.standardError = Pipe()
-        
-        do {
-            try process.run()
-            process.waitUntilExit()
-        } catch {
-            return nil
-        }
-        
-        guard process.terminationStatus == 0 else {
-            return nil
-        }
-        
-        let data = outputPipe.fileHandleForReading.readDataToEndOfFile()
-        guard let output = String(data: data, encoding: .utf8) else {
-            return nil
-        }
-        
-        for rawLine in output.split(whereSeparator: \.isNewline) {
-            let line = rawLine.trimmingCharacters(in: .whitespacesAndNewlines)
-            guard line.hasPrefix("gateway:") else { continue }
-            
-            let gateway = line.replacingOccurrences(of: "gateway:", with: "")
-                .trimmingCharacters(in: .whitespacesAndNewlines)
-            
-            guard !gateway.isEmpty, !gateway.hasPrefix("link#") else {
-                return nil
-            }
-            
-            return gateway
-        }
-        
-        return nil
-    }
-}
-
 private enum GeForceNOWDiscovery {
     private static let endpoint = URL(string: "https://status.geforcenow.com/api/v2/components.json")
     private static let zoneCodePattern = #"\bNP[A]?-[A-Z0-9-]+\b"#
@@ -645,6 +602,14 @@ struct InterventionsCard: View {
                             .font(.caption)
                             .foregroundStyle(.secondary)
                             .fixedSize(horizontal: false, vertical: true)
+
+                        let reaction = viewModel.reactionTimes.receiveToActuation
+                        if reaction.count > 0 {
+                            Text("Blocked in \(ReactionTimeHistogram.formatNanos(reaction.p50Nanos)) typical · \(ReactionTimeHistogram.formatNanos(reaction.p99Nanos)) p99 · \(ReactionTimeHistogram.formatNanos(reaction.maxNanos)) max")
+                                .font(.caption2)
+                                .foregroundStyle(.secondary)
+                                .monospacedDigit()
+                        }
                     } else {
                         Label("No AWDL activation attempts detected", systemImage: "checkmark.shield")
                             .font(.subheadline)
@@ -789,6 +754,7 @@ class DashboardViewModel: ObservableObject {
     @Published var pingHistory: [PingMonitor.PingResult] = []
     @Published private(set) var timelineEvents: [LatencyTimelineEvent] = []
     @Published var interventionCount: Int = 0
+    @Published private(set) var reactionTimes: ReactionTimeHistogram = .empty
     @Published var isAWDLBlocking: Bool = false
     @Published private(set) var baselineLatencyResults: [String: Double] = [:]
     @Published private(set) var isAutoSelectingTarget: Bool = false
@@ -826,14 +792,15 @@ class DashboardViewModel: ObservableObject {
     @Published private(set) var isRefreshingGFNServers: Bool = false
     
     private let pingMonitor = PingMonitor()
-    private var interventionTimer: Timer?
+    private var interventionObserverToken: UUID?
+    private var monitorStateObserverToken: UUID?
+    private var gatewayObserverToken: UUID?
     private var gfnRefreshTask: Task<Void, Never>?
     private var baselineSelectionTask: Task<Void, Never>?
     private var isStarted = false
     private var gfnTargets: [PingTarget] = []
     private var lastGFNRefreshDate: Date = .distantPast
-    private var previousInterventionCount: Int = 0
-    private var hasInitializedInterventionBaseline = false
+    private var interventionCursor: UInt64 = 0
     
     private let userDefaults = UserDefaults.standard
     
@@ -859,8 +826,7 @@ class DashboardViewModel: ObservableObject {
     }
     
     init() {
-        let gateway = NetworkGatewayResolver.defaultGatewayAddress()
-        targets = Self.baseTargets(localGateway: gateway)
+        targets = Self.baseTargets(localGateway: DefaultGateway.shared.address)
         
         if let savedInterval = userDefaults.object(forKey: DashboardConfig.updateIntervalKey) as? Double {
             updateInterval = sanitizedInterval(savedInterval)
@@ -896,22 +862,42 @@ class DashboardViewModel: ObservableObject {
         // Update AWDL status
         updateAWDLStatus()
         
-        // Start intervention counter updates
+        // Seed the intervention timeline, then follow the helper's pushed batches
         updateInterventionCount()
-        interventionTimer = Timer.scheduledTimer(withTimeInterval: 5.0, repeats: true) { [weak self] _ in
+        interventionObserverToken = PingWardenMonitor.shared.addInterventionObserver { [weak self] batch in
+            Task { @MainActor in
+                self?.applyInterventionBatch(batch)
+                self?.updateReactionTimes()
+            }
+        }
+        monitorStateObserverToken = PingWardenMonitor.shared.addStateObserver { [weak self] in
             Task { @MainActor in
-                self?.updateInterventionCount()
                 self?.updateAWDLStatus()
             }
         }
-        
+        // A new network moves the local-gateway target with it
+        gatewayObserverToken = DefaultGateway.shared.addObserver { [weak self] _ in
+            Task { @MainActor in
+                self?.rebuildTargets()
+            }
+        }
     }
     
     func stop() {
         isStarted = false
         pingMonitor.stop()
-        interventionTimer?.invalidate()
-        interventionTimer = nil
+        if let token = interventionObserverToken {
+            PingWardenMonitor.shared.removeInterventionObserver(token)
+            interventionObserverToken = nil
+        }
+        if let token = monitorStateObserverToken {
+            PingWardenMonitor.shared.removeStateObserver(token)
+            monitorStateObserverToken = nil
+        }
+        if let token = gatewayObserverToken {
+            DefaultGateway.shared.removeObserver(token)
+            gatewayObserverToken = nil
+        }
         gfnRefreshTask?.cancel()
         gfnRefreshTask = nil
         baselineSelectionTask?.cancel()
@@ -954,24 +940,33 @@ class DashboardViewModel: ObservableObject {
     }
     
     private func updateInterventionCount() {
-        PingWardenMonitor.shared.getInterventionCount { [weak self] count in
+        PingWardenMonitor.shared.getInterventionEvents(after: interventionCursor) { [weak self] batch in
             Task { @MainActor in
-                guard let self else { return }
+                guard let self, let batch else { return }
+                self.applyInterventionBatch(batch)
+            }
+        }
+        updateReactionTimes()
+    }
 
-                if !self.hasInitializedInterventionBaseline {
-                    self.previousInterventionCount = count
-                    self.interventionCount = count
-                    self.hasInitializedInterventionBaseline = true
-                    return
-                }
+    private func applyInterventionBatch(_ batch: InterventionEventBatch) {
+        // Pushed batches can overlap the seed fetch; keep only what this view has not shown
+        let fresh = batch.continuing(from: interventionCursor)
 
-                if count > self.previousInterventionCount {
-                    let delta = count - self.previousInterventionCount
-                    self.appendTimelineEvent(.init(timestamp: Date(), kind: .awdlIntervention(delta: delta)))
-                }
+        // Exact helper timestamps; one entry per run of closely spaced interventions
+        for cluster in fresh.clusters(within: DashboardConfig.interventionClusterWindowSeconds) {
+            appendTimelineEvent(.init(timestamp: cluster.date, kind: .awdlIntervention(delta: cluster.count)))
+        }
+
+        interventionCursor = fresh.nextCursor
+        interventionCount = fresh.interventionCount
+    }
 
-                self.previousInterventionCount = count
-                self.interventionCount = count
+    private func updateReactionTimes() {
+        PingWardenMonitor.shared.getReactionHistogram { [weak self] histogram in
+            Task { @MainActor in
+                guard let self, let histogram, histogram != self.reactionTimes else { return }
+                self.reactionTimes = histogram
             }
         }
     }
@@ -1037,8 +1032,7 @@ class DashboardViewModel: ObservableObject {
     }
     
     private func rebuildTargets() {
-        let gatewayHost = targets.first(where: { $0.source == .local })?.host ?? NetworkGatewayResolver.defaultGatewayAddress()
-        let baseTargets = Self.baseTargets(localGateway: gatewayHost)
+        let baseTargets = Self.baseTargets(localGateway: DefaultGateway.shared.address)
         let sortedGFNTargets = gfnTargets.sorted { $0.displayName < $1.displayName }
         
         var deduplicatedTargets: [PingTarget] = []
@@ -1185,6 +1179,11 @@ class DashboardViewModel: ObservableObject {
         }
 
         timelineEvents.append(event)
+        // Helper events carry their own timestamps and may predate the newest entry
+        if timelineEvents.count > 1,
+           timelineEvents[timelineEvents.count - 2].timestamp > event.timestamp {
+            timelineEvents.sort { $0.timestamp < $1.timestamp }
+        }
 
         let cutoff = Date().addingTimeInterval(-DashboardConfig.historyRetentionSeconds)
         timelineEvents.removeAll { $0.timestamp < cutoff }
@@ -1227,40 +1226,29 @@ class DashboardViewModel: ObservableObject {
         candidates: [PingTarget],
         sampleCount: Int
     ) async -> [String: [Double]] {
-        await withTaskGroup(of: (String, [Double])?.self) { group in
-            for target in candidates {
-                group.addTask {
-                    var samples: [Double] = []
-                    for sampleIndex in 0..<sampleCount {
-                        if Task.isCancelled {
-                            return nil
-                        }
-
-                        if let latency = TCPProbe.measureLatency(
-                            host: target.host,
-                            port: target.port,
-                            timeoutSeconds: DashboardConfig.baselineProbeTimeoutSeconds
-                        ) {
-                            samples.append(latency)
-                        }
-
-                        if sampleIndex < sampleCount - 1 {
-                            try? await Task.sleep(nanoseconds: DashboardConfig.baselineSampleSpacingNanoseconds)
-                        }
-                    }
+        // Each round probes every candidate at once on the probe engine's single thread
+        let endpoints = candidates.map { (host: $0.host, port: $0.port) }
+        var measurements: [String: [Double]] = [:]
+        for sampleIndex in 0..<sampleCount {
+            if Task.isCancelled {
+                return [:]
+            }
 
-                    guard !samples.isEmpty else { return nil }
-                    return (target.id, samples)
+            let latencies = await TCPProbe.measureLatencies(
+                endpoints,
+                timeoutSeconds: DashboardConfig.baselineProbeTimeoutSeconds
+            )
+            for (target, latency) in zip(candidates, latencies) {
+                if let latency {
+                    measurements[target.id, default: []].append(latency)
                 }
             }
 
-            var measurements: [String: [Double]] = [:]
-            for await result in group {
-                guard let (targetID, samples) = result else { continue }
-                measurements[targetID] = samples
+            if sampleIndex < sampleCount - 1 {
+                try? await Task.sleep(nanoseconds: DashboardConfig.baselineSampleSpacingNanoseconds)
             }
-            return measurements
         }
+        return measurements
     }
 
     nonisolated private static func robustAverage(from values: [Double]) -> Double {
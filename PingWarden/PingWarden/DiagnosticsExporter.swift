@@ -31,13 +31,24 @@ enum DiagnosticsExporter {
         let osVersion = ProcessInfo.processInfo.operatingSystemVersion
         let osString = "\(osVersion.majorVersion).\(osVersion.minorVersion).\(osVersion.patchVersion)"
 
-        var interventionCount = 0
-        let semaphore = DispatchSemaphore(value: 0)
-        monitor.getInterventionCount { count in
-            interventionCount = count
-            semaphore.signal()
+        // One round trip for everything but the trace, instead of a blocking call per statistic
+        let snapshot = monitor.fetchHelperSnapshot(timeout: 2.0)
+        let interventionCount = snapshot?.interventionCount ?? 0
+        let reactionTimes = snapshot?.reactionTimes ?? .empty
+        let eventSource = snapshot?.eventSource ?? .empty
+        let storms = snapshot?.storms ?? .empty
+        let memory = snapshot?.memory ?? .empty
+        let startup = snapshot?.startup ?? .empty
+        let lifetime = snapshot?.lifetime ?? .empty
+        let interfaces = snapshot?.interfaces ?? []
+
+        var trace = EnforcementTrace.empty
+        let traceSemaphore = DispatchSemaphore(value: 0)
+        monitor.getEnforcementTrace { result in
+            trace = result ?? .empty
+            traceSemaphore.signal()
         }
-        _ = semaphore.wait(timeout: .now() + 2.0)
+        _ = traceSemaphore.wait(timeout: .now() + 2.0)
 
         let registrationStatus: String
         switch monitor.registrationStatus {
@@ -53,8 +64,9 @@ enum DiagnosticsExporter {
             registrationStatus = "unknown"
         }
 
-        let health = monitor.performHealthCheck()
-        let awdlStatus = monitor.currentAWDLInterfaceStatus()
+        let health = monitor.performHealthCheck(snapshot: snapshot)
+        // The app's own SIOCGIFFLAGS read; the interfaces section has the helper's
+        let awdlStatus = monitor.currentAWDLInterfaceStatus().description
 
         let selectedTarget = UserDefaults.standard.string(forKey: "DashboardSelectedPingTargetID") ?? "unknown"
         let updateInterval = UserDefaults.standard.double(forKey: "DashboardUpdateInterval")
@@ -79,20 +91,71 @@ enum DiagnosticsExporter {
           game_mode_auto_detect=\(PingWardenPreferences.shared.gameModeAutoDetect)
           control_center_widget=\(PingWardenPreferences.shared.controlCenterWidgetEnabled)
           show_dock_icon=\(PingWardenPreferences.shared.showDockIcon)
+          lock_enforcement_memory=\(PingWardenPreferences.shared.lockEnforcementMemory)
+          block_llw0=\(PingWardenPreferences.shared.blockLowLatencyWLAN)
           last_known_awdl_state=\(PingWardenPreferences.shared.lastKnownState)
 
         runtime:
           helper_registered=\(monitor.isHelperRegistered)
           registration_status=\(registrationStatus)
           monitor_active=\(monitor.isMonitoringActive)
+          helper_version=\(snapshot?.version ?? "unavailable")
           intervention_count=\(interventionCount)
           awdl_interface=\(awdlStatus)
           health_ok=\(health.isHealthy)
           health_message=\(health.message)
 
+        reaction_times:
+        \(reactionTimeLines(reactionTimes))
+
+        event_source:
+          receive_buffer_bytes=\(eventSource.receiveBufferBytes)
+          overflows=\(eventSource.overflows)
+          resyncs=\(eventSource.resyncs)
+          resync_interventions=\(eventSource.resyncInterventions)
+
+        storms:
+          rate_per_second=\(String(format: "%.2f", storms.rate))
+          peak_rate_per_second=\(String(format: "%.0f", storms.peakRate))
+          episodes=\(storms.episodeCount)
+          storming=\(storms.storming)
+        \(stormEpisodeLines(storms.episodes, formatter: formatter))
+
+        startup:
+          restored_state=\(startup.restoredState)
+          state_file_available=\(startup.stateFileAvailable)
+          process_start_to_first_enforcement_ms=\(String(format: "%.2f", Double(startup.processStartToFirstEnforcementNanos) / 1_000_000))
+          uptime_s=\(startup.uptimeNanos / 1_000_000_000)
+
+        lifetime:
+          since=\(lifetime.since.map { formatter.string(from: $0) } ?? "unknown")
+          launches=\(lifetime.launches)
+          interventions=\(lifetime.interventions)
+          last_intervention=\(lifetime.lastInterventionAt.map { formatter.string(from: $0) } ?? "never")
+          max_burst_per_second=\(String(format: "%.0f", lifetime.maxBurstRate))
+          max_burst_at=\(lifetime.maxBurstAt.map { formatter.string(from: $0) } ?? "never")
+          interfaces_up_s=\(Int(lifetime.upTime))
+        \(lifetimeDayLines(lifetime.days))
+
+        memory:
+          locked=\(memory.locked)
+          locked_bytes=\(memory.lockedBytes)
+          prefaulted_bytes=\(memory.prefaultedBytes)
+          faults_available=\(memory.faultsAvailable)
+          faults_scope=\(memory.faultsPerThread ? "thread" : "process")
+          minor_faults=\(memory.minorFaults)
+          major_faults=\(memory.majorFaults)
+
+        interfaces:
+        \(interfaceLines(interfaces))
+
         dashboard:
           selected_target=\(selectedTarget)
           update_interval=\(updateIntervalValue)
+
+        trace:
+          now_ns=\(trace.nowNanos)
+        \(traceLines(trace.records))
         """
 
         let desktop = FileManager.default.urls(for: .desktopDirectory, in: .userDomainMask).first
@@ -107,4 +170,42 @@ enum DiagnosticsExporter {
             return nil
         }
     }
+
+    private static func stormEpisodeLines(_ episodes: [InterventionStorms.Episode], formatter: ISO8601DateFormatter) -> String {
+        guard !episodes.isEmpty else { return "  recent=none" }
+        return episodes.map { episode in
+            "  episode_\(episode.sequence)=started:\(formatter.string(from: episode.startedAt)) duration_ms:\(Int(episode.duration * 1000)) interventions:\(episode.interventions) peak_per_second:\(String(format: "%.0f", episode.peakRate)) active:\(episode.active)"
+        }.joined(separator: "\n")
+    }
+
+    private static func lifetimeDayLines(_ days: [LifetimeStatistics.Day]) -> String {
+        guard !days.isEmpty else { return "  days=none" }
+        let dayFormatter = ISO8601DateFormatter()
+        dayFormatter.formatOptions = [.withFullDate]
+        return days.map { "  day_\(dayFormatter.string(from: $0.start))=\($0.interventions)" }.joined(separator: "\n")
+    }
+
+    private static func traceLines(_ records: [EnforcementTraceRecord]) -> String {
+        guard !records.isEmpty else { return "  records=none" }
+        return records.map { "  \($0.description)" }.joined(separator: "\n")
+    }
+
+    private static func interfaceLines(_ table: [HelperSnapshot.Interface]) -> String {
+        guard !table.isEmpty else { return "  unavailable" }
+        return table.map { interface in
+            let entry = interface.policy
+            return "  \(entry.name): allowed=\(entry.allowed) ifindex=\(entry.ifindex) interventions=\(entry.interventions) resync_interventions=\(entry.resyncInterventions) \(interface.statusDescription)"
+        }.joined(separator: "\n")
+    }
+
+    private static func reactionTimeLines(_ histogram: ReactionTimeHistogram) -> String {
+        let stages: [(String, ReactionTimeHistogram.Stage)] = [
+            ("receive_to_decision", histogram.receiveToDecision),
+            ("decision_to_actuation", histogram.decisionToActuation),
+            ("receive_to_actuation", histogram.receiveToActuation)
+        ]
+        return stages.map { name, stage in
+            "  \(name)=count:\(stage.count) p50_ns:\(stage.p50Nanos) p99_ns:\(stage.p99Nanos) max_ns:\(stage.maxNanos)"
+        }.joined(separator: "\n")
+    }
 }
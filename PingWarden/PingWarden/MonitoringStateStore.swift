@@ -16,7 +16,7 @@ final class MonitoringStateStore: ObservableObject {
     private var monitoringIntentObserver: NSObjectProtocol?
     private var monitoringEffectiveObserver: NSObjectProtocol?
     private var monitorStateObserverToken: UUID?
-    private var interventionTimer: Timer?
+    private var interventionObserverToken: UUID?
     private var isObserving = false
 
     func startObserving() {
@@ -49,9 +49,10 @@ final class MonitoringStateStore: ObservableObject {
             }
         }
 
-        interventionTimer = Timer.scheduledTimer(withTimeInterval: 5.0, repeats: true) { [weak self] _ in
+        interventionObserverToken = PingWardenMonitor.shared.addInterventionObserver { [weak self] batch in
             Task { @MainActor in
-                self?.refreshInterventionCount()
+                guard let self, self.isMonitoring else { return }
+                self.interventionCount = batch.interventionCount
             }
         }
 
@@ -78,8 +79,10 @@ final class MonitoringStateStore: ObservableObject {
             monitorStateObserverToken = nil
         }
 
-        interventionTimer?.invalidate()
-        interventionTimer = nil
+        if let token = interventionObserverToken {
+            PingWardenMonitor.shared.removeInterventionObserver(token)
+            interventionObserverToken = nil
+        }
     }
 
     func refresh() {
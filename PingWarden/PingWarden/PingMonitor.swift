@@ -65,6 +65,8 @@ class PingMonitor {
     private let statsWindowSeconds: TimeInterval = 120
     private let historyRetentionSeconds: TimeInterval = 3900 // Keep slightly over one hour
     private let connectionTimeoutSeconds: Int = 1
+    // One ping at a time, so history stays in timestamp order. Only touched on queue.
+    private var pingInFlight = false
     
     /// Current server to ping
     var server: String = "8.8.8.8"
@@ -179,40 +181,56 @@ class PingMonitor {
     private func performPing() {
         queue.async { [weak self] in
             guard let self = self else { return }
+            // The probe no longer blocks queue; skip this tick rather than let a slow ping
+            // land after a newer one
+            guard !self.pingInFlight else {
+                log.debug("Previous ping to \(self.server) still in flight, skipping")
+                return
+            }
+            self.pingInFlight = true
 
             let timestamp = Date()
-            let measuredLatencyMs = TCPProbe.measureLatency(
+            TCPProbe.measureLatency(
                 host: self.server,
                 port: self.port,
                 timeoutSeconds: self.connectionTimeoutSeconds
-            )
-            let success = measuredLatencyMs != nil
-            let latency = success ? (measuredLatencyMs ?? 0) / 1000.0 : TimeInterval(self.connectionTimeoutSeconds)
-            let configuredInterval = self.interval
-
-            let result = PingResult(
-                latency: latency,
-                timestamp: timestamp,
-                success: success
-            )
-            
-            // Store in history
-            self.addToHistory(result, interval: configuredInterval)
-            
-            // Notify callbacks on main thread
-            DispatchQueue.main.async {
-                self.onPingResult?(result)
-                self.onStatsUpdate?(self.getStatistics())
-            }
-            
-            if success {
-                log.debug("Ping to \(self.server): \(String(format: "%.1f", result.latencyMs))ms")
-            } else {
-                log.warning("Ping to \(self.server) failed")
+            ) { [weak self] measuredLatencyMs in
+                // Off the probe engine's thread before touching history
+                self?.queue.async {
+                    self?.pingInFlight = false
+                    self?.recordPing(measuredLatencyMs: measuredLatencyMs, timestamp: timestamp)
+                }
             }
         }
     }
 
+    private func recordPing(measuredLatencyMs: Double?, timestamp: Date) {
+        let success = measuredLatencyMs != nil
+        let latency = success ? (measuredLatencyMs ?? 0) / 1000.0 : TimeInterval(connectionTimeoutSeconds)
+        let configuredInterval = interval
+
+        let result = PingResult(
+            latency: latency,
+            timestamp: timestamp,
+            success: success
+        )
+        
+        // Store in history
+        addToHistory(result, interval: configuredInterval)
+        
+        // Notify callbacks on main thread
+        DispatchQueue.main.async {
+            self.onPingResult?(result)
+            self.onStatsUpdate?(self.getStatistics())
+        }
+        
+        if success {
+            log.debug("Ping to \(self.server): \(String(format: "%.1f", result.latencyMs))ms")
+        } else {
+            log.warning("Ping to \(self.server) failed")
+        }
+    }
+
     private static func mapQuality(_ quality: PingQuality) -> Quality {
         switch quality {
         case .excellent: return .excellent
@@ -9,3 +9,7 @@
 //
 
 #import "../Common/HelperProtocol.h"
+#import "../PingWardenHelper/Core/PWStatusPage.h"
+#import "../PingWardenHelper/Core/PWInterfaceFlags.h"
+#import "Core/PWDefaultGateway.h"
+#import "Core/PWProbeEngine.h"
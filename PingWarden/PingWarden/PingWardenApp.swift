@@ -76,7 +76,8 @@ class AppDelegate: NSObject, NSApplicationDelegate, NSWindowDelegate, NSMenuDele
     private var quickPauseUntil: Date?
     private var lastToggleTime: Date = .distantPast
     private var menuMetricsPingMonitor: PingMonitor?
-    private var menuMetricsTimer: Timer?
+    private var menuMetricsInterventionToken: UUID?
+    private var menuMetricsTargetObserver: NSObjectProtocol?
     private var menuCurrentPingMs: Double?
     private var menuInterventionCount: Int?
 
@@ -224,10 +225,7 @@ class AppDelegate: NSObject, NSApplicationDelegate, NSWindowDelegate, NSMenuDele
             NotificationCenter.default.removeObserver(observer)
         }
 
-        menuMetricsTimer?.invalidate()
-        menuMetricsTimer = nil
-        menuMetricsPingMonitor?.stop()
-        menuMetricsPingMonitor = nil
+        stopMenuMetricsMonitoring()
     }
 
     private func updateDockIconVisibility() {
@@ -871,20 +869,36 @@ class AppDelegate: NSObject, NSApplicationDelegate, NSWindowDelegate, NSMenuDele
 
         refreshMenuInterventionCount()
 
-        if menuMetricsTimer == nil {
-            menuMetricsTimer = Timer.scheduledTimer(withTimeInterval: 5.0, repeats: true) { [weak self] _ in
-                self?.syncMenuMetricsTargetIfNeeded()
-                self?.refreshMenuInterventionCount()
+        // The helper pushes intervention batches; no need to poll the count
+        if menuMetricsInterventionToken == nil {
+            menuMetricsInterventionToken = PingWardenMonitor.shared.addInterventionObserver { [weak self] batch in
+                guard let self, PingWardenPreferences.shared.showMenuDropdownMetrics else { return }
+                self.menuInterventionCount = batch.interventionCount
+                self.updateMenuMetricsMenuItems()
             }
-            if let menuMetricsTimer {
-                RunLoop.main.add(menuMetricsTimer, forMode: .common)
+        }
+
+        // Follow the dashboard's target selection as it changes
+        if menuMetricsTargetObserver == nil {
+            menuMetricsTargetObserver = NotificationCenter.default.addObserver(
+                forName: UserDefaults.didChangeNotification,
+                object: UserDefaults.standard,
+                queue: .main
+            ) { [weak self] _ in
+                self?.syncMenuMetricsTargetIfNeeded()
             }
         }
     }
 
     private func stopMenuMetricsMonitoring() {
-        menuMetricsTimer?.invalidate()
-        menuMetricsTimer = nil
+        if let token = menuMetricsInterventionToken {
+            PingWardenMonitor.shared.removeInterventionObserver(token)
+            menuMetricsInterventionToken = nil
+        }
+        if let observer = menuMetricsTargetObserver {
+            NotificationCenter.default.removeObserver(observer)
+            menuMetricsTargetObserver = nil
+        }
         menuMetricsPingMonitor?.stop()
         menuMetricsPingMonitor = nil
         menuCurrentPingMs = nil
@@ -1574,9 +1588,47 @@ struct AdvancedSettingsContent: View {
     @State private var testResults = ""
     @State private var showingDiagnosticsExportResult = false
     @State private var diagnosticsExportMessage = ""
+    @State private var realtimeEnforcement = PingWardenPreferences.shared.realtimeEnforcement
+    @State private var lockEnforcementMemory = PingWardenPreferences.shared.lockEnforcementMemory
+    @State private var blockLowLatencyWLAN = PingWardenPreferences.shared.blockLowLatencyWLAN
 
     var body: some View {
         VStack(alignment: .leading, spacing: 0) {
+            SettingsSectionHeader(title: "PERFORMANCE")
+
+            SettingsGroup {
+                SettingsRow("Realtime Enforcement", description: "Keep AWDL down promptly even when games use every core") {
+                    Toggle("", isOn: $realtimeEnforcement)
+                        .toggleStyle(.switch)
+                        .controlSize(.small)
+                        .onChangeCompat(of: realtimeEnforcement) { newValue in
+                            PingWardenPreferences.shared.realtimeEnforcement = newValue
+                        }
+                }
+
+                SettingsDivider()
+
+                SettingsRow("Lock Enforcement Memory", description: "Keep the helper's enforcement loop in RAM during long sessions") {
+                    Toggle("", isOn: $lockEnforcementMemory)
+                        .toggleStyle(.switch)
+                        .controlSize(.small)
+                        .onChangeCompat(of: lockEnforcementMemory) { newValue in
+                            PingWardenPreferences.shared.lockEnforcementMemory = newValue
+                        }
+                }
+
+                SettingsDivider()
+
+                SettingsRow("Block llw0 Too", description: "Also keep the low-latency WLAN interface down while monitoring") {
+                    Toggle("", isOn: $blockLowLatencyWLAN)
+                        .toggleStyle(.switch)
+                        .controlSize(.small)
+                        .onChangeCompat(of: blockLowLatencyWLAN) { newValue in
+                            PingWardenPreferences.shared.blockLowLatencyWLAN = newValue
+                        }
+                }
+            }
+
             SettingsSectionHeader(title: "DIAGNOSTICS")
 
             SettingsGroup {
@@ -117,6 +117,15 @@ class PingWardenMonitor {
     /// Multi-observer state callbacks.
     private var stateObservers: [UUID: () -> Void] = [:]
 
+    /// Observers of interventions pushed by the helper.
+    private var interventionObservers: [UUID: (InterventionEventBatch) -> Void] = [:]
+
+    /// Sequence of the last pushed intervention, so a reconnect resumes where it left off.
+    private var pushedInterventionCursor: UInt64 = 0
+
+    /// Exported on the XPC connection to receive pushed updates.
+    private lazy var updateReceiver = HelperUpdateReceiver(monitor: self)
+
     /// Timer for polling registration status
     private var registrationTimer: Timer?
 
@@ -133,6 +142,28 @@ class PingWardenMonitor {
         log.info("  XPC service name: \(self.xpcServiceName)")
         log.info("  Helper plist: \(self.helperPlistName)")
 
+        NotificationCenter.default.addObserver(
+            forName: .realtimeEnforcementChanged,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            self?.applyRealtimeEnforcement()
+        }
+        NotificationCenter.default.addObserver(
+            forName: .enforcementMemoryLockChanged,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            self?.applyMemoryLocking()
+        }
+        NotificationCenter.default.addObserver(
+            forName: .interfacePolicyChanged,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            self?.applyInterfacePolicy()
+        }
+
         // If helper is already registered, connect to it
         if status == .enabled {
             log.info("  Helper already enabled, connecting XPC...")
@@ -190,6 +221,24 @@ class PingWardenMonitor {
         stateLock.unlock()
     }
 
+    /// Register for interventions pushed by the helper. Batches are delivered on the main
+    /// queue, at most `helperUpdateMaxFlushesPerSecond` times per second.
+    @discardableResult
+    func addInterventionObserver(_ observer: @escaping (InterventionEventBatch) -> Void) -> UUID {
+        let token = UUID()
+        stateLock.lock()
+        interventionObservers[token] = observer
+        stateLock.unlock()
+        return token
+    }
+
+    /// Remove a previously registered intervention observer.
+    func removeInterventionObserver(_ token: UUID) {
+        stateLock.lock()
+        interventionObservers.removeValue(forKey: token)
+        stateLock.unlock()
+    }
+
     /// Validate that the helper binary and plist exist in the app bundle
     private func validateHelperBundle() -> (valid: Bool, error: String?) {
         let appBundle = Bundle.main.bundlePath
@@ -366,6 +415,7 @@ class PingWardenMonitor {
                     PingWardenPreferences.shared.effectiveMonitoringEnabled = true
                     PingWardenPreferences.shared.lastKnownState = "down"
                     self.notifyStateChange()
+                    self.applyInterfacePolicy()
                     log.info("✅ AWDL monitoring started")
                 } else {
                     log.error("❌ Failed to disable AWDL")
@@ -411,6 +461,7 @@ class PingWardenMonitor {
                     PingWardenPreferences.shared.effectiveMonitoringEnabled = false
                     PingWardenPreferences.shared.lastKnownState = "up"
                     self.notifyStateChange()
+                    self.applyInterfacePolicy()
                     log.info("✅ AWDL monitoring stopped - AirDrop/Handoff available")
                 } else {
                     log.error("❌ Failed to enable AWDL")
@@ -421,6 +472,12 @@ class PingWardenMonitor {
 
     /// Perform a health check on the helper
     func performHealthCheck() -> (isHealthy: Bool, message: String) {
+        performHealthCheck(snapshot: nil)
+    }
+
+    /// Perform a health check on the helper, reusing a snapshot the caller already fetched.
+    /// Without one, blocks for at most a single bounded round trip.
+    func performHealthCheck(snapshot prefetched: HelperSnapshot?) -> (isHealthy: Bool, message: String) {
         log.info("Performing health check...")
 
         // Check 1: Is helper registered?
@@ -434,63 +491,76 @@ class PingWardenMonitor {
             connectXPC()
         }
 
-        guard let proxy = getHelperProxy() else {
+        guard getHelperProxy() != nil else {
             log.info("Health check: Cannot connect to helper")
             return (false, "Cannot connect to helper via XPC")
         }
 
-        // Check 3: Query helper status with proper timeout handling
-        var helperStatus = "Unknown"
-        var helperVersion = "Unknown"
-        var statusTimedOut = false
-        var versionTimedOut = false
-        let statusSemaphore = DispatchSemaphore(value: 0)
-        let versionSemaphore = DispatchSemaphore(value: 0)
-
-        proxy.getAWDLStatus(reply: { status in
-            helperStatus = status
-            statusSemaphore.signal()
-        })
-        if statusSemaphore.wait(timeout: .now() + 2.0) == .timedOut {
-            log.warning("Health check: getAWDLStatus timed out")
-            statusTimedOut = true
-        }
-
-        proxy.getVersion(reply: { version in
-            helperVersion = version
-            versionSemaphore.signal()
-        })
-        if versionSemaphore.wait(timeout: .now() + 2.0) == .timedOut {
-            log.warning("Health check: getVersion timed out")
-            versionTimedOut = true
-        }
-
-        // If both timed out, helper is not responding
-        if statusTimedOut && versionTimedOut {
+        // Check 3: Version, desired state and the interface flags in one round trip
+        guard let snapshot = prefetched ?? fetchHelperSnapshot(timeout: 2.0) else {
+            log.warning("Health check: getHelperSnapshot timed out")
             return (false, "Helper not responding to XPC calls (timed out)")
         }
 
-        // Check 4: Check actual AWDL interface status
-        let awdlStatus = getAWDLInterfaceStatus()
-        log.debug("AWDL interface status: \(awdlStatus)")
-
-        // Parse AWDL status - check for DOWN flag or absence of UP in flags section
-        let isAWDLDown = awdlStatus.contains("<DOWN") ||
-                         (awdlStatus.contains("flags=") && !awdlStatus.contains("<UP"))
-
-        if isMonitoring && !isAWDLDown {
+        // Check 4: The helper's own SIOCGIFFLAGS read of AWDL; an absent interface is not UP
+        log.debug("AWDL interface status: \(snapshot.awdl?.statusDescription ?? "absent")")
+        if isMonitoring && snapshot.awdl?.isUp == true {
             log.warning("Health check: AWDL is UP despite monitoring being active")
             return (false, "Monitoring active but AWDL is UP - helper may not be functioning")
         }
 
-        let message = "Helper healthy: v\(helperVersion), Status: \(helperStatus)"
+        let message = "Helper healthy: v\(snapshot.version), Status: \(snapshot.statusDescription)"
         log.info("Health check: \(message)")
         return (true, message)
     }
+
+    /// Get everything the helper reports in one round trip
+    func getHelperSnapshot(completion: @escaping (HelperSnapshot?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get helper snapshot: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getHelperSnapshot(reply: { snapshot in
+            let parsed = HelperSnapshot(dictionary: snapshot)
+            DispatchQueue.main.async {
+                completion(parsed)
+            }
+        })
+    }
+
+    /// Fetch the helper snapshot synchronously, waiting at most timeout seconds. The reply is
+    /// taken on the XPC queue, so this may be called from the main thread.
+    func fetchHelperSnapshot(timeout: TimeInterval) -> HelperSnapshot? {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get helper snapshot: No helper proxy")
+            return nil
+        }
+
+        var result: HelperSnapshot?
+        let semaphore = DispatchSemaphore(value: 0)
+        proxy.getHelperSnapshot(reply: { snapshot in
+            result = HelperSnapshot(dictionary: snapshot)
+            semaphore.signal()
+        })
+        guard semaphore.wait(timeout: .now() + timeout) == .success else {
+            return nil
+        }
+        return result
+    }
     
     /// Get the AWDL intervention count from the helper
     /// Returns the number of times AWDL was blocked from coming up
     func getInterventionCount(completion: @escaping (Int) -> Void) {
+        // The status page answers without a round trip or waking the helper
+        if let status = HelperStatusPage.shared.read(), status.isRunning {
+            DispatchQueue.main.async {
+                completion(Int(status.interventions))
+            }
+            return
+        }
+
         guard let proxy = getHelperProxy() else {
             log.warning("Cannot get intervention count: No helper proxy")
             completion(0)
@@ -504,9 +574,175 @@ class PingWardenMonitor {
         })
     }
 
-    /// Current awdl0 interface flags/status for diagnostics.
-    func currentAWDLInterfaceStatus() -> String {
-        getAWDLInterfaceStatus()
+    /// Get intervention reaction-time histograms from the helper
+    /// (routing message received -> decision -> SIOCSIFFLAGS returned)
+    func getReactionHistogram(completion: @escaping (ReactionTimeHistogram?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get reaction histogram: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getAWDLReactionHistogram(reply: { histogram in
+            let parsed = ReactionTimeHistogram(dictionary: histogram)
+            DispatchQueue.main.async {
+                completion(parsed)
+            }
+        })
+    }
+
+    /// Get the helper's routing socket overflow and resync counters
+    func getEventSourceCounters(completion: @escaping (EventSourceCounters?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get event source counters: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getEventSourceCounters(reply: { counters in
+            let parsed = EventSourceCounters(dictionary: counters)
+            DispatchQueue.main.async {
+                completion(parsed)
+            }
+        })
+    }
+
+    /// Get the helper's intervention rate and recent storm episodes
+    func getInterventionStorms(completion: @escaping (InterventionStorms?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get intervention storms: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getInterventionStorms(reply: { storms in
+            let parsed = InterventionStorms(dictionary: storms)
+            DispatchQueue.main.async {
+                completion(parsed)
+            }
+        })
+    }
+
+    /// Get the helper's enforcement loop memory residency and page faults
+    func getEnforcementMemoryStats(completion: @escaping (EnforcementMemoryStats?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get enforcement memory stats: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getEnforcementMemoryStats(reply: { stats in
+            let parsed = EnforcementMemoryStats(dictionary: stats)
+            DispatchQueue.main.async {
+                completion(parsed)
+            }
+        })
+    }
+
+    /// Get how quickly the helper enforced its persisted state after launch
+    func getStartupStatistics(completion: @escaping (HelperStartupStatistics?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get helper startup statistics: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getStartupStatistics(reply: { stats in
+            let parsed = HelperStartupStatistics(dictionary: stats)
+            DispatchQueue.main.async {
+                completion(parsed)
+            }
+        })
+    }
+
+    /// Get the intervention statistics the helper keeps across restarts and crashes
+    func getLifetimeStatistics(completion: @escaping (LifetimeStatistics?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get lifetime statistics: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getLifetimeStatistics(reply: { stats in
+            let parsed = LifetimeStatistics(dictionary: stats)
+            DispatchQueue.main.async {
+                completion(parsed)
+            }
+        })
+    }
+
+    /// Get the helper's per-interface policy table and counters
+    func getInterfacePolicy(completion: @escaping ([InterfacePolicyEntry]?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get interface policy: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getInterfacePolicy(reply: { table in
+            let parsed = InterfacePolicyEntry.table(from: table)
+            DispatchQueue.main.async {
+                completion(parsed)
+            }
+        })
+    }
+
+    /// Allow (true) or block (false) the named interfaces in one atomic helper update
+    func setInterfacePolicy(_ policy: [String: Bool], completion: ((Bool) -> Void)? = nil) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot set interface policy: No helper proxy")
+            completion?(false)
+            return
+        }
+
+        proxy.setInterfacePolicy(policy.mapValues { NSNumber(value: $0) }, reply: { success in
+            DispatchQueue.main.async {
+                completion?(success)
+            }
+        })
+    }
+
+    /// Get interventions recorded after `cursor` (0 for everything the helper retains)
+    func getInterventionEvents(after cursor: UInt64, completion: @escaping (InterventionEventBatch?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get intervention events: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getAWDLInterventionEvents(after: cursor, reply: { events, latestSequence, nowNanos, count in
+            let batch = InterventionEventBatch(
+                rawEvents: events,
+                cursor: cursor,
+                latestSequence: latestSequence,
+                nowNanos: nowNanos,
+                interventionCount: Int(count)
+            )
+            DispatchQueue.main.async {
+                completion(batch)
+            }
+        })
+    }
+
+    /// Get the helper enforcement loop's trace records after `cursor` (0 for everything retained)
+    func getEnforcementTrace(after cursor: UInt64 = 0, completion: @escaping (EnforcementTrace?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot get enforcement trace: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.getEnforcementTrace(after: cursor, reply: { records, _, nowNanos in
+            let trace = EnforcementTrace(rawRecords: records, nowNanos: nowNanos)
+            DispatchQueue.main.async {
+                completion(trace)
+            }
+        })
+    }
+
+    /// Current awdl0 interface flags, read in-process with SIOCGIFFLAGS.
+    func currentAWDLInterfaceStatus() -> InterfaceStatus {
+        InterfaceStatus.read("awdl0")
     }
     
     /// Reset the intervention counter in the helper
@@ -527,9 +763,27 @@ class PingWardenMonitor {
         })
     }
 
+    /// Run the helper's enforcement self-test on a blocked interface (see HelperSelfTest)
+    func runSelfTest(interface name: String = "awdl0", rounds: Int = 100, completion: @escaping (HelperSelfTest?) -> Void) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot run self-test: No helper proxy")
+            completion(nil)
+            return
+        }
+
+        proxy.runSelfTest(interface: name, rounds: UInt(max(rounds, 1)), reply: { result in
+            let selfTest = HelperSelfTest(dictionary: result)
+            DispatchQueue.main.async {
+                completion(selfTest)
+            }
+        })
+    }
+
     /// Test the helper response time (for Testing Mode feature)
     /// Note: This test only works when monitoring is active, as it relies on
-    /// the helper bringing AWDL back down after we bring it up.
+    /// the helper bringing AWDL back down after we bring it up. The helper raises
+    /// awdl0 itself and times its own loop, so the results carry neither XPC nor
+    /// this process's scheduling; responseTime is raise -> SIOCSIFFLAGS(DOWN).
     func testHelperResponseTime(iterations: Int = 5, completion: @escaping ([(passed: Bool, responseTime: TimeInterval)]) -> Void) {
         log.info("Testing helper response time (\(iterations) iterations)...")
 
@@ -544,37 +798,23 @@ class PingWardenMonitor {
             return
         }
 
-        var results: [(passed: Bool, responseTime: TimeInterval)] = []
-
-        DispatchQueue.global(qos: .userInitiated).async {
-            for i in 0..<iterations {
-                let startTime = Date()
-
-                // Bring AWDL up
-                self.runIfconfig(up: true)
-
-                // Small delay for system to process
-                Thread.sleep(forTimeInterval: 0.001)
-
-                // Check if AWDL is still down (helper should have caught it)
-                let status = self.getAWDLInterfaceStatus()
-                let endTime = Date()
-
-                let responseTime = endTime.timeIntervalSince(startTime)
-                let passed = !status.contains("UP") || status.contains("<DOWN")
-
-                results.append((passed: passed, responseTime: responseTime))
-                log.debug("Test \(i + 1): passed=\(passed), time=\(String(format: "%.3f", responseTime * 1000))ms")
-
-                // Small delay between tests
-                if i < iterations - 1 {
-                    Thread.sleep(forTimeInterval: 0.1)
-                }
+        runSelfTest(interface: "awdl0", rounds: iterations) { selfTest in
+            guard let selfTest else {
+                completion((0..<iterations).map { _ in (passed: false, responseTime: 0.0) })
+                return
             }
-
-            DispatchQueue.main.async {
-                completion(results)
+            if let error = selfTest.error {
+                log.error("Helper self-test: \(error)")
+            }
+            var results = selfTest.samples.map { sample in
+                (passed: sample.lowered, responseTime: TimeInterval(sample.raiseToDownNanos) / 1_000_000_000)
             }
+            // Rounds the helper never made count as failures
+            while results.count < iterations {
+                results.append((passed: false, responseTime: 0.0))
+            }
+            log.info("Helper self-test: \(selfTest.lowered)/\(selfTest.rounds) lowered, p50 \(ReactionTimeHistogram.formatNanos(selfTest.raiseToDown.p50Nanos)), max \(ReactionTimeHistogram.formatNanos(selfTest.raiseToDown.maxNanos))")
+            completion(results)
         }
     }
 
@@ -631,6 +871,8 @@ class PingWardenMonitor {
         // This is required because the daemon runs as root
         let connection = NSXPCConnection(machServiceName: xpcServiceName, options: .privileged)
         connection.remoteObjectInterface = NSXPCInterface(with: PingWardenHelperProtocol.self)
+        connection.exportedInterface = NSXPCInterface(with: PingWardenHelperClientProtocol.self)
+        connection.exportedObject = updateReceiver
 
         connection.interruptionHandler = { [weak self] in
             log.warning("XPC connection interrupted")
@@ -657,50 +899,123 @@ class PingWardenMonitor {
 
         log.info("XPC connection activated")
 
-        // Validate connection asynchronously to avoid blocking UI paths.
-        validateXPCConnection { [weak self] isValid in
+        // Registering doubles as the connection check: the helper replies once it is serving us
+        registerForUpdates { [weak self] isRegistered in
             guard let self else { return }
-            if isValid {
+            if isRegistered {
                 self.reassertMonitoringStateIfNeeded()
+                self.applyRealtimeEnforcement()
+                self.applyMemoryLocking()
+                self.applyInterfacePolicy()
             }
         }
     }
 
-    /// Validate XPC connection is actually working
-    private func validateXPCConnection(completion: ((Bool) -> Void)? = nil) {
+    /// Push the realtime-enforcement preference to the helper, which forgets it between connections.
+    private func applyRealtimeEnforcement() {
+        let enabled = PingWardenPreferences.shared.realtimeEnforcement
         guard let proxy = getHelperProxy() else {
-            log.warning("XPC validation: No proxy available")
-            completion?(false)
+            log.warning("Cannot apply realtime enforcement: No helper proxy")
+            return
+        }
+
+        proxy.setRealtimeSchedulingEnabled(enabled, reply: { success in
+            if success {
+                log.info("Realtime enforcement \(enabled ? "enabled" : "disabled")")
+            } else {
+                log.warning("Helper could not change realtime enforcement to \(enabled)")
+            }
+        })
+    }
+
+    /// Push the memory-locking preference to the helper, which forgets it between connections.
+    private func applyMemoryLocking() {
+        let enabled = PingWardenPreferences.shared.lockEnforcementMemory
+        guard let proxy = getHelperProxy() else {
+            log.warning("Cannot apply enforcement memory locking: No helper proxy")
             return
         }
 
-        let completionLock = NSLock()
-        var didComplete = false
+        proxy.setMemoryLockingEnabled(enabled, reply: { success in
+            if success {
+                log.info("Enforcement memory \(enabled ? "locked" : "unlocked")")
+            } else {
+                log.warning("Helper could not change enforcement memory locking to \(enabled)")
+            }
+        })
+    }
 
-        let finish: (Bool) -> Void = { isValid in
-            completionLock.lock()
-            defer { completionLock.unlock() }
-            guard !didComplete else { return }
-            didComplete = true
-            completion?(isValid)
+    /// Push the llw0 half of the policy table: blocked only while monitoring is on and the
+    /// preference asks for it. awdl0 follows start/stopMonitoring.
+    private func applyInterfacePolicy() {
+        let blocked = isMonitoring && PingWardenPreferences.shared.blockLowLatencyWLAN
+        setInterfacePolicy(["llw0": !blocked]) { success in
+            if success {
+                log.info("llw0 \(blocked ? "blocked" : "allowed")")
+            } else {
+                log.warning("Could not apply the llw0 interface policy")
+            }
         }
+    }
 
-        DispatchQueue.global(qos: .utility).asyncAfter(deadline: .now() + 2.0) {
-            log.warning("XPC validation: Connection timeout - helper may not be running")
-            finish(false)
+    /// Ask the helper to push interventions and state changes over this connection.
+    /// Failures surface through the proxy error handler, which drives reconnection.
+    private func registerForUpdates(completion: ((Bool) -> Void)? = nil) {
+        guard let proxy = getHelperProxy() else {
+            log.warning("Update registration: No proxy available")
+            completion?(false)
+            return
         }
 
-        proxy.getVersion(reply: { version in
-            if version.isEmpty {
-                log.warning("XPC validation: Invalid response from helper")
-                finish(false)
+        stateLock.lock()
+        let cursor = pushedInterventionCursor
+        stateLock.unlock()
+
+        let maxFlushesPerSecond = PingWardenPreferences.shared.helperUpdateMaxFlushesPerSecond
+        proxy.registerForUpdates(after: cursor, maxFlushesPerSecond: maxFlushesPerSecond, reply: { success in
+            if success {
+                log.debug("Registered for helper updates (max \(maxFlushesPerSecond)/s)")
             } else {
-                log.debug("XPC validation: Connection verified successfully")
-                finish(true)
+                log.warning("Helper refused update registration")
+            }
+            DispatchQueue.main.async {
+                completion?(success)
             }
         })
     }
 
+    /// Called on the XPC queue with a batch of pushed interventions.
+    fileprivate func handlePushedInterventions(_ events: [[String: NSNumber]],
+                                               latestSequence: UInt64,
+                                               nowNanos: UInt64,
+                                               interventionCount: Int) {
+        stateLock.lock()
+        let batch = InterventionEventBatch(
+            rawEvents: events,
+            cursor: pushedInterventionCursor,
+            latestSequence: latestSequence,
+            nowNanos: nowNanos,
+            interventionCount: interventionCount
+        )
+        pushedInterventionCursor = batch.nextCursor
+        let observers = Array(interventionObservers.values)
+        stateLock.unlock()
+
+        DispatchQueue.main.async {
+            observers.forEach { $0(batch) }
+        }
+    }
+
+    /// Called on the XPC queue when the helper's desired AWDL state changes.
+    fileprivate func handlePushedAWDLEnabled(_ enabled: Bool) {
+        DispatchQueue.main.async {
+            let state = enabled ? "up" : "down"
+            guard PingWardenPreferences.shared.lastKnownState != state else { return }
+            PingWardenPreferences.shared.lastKnownState = state
+            self.notifyStateChange()
+        }
+    }
+
     private func reassertMonitoringStateIfNeeded() {
         let shouldReassert = isMonitoring
         guard shouldReassert else {
@@ -890,49 +1205,6 @@ class PingWardenMonitor {
         }
     }
 
-    /// Get current AWDL interface status via ifconfig
-    private func getAWDLInterfaceStatus() -> String {
-        let task = Process()
-        task.executableURL = URL(fileURLWithPath: "/sbin/ifconfig")
-        task.arguments = ["awdl0"]
-
-        let pipe = Pipe()
-        task.standardOutput = pipe
-        task.standardError = Pipe()
-
-        do {
-            try task.run()
-            task.waitUntilExit()
-
-            let data = pipe.fileHandleForReading.readDataToEndOfFile()
-            let output = String(data: data, encoding: .utf8) ?? ""
-
-            if let flagsLine = output.components(separatedBy: "\n").first(where: { $0.contains("flags=") }) {
-                return flagsLine
-            }
-            return output
-        } catch {
-            log.error("Error getting AWDL status: \(error.localizedDescription)")
-            return "Error: \(error.localizedDescription)"
-        }
-    }
-
-    /// Run ifconfig to bring AWDL up or down (for testing only)
-    private func runIfconfig(up: Bool) {
-        let task = Process()
-        task.executableURL = URL(fileURLWithPath: "/sbin/ifconfig")
-        task.arguments = ["awdl0", up ? "up" : "down"]
-        task.standardOutput = Pipe()
-        task.standardError = Pipe()
-
-        do {
-            try task.run()
-            task.waitUntilExit()
-        } catch {
-            log.error("Error running ifconfig: \(error.localizedDescription)")
-        }
-    }
-
     /// Show error alert
     private func showError(_ message: String) {
         log.error("Showing error: \(message)")
@@ -946,3 +1218,30 @@ class PingWardenMonitor {
         }
     }
 }
+
+// MARK: - Pushed Updates
+
+/// Receives PingWardenHelperClientProtocol calls from the helper and forwards them to the monitor.
+private final class HelperUpdateReceiver: NSObject, PingWardenHelperClientProtocol {
+    private weak var monitor: PingWardenMonitor?
+
+    init(monitor: PingWardenMonitor) {
+        self.monitor = monitor
+    }
+
+    func helperDidRecordInterventions(_ events: [[String: NSNumber]],
+                                      latestSequence: UInt64,
+                                      nowNanos: UInt64,
+                                      interventionCount: Int) {
+        monitor?.handlePushedInterventions(
+            events,
+            latestSequence: latestSequence,
+            nowNanos: nowNanos,
+            interventionCount: interventionCount
+        )
+    }
+
+    func helperDidChangeAWDLEnabled(_ enabled: Bool) {
+        monitor?.handlePushedAWDLEnabled(enabled)
+    }
+}
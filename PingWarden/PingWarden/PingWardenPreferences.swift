@@ -25,6 +25,13 @@ class PingWardenPreferences {
     private let gameModeAutoDetectKey = "GameModeAutoDetect"
     private let showDockIconKey = "ShowDockIcon"
     private let showMenuDropdownMetricsKey = "ShowMenuDropdownMetrics"
+    private let helperUpdateMaxFlushesPerSecondKey = "HelperUpdateMaxFlushesPerSecond"
+    private let realtimeEnforcementKey = "RealtimeEnforcement"
+    private let lockEnforcementMemoryKey = "LockEnforcementMemory"
+    private let blockLowLatencyWLANKey = "BlockLowLatencyWLAN"
+
+    /// Default cap on pushed intervention batches per second
+    static let defaultHelperUpdateMaxFlushesPerSecond: Double = 10
 
     private lazy var defaults: UserDefaults? = {
         // Use standard UserDefaults if App Groups aren't available
@@ -157,6 +164,70 @@ class PingWardenPreferences {
             NotificationCenter.default.post(name: .menuDropdownMetricsChanged, object: nil)
         }
     }
+
+    /// Upper bound on how often the helper pushes intervention batches to the app.
+    /// Interventions in between are coalesced; takes effect on the next XPC connection.
+    var helperUpdateMaxFlushesPerSecond: Double {
+        get {
+            let value = defaults?.double(forKey: helperUpdateMaxFlushesPerSecondKey) ?? 0
+            return value > 0 ? value : Self.defaultHelperUpdateMaxFlushesPerSecond
+        }
+        set {
+            guard let defaults = defaults else {
+                log.error("Cannot set \(self.helperUpdateMaxFlushesPerSecondKey): defaults is nil")
+                return
+            }
+            defaults.set(newValue, forKey: helperUpdateMaxFlushesPerSecondKey)
+        }
+    }
+
+    /// Whether the helper's enforcement thread runs with realtime scheduling, so it reacts
+    /// promptly even while a game keeps every core busy
+    var realtimeEnforcement: Bool {
+        get {
+            return defaults?.bool(forKey: realtimeEnforcementKey) ?? false
+        }
+        set {
+            guard let defaults = defaults else {
+                log.error("Cannot set \(self.realtimeEnforcementKey): defaults is nil")
+                return
+            }
+            defaults.set(newValue, forKey: realtimeEnforcementKey)
+            NotificationCenter.default.post(name: .realtimeEnforcementChanged, object: nil)
+        }
+    }
+
+    /// Whether the helper locks its enforcement loop's memory in RAM, so a long session that
+    /// pushes everything else out cannot make an intervention wait for a page fault
+    var lockEnforcementMemory: Bool {
+        get {
+            return defaults?.bool(forKey: lockEnforcementMemoryKey) ?? false
+        }
+        set {
+            guard let defaults = defaults else {
+                log.error("Cannot set \(self.lockEnforcementMemoryKey): defaults is nil")
+                return
+            }
+            defaults.set(newValue, forKey: lockEnforcementMemoryKey)
+            NotificationCenter.default.post(name: .enforcementMemoryLockChanged, object: nil)
+        }
+    }
+
+    /// Whether monitoring also keeps llw0, the low-latency WLAN interface AWDL brings up
+    /// alongside awdl0, DOWN
+    var blockLowLatencyWLAN: Bool {
+        get {
+            return defaults?.bool(forKey: blockLowLatencyWLANKey) ?? false
+        }
+        set {
+            guard let defaults = defaults else {
+                log.error("Cannot set \(self.blockLowLatencyWLANKey): defaults is nil")
+                return
+            }
+            defaults.set(newValue, forKey: blockLowLatencyWLANKey)
+            NotificationCenter.default.post(name: .interfacePolicyChanged, object: nil)
+        }
+    }
 }
 
 extension Notification.Name {
@@ -168,4 +239,7 @@ extension Notification.Name {
     static let gameModeAutoDetectChanged = Notification.Name("com.amesvt.pingwarden.notification.GameModeAutoDetectChanged")
     static let dockIconVisibilityChanged = Notification.Name("com.amesvt.pingwarden.notification.DockIconVisibilityChanged")
     static let menuDropdownMetricsChanged = Notification.Name("com.amesvt.pingwarden.notification.MenuDropdownMetricsChanged")
+    static let realtimeEnforcementChanged = Notification.Name("com.amesvt.pingwarden.notification.RealtimeEnforcementChanged")
+    static let enforcementMemoryLockChanged = Notification.Name("com.amesvt.pingwarden.notification.EnforcementMemoryLockChanged")
+    static let interfacePolicyChanged = Notification.Name("com.amesvt.pingwarden.notification.InterfacePolicyChanged")
 }
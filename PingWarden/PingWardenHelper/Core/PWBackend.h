@@ -0,0 +1,163 @@
+//
+//  PWBackend.h
+//  PingWardenHelper
+//
+//  Pluggable event source and actuator interfaces for the enforcement core.
+//  A source turns kernel link notifications (AF_ROUTE on Darwin, rtnetlink on
+//  Linux) into PWLinkEvents; an actuator reads and writes interface flags.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWBackend_h
+#define PWBackend_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <net/if.h>
+
+#include "PWCapture.h"
+#include "PWMemory.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Kind of link notification reported by an event source.
+typedef enum {
+    /// Interface flags changed (RTM_IFINFO on Darwin, RTM_NEWLINK on Linux).
+    PWLinkEventInfo = 0,
+    /// Interface attached (RTM_IFANNOUNCE/IFAN_ARRIVAL, or a newly registered link on Linux).
+    PWLinkEventArrival,
+    /// Interface detached (RTM_IFANNOUNCE/IFAN_DEPARTURE, RTM_DELLINK).
+    PWLinkEventDeparture,
+} PWLinkEventType;
+
+/// A single parsed link notification.
+typedef struct {
+    PWLinkEventType type;
+    unsigned int ifindex;
+    uint32_t flags;
+    /// Interface name; only filled for arrival/departure events.
+    char ifname[IFNAMSIZ];
+} PWLinkEvent;
+
+/// Callback invoked by a source for every link event parsed during a drain.
+typedef void (*PWLinkEventHandler)(void *context, const PWLinkEvent *event);
+
+/// How a source empties its socket on each wakeup.
+typedef enum {
+    /// Large-buffer reads (recvmmsg on Linux), every message in a read parsed in one pass.
+    PWDrainModeBatched = 0,
+    /// One small read per message. Kept for comparison benchmarks.
+    PWDrainModeSingle,
+} PWDrainMode;
+
+/// Counters maintained by a source. Only valid on the thread that drains it.
+typedef struct {
+    uint64_t wakeups;    // drain calls
+    uint64_t syscalls;   // read/recv calls, including the one that returns EAGAIN
+    uint64_t messages;   // kernel messages walked, of any type
+    uint64_t overflows;  // reads that reported ENOBUFS, or on Darwin drains that found the receive buffer half full
+} PWDrainStats;
+
+/// Receive buffer requested for kernel event sockets at creation. A storm that
+/// outruns the loop overflows the buffer and drops notifications; the loop then
+/// re-reads the flags, but a larger buffer makes that rarer.
+#define PW_EVENT_SOURCE_RECEIVE_BUFFER_DEFAULT (1024 * 1024)
+
+/// Source of link events. Implementations embed this struct as their first member.
+typedef struct PWEventSource {
+    /// Pollable descriptor; readable when kernel messages are queued.
+    int fd;
+
+    PWDrainMode drainMode;
+    PWDrainStats stats;
+
+    /// PWMonotonicNanos() at which the first message of the last drain was queued,
+    /// or 0 if the backend cannot tell. Kernel route sockets carry no timestamp;
+    /// sources fed by tests and benchmarks do.
+    uint64_t lastArrivalAt;
+
+    /// When set, the raw bytes of every read are appended here before parsing.
+    /// Owned by the enforcer (PWEnforcerStartCapture).
+    PWCapture *capture;
+
+    /// Read every message currently queued on fd and report each link event to handler.
+    /// If the kernel dropped messages, increments stats.overflows and keeps reading.
+    /// Returns false only on an unrecoverable read error.
+    bool (*drain)(struct PWEventSource *source, PWLinkEventHandler handler, void *context);
+
+    /// Optional; NULL if the source cannot filter in the kernel. Restrict wakeups to
+    /// link messages for these interface indexes plus new-link registrations, so an
+    /// arrival under a new index still gets through. Called again whenever the set
+    /// changes; count 0 leaves only registrations. Returns false if the filter was
+    /// refused, in which case every message is still delivered.
+    bool (*watch)(struct PWEventSource *source, const unsigned int *ifindexes, size_t count);
+
+    /// Optional; NULL if the source keeps no buffers of its own. Copy up to capacity
+    /// regions a drain reads into (the source itself included), so the enforcer can
+    /// lock them in RAM. Fixed for the source's lifetime, and already prefaulted by
+    /// the source at creation. Returns the number of regions copied.
+    size_t (*copyBuffers)(struct PWEventSource *source, PWMemoryRegion *regions, size_t capacity);
+
+    /// Close the descriptor and free the source.
+    void (*destroy)(struct PWEventSource *source);
+} PWEventSource;
+
+/// Reads and writes interface flags. Implementations embed this struct as their first member.
+typedef struct PWActuator {
+    bool (*getFlags)(struct PWActuator *actuator, const char *ifname, uint32_t *flags);
+    bool (*setFlags)(struct PWActuator *actuator, const char *ifname, uint32_t flags);
+    void (*destroy)(struct PWActuator *actuator);
+} PWActuator;
+
+// MARK: - Built-in backends
+
+#if defined(__APPLE__)
+/// AF_ROUTE socket source reporting RTM_IFINFO/RTM_IFANNOUNCE messages. Returns NULL on failure.
+PWEventSource *PWRouteSocketSourceCreate(void);
+
+/// Route-message source over an existing non-blocking descriptor (takes ownership).
+PWEventSource *PWRouteSocketSourceCreateWithDescriptor(int fd);
+
+/// Walk the rtm_msglen chain in buf, reporting link events. Returns the number of messages walked.
+size_t PWRouteMessagesParse(const uint8_t *buf, size_t len, PWLinkEventHandler handler, void *context);
+#endif
+
+#if defined(__linux__)
+/// Most interface indexes a netlink source's kernel filter can watch.
+#define PW_NETLINK_FILTER_MAX_INDEXES 32
+
+/// NETLINK_ROUTE socket subscribed to RTNLGRP_LINK, with a classic BPF filter
+/// (SO_ATTACH_FILTER) installed through watch. Returns NULL on failure.
+PWEventSource *PWNetlinkSourceCreate(void);
+
+/// Netlink source over an existing non-blocking descriptor (takes ownership).
+PWEventSource *PWNetlinkSourceCreateWithDescriptor(int fd);
+
+/// Walk the nlmsghdr chain in buf, reporting link events. Returns the number of messages walked.
+size_t PWNetlinkMessagesParse(const void *buf, size_t len, PWLinkEventHandler handler, void *context);
+#endif
+
+/// Set SO_RCVBUF on a kernel event source (SO_RCVBUFFORCE first on Linux, which
+/// may exceed net.core.rmem_max when running as root). Returns the size the kernel
+/// reports afterwards, which may differ from bytes, or -1 on failure.
+int PWEventSourceSetReceiveBufferSize(PWEventSource *source, int bytes);
+
+/// SIOCGIFFLAGS/SIOCSIFFLAGS actuator on an AF_INET datagram socket. Returns NULL on failure.
+PWActuator *PWIoctlActuatorCreate(void);
+
+/// Platform default event source (AF_ROUTE on Darwin, rtnetlink on Linux).
+PWEventSource *PWDefaultEventSourceCreate(void);
+
+/// Parser of the platform default source, for PW_CAPTURE_FORMAT_NATIVE captures.
+size_t PWDefaultMessagesParse(const void *buf, size_t len, PWLinkEventHandler handler, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWBackend_h */
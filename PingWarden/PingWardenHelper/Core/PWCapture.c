@@ -0,0 +1,262 @@
+//
+//  PWCapture.c
+//  PingWardenHelper
+//
+//  Record-and-replay file format for routing event streams.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWCapture.h"
+#include "PWClock.h"
+#include "PWLog.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// stdio buffer for the writer; a drain of a storm is usually a few KB
+#define PW_CAPTURE_WRITE_BUFFER_SIZE (64 * 1024)
+
+// Largest LEB128 encoding of a uint64_t
+#define PW_CAPTURE_VARINT_MAX 10
+
+struct PWCapture {
+    FILE *file;
+    char *buffer;
+    uint64_t lastTimestamp;
+    uint64_t drainAt;
+    bool drainStarted;
+    bool failed;
+};
+
+struct PWCaptureReader {
+    PWCaptureFileHeader header;
+    uint8_t *bytes;
+    size_t length;
+    size_t offset;
+    uint64_t timestamp;
+};
+
+// MARK: - Writing
+
+static size_t PWCaptureEncodeVarint(uint64_t value, uint8_t *out) {
+    size_t n = 0;
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        out[n++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return n;
+}
+
+static void PWCaptureWrite(PWCapture *capture, const void *bytes, size_t length) {
+    if (capture->failed) {
+        return;
+    }
+    if (fwrite(bytes, 1, length, capture->file) != length) {
+        PW_LOG_ERROR("Error writing capture: %d (%s); capture stopped", errno, strerror(errno));
+        capture->failed = true;
+    }
+}
+
+static void PWCaptureAppendRecord(PWCapture *capture, PWCaptureRecordKind kind, uint64_t timestamp,
+                                  const void *bytes, size_t length) {
+    // Clocks never go back, but a caller-supplied timestamp may predate the header
+    uint64_t delta = timestamp > capture->lastTimestamp ? timestamp - capture->lastTimestamp : 0;
+    capture->lastTimestamp += delta;
+
+    uint8_t prefix[2 * PW_CAPTURE_VARINT_MAX];
+    size_t n = PWCaptureEncodeVarint(delta, prefix);
+    n += PWCaptureEncodeVarint(((uint64_t)length << 2) | (uint64_t)kind, prefix + n);
+    PWCaptureWrite(capture, prefix, n);
+    if (length) {
+        PWCaptureWrite(capture, bytes, length);
+    }
+}
+
+PWCapture *PWCaptureCreate(const char *path, PWCaptureFormat format, const char *ifname, unsigned int ifindex) {
+    PWCapture *capture = calloc(1, sizeof(*capture));
+    if (!capture) {
+        return NULL;
+    }
+    capture->file = fopen(path, "wb");
+    if (!capture->file) {
+        PW_LOG_ERROR("Error creating capture %s: %d (%s)", path, errno, strerror(errno));
+        free(capture);
+        return NULL;
+    }
+    capture->buffer = malloc(PW_CAPTURE_WRITE_BUFFER_SIZE);
+    if (capture->buffer) {
+        setvbuf(capture->file, capture->buffer, _IOFBF, PW_CAPTURE_WRITE_BUFFER_SIZE);
+    }
+
+    PWCaptureFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = PW_CAPTURE_MAGIC;
+    header.version = PW_CAPTURE_VERSION;
+    header.format = (uint16_t)format;
+    header.ifindex = ifindex;
+    strncpy(header.ifname, ifname, IFNAMSIZ - 1);
+    header.startedAt = PWMonotonicNanos();
+    capture->lastTimestamp = header.startedAt;
+
+    PWCaptureWrite(capture, &header, sizeof(header));
+    if (!PWCaptureFlush(capture)) {
+        PWCaptureDestroy(capture);
+        return NULL;
+    }
+    PW_LOG("Capturing routing messages for %s to %s", ifname, path);
+    return capture;
+}
+
+void PWCaptureDestroy(PWCapture *capture) {
+    if (!capture) {
+        return;
+    }
+    PWCaptureFlush(capture);
+    fclose(capture->file);
+    free(capture->buffer);
+    free(capture);
+}
+
+void PWCaptureBeginDrain(PWCapture *capture, uint64_t timestamp) {
+    capture->drainAt = timestamp;
+    capture->drainStarted = false;
+}
+
+void PWCaptureAppendMessages(PWCapture *capture, const void *bytes, size_t length) {
+    PWCaptureRecordKind kind = capture->drainStarted ? PWCaptureRecordDrainContinued : PWCaptureRecordDrain;
+    capture->drainStarted = true;
+    PWCaptureAppendRecord(capture, kind, capture->drainAt, bytes, length);
+}
+
+void PWCaptureAppendOverflow(PWCapture *capture) {
+    // Overflow records never start a drain; the failed read stands in for the first one
+    if (!capture->drainStarted) {
+        PWCaptureAppendMessages(capture, NULL, 0);
+    }
+    PWCaptureAppendRecord(capture, PWCaptureRecordOverflow, capture->drainAt, NULL, 0);
+}
+
+void PWCaptureAppendControl(PWCapture *capture, uint64_t timestamp, uint8_t allowMask) {
+    PWCaptureAppendRecord(capture, PWCaptureRecordControl, timestamp, &allowMask, 1);
+}
+
+bool PWCaptureFlush(PWCapture *capture) {
+    if (!capture->failed && fflush(capture->file) != 0) {
+        PW_LOG_ERROR("Error flushing capture: %d (%s); capture stopped", errno, strerror(errno));
+        capture->failed = true;
+    }
+    return !capture->failed;
+}
+
+// MARK: - Reading
+
+PWCaptureReader *PWCaptureReaderOpen(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        PW_LOG_ERROR("Error opening capture %s: %d (%s)", path, errno, strerror(errno));
+        return NULL;
+    }
+
+    PWCaptureReader *reader = calloc(1, sizeof(*reader));
+    size_t capacity = 64 * 1024;
+    uint8_t *bytes = malloc(capacity);
+    size_t length = 0;
+    while (reader && bytes) {
+        length += fread(bytes + length, 1, capacity - length, file);
+        if (length < capacity) {
+            break;
+        }
+        uint8_t *grown = realloc(bytes, capacity * 2);
+        if (!grown) {
+            free(bytes);
+            bytes = NULL;
+            break;
+        }
+        bytes = grown;
+        capacity *= 2;
+    }
+    bool readFailed = ferror(file);
+    fclose(file);
+
+    if (!reader || !bytes || readFailed) {
+        PW_LOG_ERROR("Error reading capture %s", path);
+        free(bytes);
+        free(reader);
+        return NULL;
+    }
+    if (length < sizeof(PWCaptureFileHeader)) {
+        PW_LOG_ERROR("Capture %s is too short", path);
+        free(bytes);
+        free(reader);
+        return NULL;
+    }
+
+    memcpy(&reader->header, bytes, sizeof(reader->header));
+    reader->header.ifname[IFNAMSIZ - 1] = '\0';
+    if (reader->header.magic != PW_CAPTURE_MAGIC || reader->header.version != PW_CAPTURE_VERSION) {
+        PW_LOG_ERROR("%s is not a version %d capture", path, PW_CAPTURE_VERSION);
+        free(bytes);
+        free(reader);
+        return NULL;
+    }
+    reader->bytes = bytes;
+    reader->length = length;
+    PWCaptureReaderRewind(reader);
+    return reader;
+}
+
+void PWCaptureReaderClose(PWCaptureReader *reader) {
+    if (!reader) {
+        return;
+    }
+    free(reader->bytes);
+    free(reader);
+}
+
+const PWCaptureFileHeader *PWCaptureReaderHeader(const PWCaptureReader *reader) {
+    return &reader->header;
+}
+
+static bool PWCaptureDecodeVarint(PWCaptureReader *reader, uint64_t *value) {
+    *value = 0;
+    for (unsigned int shift = 0; shift < 64 && reader->offset < reader->length; shift += 7) {
+        uint8_t byte = reader->bytes[reader->offset++];
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PWCaptureReaderNext(PWCaptureReader *reader, PWCaptureRecord *record) {
+    size_t start = reader->offset;
+    uint64_t delta, tag;
+    if (reader->offset == reader->length) {
+        return false;
+    }
+    if (!PWCaptureDecodeVarint(reader, &delta) || !PWCaptureDecodeVarint(reader, &tag) ||
+        (tag >> 2) > reader->length - reader->offset) {
+        PW_LOG_ERROR("Capture truncated at byte %zu", start);
+        reader->offset = reader->length;
+        return false;
+    }
+
+    reader->timestamp += delta;
+    record->kind = (PWCaptureRecordKind)(tag & 3);
+    record->timestamp = reader->timestamp;
+    record->data = reader->bytes + reader->offset;
+    record->length = (size_t)(tag >> 2);
+    reader->offset += record->length;
+    return true;
+}
+
+void PWCaptureReaderRewind(PWCaptureReader *reader) {
+    reader->offset = sizeof(PWCaptureFileHeader);
+    reader->timestamp = reader->header.startedAt;
+}
@@ -0,0 +1,122 @@
+//
+//  PWCapture.h
+//  PingWardenHelper
+//
+//  Record-and-replay file format for routing event streams.
+//  A capture holds the raw bytes of every routing socket read (AF_ROUTE on
+//  Darwin, rtnetlink on Linux) and every allow/block change, stamped with the
+//  monotonic clock, so a field storm can be fed back through the same parser
+//  and decision code without sockets.
+//
+//  Layout: a fixed PWCaptureFileHeader, then records of
+//  [LEB128 nanoseconds since previous record][LEB128 (length << 2) | kind][length bytes].
+//  Header fields are in the byte order of the recording machine; both
+//  supported platforms are little-endian.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWCapture_h
+#define PWCapture_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <net/if.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PW_CAPTURE_MAGIC 0x50435750u  // "PWCP"
+#define PW_CAPTURE_VERSION 1
+
+/// Wire format of the message payloads.
+typedef enum {
+    PWCaptureFormatRouteSocket = 1,  // XNU rt_msghdr chains
+    PWCaptureFormatNetlink = 2,      // Linux nlmsghdr chains
+} PWCaptureFormat;
+
+#if defined(__APPLE__)
+#define PW_CAPTURE_FORMAT_NATIVE PWCaptureFormatRouteSocket
+#else
+#define PW_CAPTURE_FORMAT_NATIVE PWCaptureFormatNetlink
+#endif
+
+typedef enum {
+    /// Bytes of the first read after a wakeup.
+    PWCaptureRecordDrain = 0,
+    /// Bytes of a further read in the same drain.
+    PWCaptureRecordDrainContinued = 1,
+    /// One byte: bit n set if policy table slot n was allowed up (slot 0 is the
+    /// header's interface, so single-interface captures hold 1 or 0).
+    PWCaptureRecordControl = 2,
+    /// No payload: a read in the current drain failed with ENOBUFS. Always follows
+    /// the drain's first record (an empty one if no read had returned data yet).
+    PWCaptureRecordOverflow = 3,
+} PWCaptureRecordKind;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t format;         // PWCaptureFormat
+    uint32_t ifindex;        // index of ifname when the capture started, 0 if absent
+    char ifname[IFNAMSIZ];
+    uint64_t startedAt;      // PWMonotonicNanos() of the first record's reference point
+} PWCaptureFileHeader;
+
+typedef struct {
+    PWCaptureRecordKind kind;
+    uint64_t timestamp;      // recording machine's PWMonotonicNanos()
+    const uint8_t *data;     // valid until the next PWCaptureReaderNext
+    size_t length;
+} PWCaptureRecord;
+
+// MARK: - Writing
+
+typedef struct PWCapture PWCapture;
+
+/// Create (truncate) path and write the header. Returns NULL on failure.
+PWCapture *PWCaptureCreate(const char *path, PWCaptureFormat format, const char *ifname, unsigned int ifindex);
+
+/// Flush and close. Accepts NULL.
+void PWCaptureDestroy(PWCapture *capture);
+
+/// Start a new drain; the next PWCaptureAppendMessages is a PWCaptureRecordDrain at timestamp.
+void PWCaptureBeginDrain(PWCapture *capture, uint64_t timestamp);
+
+/// Append the raw bytes of one socket read.
+void PWCaptureAppendMessages(PWCapture *capture, const void *bytes, size_t length);
+
+/// Note that the kernel dropped messages during the current drain.
+void PWCaptureAppendOverflow(PWCapture *capture);
+
+/// Append an allow/block change: bit n of allowMask is policy table slot n.
+void PWCaptureAppendControl(PWCapture *capture, uint64_t timestamp, uint8_t allowMask);
+
+/// Push buffered records to the file. Returns false if a write failed; later appends are dropped.
+bool PWCaptureFlush(PWCapture *capture);
+
+// MARK: - Reading
+
+typedef struct PWCaptureReader PWCaptureReader;
+
+/// Load a capture into memory and validate its header. Returns NULL on failure.
+PWCaptureReader *PWCaptureReaderOpen(const char *path);
+
+void PWCaptureReaderClose(PWCaptureReader *reader);
+
+const PWCaptureFileHeader *PWCaptureReaderHeader(const PWCaptureReader *reader);
+
+/// Read the next record. Returns false at the end of the capture or at a truncated record.
+bool PWCaptureReaderNext(PWCaptureReader *reader, PWCaptureRecord *record);
+
+/// Go back to the first record.
+void PWCaptureReaderRewind(PWCaptureReader *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWCapture_h */
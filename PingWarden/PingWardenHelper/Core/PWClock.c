@@ -0,0 +1,80 @@
+//
+//  PWClock.c
+//  PingWardenHelper
+//
+//  Process start time on the monotonic clock.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWClock.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <libproc.h>
+#include <sys/proc_info.h>
+#endif
+
+/// Nanoseconds on clock, for converting the kernel's start stamp.
+static uint64_t PWClockNanos(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#if defined(__APPLE__)
+
+bool PWProcessStartNanos(uint64_t *monotonicNanos) {
+    struct proc_bsdinfo info;
+    if (proc_pidinfo(getpid(), PROC_PIDTBSDINFO, 0, &info, sizeof(info)) != (int)sizeof(info)) {
+        return false;
+    }
+    // The kernel stamps the start on the wall clock; take its age and count back
+    uint64_t startedAt = info.pbi_start_tvsec * 1000000000ull + info.pbi_start_tvusec * 1000ull;
+    uint64_t wallNow = PWClockNanos(CLOCK_REALTIME);
+    uint64_t now = PWMonotonicNanos();
+    uint64_t age = wallNow > startedAt ? wallNow - startedAt : 0;
+    *monotonicNanos = now > age ? now - age : 0;
+    return true;
+}
+
+#else
+
+bool PWProcessStartNanos(uint64_t *monotonicNanos) {
+    int fd = open("/proc/self/stat", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char line[1024];
+    ssize_t length = read(fd, line, sizeof(line) - 1);
+    close(fd);
+    if (length <= 0) {
+        return false;
+    }
+    line[length] = '\0';
+
+    // starttime is field 22, in clock ticks since boot; fields resume after the last ')'
+    const char *fields = strrchr(line, ')');
+    unsigned long long ticks;
+    if (!fields || sscanf(fields + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d "
+                                      "%*d %*d %llu", &ticks) != 1) {
+        return false;
+    }
+    long hertz = sysconf(_SC_CLK_TCK);
+    if (hertz <= 0) {
+        return false;
+    }
+    uint64_t startedAt = ticks * 1000000000ull / (uint64_t)hertz;
+    uint64_t bootNow = PWClockNanos(CLOCK_BOOTTIME);
+    uint64_t now = PWMonotonicNanos();
+    uint64_t age = bootNow > startedAt ? bootNow - startedAt : 0;
+    *monotonicNanos = now > age ? now - age : 0;
+    return true;
+}
+
+#endif
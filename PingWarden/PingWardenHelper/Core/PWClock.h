@@ -0,0 +1,52 @@
+//
+//  PWClock.h
+//  PingWardenHelper
+//
+//  Monotonic nanosecond clock for the enforcement core.
+//  mach_absolute_time-based on Darwin, CLOCK_MONOTONIC elsewhere; both are
+//  served from the commpage/vDSO without entering the kernel.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWClock_h
+#define PWClock_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Nanoseconds on a clock that never jumps. Only differences are meaningful.
+static inline uint64_t PWMonotonicNanos(void) {
+#if defined(__APPLE__)
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/// Nanoseconds since the Unix epoch. Jumps with the system clock; for calendar
+/// bucketing only. Also served without entering the kernel.
+static inline uint64_t PWWallClockNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/// When the kernel started this process, on the PWMonotonicNanos() clock, for
+/// measuring launch latency. Microsecond resolution on Darwin; on Linux the kernel
+/// only keeps clock ticks (usually 10 ms). Returns false if it cannot be read.
+bool PWProcessStartNanos(uint64_t *monotonicNanos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWClock_h */
@@ -0,0 +1,1195 @@
+//
+//  PWEnforcer.c
+//  PingWardenHelper
+//
+//  Platform-neutral interface-state enforcement loop.
+//  Based on jamestut/awdlkiller.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWEnforcer.h"
+#include "PWClock.h"
+#include "PWLog.h"
+#include "PWWakeup.h"
+
+#include <sys/types.h>
+#include <net/if.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Invalid file descriptor sentinel
+#define INVALID_FD (-1)
+
+// Single-writer counter bump: the loop thread is the only writer, so a relaxed
+// load/store pair is enough and avoids a locked read-modify-write.
+#define PW_COUNTER_ADD(counter, n) \
+    atomic_store_explicit(&(counter), atomic_load_explicit(&(counter), memory_order_relaxed) + (n), \
+                          memory_order_relaxed)
+#define PW_COUNTER_INC(counter) PW_COUNTER_ADD(counter, 1)
+
+// Control word layout: the requested state of every table entry (one allow
+// bit per slot), a quit bit, and a generation that every command bumps, so the
+// loop can tell "changed and changed back" from "nothing happened" and act once
+// on whatever is newest.
+#define PW_CONTROL_ALLOW_MASK       (((uint64_t)1 << PW_ENFORCER_MAX_TARGETS) - 1)
+#define PW_CONTROL_QUIT             ((uint64_t)1 << PW_ENFORCER_MAX_TARGETS)
+#define PW_CONTROL_GENERATION_SHIFT (PW_ENFORCER_MAX_TARGETS + 1)
+#define PW_CONTROL_GENERATION(word) ((word) >> PW_CONTROL_GENERATION_SHIFT)
+
+// Interface indexes below this map straight to a table slot. The kernel hands
+// out small indexes, so anything larger is rare enough to scan the table.
+#define PW_INDEX_MAP_SIZE 256
+
+// Most buffer regions a source reports through copyBuffers
+#define PW_ENFORCER_MAX_SOURCE_BUFFERS 4
+
+_Static_assert(PW_ENFORCER_MAX_TARGETS <= 8, "slots are stored in uint8_t and capture control bytes");
+_Static_assert(PW_ENFORCER_MAX_TARGETS <= PW_STATUS_PAGE_MAX_TARGETS, "the status page holds the whole table");
+_Static_assert(IFNAMSIZ <= sizeof(((PWStatusTarget *)0)->ifname), "status page names hold IFNAMSIZ bytes");
+
+/// One entry of the policy table. Written only by the loop thread except for
+/// the published fields and counters.
+typedef struct {
+    char ifname[IFNAMSIZ];
+
+    // Interface index cache: resolved once, then kept current by
+    // arrival/departure events. 0 while the interface does not exist.
+    unsigned int index;
+    atomic_uint publishedIndex;
+
+    bool allowUp;
+
+    // Last known flag word, kept current by link messages and by our own writes
+    // so an intervention needs only SIOCSIFFLAGS. Invalid after the interface
+    // changes identity or a write fails.
+    uint32_t cachedFlags;
+    bool cachedFlagsValid;
+
+    // UP notifications for this interface in the current drain
+    unsigned int drainUpNotifications;
+
+    // When the flags were first seen UP, 0 while DOWN or unknown; for lifetime UP time
+    uint64_t upSince;
+
+    atomic_uint_fast64_t interventions;
+    atomic_uint_fast64_t resyncInterventions;
+    atomic_uint_fast64_t lastInterventionAt;
+} PWTarget;
+
+struct PWEnforcer {
+    PWTarget targets[PW_ENFORCER_MAX_TARGETS];
+    size_t targetCount;
+    // Slot + 1 of the entry holding each small interface index, 0 for none
+    uint8_t slotByIndex[PW_INDEX_MAP_SIZE];
+
+    PWEventSource *source;
+    PWActuator *actuator;
+
+    // Mailbox written by control threads; the loop only ever acts on the newest value
+    _Atomic uint64_t control;
+    PWWakeup wakeup;
+
+    // Loop-thread state
+    atomic_uint_fast64_t appliedGeneration;
+    atomic_uint_fast64_t controlActuations;
+    atomic_uint_fast64_t firstAppliedAt;
+
+    // Entries touched in the current drain, one bit per slot
+    uint32_t drainTargets;   // link message or resync reported flags
+    uint32_t drainArrivals;  // interface (re)appeared
+    // The kernel filter was just regenerated; messages queued under the old one
+    // may have been dropped, so the next drain re-reads these entries' flags once
+    uint32_t resyncTargets;
+
+    atomic_uint_fast64_t fastPathWrites;
+    atomic_uint_fast64_t fallbackWrites;
+    atomic_uint_fast64_t failedWrites;
+    atomic_uint_fast64_t coalescedNotifications;
+    atomic_uint_fast64_t actuatorCalls;
+
+    atomic_uint_fast64_t indexLookups;
+    atomic_uint_fast64_t indexLookupsAvoided;
+    atomic_uint_fast64_t indexCacheUpdates;
+    atomic_uint_fast64_t filterUpdates;
+
+    // The kernel dropped messages in the current drain (receive buffer overflow)
+    bool drainOverflowed;
+    atomic_uint_fast64_t overflows;
+    atomic_uint_fast64_t resyncs;
+    atomic_uint_fast64_t resyncInterventions;
+
+    // Counter for interventions on every interface (how many times one was brought down)
+    atomic_uint_fast64_t interventionCount;
+
+    // Monotonic time the current drain's wakeup arrived; 0 outside PWEnforcerRun
+    uint64_t drainReceivedAt;
+    PWHistogram reactionTimes[PWReactionStageCount];
+    // Event queued -> loop running, per drain whose source reports arrival times
+    PWHistogram wakeupLatency;
+
+    // Timeline of interventions for clients; written only by the loop thread
+    PWEventRing interventionEvents;
+    // Intervention rate and burst episodes; written only by the loop thread
+    PWStormDetector storm;
+    // What the loop did, in place of per-event log lines; written only by the loop thread
+    PWTraceRing trace;
+
+    PWInterventionCallback interventionCallback;
+    void *interventionContext;
+
+    // Counters that survive the process; not owned, may be NULL
+    PWLifetime *lifetime;
+    // Published for clients after every drain and command; not owned, may be NULL
+    PWStatusPage *statusPage;
+    int64_t pid;
+    // Wall clock time of the newest intervention, for the status page
+    uint64_t lastInterventionWallAt;
+
+    // Working-set residency; the stack region is set by PWEnforcerPrepareThread
+    PWMemoryRegion stackRegion;
+    bool memoryLocked;
+    atomic_bool memoryLockedPublished;
+    atomic_uint_fast64_t lockedBytes;
+    atomic_uint_fast64_t prefaultedBytes;
+    atomic_uint_fast64_t loopThreadId;
+    PWFaultCounts faultBaseline;
+};
+
+static inline uint32_t PWEnforcerSlotBit(const PWEnforcer *enforcer, const PWTarget *target) {
+    return 1u << (target - enforcer->targets);
+}
+
+/// The entry holding an interface index: a table read on the hot path.
+static inline PWTarget *PWEnforcerTargetForIndex(PWEnforcer *enforcer, unsigned int ifindex) {
+    if (ifindex < PW_INDEX_MAP_SIZE) {
+        uint8_t slot = enforcer->slotByIndex[ifindex];
+        return slot ? &enforcer->targets[slot - 1] : NULL;
+    }
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        if (enforcer->targets[i].index == ifindex) {
+            return &enforcer->targets[i];
+        }
+    }
+    return NULL;
+}
+
+/// Append a trace record. Loop thread (or replay) only.
+static inline void PWEnforcerTrace(PWEnforcer *enforcer, PWTraceEvent event, uint64_t timestamp,
+                                   uint64_t arg0, uint64_t arg1) {
+    PWTraceRingPush(&enforcer->trace, event, timestamp, arg0, arg1);
+}
+
+static inline uint64_t PWEnforcerSlot(const PWEnforcer *enforcer, const PWTarget *target) {
+    return (uint64_t)(target - enforcer->targets);
+}
+
+static PWTarget *PWEnforcerTargetForName(PWEnforcer *enforcer, const char *ifname) {
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        if (strncmp(enforcer->targets[i].ifname, ifname, IFNAMSIZ) == 0) {
+            return &enforcer->targets[i];
+        }
+    }
+    return NULL;
+}
+
+/// Move an entry to a new index (0: absent) and keep the index map in step.
+static void PWEnforcerSetTargetIndex(PWEnforcer *enforcer, PWTarget *target, unsigned int ifindex) {
+    if (target->index && target->index < PW_INDEX_MAP_SIZE) {
+        enforcer->slotByIndex[target->index] = 0;
+    }
+    target->index = ifindex;
+    if (ifindex && ifindex < PW_INDEX_MAP_SIZE) {
+        enforcer->slotByIndex[ifindex] = (uint8_t)(target - enforcer->targets + 1);
+    }
+    atomic_store_explicit(&target->publishedIndex, ifindex, memory_order_relaxed);
+}
+
+/// Point the source's kernel filter at every index in the table.
+static void PWEnforcerWatchTargets(PWEnforcer *enforcer) {
+    if (!enforcer->source || !enforcer->source->watch) {
+        return;
+    }
+    unsigned int indexes[PW_ENFORCER_MAX_TARGETS];
+    uint32_t present = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        if (enforcer->targets[i].index) {
+            indexes[count++] = enforcer->targets[i].index;
+            present |= 1u << i;
+        }
+    }
+    if (enforcer->source->watch(enforcer->source, indexes, count)) {
+        PW_COUNTER_INC(enforcer->filterUpdates);
+        enforcer->resyncTargets = present;
+    }
+}
+
+/// Fill the interface index cache with name lookups. Only called at start-up, on
+/// explicit state changes and after overflows, never per message.
+/// Returns true if any index changed.
+static bool PWEnforcerResolveTargetIndexes(PWEnforcer *enforcer) {
+    bool changed = false;
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        PWTarget *target = &enforcer->targets[i];
+        unsigned int ifidx = if_nametoindex(target->ifname);
+        PW_COUNTER_INC(enforcer->indexLookups);
+        if (ifidx == target->index) {
+            continue;
+        }
+
+        if (ifidx) {
+            PW_LOG("Interface %s has index %u", target->ifname, ifidx);
+            // A missed departure can leave another entry holding the index
+            PWTarget *holder = PWEnforcerTargetForIndex(enforcer, ifidx);
+            if (holder) {
+                PWEnforcerSetTargetIndex(enforcer, holder, 0);
+            }
+        } else {
+            PW_LOG_ERROR("Interface %s not found - waiting for it to arrive", target->ifname);
+        }
+        PWEnforcerSetTargetIndex(enforcer, target, ifidx);
+        PW_COUNTER_INC(enforcer->indexCacheUpdates);
+        changed = true;
+    }
+    return changed;
+}
+
+PWEnforcer *PWEnforcerCreateWithTargets(const char *const *ifnames, size_t count,
+                                        PWEventSource *source, PWActuator *actuator) {
+    bool valid = actuator && ifnames && count > 0 && count <= PW_ENFORCER_MAX_TARGETS;
+    for (size_t i = 0; valid && i < count; i++) {
+        valid = ifnames[i] && ifnames[i][0] && strlen(ifnames[i]) < IFNAMSIZ;
+        for (size_t j = 0; valid && j < i; j++) {
+            valid = strcmp(ifnames[i], ifnames[j]) != 0;
+        }
+    }
+    if (!valid) {
+        PW_LOG_ERROR("Invalid enforcer configuration");
+        if (source) source->destroy(source);
+        if (actuator) actuator->destroy(actuator);
+        return NULL;
+    }
+
+    PWEnforcer *enforcer = calloc(1, sizeof(*enforcer));
+    if (!enforcer) {
+        if (source) source->destroy(source);
+        actuator->destroy(actuator);
+        return NULL;
+    }
+
+    enforcer->targetCount = count;
+    for (size_t i = 0; i < count; i++) {
+        PWTarget *target = &enforcer->targets[i];
+        strncpy(target->ifname, ifnames[i], IFNAMSIZ - 1);
+        // Start off allowing every interface to be active
+        target->allowUp = true;
+        atomic_init(&target->publishedIndex, 0);
+        atomic_init(&target->interventions, 0);
+        atomic_init(&target->resyncInterventions, 0);
+        atomic_init(&target->lastInterventionAt, 0);
+    }
+    enforcer->source = source;
+    enforcer->actuator = actuator;
+    enforcer->wakeup.fd = INVALID_FD;
+    atomic_init(&enforcer->control, PW_CONTROL_ALLOW_MASK & ((1u << count) - 1));
+    atomic_init(&enforcer->appliedGeneration, 0);
+    atomic_init(&enforcer->controlActuations, 0);
+    atomic_init(&enforcer->firstAppliedAt, 0);
+    atomic_init(&enforcer->interventionCount, 0);
+    atomic_init(&enforcer->indexLookups, 0);
+    atomic_init(&enforcer->indexLookupsAvoided, 0);
+    atomic_init(&enforcer->indexCacheUpdates, 0);
+    atomic_init(&enforcer->filterUpdates, 0);
+    atomic_init(&enforcer->overflows, 0);
+    atomic_init(&enforcer->resyncs, 0);
+    atomic_init(&enforcer->resyncInterventions, 0);
+    atomic_init(&enforcer->fastPathWrites, 0);
+    atomic_init(&enforcer->fallbackWrites, 0);
+    atomic_init(&enforcer->failedWrites, 0);
+    atomic_init(&enforcer->coalescedNotifications, 0);
+    atomic_init(&enforcer->actuatorCalls, 0);
+    atomic_init(&enforcer->memoryLockedPublished, false);
+    atomic_init(&enforcer->lockedBytes, 0);
+    atomic_init(&enforcer->loopThreadId, 0);
+
+    // The rings and histograms are large and calloc leaves them as untouched zero
+    // pages; fault them in here, before any other thread can see the enforcer
+    uint64_t prefaulted = PWMemoryPrefault(&(PWMemoryRegion){ enforcer, sizeof(*enforcer) });
+    if (source && source->copyBuffers) {
+        PWMemoryRegion buffers[PW_ENFORCER_MAX_SOURCE_BUFFERS];
+        size_t bufferCount = source->copyBuffers(source, buffers, PW_ENFORCER_MAX_SOURCE_BUFFERS);
+        for (size_t i = 0; i < bufferCount; i++) {
+            prefaulted += buffers[i].length;
+        }
+    }
+    atomic_init(&enforcer->prefaultedBytes, prefaulted);
+
+    // Wakes the loop when control threads post to the mailbox
+    if (!PWWakeupInit(&enforcer->wakeup)) {
+        PWEnforcerDestroy(enforcer);
+        return NULL;
+    }
+
+    // Even with nothing present yet, filter everything but registrations
+    PWEnforcerResolveTargetIndexes(enforcer);
+    PWEnforcerWatchTargets(enforcer);
+    return enforcer;
+}
+
+PWEnforcer *PWEnforcerCreate(const char *ifname, PWEventSource *source, PWActuator *actuator) {
+    return PWEnforcerCreateWithTargets(&ifname, 1, source, actuator);
+}
+
+void PWEnforcerSetInterventionCallback(PWEnforcer *enforcer, PWInterventionCallback callback, void *context) {
+    enforcer->interventionCallback = callback;
+    enforcer->interventionContext = context;
+}
+
+void PWEnforcerSetLifetime(PWEnforcer *enforcer, PWLifetime *lifetime) {
+    enforcer->lifetime = lifetime;
+    if (lifetime) {
+        PWMemoryRegion region = PWLifetimeGetRegion(lifetime);
+        atomic_fetch_add_explicit(&enforcer->prefaultedBytes, PWMemoryPrefault(&region), memory_order_relaxed);
+    }
+}
+
+void PWEnforcerSetStatusPage(PWEnforcer *enforcer, PWStatusPage *page) {
+    enforcer->statusPage = page;
+    // Looked up once: the loop must not make a syscall to publish
+    enforcer->pid = getpid();
+    if (page) {
+        PWMemoryRegion region = { PWStatusPageGetAddress(page), PW_STATUS_PAGE_SIZE };
+        atomic_fetch_add_explicit(&enforcer->prefaultedBytes, PWMemoryPrefault(&region), memory_order_relaxed);
+    }
+}
+
+/// Write the table's state and the counters to the status page. Must be run only on the loop thread.
+static void PWEnforcerPublishStatus(PWEnforcer *enforcer, bool running) {
+    if (!enforcer->statusPage) {
+        return;
+    }
+    PWStatusSnapshot snapshot;
+    // Zeroed so padding and unused slots publish as zeros, not stack contents
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.writerPid = enforcer->pid;
+    snapshot.running = running;
+    snapshot.targetCount = (uint32_t)enforcer->targetCount;
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        const PWTarget *target = &enforcer->targets[i];
+        PWStatusTarget *status = &snapshot.targets[i];
+        memcpy(status->ifname, target->ifname, sizeof(status->ifname));
+        status->present = target->index != 0;
+        status->allowUp = target->allowUp;
+        status->flagsKnown = target->cachedFlagsValid;
+        status->flags = target->cachedFlagsValid ? target->cachedFlags : 0;
+        status->interventions = atomic_load_explicit(&target->interventions, memory_order_relaxed);
+    }
+    snapshot.interventions = atomic_load_explicit(&enforcer->interventionCount, memory_order_relaxed);
+    snapshot.lifetimeInterventions = enforcer->lifetime ? PWLifetimeGetInterventions(enforcer->lifetime) : 0;
+    snapshot.lastInterventionAt = enforcer->lastInterventionWallAt;
+    snapshot.updatedAt = PWWallClockNanos();
+    PWStatusPagePublish(enforcer->statusPage, &snapshot);
+}
+
+bool PWEnforcerStartCapture(PWEnforcer *enforcer, const char *path) {
+    if (!enforcer->source) {
+        PW_LOG_ERROR("Cannot capture without an event source");
+        return false;
+    }
+    const PWTarget *first = &enforcer->targets[0];
+    PWCapture *capture = PWCaptureCreate(path, PW_CAPTURE_FORMAT_NATIVE, first->ifname, first->index);
+    if (!capture) {
+        return false;
+    }
+    PWCaptureDestroy(enforcer->source->capture);
+    enforcer->source->capture = capture;
+    // Replays start from the state the loop starts in
+    uint8_t allowMask = 0;
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        allowMask |= enforcer->targets[i].allowUp ? (uint8_t)(1u << i) : 0;
+    }
+    PWCaptureAppendControl(capture, PWMonotonicNanos(), allowMask);
+    return true;
+}
+
+void PWEnforcerDestroy(PWEnforcer *enforcer) {
+    if (!enforcer) {
+        return;
+    }
+    if (enforcer->memoryLocked) {
+        // The loop thread's stack may be gone by now; only the heap is ours to unlock
+        enforcer->stackRegion = (PWMemoryRegion){ 0 };
+        PWEnforcerSetMemoryLocked(enforcer, false);
+    }
+    PWWakeupDestroy(&enforcer->wakeup);
+    if (enforcer->source) {
+        PWCaptureDestroy(enforcer->source->capture);
+        enforcer->source->destroy(enforcer->source);
+    }
+    if (enforcer->actuator) {
+        enforcer->actuator->destroy(enforcer->actuator);
+    }
+    free(enforcer);
+}
+
+/// Track how long an entry stays UP from every flag word the loop learns, and add
+/// each closed interval to the lifetime counters.
+static inline void PWEnforcerNoteFlags(PWEnforcer *enforcer, PWTarget *target, uint32_t flags, uint64_t at) {
+    if (flags & IFF_UP) {
+        if (!target->upSince) {
+            target->upSince = at;
+        }
+    } else if (target->upSince) {
+        if (enforcer->lifetime && at > target->upSince) {
+            PWLifetimeAddUpTime(enforcer->lifetime, at - target->upSince);
+        }
+        target->upSince = 0;
+    }
+}
+
+/// Forget an entry's cached flag word; the next write re-reads it.
+static void PWEnforcerInvalidateFlags(PWEnforcer *enforcer, PWTarget *target) {
+    uint32_t bit = PWEnforcerSlotBit(enforcer, target);
+    target->cachedFlagsValid = false;
+    target->drainUpNotifications = 0;
+    enforcer->drainTargets &= ~bit;
+    enforcer->drainArrivals &= ~bit;
+}
+
+static bool PWEnforcerSetFlags(PWEnforcer *enforcer, PWTarget *target, uint32_t flags) {
+    PW_COUNTER_INC(enforcer->actuatorCalls);
+    if (!enforcer->actuator->setFlags(enforcer->actuator, target->ifname, flags)) {
+        PWEnforcerInvalidateFlags(enforcer, target);
+        return false;
+    }
+    // Our own write will be echoed by a link message; until then this is the best guess
+    target->cachedFlags = flags;
+    target->cachedFlagsValid = true;
+    return true;
+}
+
+/// Trace a failed flags read or write with its errno, before logging can clobber it.
+static void PWEnforcerTraceFailure(PWEnforcer *enforcer, PWTarget *target, int error) {
+    PWEnforcerTrace(enforcer, PWTraceEventWriteFailed, PWMonotonicNanos(), PWEnforcerSlot(enforcer, target),
+                    (uint64_t)error);
+}
+
+/// Bring an interface up or down with a read-modify-write. Must be run only on the loop thread.
+/// Returns true if the interface is now in the requested state, false if it is absent or an
+/// ioctl failed.
+static bool PWEnforcerApply(PWEnforcer *enforcer, PWTarget *target, bool up) {
+    if (!target->index) {
+        // Enforced from its arrival, if it ever appears
+        PW_LOG_DEBUG("%s is not present, nothing to apply", target->ifname);
+        return false;
+    }
+    uint32_t flags = 0;
+    PW_COUNTER_INC(enforcer->actuatorCalls);
+    if (!enforcer->actuator->getFlags(enforcer->actuator, target->ifname, &flags)) {
+        int error = errno;
+        PWEnforcerTraceFailure(enforcer, target, error);
+        PW_LOG_ERROR("Error getting current %s flags: %d (%s)", target->ifname, error, strerror(error));
+        PWEnforcerInvalidateFlags(enforcer, target);
+        return false;
+    }
+    target->cachedFlags = flags;
+    target->cachedFlagsValid = true;
+    PWEnforcerNoteFlags(enforcer, target, flags, PWMonotonicNanos());
+
+    if ((flags & IFF_UP) && !up) {
+        // Interface is UP but we want it DOWN
+        if (!PWEnforcerSetFlags(enforcer, target, flags & ~(uint32_t)IFF_UP)) {
+            int error = errno;
+            PWEnforcerTraceFailure(enforcer, target, error);
+            PW_LOG_ERROR("Error bringing %s down: %d (%s)", target->ifname, error, strerror(error));
+            return false;
+        }
+        uint64_t now = PWMonotonicNanos();
+        PWEnforcerNoteFlags(enforcer, target, flags & ~(uint32_t)IFF_UP, now);
+        PWEnforcerTrace(enforcer, PWTraceEventApplied, now, PWEnforcerSlot(enforcer, target),
+                        flags & ~(uint32_t)IFF_UP);
+    } else if (!(flags & IFF_UP) && up) {
+        // Interface is DOWN but we want it UP
+        if (!PWEnforcerSetFlags(enforcer, target, flags | IFF_UP)) {
+            int error = errno;
+            PWEnforcerTraceFailure(enforcer, target, error);
+            PW_LOG_ERROR("Error bringing %s up: %d (%s)", target->ifname, error, strerror(error));
+            return false;
+        }
+        uint64_t now = PWMonotonicNanos();
+        PWEnforcerNoteFlags(enforcer, target, flags | IFF_UP, now);
+        PWEnforcerTrace(enforcer, PWTraceEventApplied, now, PWEnforcerSlot(enforcer, target),
+                        flags | IFF_UP);
+    }
+    // else: interface is already in desired state, do nothing
+    return true;
+}
+
+/// Bring an interface down on the hot path. The flag word from the routing
+/// message is current, so a single SIOCSIFFLAGS replaces the get/set pair.
+/// SIOCSIFFLAGS ignores the read-only bits, so writing back what the kernel
+/// reported is equivalent to what SIOCGIFFLAGS would have returned.
+/// Returns false if the interface could not be lowered.
+static bool PWEnforcerBlock(PWEnforcer *enforcer, PWTarget *target) {
+    if (target->cachedFlagsValid) {
+        if (PWEnforcerSetFlags(enforcer, target, target->cachedFlags & ~(uint32_t)IFF_UP)) {
+            PW_COUNTER_INC(enforcer->fastPathWrites);
+            return true;
+        }
+        // Falls back to re-reading the flags below
+        PWEnforcerTraceFailure(enforcer, target, errno);
+    }
+    PW_COUNTER_INC(enforcer->fallbackWrites);
+    return PWEnforcerApply(enforcer, target, false);
+}
+
+void PWEnforcerHandleLinkEvent(void *context, const PWLinkEvent *event) {
+    PWEnforcer *enforcer = context;
+    PWTarget *target;
+
+    switch (event->type) {
+        case PWLinkEventInfo:
+            // Hot path: one table read on the cached indexes
+            PW_COUNTER_INC(enforcer->indexLookupsAvoided);
+            target = PWEnforcerTargetForIndex(enforcer, event->ifindex);
+            if (!target) {
+                // Not an interface we're watching
+                return;
+            }
+            target->cachedFlags = event->flags;
+            target->cachedFlagsValid = true;
+            PWEnforcerNoteFlags(enforcer, target, event->flags, enforcer->drainReceivedAt);
+            enforcer->drainTargets |= PWEnforcerSlotBit(enforcer, target);
+            PWEnforcerTrace(enforcer, PWTraceEventLinkInfo, enforcer->drainReceivedAt,
+                            PWEnforcerSlot(enforcer, target), event->flags);
+            if (event->flags & IFF_UP) {
+                target->drainUpNotifications++;
+            }
+            return;
+
+        case PWLinkEventArrival: {
+            bool changed = false;
+            target = PWEnforcerTargetForIndex(enforcer, event->ifindex);
+            if (target && strncmp(event->ifname, target->ifname, IFNAMSIZ) != 0) {
+                // The index now belongs to a different name
+                PWEnforcerSetTargetIndex(enforcer, target, 0);
+                PWEnforcerInvalidateFlags(enforcer, target);
+                PW_COUNTER_INC(enforcer->indexCacheUpdates);
+                changed = true;
+            }
+            target = PWEnforcerTargetForName(enforcer, event->ifname);
+            if (target) {
+                if (event->ifindex != target->index) {
+                    PW_LOG("Interface %s arrived with index %u", target->ifname, event->ifindex);
+                    PWEnforcerTrace(enforcer, PWTraceEventArrival, enforcer->drainReceivedAt,
+                                    PWEnforcerSlot(enforcer, target), event->ifindex);
+                    PWEnforcerSetTargetIndex(enforcer, target, event->ifindex);
+                    PWEnforcerInvalidateFlags(enforcer, target);
+                    PW_COUNTER_INC(enforcer->indexCacheUpdates);
+                    changed = true;
+                }
+                enforcer->drainArrivals |= PWEnforcerSlotBit(enforcer, target);
+            }
+            if (changed) {
+                PWEnforcerWatchTargets(enforcer);
+            }
+            return;
+        }
+
+        case PWLinkEventDeparture:
+            target = PWEnforcerTargetForIndex(enforcer, event->ifindex);
+            if (target) {
+                PW_LOG("Interface %s departed", target->ifname);
+                PWEnforcerTrace(enforcer, PWTraceEventDeparture, enforcer->drainReceivedAt,
+                                PWEnforcerSlot(enforcer, target), event->ifindex);
+                PWEnforcerNoteFlags(enforcer, target, 0, enforcer->drainReceivedAt);
+                PWEnforcerSetTargetIndex(enforcer, target, 0);
+                PWEnforcerInvalidateFlags(enforcer, target);
+                PW_COUNTER_INC(enforcer->indexCacheUpdates);
+                PWEnforcerWatchTargets(enforcer);
+            }
+            return;
+    }
+}
+
+/// Read an entry's flags directly, as if a link message had reported them.
+/// Returns true if the interface is UP although no message in the drain said so.
+static bool PWEnforcerResync(PWEnforcer *enforcer, PWTarget *target) {
+    uint32_t flags = 0;
+    PW_COUNTER_INC(enforcer->actuatorCalls);
+    PW_COUNTER_INC(enforcer->resyncs);
+    if (!enforcer->actuator->getFlags(enforcer->actuator, target->ifname, &flags)) {
+        PW_LOG_ERROR("Error re-reading %s flags: %d (%s)", target->ifname, errno, strerror(errno));
+        return false;
+    }
+    target->cachedFlags = flags;
+    target->cachedFlagsValid = true;
+    enforcer->drainTargets |= PWEnforcerSlotBit(enforcer, target);
+    uint64_t now = PWMonotonicNanos();
+    PWEnforcerNoteFlags(enforcer, target, flags, now);
+    PWEnforcerTrace(enforcer, PWTraceEventResync, now, PWEnforcerSlot(enforcer, target), flags);
+    if ((flags & IFF_UP) && !target->drainUpNotifications) {
+        target->drainUpNotifications = 1;
+        return true;
+    }
+    return false;
+}
+
+void PWEnforcerNoteOverflow(PWEnforcer *enforcer) {
+    enforcer->drainOverflowed = true;
+}
+
+/// Act on the final state one entry reached during the drain.
+static void PWEnforcerFinishTarget(PWEnforcer *enforcer, PWTarget *target, PWInterventionTrigger trigger) {
+    uint32_t flags = target->cachedFlags;
+    unsigned int upNotifications = target->drainUpNotifications;
+    target->drainUpNotifications = 0;
+
+    // If the interface was brought UP by the system but we want it DOWN
+    if (!(flags & IFF_UP) || target->allowUp) {
+        return;
+    }
+    uint64_t decidedAt = PWMonotonicNanos();
+    uint64_t receivedAt = enforcer->drainReceivedAt ? enforcer->drainReceivedAt : decidedAt;
+    if (!PWEnforcerBlock(enforcer, target)) {
+        // Nothing was lowered, so nothing downstream may record an intervention. The
+        // write-failed trace is already out; the next link message for it tries again.
+        PW_COUNTER_INC(enforcer->failedWrites);
+        return;
+    }
+    uint64_t actuatedAt = PWMonotonicNanos();
+    if (target->cachedFlagsValid) {
+        PWEnforcerNoteFlags(enforcer, target, target->cachedFlags, actuatedAt);
+    }
+
+    PWHistogramRecord(&enforcer->reactionTimes[PWReactionStageDecision], decidedAt - receivedAt);
+    PWHistogramRecord(&enforcer->reactionTimes[PWReactionStageActuation], actuatedAt - decidedAt);
+    PWHistogramRecord(&enforcer->reactionTimes[PWReactionStageTotal], actuatedAt - receivedAt);
+    PWEventRingPush(&enforcer->interventionEvents, receivedAt, flags, trigger,
+                    (uint32_t)(target - enforcer->targets));
+    PW_COUNTER_INC(target->interventions);
+    atomic_store_explicit(&target->lastInterventionAt, receivedAt, memory_order_relaxed);
+    PWStormDetectorRecord(&enforcer->storm, receivedAt);
+
+    // No log line here: a storm would pay for the formatting before the next drain.
+    // Traced before the count moves, so a reader that sees the count sees the record
+    PWEnforcerTrace(enforcer, PWTraceEventIntervention, actuatedAt, PWEnforcerSlot(enforcer, target),
+                    actuatedAt - receivedAt);
+    atomic_fetch_add(&enforcer->interventionCount, 1);
+    if (enforcer->lifetime || enforcer->statusPage) {
+        enforcer->lastInterventionWallAt = PWWallClockNanos();
+    }
+    if (enforcer->lifetime) {
+        uint64_t wallNow = enforcer->lastInterventionWallAt;
+        PWLifetimeRecordIntervention(enforcer->lifetime, wallNow);
+        PWLifetimeRecordBurst(enforcer->lifetime,
+                              (uint32_t)atomic_load_explicit(&enforcer->storm.windowCount, memory_order_relaxed),
+                              wallNow);
+    }
+
+    // One transition often produces several UP notifications (UP, RUNNING,
+    // LOWER_UP...); they all collapse into the single write above
+    if (upNotifications > 1) {
+        PW_COUNTER_ADD(enforcer->coalescedNotifications, upNotifications - 1);
+    }
+    if (trigger == PWInterventionTriggerResync) {
+        PW_COUNTER_INC(enforcer->resyncInterventions);
+        PW_COUNTER_INC(target->resyncInterventions);
+    }
+
+    if (enforcer->interventionCallback) {
+        enforcer->interventionCallback(enforcer->interventionContext);
+    }
+}
+
+void PWEnforcerFinishDrain(PWEnforcer *enforcer) {
+    // Lost messages may have said anything about any entry, so whatever the
+    // rest of the drain showed, read the flags of every present one before deciding
+    if (enforcer->drainOverflowed) {
+        enforcer->drainOverflowed = false;
+        PW_COUNTER_INC(enforcer->overflows);
+        PWEnforcerTrace(enforcer, PWTraceEventOverflow, PWMonotonicNanos(),
+                        atomic_load_explicit(&enforcer->overflows, memory_order_relaxed), 0);
+        for (size_t i = 0; i < enforcer->targetCount; i++) {
+            if (enforcer->targets[i].index) {
+                enforcer->resyncTargets |= 1u << i;
+            }
+        }
+    }
+    uint32_t resyncFoundUp = 0;
+    for (uint32_t pending = enforcer->resyncTargets; pending; pending &= pending - 1) {
+        PWTarget *target = &enforcer->targets[__builtin_ctz(pending)];
+        if (PWEnforcerResync(enforcer, target)) {
+            resyncFoundUp |= PWEnforcerSlotBit(enforcer, target);
+        }
+    }
+    enforcer->resyncTargets = 0;
+
+    uint32_t seen = enforcer->drainTargets;
+    uint32_t arrivals = enforcer->drainArrivals;
+    enforcer->drainTargets = 0;
+    enforcer->drainArrivals = 0;
+    for (; seen; seen &= seen - 1) {
+        uint32_t bit = seen & -seen;
+        PWInterventionTrigger trigger = (arrivals & bit) ? PWInterventionTriggerArrival
+                                      : (resyncFoundUp & bit) ? PWInterventionTriggerResync
+                                                              : PWInterventionTriggerLinkUp;
+        PWEnforcerFinishTarget(enforcer, &enforcer->targets[__builtin_ctz(seen)], trigger);
+    }
+}
+
+/// Switch one entry between allow and block mode and bring the interface in line.
+static void PWEnforcerChangeState(PWEnforcer *enforcer, PWTarget *target, bool allowUp) {
+    PWEnforcerInvalidateFlags(enforcer, target);
+    target->allowUp = allowUp;
+    PWEnforcerApply(enforcer, target, allowUp);
+}
+
+/// Bring every entry in line with a mailbox word, unless its generation is already applied.
+static void PWEnforcerApplyControl(PWEnforcer *enforcer, uint64_t word) {
+    uint64_t generation = PW_CONTROL_GENERATION(word);
+    uint64_t applied = atomic_load_explicit(&enforcer->appliedGeneration, memory_order_relaxed);
+    if (generation == applied) {
+        return;
+    }
+    uint64_t superseded = generation - applied - 1;
+    uint8_t allowMask = (uint8_t)(word & PW_CONTROL_ALLOW_MASK);
+
+    // State changes are rare; recheck the indexes in case an announcement was missed
+    if (PWEnforcerResolveTargetIndexes(enforcer)) {
+        PWEnforcerWatchTargets(enforcer);
+    }
+    uint64_t now = PWMonotonicNanos();
+    if (enforcer->source && enforcer->source->capture) {
+        PWCaptureAppendControl(enforcer->source->capture, now, allowMask);
+    }
+    PWEnforcerTrace(enforcer, PWTraceEventControl, now, allowMask, superseded);
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        PWTarget *target = &enforcer->targets[i];
+        bool allowUp = (allowMask >> i) & 1;
+        if (allowUp) {
+            PW_LOG("Bringing %s UP (enabling, %llu superseded)", target->ifname, (unsigned long long)superseded);
+        } else {
+            PW_LOG("Bringing %s DOWN (disabling, %llu superseded)", target->ifname, (unsigned long long)superseded);
+        }
+        PWEnforcerChangeState(enforcer, target, allowUp);
+    }
+    // The read-modify-writes above already saw the current flags
+    enforcer->resyncTargets = 0;
+    if (!atomic_load_explicit(&enforcer->firstAppliedAt, memory_order_relaxed)) {
+        // Launch latency: how soon a restored state reached the interfaces
+        atomic_store_explicit(&enforcer->firstAppliedAt, PWMonotonicNanos(), memory_order_relaxed);
+    }
+    PW_COUNTER_INC(enforcer->controlActuations);
+    atomic_store_explicit(&enforcer->appliedGeneration, generation, memory_order_release);
+}
+
+/// Act on the newest mailbox state. However many commands were posted since the
+/// last wakeup, each entry is actuated at most once. Returns true if the loop should exit.
+static bool PWEnforcerProcessControl(PWEnforcer *enforcer) {
+    PWWakeupConsume(&enforcer->wakeup);
+    uint64_t word = atomic_load(&enforcer->control);
+
+    // The quit bit shares the word with the state posted before it. Apply that state
+    // first, as the pipe did when it delivered 'U' ahead of 'Q', so an exit that
+    // restores the interfaces never leaves them DOWN.
+    PWEnforcerApplyControl(enforcer, word);
+    if (word & PW_CONTROL_QUIT) {
+        PW_LOG("Received quit message");
+        return true;
+    }
+    return false;
+}
+
+void PWEnforcerRun(PWEnforcer *enforcer) {
+    if (!enforcer->source) {
+        PW_LOG_ERROR("Enforcement loop has no event source");
+        return;
+    }
+    PW_LOG("Enforcement loop started for %s (%zu interface(s))", enforcer->targets[0].ifname,
+           enforcer->targetCount);
+    PWEnforcerPublishStatus(enforcer, true);
+
+    bool quit = false;
+
+    while (!quit) {
+        struct pollfd fds[] = {
+            {
+                .fd = enforcer->source->fd,
+                .events = POLLIN,
+                .revents = 0
+            },
+            {
+                .fd = enforcer->wakeup.fd,
+                .events = POLLIN,
+                .revents = 0
+            }
+        };
+
+        // Block until we get a link event or a control command
+        if (poll(fds, 2, -1) < 1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PW_LOG_ERROR("Poll error: %d (%s)", errno, strerror(errno));
+            break;
+        }
+
+        uint64_t wokeAt = PWMonotonicNanos();
+        PWEnforcerTrace(enforcer, PWTraceEventWakeup, wokeAt, fds[0].revents != 0, fds[1].revents != 0);
+
+        // Check for interface state changes
+        if (fds[0].revents) {
+            enforcer->drainReceivedAt = wokeAt;
+            enforcer->source->lastArrivalAt = 0;
+            uint64_t overflowsBefore = enforcer->source->stats.overflows;
+            if (enforcer->source->capture) {
+                PWCaptureBeginDrain(enforcer->source->capture, enforcer->drainReceivedAt);
+            }
+            if (!enforcer->source->drain(enforcer->source, PWEnforcerHandleLinkEvent, enforcer)) {
+                PW_LOG_ERROR("Event source failed, leaving enforcement loop");
+                break;
+            }
+            bool overflowed = enforcer->source->stats.overflows != overflowsBefore;
+            if (overflowed) {
+                // An announcement may have been lost too; the name lookups are cheap next to a missed UP
+                if (PWEnforcerResolveTargetIndexes(enforcer)) {
+                    PWEnforcerWatchTargets(enforcer);
+                }
+                PWEnforcerNoteOverflow(enforcer);
+            }
+            PWEnforcerFinishDrain(enforcer);
+
+            // After the decision so it costs the intervention nothing
+            uint64_t arrivedAt = enforcer->source->lastArrivalAt;
+            if (arrivedAt && arrivedAt <= enforcer->drainReceivedAt) {
+                PWHistogramRecord(&enforcer->wakeupLatency, enforcer->drainReceivedAt - arrivedAt);
+            }
+            PWEnforcerPublishStatus(enforcer, true);
+            if (overflowed) {
+                PW_LOG_ERROR("Routing socket overflowed, interface flags re-read");
+            }
+            if (enforcer->source->capture) {
+                PWCaptureFlush(enforcer->source->capture);
+            }
+        }
+
+        // Check the mailbox (enable/disable/quit)
+        if (fds[1].revents) {
+            quit = PWEnforcerProcessControl(enforcer);
+            PWEnforcerPublishStatus(enforcer, !quit);
+        }
+    }
+
+    // Close the UP intervals still open, or the lifetime total would miss them
+    uint64_t exitedAt = PWMonotonicNanos();
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        PWEnforcerNoteFlags(enforcer, &enforcer->targets[i], 0, exitedAt);
+    }
+    PWEnforcerPublishStatus(enforcer, false);
+    PW_LOG("Enforcement loop exiting");
+}
+
+// MARK: - Memory residency
+
+void PWEnforcerPrepareThread(PWEnforcer *enforcer) {
+    PWMemoryPrefaultStack(PW_MEMORY_STACK_PREFAULT_BYTES, &enforcer->stackRegion);
+    atomic_fetch_add_explicit(&enforcer->prefaultedBytes, enforcer->stackRegion.length, memory_order_relaxed);
+
+    uint64_t threadId = PWMemoryCurrentThreadId();
+    if (!PWMemoryGetFaultCounts(threadId, &enforcer->faultBaseline)) {
+        threadId = 0;
+    }
+    atomic_store_explicit(&enforcer->loopThreadId, threadId, memory_order_release);
+}
+
+/// Every region a drain and an intervention touch that the enforcer knows of.
+static size_t PWEnforcerWorkingSet(PWEnforcer *enforcer, PWMemoryRegion *regions, size_t capacity) {
+    size_t count = 0;
+    regions[count++] = (PWMemoryRegion){ enforcer, sizeof(*enforcer) };
+    if (enforcer->stackRegion.length) {
+        regions[count++] = enforcer->stackRegion;
+    }
+    if (enforcer->lifetime) {
+        regions[count++] = PWLifetimeGetRegion(enforcer->lifetime);
+    }
+    if (enforcer->statusPage) {
+        regions[count++] = (PWMemoryRegion){ PWStatusPageGetAddress(enforcer->statusPage), PW_STATUS_PAGE_SIZE };
+    }
+    if (enforcer->source && enforcer->source->copyBuffers) {
+        count += enforcer->source->copyBuffers(enforcer->source, regions + count, capacity - count);
+    }
+    return count;
+}
+
+bool PWEnforcerSetMemoryLocked(PWEnforcer *enforcer, bool locked) {
+    if (locked == enforcer->memoryLocked) {
+        return true;
+    }
+    PWMemoryRegion regions[4 + PW_ENFORCER_MAX_SOURCE_BUFFERS];
+    size_t count = PWEnforcerWorkingSet(enforcer, regions, sizeof(regions) / sizeof(regions[0]));
+
+    uint64_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!locked) {
+            PWMemoryUnlock(&regions[i]);
+        } else if (PWMemoryLock(&regions[i])) {
+            bytes += regions[i].length;
+        } else {
+            // All or nothing
+            while (i-- > 0) {
+                PWMemoryUnlock(&regions[i]);
+            }
+            return false;
+        }
+    }
+    enforcer->memoryLocked = locked;
+    atomic_store_explicit(&enforcer->lockedBytes, bytes, memory_order_relaxed);
+    atomic_store_explicit(&enforcer->memoryLockedPublished, locked, memory_order_relaxed);
+    PW_LOG("%s %llu bytes of the enforcement loop's working set", locked ? "Locked" : "Unlocked",
+           (unsigned long long)(locked ? bytes : 0));
+    return true;
+}
+
+void PWEnforcerGetMemoryStats(PWEnforcer *enforcer, PWMemoryStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->locked = atomic_load_explicit(&enforcer->memoryLockedPublished, memory_order_relaxed);
+    stats->lockedBytes = atomic_load_explicit(&enforcer->lockedBytes, memory_order_relaxed);
+    stats->prefaultedBytes = atomic_load_explicit(&enforcer->prefaultedBytes, memory_order_relaxed);
+    stats->faultsPerThread = PW_MEMORY_FAULTS_PER_THREAD;
+
+    uint64_t threadId = atomic_load_explicit(&enforcer->loopThreadId, memory_order_acquire);
+    PWFaultCounts now;
+    if (threadId && PWMemoryGetFaultCounts(threadId, &now)) {
+        stats->faultsAvailable = true;
+        stats->minorFaults = now.minorFaults - enforcer->faultBaseline.minorFaults;
+        stats->majorFaults = now.majorFaults - enforcer->faultBaseline.majorFaults;
+    }
+}
+
+// MARK: - Replay
+
+/// Sleep until the monotonic clock reaches deadline.
+static void PWEnforcerSleepUntil(uint64_t deadline) {
+    for (uint64_t now = PWMonotonicNanos(); now < deadline; now = PWMonotonicNanos()) {
+        uint64_t remaining = deadline - now;
+        struct timespec ts = { (time_t)(remaining / 1000000000ull), (long)(remaining % 1000000000ull) };
+        nanosleep(&ts, NULL);
+    }
+}
+
+bool PWEnforcerReplay(PWEnforcer *enforcer, PWCaptureReader *reader, PWReplaySpeed speed, PWReplayStats *stats) {
+    const PWCaptureFileHeader *header = PWCaptureReaderHeader(reader);
+    memset(stats, 0, sizeof(*stats));
+    if (header->format != PW_CAPTURE_FORMAT_NATIVE) {
+        PW_LOG_ERROR("Capture format %u cannot be parsed on this platform", header->format);
+        return false;
+    }
+
+    // Indexes are per machine; take the recorded one, arrivals in the capture update it.
+    // Captures name only the first table entry; the others start absent.
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        PWEnforcerSetTargetIndex(enforcer, &enforcer->targets[i], i == 0 ? header->ifindex : 0);
+        PWEnforcerInvalidateFlags(enforcer, &enforcer->targets[i]);
+    }
+
+    uint64_t replayStartedAt = PWMonotonicNanos();
+    bool inDrain = false;
+    PWCaptureRecord record;
+    while (PWCaptureReaderNext(reader, &record)) {
+        if (inDrain && record.kind != PWCaptureRecordDrainContinued && record.kind != PWCaptureRecordOverflow) {
+            PWEnforcerFinishDrain(enforcer);
+            inDrain = false;
+        }
+        if (speed == PWReplaySpeedRecorded && record.timestamp > header->startedAt) {
+            PWEnforcerSleepUntil(replayStartedAt + (record.timestamp - header->startedAt));
+        }
+
+        switch (record.kind) {
+            case PWCaptureRecordDrain:
+                enforcer->drainReceivedAt = PWMonotonicNanos();
+                inDrain = true;
+                stats->drains++;
+                // fall through
+            case PWCaptureRecordDrainContinued:
+                stats->reads++;
+                stats->messages += PWDefaultMessagesParse(record.data, record.length,
+                                                          PWEnforcerHandleLinkEvent, enforcer);
+                break;
+            case PWCaptureRecordOverflow:
+                stats->overflows++;
+                PWEnforcerNoteOverflow(enforcer);
+                break;
+            case PWCaptureRecordControl:
+                if (record.length >= 1) {
+                    for (size_t i = 0; i < enforcer->targetCount; i++) {
+                        PWEnforcerChangeState(enforcer, &enforcer->targets[i], (record.data[0] >> i) & 1);
+                    }
+                    stats->controls++;
+                }
+                break;
+        }
+    }
+    if (inDrain) {
+        PWEnforcerFinishDrain(enforcer);
+    }
+    enforcer->drainReceivedAt = 0;
+    stats->elapsedNanos = PWMonotonicNanos() - replayStartedAt;
+    return true;
+}
+
+/// Publish a new mailbox word built from the current one, then wake the loop. Only
+/// state commands advance the generation; quitting applies nothing of its own.
+static bool PWEnforcerPostControl(PWEnforcer *enforcer, uint64_t setBits, uint64_t clearBits, bool command) {
+    if (enforcer->wakeup.fd == INVALID_FD) {
+        PW_LOG_ERROR("Cannot post control command: wakeup is invalid");
+        return false;
+    }
+
+    uint64_t current = atomic_load(&enforcer->control);
+    uint64_t next;
+    do {
+        uint64_t generation = PW_CONTROL_GENERATION(current) + (command ? 1 : 0);
+        uint64_t bits = (current & (PW_CONTROL_ALLOW_MASK | PW_CONTROL_QUIT) & ~clearBits) | setBits;
+        next = (generation << PW_CONTROL_GENERATION_SHIFT) | bits;
+    } while (!atomic_compare_exchange_weak(&enforcer->control, &current, next));
+
+    return PWWakeupSignal(&enforcer->wakeup);
+}
+
+bool PWEnforcerSetPolicy(PWEnforcer *enforcer, uint32_t allowMask, uint32_t changeMask) {
+    uint64_t change = changeMask & PW_CONTROL_ALLOW_MASK & ((1u << enforcer->targetCount) - 1);
+    return PWEnforcerPostControl(enforcer, allowMask & change, ~allowMask & change, true);
+}
+
+bool PWEnforcerSetAllowUp(PWEnforcer *enforcer, bool allowUp) {
+    return PWEnforcerSetPolicy(enforcer, allowUp ? UINT32_MAX : 0, UINT32_MAX);
+}
+
+uint32_t PWEnforcerGetPolicy(PWEnforcer *enforcer) {
+    return (uint32_t)(atomic_load_explicit(&enforcer->control, memory_order_relaxed) & PW_CONTROL_ALLOW_MASK);
+}
+
+bool PWEnforcerStop(PWEnforcer *enforcer) {
+    return PWEnforcerPostControl(enforcer, PW_CONTROL_QUIT, 0, false);
+}
+
+void PWEnforcerGetControlStats(PWEnforcer *enforcer, PWControlStats *stats) {
+    stats->commands = PW_CONTROL_GENERATION(atomic_load_explicit(&enforcer->control, memory_order_relaxed));
+    stats->applied = atomic_load_explicit(&enforcer->appliedGeneration, memory_order_acquire);
+    stats->actuations = atomic_load_explicit(&enforcer->controlActuations, memory_order_relaxed);
+    stats->firstAppliedAt = atomic_load_explicit(&enforcer->firstAppliedAt, memory_order_relaxed);
+}
+
+bool PWEnforcerAwaitControl(PWEnforcer *enforcer, uint64_t timeoutNanos) {
+    uint64_t posted = PW_CONTROL_GENERATION(atomic_load(&enforcer->control));
+    uint64_t deadline = PWMonotonicNanos() + timeoutNanos;
+    // Generations only grow, so a later command that supersedes ours also satisfies the wait
+    while (atomic_load_explicit(&enforcer->appliedGeneration, memory_order_acquire) < posted) {
+        if (PWMonotonicNanos() >= deadline) {
+            return false;
+        }
+        usleep(50);
+    }
+    return true;
+}
+
+uint64_t PWEnforcerGetInterventionCount(PWEnforcer *enforcer) {
+    return atomic_load(&enforcer->interventionCount);
+}
+
+void PWEnforcerResetInterventionCount(PWEnforcer *enforcer) {
+    atomic_store(&enforcer->interventionCount, 0);
+    for (size_t i = 0; i < enforcer->targetCount; i++) {
+        atomic_store(&enforcer->targets[i].interventions, 0);
+        atomic_store(&enforcer->targets[i].resyncInterventions, 0);
+    }
+}
+
+size_t PWEnforcerGetTargetCount(PWEnforcer *enforcer) {
+    return enforcer->targetCount;
+}
+
+int PWEnforcerFindTarget(PWEnforcer *enforcer, const char *ifname) {
+    PWTarget *target = PWEnforcerTargetForName(enforcer, ifname);
+    return target ? (int)(target - enforcer->targets) : -1;
+}
+
+bool PWEnforcerGetTargetStats(PWEnforcer *enforcer, size_t slot, PWTargetStats *stats) {
+    if (slot >= enforcer->targetCount) {
+        return false;
+    }
+    PWTarget *target = &enforcer->targets[slot];
+    memcpy(stats->ifname, target->ifname, IFNAMSIZ);
+    stats->ifindex = atomic_load_explicit(&target->publishedIndex, memory_order_relaxed);
+    stats->allowUp = (PWEnforcerGetPolicy(enforcer) >> slot) & 1;
+    stats->interventions = atomic_load_explicit(&target->interventions, memory_order_relaxed);
+    stats->resyncInterventions = atomic_load_explicit(&target->resyncInterventions, memory_order_relaxed);
+    stats->lastInterventionAt = atomic_load_explicit(&target->lastInterventionAt, memory_order_relaxed);
+    return true;
+}
+
+void PWEnforcerGetIfindexCacheStats(PWEnforcer *enforcer, PWIfindexCacheStats *stats) {
+    stats->lookups = atomic_load_explicit(&enforcer->indexLookups, memory_order_relaxed);
+    stats->lookupsAvoided = atomic_load_explicit(&enforcer->indexLookupsAvoided, memory_order_relaxed);
+    stats->cacheUpdates = atomic_load_explicit(&enforcer->indexCacheUpdates, memory_order_relaxed);
+    stats->filterUpdates = atomic_load_explicit(&enforcer->filterUpdates, memory_order_relaxed);
+}
+
+void PWEnforcerGetResyncStats(PWEnforcer *enforcer, PWResyncStats *stats) {
+    stats->overflows = atomic_load_explicit(&enforcer->overflows, memory_order_relaxed);
+    stats->resyncs = atomic_load_explicit(&enforcer->resyncs, memory_order_relaxed);
+    stats->resyncInterventions = atomic_load_explicit(&enforcer->resyncInterventions, memory_order_relaxed);
+}
+
+void PWEnforcerGetActuationStats(PWEnforcer *enforcer, PWActuationStats *stats) {
+    stats->fastPathWrites = atomic_load_explicit(&enforcer->fastPathWrites, memory_order_relaxed);
+    stats->fallbackWrites = atomic_load_explicit(&enforcer->fallbackWrites, memory_order_relaxed);
+    stats->failedWrites = atomic_load_explicit(&enforcer->failedWrites, memory_order_relaxed);
+    stats->coalescedNotifications = atomic_load_explicit(&enforcer->coalescedNotifications, memory_order_relaxed);
+    stats->actuatorCalls = atomic_load_explicit(&enforcer->actuatorCalls, memory_order_relaxed);
+}
+
+void PWEnforcerCopyReactionHistogram(PWEnforcer *enforcer, PWReactionStage stage, PWHistogramSnapshot *snapshot) {
+    if ((unsigned int)stage >= PWReactionStageCount) {
+        memset(snapshot, 0, sizeof(*snapshot));
+        return;
+    }
+    PWHistogramCopy(&enforcer->reactionTimes[stage], snapshot);
+}
+
+void PWEnforcerCopyWakeupHistogram(PWEnforcer *enforcer, PWHistogramSnapshot *snapshot) {
+    PWHistogramCopy(&enforcer->wakeupLatency, snapshot);
+}
+
+size_t PWEnforcerCopyInterventionEvents(PWEnforcer *enforcer, uint64_t cursor,
+                                        PWInterventionEvent *events, size_t capacity) {
+    return PWEventRingRead(&enforcer->interventionEvents, cursor, events, capacity);
+}
+
+uint64_t PWEnforcerGetLatestInterventionSequence(PWEnforcer *enforcer) {
+    return PWEventRingHead(&enforcer->interventionEvents);
+}
+
+size_t PWEnforcerCopyTrace(PWEnforcer *enforcer, uint64_t cursor, PWTraceRecord *records, size_t capacity) {
+    return PWTraceRingRead(&enforcer->trace, cursor, records, capacity);
+}
+
+uint64_t PWEnforcerGetLatestTraceSequence(PWEnforcer *enforcer) {
+    return PWTraceRingHead(&enforcer->trace);
+}
+
+void PWEnforcerGetStormStats(PWEnforcer *enforcer, PWStormStats *stats) {
+    PWStormDetectorGetStats(&enforcer->storm, PWMonotonicNanos(), stats);
+}
+
+size_t PWEnforcerCopyStormEpisodes(PWEnforcer *enforcer, PWStormEpisode *episodes, size_t capacity) {
+    return PWStormDetectorCopyEpisodes(&enforcer->storm, PWMonotonicNanos(), episodes, capacity);
+}
@@ -0,0 +1,286 @@
+//
+//  PWEnforcer.h
+//  PingWardenHelper
+//
+//  Platform-neutral interface-state enforcement loop.
+//  Waits on a PWEventSource and a control mailbox, and uses a PWActuator to
+//  keep each interface in its policy table DOWN whenever it is not allowed to be UP.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWEnforcer_h
+#define PWEnforcer_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <net/if.h>
+
+#include "PWBackend.h"
+#include "PWEventRing.h"
+#include "PWHistogram.h"
+#include "PWLifetime.h"
+#include "PWStatusPage.h"
+#include "PWMemory.h"
+#include "PWStorm.h"
+#include "PWTrace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct PWEnforcer PWEnforcer;
+
+/// Most interfaces one enforcer's policy table can hold.
+#define PW_ENFORCER_MAX_TARGETS 8
+
+/// One policy table entry.
+typedef struct {
+    char ifname[IFNAMSIZ];
+    unsigned int ifindex;           // 0 while the interface does not exist
+    bool allowUp;                   // newest requested state
+    uint64_t interventions;         // times this interface was brought back DOWN
+    uint64_t resyncInterventions;   // of which only a resync revealed the UP
+    uint64_t lastInterventionAt;    // PWMonotonicNanos() of the latest one's wakeup, 0 if none
+} PWTargetStats;
+
+/// Interface index cache counters.
+typedef struct {
+    uint64_t lookups;          // if_nametoindex() calls
+    uint64_t lookupsAvoided;   // link messages filtered against the cached index instead
+    uint64_t cacheUpdates;     // index changes from lookups or arrival/departure events
+    uint64_t filterUpdates;    // kernel filter regenerations for a new index (PWEventSource.watch)
+} PWIfindexCacheStats;
+
+/// Receive-overflow recovery counters.
+typedef struct {
+    uint64_t overflows;            // drains in which the kernel reported dropped messages (ENOBUFS)
+    uint64_t resyncs;              // direct flag reads standing in for messages that may have been lost
+    uint64_t resyncInterventions;  // interventions on an UP that only a resync revealed
+} PWResyncStats;
+
+/// Intervention write-path counters.
+typedef struct {
+    uint64_t fastPathWrites;          // interventions done with a single SIOCSIFFLAGS from cached flags
+    uint64_t fallbackWrites;          // interventions that needed a SIOCGIFFLAGS/SIOCSIFFLAGS pair
+    uint64_t failedWrites;            // UPs left UP because both paths failed; not counted as interventions
+    uint64_t coalescedNotifications;  // extra UP notifications absorbed into an intervention already issued
+    uint64_t actuatorCalls;           // getFlags/setFlags calls, i.e. ioctl syscalls on the real actuator
+} PWActuationStats;
+
+/// Control mailbox counters.
+typedef struct {
+    uint64_t commands;    // PWEnforcerSetAllowUp/PWEnforcerSetPolicy calls
+    uint64_t applied;     // newest command the interface state reflects; equals commands once caught up
+    uint64_t actuations;  // times the loop applied a state; superseded commands never reach the interface
+    uint64_t firstAppliedAt;  // PWMonotonicNanos() when the loop finished applying its first command, 0 before
+} PWControlStats;
+
+/// Residency of the loop's working set.
+typedef struct {
+    bool locked;               // PWEnforcerSetMemoryLocked(true) is in effect
+    uint64_t lockedBytes;      // bytes mlock'd: the enforcer, the source's buffers, the loop's stack, the lifetime counters, the status page
+    uint64_t prefaultedBytes;  // bytes faulted in before the first event
+    bool faultsAvailable;      // PWEnforcerPrepareThread ran and the kernel reports faults
+    bool faultsPerThread;      // the counts are the loop thread's own, not the whole process's
+    uint64_t minorFaults;      // since PWEnforcerPrepareThread
+    uint64_t majorFaults;
+} PWMemoryStats;
+
+/// Intervention reaction-time stages, all measured on the monotonic clock.
+typedef enum {
+    PWReactionStageDecision = 0,  // routing message received -> decision to intervene
+    PWReactionStageActuation,     // decision -> SIOCSIFFLAGS returned
+    PWReactionStageTotal,         // routing message received -> SIOCSIFFLAGS returned
+    PWReactionStageCount
+} PWReactionStage;
+
+/// Create an enforcer for ifname. Takes ownership of source and actuator, which
+/// are destroyed with the enforcer (or immediately, if creation fails).
+/// source may be NULL for an enforcer that is only driven by PWEnforcerReplay.
+/// The enforcer starts in allow mode (interface may be UP). Returns NULL on failure.
+PWEnforcer *PWEnforcerCreate(const char *ifname, PWEventSource *source, PWActuator *actuator);
+
+/// Create an enforcer whose policy table holds count (1...PW_ENFORCER_MAX_TARGETS)
+/// distinct interfaces; ifnames[n] is slot n. The table is fixed for the enforcer's
+/// lifetime; interfaces in it may come and go. Otherwise as PWEnforcerCreate.
+PWEnforcer *PWEnforcerCreateWithTargets(const char *const *ifnames, size_t count,
+                                        PWEventSource *source, PWActuator *actuator);
+
+/// Called on the loop thread after every intervention, once the interface is back DOWN.
+/// Must return quickly, must not allocate and must not call back into the enforcer.
+typedef void (*PWInterventionCallback)(void *context);
+
+/// Install the intervention callback. Must be called before PWEnforcerRun.
+void PWEnforcerSetInterventionCallback(PWEnforcer *enforcer, PWInterventionCallback callback, void *context);
+
+/// Also count interventions, burst peaks and interface UP time in lifetime, which
+/// outlives the enforcer; the caller keeps ownership and closes it after
+/// PWEnforcerDestroy. The loop updates it without syscalls. Must be called before PWEnforcerRun.
+void PWEnforcerSetLifetime(PWEnforcer *enforcer, PWLifetime *lifetime);
+
+/// Publish the table's desired and actual state and the intervention counters to
+/// page whenever the loop starts, finishes a drain, applies a command or exits.
+/// The caller keeps ownership and destroys it after PWEnforcerDestroy. Publishing
+/// is a seqlock write of a few hundred bytes without syscalls. Must be called before PWEnforcerRun.
+void PWEnforcerSetStatusPage(PWEnforcer *enforcer, PWStatusPage *page);
+
+/// Append every routing socket read and allow/block change to a capture file at path,
+/// truncating it, until the enforcer is destroyed. Must be called before PWEnforcerRun.
+/// Returns false if the file could not be created.
+bool PWEnforcerStartCapture(PWEnforcer *enforcer, const char *path);
+
+/// Release all resources. The loop must not be running.
+void PWEnforcerDestroy(PWEnforcer *enforcer);
+
+/// Run the enforcement loop on the calling thread until PWEnforcerStop is called
+/// or an unrecoverable error occurs. Once running, handling link messages and
+/// intervening neither allocates nor formats log output; it leaves trace records
+/// instead (PWEnforcerCopyTrace). Only state changes, arrivals and overflow
+/// recovery log or look names up.
+void PWEnforcerRun(PWEnforcer *enforcer);
+
+/// Prefault PW_MEMORY_STACK_PREFAULT_BYTES of the calling thread's stack and start
+/// counting its page faults. Call on the thread that will run the loop, before
+/// PWEnforcerRun. The enforcer and the source's buffers are prefaulted at creation.
+void PWEnforcerPrepareThread(PWEnforcer *enforcer);
+
+/// Lock (true) or unlock the loop's working set in RAM: the enforcer, the source's
+/// buffers, the lifetime counters, the status page and the stack PWEnforcerPrepareThread prefaulted. Needs root. Not
+/// thread-safe against itself, and must not be called once the prepared thread has
+/// exited. Returns false, leaving everything unlocked, if the kernel refused.
+bool PWEnforcerSetMemoryLocked(PWEnforcer *enforcer, bool locked);
+
+/// Snapshot of the working set's residency and the loop's page faults. Thread-safe.
+void PWEnforcerGetMemoryStats(PWEnforcer *enforcer, PWMemoryStats *stats);
+
+/// Ask the loop to allow (true) or block (false) every interface in the table.
+/// Thread-safe and lock-free. Commands posted faster than the loop wakes collapse:
+/// only the newest state is applied, with one actuation.
+bool PWEnforcerSetAllowUp(PWEnforcer *enforcer, bool allowUp);
+
+/// Set the requested state of the slots in changeMask (bit n = slot n) to the
+/// matching bits of allowMask, leaving the others as they are, in one atomic
+/// mailbox update. Thread-safe and lock-free, and collapses like PWEnforcerSetAllowUp.
+bool PWEnforcerSetPolicy(PWEnforcer *enforcer, uint32_t allowMask, uint32_t changeMask);
+
+/// Newest requested state as a mask, bit n set if slot n may be UP. Thread-safe.
+uint32_t PWEnforcerGetPolicy(PWEnforcer *enforcer);
+
+/// Number of slots in the policy table.
+size_t PWEnforcerGetTargetCount(PWEnforcer *enforcer);
+
+/// Slot of ifname in the policy table, -1 if it is not in it.
+int PWEnforcerFindTarget(PWEnforcer *enforcer, const char *ifname);
+
+/// Snapshot of one table entry. Thread-safe. Returns false if slot is out of range.
+bool PWEnforcerGetTargetStats(PWEnforcer *enforcer, size_t slot, PWTargetStats *stats);
+
+/// Wait until the loop has applied every state command posted before the call, so the
+/// interfaces reflect it. Returns false after timeoutNanos, e.g. if the loop is not running.
+bool PWEnforcerAwaitControl(PWEnforcer *enforcer, uint64_t timeoutNanos);
+
+/// Ask the loop to exit. Thread-safe. A state posted before the call is applied before the
+/// loop exits, so PWEnforcerSetPolicy then PWEnforcerStop leaves the interfaces in that state.
+bool PWEnforcerStop(PWEnforcer *enforcer);
+
+/// Snapshot of the control mailbox counters. Thread-safe.
+void PWEnforcerGetControlStats(PWEnforcer *enforcer, PWControlStats *stats);
+
+/// Number of times an interface was brought back DOWN after the system raised it,
+/// across the whole table.
+uint64_t PWEnforcerGetInterventionCount(PWEnforcer *enforcer);
+
+/// Reset the intervention counters, total and per interface, to zero.
+void PWEnforcerResetInterventionCount(PWEnforcer *enforcer);
+
+/// Snapshot of the interface index cache counters. Thread-safe.
+void PWEnforcerGetIfindexCacheStats(PWEnforcer *enforcer, PWIfindexCacheStats *stats);
+
+/// Snapshot of the receive-overflow recovery counters. Thread-safe.
+void PWEnforcerGetResyncStats(PWEnforcer *enforcer, PWResyncStats *stats);
+
+/// Snapshot of the intervention write-path counters. Thread-safe.
+void PWEnforcerGetActuationStats(PWEnforcer *enforcer, PWActuationStats *stats);
+
+/// Copy the reaction-time histogram (nanoseconds) for one stage. Thread-safe.
+void PWEnforcerCopyReactionHistogram(PWEnforcer *enforcer, PWReactionStage stage, PWHistogramSnapshot *snapshot);
+
+/// Copy the wakeup-latency histogram (nanoseconds): time from an event being queued
+/// to the loop running, one sample per drain. Empty unless the source reports
+/// arrival times (PWEventSource.lastArrivalAt). Thread-safe.
+void PWEnforcerCopyWakeupHistogram(PWEnforcer *enforcer, PWHistogramSnapshot *snapshot);
+
+/// Copy up to capacity of the most recent interventions with a sequence greater
+/// than cursor (0 for everything still retained), oldest first. Thread-safe and
+/// never blocks the loop. Returns the number of events copied.
+size_t PWEnforcerCopyInterventionEvents(PWEnforcer *enforcer, uint64_t cursor,
+                                        PWInterventionEvent *events, size_t capacity);
+
+/// Sequence of the newest intervention event, 0 if there has been none. Thread-safe.
+uint64_t PWEnforcerGetLatestInterventionSequence(PWEnforcer *enforcer);
+
+/// Copy up to capacity trace records with a sequence greater than cursor, oldest
+/// first (see PWTrace.h). The loop records wakeups, link messages for the table,
+/// arrivals, departures, overflows, resyncs, interventions, failed writes and
+/// state changes here instead of logging them. Thread-safe and wait-free.
+size_t PWEnforcerCopyTrace(PWEnforcer *enforcer, uint64_t cursor, PWTraceRecord *records, size_t capacity);
+
+/// Sequence of the newest trace record, 0 if there has been none. Thread-safe.
+uint64_t PWEnforcerGetLatestTraceSequence(PWEnforcer *enforcer);
+
+/// Intervention rate (EWMA) and storm state, across the whole table, as of now. Thread-safe.
+void PWEnforcerGetStormStats(PWEnforcer *enforcer, PWStormStats *stats);
+
+/// Copy up to capacity of the most recent intervention storms (bursts faster than
+/// PW_STORM_SUSTAINED_PER_SECOND that outlast PW_STORM_BURST), oldest first.
+/// Thread-safe and never blocks the loop. Returns the number of episodes copied.
+size_t PWEnforcerCopyStormEpisodes(PWEnforcer *enforcer, PWStormEpisode *episodes, size_t capacity);
+
+// MARK: - Decision path
+
+// The loop drives these for every drain; they are exposed so tests can feed
+// events without sockets. They must only be called from the loop's thread.
+
+/// Record one link event from the current drain. Signature matches PWLinkEventHandler.
+void PWEnforcerHandleLinkEvent(void *enforcer, const PWLinkEvent *event);
+
+/// The source reported dropped messages during the current drain: the flags of every
+/// present table entry are read back directly before the drain is finished.
+void PWEnforcerNoteOverflow(PWEnforcer *enforcer);
+
+/// Act on the final state of every table entry seen during the drain and reset it.
+void PWEnforcerFinishDrain(PWEnforcer *enforcer);
+
+// MARK: - Replay
+
+typedef enum {
+    /// Feed records back to back: decision throughput.
+    PWReplaySpeedMaximum = 0,
+    /// Sleep between records to reproduce the recorded timing.
+    PWReplaySpeedRecorded,
+} PWReplaySpeed;
+
+typedef struct {
+    uint64_t drains;        // wakeups replayed
+    uint64_t reads;         // socket reads replayed
+    uint64_t messages;      // routing messages walked by the parser
+    uint64_t controls;      // allow/block changes replayed
+    uint64_t overflows;     // drains in which the recording machine's kernel dropped messages
+    uint64_t elapsedNanos;  // wall time of the whole replay
+} PWReplayStats;
+
+/// Feed a capture through the platform parser and the decision path on the calling
+/// thread, in place of PWEnforcerRun: each drain record becomes one wakeup and each
+/// control record one allow/block change. Slot 0 starts with the index it had when
+/// recorded, the other slots absent. Interventions reach the enforcer's actuator, counters, histograms and ring
+/// as they would live. Returns false if the capture is in another platform's format.
+bool PWEnforcerReplay(PWEnforcer *enforcer, PWCaptureReader *reader, PWReplaySpeed speed, PWReplayStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWEnforcer_h */
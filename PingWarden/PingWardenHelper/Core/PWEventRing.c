@@ -0,0 +1,68 @@
+//
+//  PWEventRing.c
+//  PingWardenHelper
+//
+//  Fixed-size single-producer ring of intervention events.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWEventRing.h"
+
+_Static_assert((PW_EVENT_RING_CAPACITY & (PW_EVENT_RING_CAPACITY - 1)) == 0,
+               "PW_EVENT_RING_CAPACITY must be a power of two");
+
+void PWEventRingPush(PWEventRing *ring, uint64_t timestamp, uint32_t flags, PWInterventionTrigger trigger,
+                     uint32_t target) {
+    uint64_t sequence = atomic_load_explicit(&ring->head, memory_order_relaxed) + 1;
+    PWEventRingSlot *slot = &ring->slots[sequence & (PW_EVENT_RING_CAPACITY - 1)];
+
+    // Mark the slot as in flux before touching the payload
+    atomic_store_explicit(&slot->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->timestamp, timestamp, memory_order_relaxed);
+    atomic_store_explicit(&slot->flags, flags, memory_order_relaxed);
+    atomic_store_explicit(&slot->trigger, (uint32_t)trigger, memory_order_relaxed);
+    atomic_store_explicit(&slot->target, target, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->sequence, sequence, memory_order_release);
+    atomic_store_explicit(&ring->head, sequence, memory_order_release);
+}
+
+uint64_t PWEventRingHead(const PWEventRing *ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire);
+}
+
+size_t PWEventRingRead(const PWEventRing *ring, uint64_t cursor, PWInterventionEvent *events, size_t capacity) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (cursor >= head) {
+        return 0;
+    }
+    uint64_t oldest = head > PW_EVENT_RING_CAPACITY ? head - PW_EVENT_RING_CAPACITY + 1 : 1;
+    uint64_t sequence = cursor + 1 > oldest ? cursor + 1 : oldest;
+
+    size_t count = 0;
+    for (; sequence <= head && count < capacity; sequence++) {
+        const PWEventRingSlot *slot = &ring->slots[sequence & (PW_EVENT_RING_CAPACITY - 1)];
+
+        uint64_t before = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        PWInterventionEvent event = {
+            .sequence = sequence,
+            .timestamp = atomic_load_explicit(&slot->timestamp, memory_order_relaxed),
+            .flags = (uint32_t)atomic_load_explicit(&slot->flags, memory_order_relaxed),
+            .trigger = (PWInterventionTrigger)atomic_load_explicit(&slot->trigger, memory_order_relaxed),
+            .target = (uint32_t)atomic_load_explicit(&slot->target, memory_order_relaxed),
+        };
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+
+        // Overwritten by a newer lap (or mid-write): that event is gone
+        if (before != sequence || after != sequence) {
+            continue;
+        }
+        events[count++] = event;
+    }
+    return count;
+}
@@ -0,0 +1,78 @@
+//
+//  PWEventRing.h
+//  PingWardenHelper
+//
+//  Fixed-size single-producer ring of intervention events.
+//  The enforcement thread appends with plain stores and never waits; readers
+//  fetch everything after a cursor without taking a lock. Old events are
+//  overwritten once the ring wraps.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWEventRing_h
+#define PWEventRing_h
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Must be a power of two
+#define PW_EVENT_RING_CAPACITY 256
+
+/// What made the enforcer intervene.
+typedef enum {
+    /// The system raised the interface (flag change notification).
+    PWInterventionTriggerLinkUp = 0,
+    /// The interface (re)appeared already UP.
+    PWInterventionTriggerArrival,
+    /// A direct flags read after dropped messages (or a filter change) found it UP.
+    PWInterventionTriggerResync,
+} PWInterventionTrigger;
+
+/// One intervention, as read back from the ring.
+typedef struct {
+    uint64_t sequence;   // 1-based, never reused; the cursor for the next fetch
+    uint64_t timestamp;  // PWMonotonicNanos() when the routing message was received
+    uint32_t flags;      // interface flags reported by the routing message
+    PWInterventionTrigger trigger;
+    uint32_t target;     // enforcer table slot of the interface (PWEnforcerGetTargetStats)
+} PWInterventionEvent;
+
+typedef struct {
+    // Per-slot sequence doubles as a seqlock: 0 while the slot is being written
+    atomic_uint_fast64_t sequence;
+    atomic_uint_fast64_t timestamp;
+    atomic_uint_fast32_t flags;
+    atomic_uint_fast32_t trigger;
+    atomic_uint_fast32_t target;
+} PWEventRingSlot;
+
+/// Zero-initialised memory is an empty ring.
+typedef struct {
+    atomic_uint_fast64_t head;  // sequence of the newest published event
+    PWEventRingSlot slots[PW_EVENT_RING_CAPACITY];
+} PWEventRing;
+
+/// Append an event. Must only be called from the producer thread.
+void PWEventRingPush(PWEventRing *ring, uint64_t timestamp, uint32_t flags, PWInterventionTrigger trigger,
+                     uint32_t target);
+
+/// Sequence of the newest event, or 0 if nothing was pushed yet. Thread-safe.
+uint64_t PWEventRingHead(const PWEventRing *ring);
+
+/// Copy up to capacity events with a sequence greater than cursor, oldest first.
+/// Events that were already overwritten are skipped; compare sequences to detect
+/// the gap. Thread-safe and wait-free with respect to the producer.
+size_t PWEventRingRead(const PWEventRing *ring, uint64_t cursor, PWInterventionEvent *events, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWEventRing_h */
@@ -0,0 +1,101 @@
+//
+//  PWHistogram.c
+//  PingWardenHelper
+//
+//  Fixed-size log-linear (HDR-style) latency histogram.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWHistogram.h"
+
+#define SUB_BUCKET_COUNT      (1u << PW_HISTOGRAM_SUB_BUCKET_BITS)
+#define SUB_BUCKET_HALF_COUNT (SUB_BUCKET_COUNT / 2)
+#define SUB_BUCKET_HALF_BITS  (PW_HISTOGRAM_SUB_BUCKET_BITS - 1)
+
+_Static_assert(PW_HISTOGRAM_BUCKET_COUNT ==
+               SUB_BUCKET_COUNT + (PW_HISTOGRAM_MAX_BITS - PW_HISTOGRAM_SUB_BUCKET_BITS) * SUB_BUCKET_HALF_COUNT,
+               "bucket count must cover every magnitude up to PW_HISTOGRAM_MAX_BITS");
+
+size_t PWHistogramBucketIndex(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return (size_t)value;
+    }
+    if (value >> PW_HISTOGRAM_MAX_BITS) {
+        return PW_HISTOGRAM_BUCKET_COUNT - 1;
+    }
+    // Each further power of two adds SUB_BUCKET_HALF_COUNT linear buckets,
+    // keyed by the top PW_HISTOGRAM_SUB_BUCKET_BITS bits of the value
+    unsigned int magnitude = 63u - (unsigned int)__builtin_clzll(value);
+    unsigned int shift = magnitude - SUB_BUCKET_HALF_BITS;
+    size_t subBucket = (size_t)(value >> shift) - SUB_BUCKET_HALF_COUNT;
+    return SUB_BUCKET_COUNT + (size_t)(magnitude - PW_HISTOGRAM_SUB_BUCKET_BITS) * SUB_BUCKET_HALF_COUNT + subBucket;
+}
+
+uint64_t PWHistogramBucketLowerBound(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    size_t offset = index - SUB_BUCKET_COUNT;
+    unsigned int shift = (unsigned int)(offset / SUB_BUCKET_HALF_COUNT) + 1;
+    uint64_t subBucket = (offset % SUB_BUCKET_HALF_COUNT) + SUB_BUCKET_HALF_COUNT;
+    return subBucket << shift;
+}
+
+uint64_t PWHistogramBucketUpperBound(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    unsigned int shift = (unsigned int)((index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF_COUNT) + 1;
+    return PWHistogramBucketLowerBound(index) + ((uint64_t)1 << shift) - 1;
+}
+
+void PWHistogramRecord(PWHistogram *histogram, uint64_t value) {
+    // Single writer: relaxed load/store pairs, no locked read-modify-write
+    atomic_uint_fast64_t *bucket = &histogram->counts[PWHistogramBucketIndex(value)];
+    atomic_store_explicit(bucket, atomic_load_explicit(bucket, memory_order_relaxed) + 1, memory_order_relaxed);
+    if (value > atomic_load_explicit(&histogram->max, memory_order_relaxed)) {
+        atomic_store_explicit(&histogram->max, value, memory_order_relaxed);
+    }
+}
+
+void PWHistogramCopy(const PWHistogram *histogram, PWHistogramSnapshot *snapshot) {
+    snapshot->max = atomic_load_explicit(&histogram->max, memory_order_relaxed);
+
+    // The total is recounted from the copied buckets so the snapshot stays
+    // self-consistent while records land concurrently
+    uint64_t copied = 0;
+    for (size_t i = 0; i < PW_HISTOGRAM_BUCKET_COUNT; i++) {
+        snapshot->counts[i] = atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+        copied += snapshot->counts[i];
+    }
+    snapshot->total = copied;
+}
+
+uint64_t PWHistogramValueAtPercentile(const PWHistogramSnapshot *snapshot, double percentile) {
+    if (snapshot->total == 0) {
+        return 0;
+    }
+    if (percentile < 0.0) {
+        percentile = 0.0;
+    } else if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+
+    // Rank of the requested value, 1-based, rounded up
+    uint64_t rank = (uint64_t)((percentile / 100.0) * (double)snapshot->total + 0.999999);
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < PW_HISTOGRAM_BUCKET_COUNT; i++) {
+        seen += snapshot->counts[i];
+        if (seen >= rank) {
+            uint64_t value = PWHistogramBucketUpperBound(i);
+            return value < snapshot->max ? value : snapshot->max;
+        }
+    }
+    return snapshot->max;
+}
@@ -0,0 +1,68 @@
+//
+//  PWHistogram.h
+//  PingWardenHelper
+//
+//  Fixed-size log-linear (HDR-style) latency histogram.
+//  Values are bucketed with about 3% relative precision from 1ns up to ~18
+//  minutes. Recording is a couple of shifts and a relaxed store, so it is safe
+//  on the enforcement thread; any thread may take a snapshot.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWHistogram_h
+#define PWHistogram_h
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 2^6 linear sub-buckets per power of two; values below 2^6 are exact
+#define PW_HISTOGRAM_SUB_BUCKET_BITS 6
+// Values at or above 2^40 ns are clamped into the last bucket
+#define PW_HISTOGRAM_MAX_BITS 40
+#define PW_HISTOGRAM_BUCKET_COUNT \
+    ((1 << PW_HISTOGRAM_SUB_BUCKET_BITS) + \
+     (PW_HISTOGRAM_MAX_BITS - PW_HISTOGRAM_SUB_BUCKET_BITS) * (1 << (PW_HISTOGRAM_SUB_BUCKET_BITS - 1)))
+
+/// Live histogram. Zero-initialised memory is an empty histogram.
+/// Single writer: only one thread may call PWHistogramRecord.
+typedef struct {
+    atomic_uint_fast64_t counts[PW_HISTOGRAM_BUCKET_COUNT];
+    atomic_uint_fast64_t max;
+} PWHistogram;
+
+/// Point-in-time copy of a histogram.
+typedef struct {
+    uint64_t counts[PW_HISTOGRAM_BUCKET_COUNT];
+    uint64_t total;
+    uint64_t max;
+} PWHistogramSnapshot;
+
+/// Add one value. Must only be called from the owning thread.
+void PWHistogramRecord(PWHistogram *histogram, uint64_t value);
+
+/// Copy the current counts. Thread-safe; concurrent records may or may not be included.
+void PWHistogramCopy(const PWHistogram *histogram, PWHistogramSnapshot *snapshot);
+
+/// Bucket holding value.
+size_t PWHistogramBucketIndex(uint64_t value);
+
+/// Smallest and largest values that land in bucket index.
+uint64_t PWHistogramBucketLowerBound(size_t index);
+uint64_t PWHistogramBucketUpperBound(size_t index);
+
+/// Value at percentile (0-100): the upper bound of the bucket holding that rank,
+/// capped at the recorded maximum. Returns 0 for an empty snapshot.
+uint64_t PWHistogramValueAtPercentile(const PWHistogramSnapshot *snapshot, double percentile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWHistogram_h */
@@ -0,0 +1,162 @@
+//
+//  PWInterfaceFlags.h
+//  PingWardenHelper
+//
+//  Interface flags read in-process with SIOCGIFFLAGS and getifaddrs, instead
+//  of spawning ifconfig and searching its output for "<UP". One ioctl on a
+//  datagram socket costs microseconds; a spawn costs milliseconds.
+//
+//  Everything is inline so the app can use it through its bridging header
+//  without linking the enforcement core; the helper's ioctl actuator and its
+//  snapshot use the same functions. The ifreq layout for these requests is
+//  shared by Darwin and Linux.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWInterfaceFlags_h
+#define PWInterfaceFlags_h
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <errno.h>
+#include <ifaddrs.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// One interface as getifaddrs reports it.
+typedef struct {
+    char ifname[IFNAMSIZ];
+    uint32_t flags;  // IFF_*
+} PWInterfaceInfo;
+
+/// A socket for PWInterfaceFlagsGet and PWInterfaceFlagsSet. Returns -1 on failure; close it when done.
+static inline int PWInterfaceFlagsOpenSocket(void) {
+    return socket(AF_INET, SOCK_DGRAM, 0);
+}
+
+/// Read ifname's flags (SIOCGIFFLAGS) on fd. Returns false with errno set; ENXIO
+/// (ENODEV on Linux) means the interface does not exist.
+static inline bool PWInterfaceFlagsGet(int fd, const char *ifname, uint32_t *flags) {
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    memcpy(ifr.ifr_name, ifname, strnlen(ifname, IFNAMSIZ - 1));
+    if (ioctl(fd, SIOCGIFFLAGS, &ifr) < 0) {
+        return false;
+    }
+    *flags = (uint16_t)ifr.ifr_flags;
+    return true;
+}
+
+/// Write ifname's flags (SIOCSIFFLAGS) on fd; needs root. Returns false with errno set.
+static inline bool PWInterfaceFlagsSet(int fd, const char *ifname, uint32_t flags) {
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    memcpy(ifr.ifr_name, ifname, strnlen(ifname, IFNAMSIZ - 1));
+    // ifr_flags is 16 bits wide; higher bits reported by rtnetlink are read-only
+    ifr.ifr_flags = (short)(flags & 0xffff);
+    return ioctl(fd, SIOCSIFFLAGS, &ifr) == 0;
+}
+
+/// PWInterfaceFlagsGet on a socket opened for this call, for occasional callers.
+static inline bool PWInterfaceFlagsRead(const char *ifname, uint32_t *flags) {
+    int fd = PWInterfaceFlagsOpenSocket();
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = PWInterfaceFlagsGet(fd, ifname, flags);
+    int error = errno;
+    close(fd);
+    errno = error;
+    return ok;
+}
+
+/// Every interface once, in getifaddrs order, with its flags. Writes up to capacity
+/// entries and returns how many interfaces there are (possibly more than capacity),
+/// or -1 with errno set.
+static inline int PWInterfaceFlagsList(PWInterfaceInfo *interfaces, size_t capacity) {
+    struct ifaddrs *list;
+    if (getifaddrs(&list) != 0) {
+        return -1;
+    }
+    size_t count = 0;
+    for (struct ifaddrs *entry = list; entry; entry = entry->ifa_next) {
+        // One entry per address; report each name once
+        bool seen = false;
+        for (struct ifaddrs *earlier = list; earlier != entry && !seen; earlier = earlier->ifa_next) {
+            seen = strcmp(earlier->ifa_name, entry->ifa_name) == 0;
+        }
+        if (seen) {
+            continue;
+        }
+        if (count < capacity) {
+            memset(&interfaces[count], 0, sizeof(interfaces[count]));
+            strncpy(interfaces[count].ifname, entry->ifa_name, IFNAMSIZ - 1);
+            interfaces[count].flags = entry->ifa_flags;
+        }
+        count++;
+    }
+    freeifaddrs(list);
+    return (int)count;
+}
+
+/// Format flags as ifconfig prints them, e.g. "8843<UP,BROADCAST,RUNNING,SIMPLEX,MULTICAST>".
+/// Always NUL-terminates; returns the length snprintf would have produced.
+static inline size_t PWInterfaceFlagsFormat(uint32_t flags, char *buffer, size_t size) {
+    static const struct {
+        uint32_t flag;
+        const char *name;
+    } names[] = {
+        { IFF_UP, "UP" },
+        { IFF_BROADCAST, "BROADCAST" },
+        { IFF_DEBUG, "DEBUG" },
+        { IFF_LOOPBACK, "LOOPBACK" },
+        { IFF_POINTOPOINT, "POINTOPOINT" },
+#ifdef IFF_NOTRAILERS
+        { IFF_NOTRAILERS, "NOTRAILERS" },
+#endif
+        { IFF_RUNNING, "RUNNING" },
+        { IFF_NOARP, "NOARP" },
+        { IFF_PROMISC, "PROMISC" },
+        { IFF_ALLMULTI, "ALLMULTI" },
+#ifdef IFF_OACTIVE
+        { IFF_OACTIVE, "OACTIVE" },
+#endif
+#ifdef IFF_SIMPLEX
+        { IFF_SIMPLEX, "SIMPLEX" },
+#endif
+        { IFF_MULTICAST, "MULTICAST" },
+    };
+    if (size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+    size_t length = (size_t)snprintf(buffer, size, "%x<", flags);
+    const char *separator = "";
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (flags & names[i].flag) {
+            length += (size_t)snprintf(buffer + (length < size ? length : size - 1),
+                                       length < size ? size - length : 1, "%s%s", separator, names[i].name);
+            separator = ",";
+        }
+    }
+    length += (size_t)snprintf(buffer + (length < size ? length : size - 1), length < size ? size - length : 1, ">");
+    return length;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWInterfaceFlags_h */
@@ -0,0 +1,58 @@
+//
+//  PWIoctlActuator.c
+//  PingWardenHelper
+//
+//  Interface flag actuator using SIOCGIFFLAGS/SIOCSIFFLAGS (PWInterfaceFlags.h).
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWBackend.h"
+#include "PWInterfaceFlags.h"
+#include "PWLog.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    PWActuator base;
+    // Socket to perform ioctl to set interface flags
+    int fd;
+} PWIoctlActuator;
+
+static bool PWIoctlActuatorGetFlags(PWActuator *actuator, const char *ifname, uint32_t *flags) {
+    return PWInterfaceFlagsGet(((PWIoctlActuator *)actuator)->fd, ifname, flags);
+}
+
+static bool PWIoctlActuatorSetFlags(PWActuator *actuator, const char *ifname, uint32_t flags) {
+    return PWInterfaceFlagsSet(((PWIoctlActuator *)actuator)->fd, ifname, flags);
+}
+
+static void PWIoctlActuatorDestroy(PWActuator *actuator) {
+    PWIoctlActuator *self = (PWIoctlActuator *)actuator;
+    if (self->fd >= 0) {
+        close(self->fd);
+    }
+    free(self);
+}
+
+PWActuator *PWIoctlActuatorCreate(void) {
+    PWIoctlActuator *self = calloc(1, sizeof(*self));
+    if (!self) {
+        return NULL;
+    }
+    self->base.getFlags = PWIoctlActuatorGetFlags;
+    self->base.setFlags = PWIoctlActuatorSetFlags;
+    self->base.destroy = PWIoctlActuatorDestroy;
+
+    self->fd = PWInterfaceFlagsOpenSocket();
+    if (self->fd < 0) {
+        PW_LOG_ERROR("Error creating AF_INET socket: %d (%s)", errno, strerror(errno));
+        free(self);
+        return NULL;
+    }
+    return &self->base;
+}
@@ -0,0 +1,195 @@
+//
+//  PWLifetime.c
+//  PingWardenHelper
+//
+//  Intervention statistics that outlive the helper process.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWLifetime.h"
+#include "PWClock.h"
+#include "PWLog.h"
+#include "PWStorm.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PW_LIFETIME_FILE_SIZE 4096
+#define PW_NANOS_PER_DAY (86400ull * 1000000000ull)
+
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "counters are shared through a file mapping and must not hide a lock");
+
+typedef struct {
+    atomic_uint_fast64_t day;  // UTC days since the epoch + 1, 0 for an unused bucket
+    atomic_uint_fast64_t interventions;
+} PWLifetimeDayBucket;
+
+/// The mapped file. Only the enforcement thread stores into it after PWLifetimeOpen.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;  // sizeof(PWLifetimeBlock) when initialised
+    uint64_t createdAt;
+    atomic_uint_fast64_t launches;
+    atomic_uint_fast64_t interventions;
+    atomic_uint_fast64_t lastInterventionAt;
+    atomic_uint_fast64_t maxBurstWindowCount;
+    atomic_uint_fast64_t maxBurstAt;
+    atomic_uint_fast64_t upNanos;
+    // Indexed by day modulo PW_LIFETIME_DAY_COUNT
+    PWLifetimeDayBucket days[PW_LIFETIME_DAY_COUNT];
+} PWLifetimeBlock;
+
+_Static_assert(sizeof(PWLifetimeBlock) <= PW_LIFETIME_FILE_SIZE, "the block fits in the file");
+
+struct PWLifetime {
+    int fd;
+    PWLifetimeBlock *block;
+};
+
+// Single writer, as PW_COUNTER_ADD in the enforcer
+#define PW_LIFETIME_ADD(counter, n) \
+    atomic_store_explicit(&(counter), atomic_load_explicit(&(counter), memory_order_relaxed) + (n), \
+                          memory_order_relaxed)
+
+PWLifetime *PWLifetimeOpen(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        PW_LOG_ERROR("Error opening counter file %s: %d (%s)", path, errno, strerror(errno));
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (info.st_size != PW_LIFETIME_FILE_SIZE && ftruncate(fd, PW_LIFETIME_FILE_SIZE) != 0)) {
+        PW_LOG_ERROR("Error sizing counter file %s: %d (%s)", path, errno, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    void *mapping = mmap(NULL, PW_LIFETIME_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        PW_LOG_ERROR("Error mapping counter file %s: %d (%s)", path, errno, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    PWLifetime *lifetime = calloc(1, sizeof(*lifetime));
+    if (!lifetime) {
+        munmap(mapping, PW_LIFETIME_FILE_SIZE);
+        close(fd);
+        return NULL;
+    }
+    lifetime->fd = fd;
+    lifetime->block = mapping;
+
+    PWLifetimeBlock *block = lifetime->block;
+    if (block->magic != PW_LIFETIME_MAGIC || block->version != PW_LIFETIME_VERSION ||
+        block->length != sizeof(PWLifetimeBlock)) {
+        if (block->magic) {
+            PW_LOG_ERROR("Counter file %s is damaged or from another version, starting over", path);
+        }
+        memset(block, 0, PW_LIFETIME_FILE_SIZE);
+        block->createdAt = PWWallClockNanos();
+        block->version = PW_LIFETIME_VERSION;
+        block->length = sizeof(PWLifetimeBlock);
+        // Last, so a crash while initialising is caught next time
+        block->magic = PW_LIFETIME_MAGIC;
+    }
+    atomic_fetch_add_explicit(&block->launches, 1, memory_order_relaxed);
+    return lifetime;
+}
+
+void PWLifetimeClose(PWLifetime *lifetime) {
+    if (!lifetime) {
+        return;
+    }
+    msync(lifetime->block, PW_LIFETIME_FILE_SIZE, MS_SYNC);
+    munmap(lifetime->block, PW_LIFETIME_FILE_SIZE);
+    close(lifetime->fd);
+    free(lifetime);
+}
+
+// MARK: - Recording
+
+void PWLifetimeRecordIntervention(PWLifetime *lifetime, uint64_t wallNanos) {
+    PWLifetimeBlock *block = lifetime->block;
+    uint64_t day = wallNanos / PW_NANOS_PER_DAY + 1;
+    PWLifetimeDayBucket *bucket = &block->days[day % PW_LIFETIME_DAY_COUNT];
+    if (atomic_load_explicit(&bucket->day, memory_order_relaxed) != day) {
+        // A new day takes over the bucket from the one PW_LIFETIME_DAY_COUNT days ago.
+        // Cleared first, so a reader never credits the old count to the new day
+        atomic_store_explicit(&bucket->day, 0, memory_order_relaxed);
+        atomic_store_explicit(&bucket->interventions, 0, memory_order_release);
+        atomic_store_explicit(&bucket->day, day, memory_order_release);
+    }
+    PW_LIFETIME_ADD(bucket->interventions, 1);
+    PW_LIFETIME_ADD(block->interventions, 1);
+    atomic_store_explicit(&block->lastInterventionAt, wallNanos, memory_order_relaxed);
+}
+
+void PWLifetimeRecordBurst(PWLifetime *lifetime, uint32_t windowCount, uint64_t wallNanos) {
+    PWLifetimeBlock *block = lifetime->block;
+    if (windowCount <= atomic_load_explicit(&block->maxBurstWindowCount, memory_order_relaxed)) {
+        return;
+    }
+    atomic_store_explicit(&block->maxBurstWindowCount, windowCount, memory_order_relaxed);
+    atomic_store_explicit(&block->maxBurstAt, wallNanos, memory_order_relaxed);
+}
+
+void PWLifetimeAddUpTime(PWLifetime *lifetime, uint64_t nanos) {
+    PW_LIFETIME_ADD(lifetime->block->upNanos, nanos);
+}
+
+// MARK: - Reading
+
+uint64_t PWLifetimeGetInterventions(const PWLifetime *lifetime) {
+    return atomic_load_explicit(&lifetime->block->interventions, memory_order_relaxed);
+}
+
+void PWLifetimeGetStats(const PWLifetime *lifetime, PWLifetimeStats *stats) {
+    PWLifetimeBlock *block = lifetime->block;
+    memset(stats, 0, sizeof(*stats));
+    stats->createdAt = block->createdAt;
+    stats->launches = atomic_load_explicit(&block->launches, memory_order_relaxed);
+    stats->interventions = atomic_load_explicit(&block->interventions, memory_order_relaxed);
+    stats->lastInterventionAt = atomic_load_explicit(&block->lastInterventionAt, memory_order_relaxed);
+    stats->maxBurstRate = (double)atomic_load_explicit(&block->maxBurstWindowCount, memory_order_relaxed) *
+                          (1e9 / (double)PW_STORM_WINDOW_NANOS);
+    stats->maxBurstAt = atomic_load_explicit(&block->maxBurstAt, memory_order_relaxed);
+    stats->upNanos = atomic_load_explicit(&block->upNanos, memory_order_relaxed);
+
+    for (size_t i = 0; i < PW_LIFETIME_DAY_COUNT; i++) {
+        const PWLifetimeDayBucket *bucket = &block->days[i];
+        uint64_t day = atomic_load_explicit(&bucket->day, memory_order_acquire);
+        uint64_t interventions = atomic_load_explicit(&bucket->interventions, memory_order_acquire);
+        if (!day || atomic_load_explicit(&bucket->day, memory_order_relaxed) != day) {
+            continue;
+        }
+        // Insertion sort, newest first
+        size_t position = stats->dayCount++;
+        while (position > 0 && stats->days[position - 1].day < day - 1) {
+            stats->days[position] = stats->days[position - 1];
+            position--;
+        }
+        stats->days[position].day = day - 1;
+        stats->days[position].interventions = interventions;
+    }
+}
+
+PWMemoryRegion PWLifetimeGetRegion(const PWLifetime *lifetime) {
+    return (PWMemoryRegion){ lifetime->block, PW_LIFETIME_FILE_SIZE };
+}
+
+bool PWLifetimeFlush(PWLifetime *lifetime) {
+    if (msync(lifetime->block, PW_LIFETIME_FILE_SIZE, MS_ASYNC) != 0) {
+        PW_LOG_ERROR("Error flushing counter file: %d (%s)", errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+//
+//  PWLifetime.h
+//  PingWardenHelper
+//
+//  Intervention statistics that outlive the helper process.
+//  The counters live in a memory-mapped file. The enforcement thread updates
+//  them with relaxed atomic stores straight into the mapping, with no syscalls,
+//  and any thread (or process) may read them at any time. The pages belong to
+//  the kernel's file cache, so a helper crash loses nothing. PWLifetimeFlush
+//  schedules writeback so a power loss loses at most the interval since the last one.
+//
+//  Layout: one PWLifetimeBlock at offset 0, in the byte order of the machine
+//  that wrote it. A block with the wrong magic, version or length is zeroed.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWLifetime_h
+#define PWLifetime_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "PWMemory.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PW_LIFETIME_MAGIC 0x544C5750u  // "PWLT"
+#define PW_LIFETIME_VERSION 1
+// UTC days of interventions kept, newest first when copied out
+#define PW_LIFETIME_DAY_COUNT 32
+
+typedef struct {
+    uint64_t day;            // UTC days since the epoch
+    uint64_t interventions;
+} PWLifetimeDay;
+
+typedef struct {
+    uint64_t createdAt;           // wall clock nanoseconds when the file was first initialised
+    uint64_t launches;            // helper processes that opened the file
+    uint64_t interventions;       // every intervention since createdAt, on every interface
+    uint64_t lastInterventionAt;  // wall clock nanoseconds of the newest one, 0 if none
+    double maxBurstRate;          // busiest PW_STORM_WINDOW_NANOS window ever, interventions per second
+    uint64_t maxBurstAt;          // wall clock nanoseconds when it was reached, 0 if never
+    uint64_t upNanos;             // time the controlled interfaces were seen UP, summed over interfaces
+    size_t dayCount;              // valid entries in days
+    PWLifetimeDay days[PW_LIFETIME_DAY_COUNT];  // newest first; days without interventions are omitted
+} PWLifetimeStats;
+
+typedef struct PWLifetime PWLifetime;
+
+/// Open (creating if needed, mode 0600) and map the counter file at path, and
+/// count a launch. The directory must exist. Returns NULL on failure.
+PWLifetime *PWLifetimeOpen(const char *path);
+
+/// Sync and unmap. No thread may still be recording.
+void PWLifetimeClose(PWLifetime *lifetime);
+
+// MARK: - Recording
+
+// Single writer: only one thread (the enforcement loop's) may call these.
+// Each is a handful of relaxed loads and stores into the mapping.
+
+/// Count one intervention at wallNanos (PWWallClockNanos()), in the lifetime
+/// total and its UTC day's bucket.
+void PWLifetimeRecordIntervention(PWLifetime *lifetime, uint64_t wallNanos);
+
+/// Raise the lifetime burst peak to windowCount interventions per storm window
+/// (PW_STORM_WINDOW_NANOS) if it is higher.
+void PWLifetimeRecordBurst(PWLifetime *lifetime, uint32_t windowCount, uint64_t wallNanos);
+
+/// Add a closed interval during which a controlled interface was UP.
+void PWLifetimeAddUpTime(PWLifetime *lifetime, uint64_t nanos);
+
+// MARK: - Reading
+
+/// Lifetime intervention total alone: one load, for publishing it often. Thread-safe.
+uint64_t PWLifetimeGetInterventions(const PWLifetime *lifetime);
+
+/// Snapshot of the counters. Thread-safe and never blocks the writer; a day
+/// rolling over while it runs may be left out.
+void PWLifetimeGetStats(const PWLifetime *lifetime, PWLifetimeStats *stats);
+
+/// The mapping, for locking it with the rest of the enforcement loop's working set.
+PWMemoryRegion PWLifetimeGetRegion(const PWLifetime *lifetime);
+
+/// Start writing dirty pages back to disk without waiting. Never call it from
+/// the enforcement thread. Returns false if the kernel refused.
+bool PWLifetimeFlush(PWLifetime *lifetime);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWLifetime_h */
@@ -0,0 +1,41 @@
+//
+//  PWLog.h
+//  PingWardenHelper
+//
+//  Logging shim for the portable enforcement core.
+//  Routes to os_log on Darwin and to stderr elsewhere so the same core
+//  sources build for the helper and for Linux test/benchmark binaries.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWLog_h
+#define PWLog_h
+
+#if defined(__APPLE__)
+
+#include <os/log.h>
+
+#define PW_LOG(fmt, ...)        os_log(OS_LOG_DEFAULT, fmt, ##__VA_ARGS__)
+#define PW_LOG_ERROR(fmt, ...)  os_log_error(OS_LOG_DEFAULT, fmt, ##__VA_ARGS__)
+#define PW_LOG_DEBUG(fmt, ...)  os_log_debug(OS_LOG_DEFAULT, fmt, ##__VA_ARGS__)
+
+#else
+
+#include <stdio.h>
+
+#define PW_LOG(fmt, ...)        fprintf(stderr, "[pingwarden] " fmt "\n", ##__VA_ARGS__)
+#define PW_LOG_ERROR(fmt, ...)  fprintf(stderr, "[pingwarden] error: " fmt "\n", ##__VA_ARGS__)
+
+// Debug output is compiled out unless explicitly requested; the enforcement
+// loop logs on every routing message and stderr is not free.
+#if defined(PW_DEBUG_LOGGING)
+#define PW_LOG_DEBUG(fmt, ...)  fprintf(stderr, "[pingwarden] debug: " fmt "\n", ##__VA_ARGS__)
+#else
+#define PW_LOG_DEBUG(fmt, ...)  do { if (0) fprintf(stderr, fmt "\n", ##__VA_ARGS__); } while (0)
+#endif
+
+#endif
+
+#endif /* PWLog_h */
@@ -0,0 +1,151 @@
+//
+//  PWMemory.c
+//  PingWardenHelper
+//
+//  Residency of the enforcement loop's working set.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWMemory.h"
+#include "PWLog.h"
+
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <pthread.h>
+#else
+#include <sys/syscall.h>
+#endif
+
+static size_t PWMemoryPageSize(void) {
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t)size : 4096;
+}
+
+// MARK: - Prefaulting
+
+size_t PWMemoryPrefault(const PWMemoryRegion *region) {
+    volatile uint8_t *bytes = region->address;
+    size_t page = PWMemoryPageSize();
+    // A write, not a read: reading a fresh anonymous page only maps the shared zero page
+    for (size_t offset = 0; offset < region->length; offset += page) {
+        bytes[offset] = bytes[offset];
+    }
+    if (region->length) {
+        bytes[region->length - 1] = bytes[region->length - 1];
+    }
+    return region->length;
+}
+
+__attribute__((noinline))
+void PWMemoryPrefaultStack(size_t length, PWMemoryRegion *region) {
+    volatile uint8_t frame[length];
+    size_t page = PWMemoryPageSize();
+    for (size_t offset = 0; offset < length; offset += page) {
+        frame[offset] = 0;
+    }
+    frame[length - 1] = 0;
+    region->address = (void *)frame;
+    region->length = length;
+}
+
+// MARK: - Locking
+
+/// Widen region to whole pages, as mlock may require.
+static void PWMemoryPageAlign(const PWMemoryRegion *region, void **start, size_t *length) {
+    uintptr_t mask = (uintptr_t)PWMemoryPageSize() - 1;
+    uintptr_t first = (uintptr_t)region->address & ~mask;
+    uintptr_t end = ((uintptr_t)region->address + region->length + mask) & ~mask;
+    *start = (void *)first;
+    *length = (size_t)(end - first);
+}
+
+bool PWMemoryLock(const PWMemoryRegion *region) {
+    void *start;
+    size_t length;
+    PWMemoryPageAlign(region, &start, &length);
+    if (mlock(start, length) != 0) {
+        PW_LOG_ERROR("Error locking %zu bytes: %d (%s)", length, errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool PWMemoryUnlock(const PWMemoryRegion *region) {
+    void *start;
+    size_t length;
+    PWMemoryPageAlign(region, &start, &length);
+    if (munlock(start, length) != 0) {
+        PW_LOG_ERROR("Error unlocking %zu bytes: %d (%s)", length, errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+// MARK: - Fault counters
+
+#if defined(__APPLE__)
+
+uint64_t PWMemoryCurrentThreadId(void) {
+    uint64_t threadId = 0;
+    pthread_threadid_np(NULL, &threadId);
+    return threadId;
+}
+
+bool PWMemoryGetFaultCounts(uint64_t threadId, PWFaultCounts *counts) {
+    (void)threadId;
+    task_events_info_data_t info;
+    mach_msg_type_number_t count = TASK_EVENTS_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_EVENTS_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return false;
+    }
+    // faults counts every fault; pageins are the ones that went to disk
+    uint64_t faults = (uint32_t)info.faults;
+    uint64_t pageins = (uint32_t)info.pageins;
+    counts->majorFaults = pageins;
+    counts->minorFaults = faults > pageins ? faults - pageins : 0;
+    return true;
+}
+
+#else
+
+uint64_t PWMemoryCurrentThreadId(void) {
+    return (uint64_t)syscall(SYS_gettid);
+}
+
+bool PWMemoryGetFaultCounts(uint64_t threadId, PWFaultCounts *counts) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%llu/stat", (unsigned long long)threadId);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char line[1024];
+    ssize_t length = read(fd, line, sizeof(line) - 1);
+    close(fd);
+    if (length <= 0) {
+        return false;
+    }
+    line[length] = '\0';
+
+    // The command name may hold spaces and parentheses; fields resume after the last ')'.
+    // State is field 3, minflt field 10 and majflt field 12.
+    const char *fields = strrchr(line, ')');
+    unsigned long long minor, major;
+    if (!fields || sscanf(fields + 1, " %*c %*d %*d %*d %*d %*d %*u %llu %*u %llu", &minor, &major) != 2) {
+        return false;
+    }
+    counts->minorFaults = minor;
+    counts->majorFaults = major;
+    return true;
+}
+
+#endif
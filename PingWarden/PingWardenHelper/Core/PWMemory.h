@@ -0,0 +1,72 @@
+//
+//  PWMemory.h
+//  PingWardenHelper
+//
+//  Residency of the enforcement loop's working set.
+//  Prefaulting touches every page of a region so the first routing event after
+//  start-up does not pay for zero-fill faults; locking keeps the pages in RAM
+//  while a long game session pushes everything else out. Fault counters show
+//  whether the loop still takes faults.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWMemory_h
+#define PWMemory_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Stack the enforcement thread prefaults (and locks) below its entry point: poll,
+/// a drain and an ioctl need a few KB, so this leaves a wide margin.
+#define PW_MEMORY_STACK_PREFAULT_BYTES (64 * 1024)
+
+/// Darwin only counts faults per task; Linux counts them per thread.
+#if defined(__linux__)
+#define PW_MEMORY_FAULTS_PER_THREAD 1
+#else
+#define PW_MEMORY_FAULTS_PER_THREAD 0
+#endif
+
+typedef struct {
+    void *address;
+    size_t length;
+} PWMemoryRegion;
+
+typedef struct {
+    uint64_t minorFaults;  // resolved without I/O (zero fill, copy-on-write, page cache)
+    uint64_t majorFaults;  // needed a read from disk or swap
+} PWFaultCounts;
+
+/// Write every page of region back with its own contents, so each is resident and
+/// private. Only for memory no other thread is using yet. Returns region->length.
+size_t PWMemoryPrefault(const PWMemoryRegion *region);
+
+/// Touch length bytes of the calling thread's stack below the caller's frame and
+/// describe them in region, for PWMemoryLock. Functions the caller then calls run
+/// within the touched pages.
+void PWMemoryPrefaultStack(size_t length, PWMemoryRegion *region);
+
+/// mlock/munlock the pages spanning region. Needs root (CAP_IPC_LOCK or enough
+/// RLIMIT_MEMLOCK on Linux). Locking also faults in every page.
+bool PWMemoryLock(const PWMemoryRegion *region);
+bool PWMemoryUnlock(const PWMemoryRegion *region);
+
+/// Kernel identifier of the calling thread, for PWMemoryGetFaultCounts.
+uint64_t PWMemoryCurrentThreadId(void);
+
+/// Faults taken so far by threadId (Linux), or by the whole process where the
+/// kernel only counts per task (!PW_MEMORY_FAULTS_PER_THREAD). Callable from any thread.
+bool PWMemoryGetFaultCounts(uint64_t threadId, PWFaultCounts *counts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWMemory_h */
@@ -0,0 +1,129 @@
+//
+//  PWRealtime.c
+//  PingWardenHelper
+//
+//  Opt-in realtime scheduling for the enforcement thread.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#if defined(__linux__)
+#define _GNU_SOURCE  // pthread_setaffinity_np
+#endif
+
+#include "PWRealtime.h"
+#include "PWLog.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/mach_error.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#endif
+
+#if defined(__APPLE__)
+
+/// Convert nanoseconds to mach absolute time units.
+static uint32_t PWRealtimeAbsoluteTime(uint64_t nanos) {
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    return (uint32_t)(nanos * timebase.denom / timebase.numer);
+}
+
+bool PWRealtimeEnable(pthread_t thread, const PWRealtimeConfig *config) {
+    // period 0: no fixed cadence, the thread runs whenever an event wakes it
+    thread_time_constraint_policy_data_t policy = {
+        .period = 0,
+        .computation = PWRealtimeAbsoluteTime(config->computationNanos),
+        .constraint = PWRealtimeAbsoluteTime(config->constraintNanos),
+        .preemptible = TRUE,
+    };
+    kern_return_t kr = thread_policy_set(pthread_mach_thread_np(thread), THREAD_TIME_CONSTRAINT_POLICY,
+                                         (thread_policy_t)&policy, THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+    if (kr != KERN_SUCCESS) {
+        PW_LOG_ERROR("Error setting time-constraint policy: %d (%s)", kr, mach_error_string(kr));
+        return false;
+    }
+    PW_LOG("Enforcement thread uses a time-constraint policy (%llu us within %llu us)",
+           (unsigned long long)(config->computationNanos / 1000), (unsigned long long)(config->constraintNanos / 1000));
+    return true;
+}
+
+bool PWRealtimeDisable(pthread_t thread) {
+    thread_standard_policy_data_t policy = { 0 };
+    kern_return_t kr = thread_policy_set(pthread_mach_thread_np(thread), THREAD_STANDARD_POLICY,
+                                         (thread_policy_t)&policy, THREAD_STANDARD_POLICY_COUNT);
+    if (kr != KERN_SUCCESS) {
+        PW_LOG_ERROR("Error restoring standard policy: %d (%s)", kr, mach_error_string(kr));
+        return false;
+    }
+    PW_LOG("Enforcement thread uses the standard policy");
+    return true;
+}
+
+#elif defined(__linux__)
+
+bool PWRealtimeEnable(pthread_t thread, const PWRealtimeConfig *config) {
+    struct sched_param param = { .sched_priority = config->priority };
+    int err = pthread_setschedparam(thread, SCHED_FIFO, &param);
+    if (err != 0) {
+        PW_LOG_ERROR("Error setting SCHED_FIFO: %d (%s)", err, strerror(err));
+        return false;
+    }
+
+    if (config->cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config->cpu, &cpus);
+        err = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+        if (err != 0) {
+            // Priority alone still helps; keep it rather than fail the whole mode
+            PW_LOG_ERROR("Error pinning to CPU %d: %d (%s)", config->cpu, err, strerror(err));
+        }
+    }
+    PW_LOG("Enforcement thread uses SCHED_FIFO priority %d (cpu %d)", config->priority, config->cpu);
+    return true;
+}
+
+bool PWRealtimeDisable(pthread_t thread) {
+    struct sched_param param = { .sched_priority = 0 };
+    int err = pthread_setschedparam(thread, SCHED_OTHER, &param);
+    if (err != 0) {
+        PW_LOG_ERROR("Error restoring SCHED_OTHER: %d (%s)", err, strerror(err));
+        return false;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    long count = sysconf(_SC_NPROCESSORS_CONF);
+    for (long cpu = 0; cpu < count && cpu < CPU_SETSIZE; cpu++) {
+        CPU_SET((int)cpu, &cpus);
+    }
+    err = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+    if (err != 0) {
+        PW_LOG_ERROR("Error clearing CPU affinity: %d (%s)", err, strerror(err));
+    }
+    PW_LOG("Enforcement thread uses SCHED_OTHER");
+    return true;
+}
+
+#else
+
+bool PWRealtimeEnable(pthread_t thread, const PWRealtimeConfig *config) {
+    (void)thread; (void)config;
+    PW_LOG_ERROR("Realtime scheduling is not supported on this platform");
+    return false;
+}
+
+bool PWRealtimeDisable(pthread_t thread) {
+    (void)thread;
+    return true;
+}
+
+#endif
@@ -0,0 +1,50 @@
+//
+//  PWRealtime.h
+//  PingWardenHelper
+//
+//  Opt-in realtime scheduling for the enforcement thread.
+//  A Mach time-constraint policy on Darwin; SCHED_FIFO plus optional CPU
+//  pinning on Linux. Keeps a routing event from waiting behind a game that
+//  saturates every core.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWRealtime_h
+#define PWRealtime_h
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    /// Darwin: CPU time the thread needs per wakeup, and the window it must get it in.
+    /// A drain plus one SIOCSIFFLAGS is well under computationNanos.
+    uint64_t computationNanos;
+    uint64_t constraintNanos;
+    /// Linux: SCHED_FIFO priority (1-99).
+    int priority;
+    /// Linux: CPU to pin the thread to, or -1 to leave affinity alone.
+    int cpu;
+} PWRealtimeConfig;
+
+/// 200us of CPU within 1ms, FIFO priority 50, no pinning.
+#define PW_REALTIME_CONFIG_DEFAULT { .computationNanos = 200000, .constraintNanos = 1000000, .priority = 50, .cpu = -1 }
+
+/// Give thread realtime scheduling. Needs root (or CAP_SYS_NICE on Linux).
+/// Returns false, leaving the thread as it was, if the policy was refused.
+bool PWRealtimeEnable(pthread_t thread, const PWRealtimeConfig *config);
+
+/// Return thread to the default timesharing policy and, on Linux, to every CPU.
+bool PWRealtimeDisable(pthread_t thread);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWRealtime_h */
@@ -0,0 +1,266 @@
+//
+//  PWRouteSocketSource.c
+//  PingWardenHelper
+//
+//  Darwin event source reading RTM_IFINFO messages from an AF_ROUTE socket.
+//  Based on james-howard/AWDLControl and jamestut/awdlkiller.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#if defined(__APPLE__)
+
+#include "PWBackend.h"
+#include "PWLog.h"
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <net/if_dl.h>
+#include <net/route.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Legacy single-message buffer: rt_msghdr + if_msghdr + a few sockaddr structures
+#define RTMSG_BUFFER_SIZE 512
+
+// Batched drain buffer. XNU hands out one routing record per read(), but a
+// large buffer never truncates oversized messages and lets the parser walk
+// any chain of messages a read returns in a single pass.
+#define RTMSG_BATCH_BUFFER_SIZE (64 * 1024)
+
+typedef struct {
+    PWEventSource base;
+    uint8_t *batchBuffer;
+    int receiveBufferSize;  // granted SO_RCVBUF, or 0 if unknown
+} PWRouteSocketSource;
+
+// XNU's raw_input drops a routing message when sbappendaddr finds no room and
+// never sets so_error, so read() does not reliably report ENOBUFS. A drain that
+// finds the receive buffer at least this full is treated as an overflow too.
+// sbspace() also limits the mbufs held, which can run out before the byte count
+// reaches SO_RCVBUF, so the mark is half the buffer rather than nearly all of it.
+// A false alarm costs only a flags read per controlled interface.
+static bool PWRouteSocketSourceNearlyFull(const PWRouteSocketSource *self) {
+    if (self->receiveBufferSize <= 0) {
+        return false;
+    }
+    int queued = 0;
+    if (ioctl(self->base.fd, FIONREAD, &queued) < 0) {
+        return false;
+    }
+    return queued >= self->receiveBufferSize / 2;
+}
+
+size_t PWRouteMessagesParse(const uint8_t *buf, size_t len, PWLinkEventHandler handler, void *context) {
+    size_t walked = 0;
+    size_t offset = 0;
+
+    while (len - offset >= sizeof(struct rt_msghdr)) {
+        const struct rt_msghdr *rtmsg = (const void *)(buf + offset);
+
+        // rtm_msglen must cover at least the header and stay inside what was read
+        if (rtmsg->rtm_msglen < sizeof(struct rt_msghdr) || rtmsg->rtm_msglen > len - offset) {
+            PW_LOG_DEBUG("Invalid rtm_msglen: %hu (remaining: %zu)", rtmsg->rtm_msglen, len - offset);
+            break;
+        }
+        offset += rtmsg->rtm_msglen;
+        walked++;
+
+        if (rtmsg->rtm_type == RTM_IFANNOUNCE) {
+            if (rtmsg->rtm_msglen < sizeof(struct if_announcemsghdr)) {
+                PW_LOG_DEBUG("IFANNOUNCE message too short: %hu bytes", rtmsg->rtm_msglen);
+                continue;
+            }
+            const struct if_announcemsghdr *ifan = (const void *)rtmsg;
+            if (ifan->ifan_what != IFAN_ARRIVAL && ifan->ifan_what != IFAN_DEPARTURE) {
+                continue;
+            }
+            PWLinkEvent event = {
+                .type = ifan->ifan_what == IFAN_ARRIVAL ? PWLinkEventArrival : PWLinkEventDeparture,
+                .ifindex = ifan->ifan_index,
+            };
+            memcpy(event.ifname, ifan->ifan_name, IFNAMSIZ);
+            event.ifname[IFNAMSIZ - 1] = '\0';
+            handler(context, &event);
+            continue;
+        }
+
+        if (rtmsg->rtm_type != RTM_IFINFO) {
+            continue;
+        }
+
+        // Validate we have enough data for if_msghdr
+        if (rtmsg->rtm_msglen < sizeof(struct if_msghdr)) {
+            PW_LOG_DEBUG("IFINFO message too short: %hu bytes (min %zu)", rtmsg->rtm_msglen, sizeof(struct if_msghdr));
+            continue;
+        }
+
+        const struct if_msghdr *ifmsg = (const void *)rtmsg;
+        PWLinkEvent event = {
+            .type = PWLinkEventInfo,
+            .ifindex = ifmsg->ifm_index,
+            .flags = (uint32_t)ifmsg->ifm_flags,
+        };
+        handler(context, &event);
+    }
+
+    if (offset < len && walked == 0) {
+        PW_LOG_DEBUG("Routing message too short: %zu bytes (min %zu)", len, sizeof(struct rt_msghdr));
+    }
+    return walked;
+}
+
+static bool PWRouteSocketSourceDrain(PWEventSource *source, PWLinkEventHandler handler, void *context) {
+    PWRouteSocketSource *self = (PWRouteSocketSource *)source;
+    uint8_t singleBuffer[RTMSG_BUFFER_SIZE];
+
+    uint8_t *buffer = singleBuffer;
+    size_t bufferSize = sizeof(singleBuffer);
+    if (source->drainMode == PWDrainModeBatched && self->batchBuffer) {
+        buffer = self->batchBuffer;
+        bufferSize = RTMSG_BATCH_BUFFER_SIZE;
+    }
+
+    source->stats.wakeups++;
+    if (PWRouteSocketSourceNearlyFull(self)) {
+        source->stats.overflows++;
+        if (source->capture) {
+            PWCaptureAppendOverflow(source->capture);
+        }
+    }
+    for (;;) {
+        source->stats.syscalls++;
+        ssize_t len = read(source->fd, buffer, bufferSize);
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN) {
+                break;
+            } else if (errno == ENOBUFS) {
+                // The receive buffer filled and routing messages were dropped; the
+                // enforcer re-reads the flags. Keep draining what is still queued.
+                source->stats.overflows++;
+                if (source->capture) {
+                    PWCaptureAppendOverflow(source->capture);
+                }
+                continue;
+            }
+            PW_LOG_ERROR("Error reading AF_ROUTE socket: %d (%s)", errno, strerror(errno));
+            break;  // Exit loop on unexpected errors
+        }
+        if (len == 0) {
+            break;  // Socket closed
+        }
+
+        if (source->capture) {
+            PWCaptureAppendMessages(source->capture, buffer, (size_t)len);
+        }
+        source->stats.messages += PWRouteMessagesParse(buffer, (size_t)len, handler, context);
+    }
+
+    return true;
+}
+
+static int PWRouteSocketSourceReadReceiveBufferSize(int fd) {
+    int granted = 0;
+    socklen_t length = sizeof(granted);
+    if (getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &granted, &length) < 0) {
+        return -1;
+    }
+    return granted;
+}
+
+int PWEventSourceSetReceiveBufferSize(PWEventSource *source, int bytes) {
+    PWRouteSocketSource *self = (PWRouteSocketSource *)source;
+    // Bounded by kern.ipc.maxsockbuf
+    if (setsockopt(source->fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes)) < 0) {
+        PW_LOG_ERROR("Error setting AF_ROUTE receive buffer to %d: %d (%s)", bytes, errno, strerror(errno));
+        return -1;
+    }
+    int granted = PWRouteSocketSourceReadReceiveBufferSize(source->fd);
+    if (granted > 0) {
+        self->receiveBufferSize = granted;
+    }
+    return granted;
+}
+
+static size_t PWRouteSocketSourceCopyBuffers(PWEventSource *source, PWMemoryRegion *regions, size_t capacity) {
+    PWRouteSocketSource *self = (PWRouteSocketSource *)source;
+    PWMemoryRegion buffers[] = {
+        { self, sizeof(*self) },
+        { self->batchBuffer, RTMSG_BATCH_BUFFER_SIZE },
+    };
+    size_t count = capacity < 2 ? capacity : 2;
+    memcpy(regions, buffers, count * sizeof(*regions));
+    return count;
+}
+
+static void PWRouteSocketSourceDestroy(PWEventSource *source) {
+    PWRouteSocketSource *self = (PWRouteSocketSource *)source;
+    if (source->fd >= 0) {
+        close(source->fd);
+    }
+    free(self->batchBuffer);
+    free(self);
+}
+
+PWEventSource *PWRouteSocketSourceCreateWithDescriptor(int fd) {
+    PWRouteSocketSource *self = calloc(1, sizeof(*self));
+    if (!self) {
+        close(fd);
+        return NULL;
+    }
+    self->base.fd = fd;
+    self->base.drainMode = PWDrainModeBatched;
+    self->base.drain = PWRouteSocketSourceDrain;
+    self->base.copyBuffers = PWRouteSocketSourceCopyBuffers;
+    self->base.destroy = PWRouteSocketSourceDestroy;
+    self->receiveBufferSize = PWRouteSocketSourceReadReceiveBufferSize(fd);
+
+    self->batchBuffer = malloc(RTMSG_BATCH_BUFFER_SIZE);
+    if (!self->batchBuffer) {
+        PWRouteSocketSourceDestroy(&self->base);
+        return NULL;
+    }
+    // Fault the buffer in now rather than on the first storm
+    PWMemoryRegion buffers[2];
+    for (size_t i = 0, count = PWRouteSocketSourceCopyBuffers(&self->base, buffers, 2); i < count; i++) {
+        PWMemoryPrefault(&buffers[i]);
+    }
+    return &self->base;
+}
+
+PWEventSource *PWRouteSocketSourceCreate(void) {
+    // Socket to monitor network interface changes
+    int fd = socket(AF_ROUTE, SOCK_RAW, 0);
+    if (fd < 0) {
+        PW_LOG_ERROR("Error creating AF_ROUTE socket: %d (%s)", errno, strerror(errno));
+        return NULL;
+    }
+    if (fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+        PW_LOG_ERROR("Error setting nonblock on AF_ROUTE socket: %d (%s)", errno, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    PWEventSource *source = PWRouteSocketSourceCreateWithDescriptor(fd);
+    if (source) {
+        PWEventSourceSetReceiveBufferSize(source, PW_EVENT_SOURCE_RECEIVE_BUFFER_DEFAULT);
+    }
+    return source;
+}
+
+PWEventSource *PWDefaultEventSourceCreate(void) {
+    return PWRouteSocketSourceCreate();
+}
+
+size_t PWDefaultMessagesParse(const void *buf, size_t len, PWLinkEventHandler handler, void *context) {
+    return PWRouteMessagesParse(buf, len, handler, context);
+}
+
+#endif /* __APPLE__ */
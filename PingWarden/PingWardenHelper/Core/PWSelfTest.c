@@ -0,0 +1,140 @@
+//
+//  PWSelfTest.c
+//  PingWardenHelper
+//
+//  Enforcement self-test.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWSelfTest.h"
+#include "PWClock.h"
+#include "PWInterfaceFlags.h"
+#include "PWLog.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Trace records copied per look; anything older is skipped by advancing the cursor
+#define PW_SELF_TEST_TRACE_BATCH 64
+
+/// Wait for the loop's next intervention on slot after *cursor. On success sets
+/// seenAt and downAt from the trace record and moves *cursor past it.
+static bool PWSelfTestAwaitIntervention(PWEnforcer *enforcer, size_t slot, uint64_t *cursor, uint64_t deadline,
+                                        uint64_t *seenAt, uint64_t *downAt) {
+    PWTraceRecord records[PW_SELF_TEST_TRACE_BATCH];
+    for (;;) {
+        size_t count = PWEnforcerCopyTrace(enforcer, *cursor, records, PW_SELF_TEST_TRACE_BATCH);
+        for (size_t i = 0; i < count; i++) {
+            *cursor = records[i].sequence;
+            if (records[i].event == PWTraceEventIntervention && records[i].arg0 == slot) {
+                // Stamped when SIOCSIFFLAGS returned, with the reaction time since receipt
+                *downAt = records[i].timestamp;
+                *seenAt = records[i].timestamp - records[i].arg1;
+                return true;
+            }
+        }
+        if (count == 0) {
+            if (PWMonotonicNanos() > deadline) {
+                return false;
+            }
+            // Let the loop run if it shares our CPU
+            sched_yield();
+        }
+    }
+}
+
+/// Wait until the interface reads DOWN, so each raise is a distinct UP transition.
+static bool PWSelfTestAwaitDown(int fd, const char *ifname, uint32_t *flags, uint64_t deadline) {
+    while (PWInterfaceFlagsGet(fd, ifname, flags)) {
+        if (!(*flags & IFF_UP)) {
+            return true;
+        }
+        if (PWMonotonicNanos() > deadline) {
+            return false;
+        }
+        sched_yield();
+    }
+    return false;
+}
+
+bool PWSelfTestRun(PWEnforcer *enforcer, size_t slot, uint32_t rounds,
+                   PWSelfTestSample *samples, PWSelfTestResult *result) {
+    memset(result, 0, sizeof(*result));
+    PWTargetStats target;
+    if (!PWEnforcerGetTargetStats(enforcer, slot, &target)) {
+        PW_LOG_ERROR("Self-test: no table slot %zu", slot);
+        return false;
+    }
+    if (target.allowUp) {
+        // Nothing would lower it again; the test would just leave the interface UP
+        PW_LOG_ERROR("Self-test: %s is not blocked", target.ifname);
+        return false;
+    }
+    if (rounds > PW_SELF_TEST_MAX_ROUNDS) {
+        rounds = PW_SELF_TEST_MAX_ROUNDS;
+    }
+
+    // A block still in the mailbox would lower the first raise as a state change, not an intervention
+    uint64_t deadline = PWMonotonicNanos() + PW_SELF_TEST_ROUND_TIMEOUT_NANOS;
+    PWControlStats control;
+    for (PWEnforcerGetControlStats(enforcer, &control); control.applied != control.commands;
+         PWEnforcerGetControlStats(enforcer, &control)) {
+        if (PWMonotonicNanos() > deadline) {
+            PW_LOG_ERROR("Self-test: the loop has not applied its commands");
+            return false;
+        }
+        sched_yield();
+    }
+
+    int fd = PWInterfaceFlagsOpenSocket();
+    if (fd < 0) {
+        PW_LOG_ERROR("Self-test: error creating AF_INET socket: %d (%s)", errno, strerror(errno));
+        return false;
+    }
+    PWHistogram *raiseToSeen = calloc(1, sizeof(*raiseToSeen));
+    PWHistogram *raiseToDown = calloc(1, sizeof(*raiseToDown));
+    bool ok = raiseToSeen && raiseToDown;
+
+    uint32_t flags = 0;
+    for (uint32_t round = 0; ok && round < rounds; round++) {
+        if (!PWSelfTestAwaitDown(fd, target.ifname, &flags, PWMonotonicNanos() + PW_SELF_TEST_ROUND_TIMEOUT_NANOS)) {
+            PW_LOG_ERROR("Self-test: %s is missing or stays UP: %d (%s)", target.ifname, errno, strerror(errno));
+            ok = false;
+            break;
+        }
+
+        PWSelfTestSample sample = { 0 };
+        uint64_t cursor = PWEnforcerGetLatestTraceSequence(enforcer);
+        sample.raisedAt = PWMonotonicNanos();
+        if (!PWInterfaceFlagsSet(fd, target.ifname, flags | IFF_UP)) {
+            PW_LOG_ERROR("Self-test: error raising %s: %d (%s)", target.ifname, errno, strerror(errno));
+            ok = false;
+            break;
+        }
+        result->rounds++;
+        if (PWSelfTestAwaitIntervention(enforcer, slot, &cursor, sample.raisedAt + PW_SELF_TEST_ROUND_TIMEOUT_NANOS,
+                                        &sample.seenAt, &sample.downAt)) {
+            result->lowered++;
+            // The loop may receive the UP before our SIOCSIFFLAGS has returned, never before it started
+            PWHistogramRecord(raiseToSeen, sample.seenAt > sample.raisedAt ? sample.seenAt - sample.raisedAt : 0);
+            PWHistogramRecord(raiseToDown, sample.downAt - sample.raisedAt);
+        }
+        if (samples) {
+            samples[round] = sample;
+        }
+    }
+
+    if (raiseToSeen && raiseToDown) {
+        PWHistogramCopy(raiseToSeen, &result->raiseToSeen);
+        PWHistogramCopy(raiseToDown, &result->raiseToDown);
+    }
+    free(raiseToSeen);
+    free(raiseToDown);
+    close(fd);
+    return ok;
+}
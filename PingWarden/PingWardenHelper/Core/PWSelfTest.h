@@ -0,0 +1,65 @@
+//
+//  PWSelfTest.h
+//  PingWardenHelper
+//
+//  Enforcement self-test. The calling thread raises a blocked interface N
+//  times with SIOCSIFFLAGS and, for each raise, finds the enforcement loop's
+//  intervention in its trace: when the loop received the UP and when its own
+//  SIOCSIFFLAGS(DOWN) returned, on the same monotonic clock as the raise.
+//  Nothing is spawned and nothing is polled from another process, so the
+//  distribution is the loop's reaction time and nothing else.
+//
+//  Needs the privileges to set interface flags and a running enforcement
+//  loop. Works against any interface the loop watches, so CI can run it on a
+//  Linux dummy interface (scripts/enforcement_self_test.c).
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWSelfTest_h
+#define PWSelfTest_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "PWEnforcer.h"
+#include "PWHistogram.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Upper bound on rounds per run, so one request cannot keep an interface flapping for long
+#define PW_SELF_TEST_MAX_ROUNDS 1000
+// How long a round waits for the loop before counting the raise as missed
+#define PW_SELF_TEST_ROUND_TIMEOUT_NANOS 1000000000ull
+
+/// One raise. Times are PWMonotonicNanos().
+typedef struct {
+    uint64_t raisedAt;  // just before the SIOCSIFFLAGS that set IFF_UP
+    uint64_t seenAt;    // the loop received the message (or resynced) that showed it UP; 0 if missed
+    uint64_t downAt;    // the loop's SIOCSIFFLAGS(DOWN) returned; 0 if missed
+} PWSelfTestSample;
+
+typedef struct {
+    uint32_t rounds;                  // raises made
+    uint32_t lowered;                 // of which the loop brought back DOWN within the timeout
+    PWHistogramSnapshot raiseToSeen;  // raisedAt -> seenAt
+    PWHistogramSnapshot raiseToDown;  // raisedAt -> downAt
+} PWSelfTestResult;
+
+/// Raise slot's interface rounds times (at most PW_SELF_TEST_MAX_ROUNDS), waiting after
+/// each for the loop to lower it, and fill result. samples, if not NULL, receives one
+/// entry per round. The slot must be blocked and the interface present; the interface
+/// is left DOWN. Must not be called on the enforcement thread. Returns false, logging
+/// why, if the test could not start or a raise failed.
+bool PWSelfTestRun(PWEnforcer *enforcer, size_t slot, uint32_t rounds,
+                   PWSelfTestSample *samples, PWSelfTestResult *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWSelfTest_h */
@@ -0,0 +1,164 @@
+//
+//  PWStateFile.c
+//  PingWardenHelper
+//
+//  Crash-safe record of what clients asked the helper to enforce.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWStateFile.h"
+#include "PWLog.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PW_STATE_FILE_SIZE 4096
+#define PW_STATE_FILE_SLOTS 2
+
+/// One copy of the state. The checksum covers every byte before it.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;    // sizeof(PWStateFileSlot) when written
+    uint64_t sequence;  // bumped by every save; the newest valid slot wins
+    PWPersistedState state;
+    uint32_t checksum;
+} __attribute__((aligned(64))) PWStateFileSlot;
+
+_Static_assert(sizeof(PWStateFileSlot) == 64, "slots are one cache line each");
+_Static_assert(sizeof(PWStateFileSlot) * PW_STATE_FILE_SLOTS <= PW_STATE_FILE_SIZE, "slots fit in the file");
+
+struct PWStateFile {
+    int fd;
+    volatile PWStateFileSlot *slots;
+    pthread_mutex_t lock;
+};
+
+/// CRC-32 (IEEE, reflected). Bitwise: the slot is 56 bytes and saves are rare.
+static uint32_t PWStateFileChecksum(const void *data, size_t length) {
+    const uint8_t *bytes = data;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+/// Copy a slot out of the mapping and check it. Returns its sequence, 0 if invalid.
+static uint64_t PWStateFileReadSlot(const PWStateFile *file, size_t index, PWStateFileSlot *slot) {
+    memcpy(slot, (const void *)&file->slots[index], sizeof(*slot));
+    if (slot->magic != PW_STATE_FILE_MAGIC || slot->version != PW_STATE_FILE_VERSION ||
+        slot->length != sizeof(*slot) || slot->sequence == 0) {
+        return 0;
+    }
+    if (PWStateFileChecksum(slot, offsetof(PWStateFileSlot, checksum)) != slot->checksum) {
+        return 0;
+    }
+    return slot->sequence;
+}
+
+PWStateFile *PWStateFileOpen(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        PW_LOG_ERROR("Error opening state file %s: %d (%s)", path, errno, strerror(errno));
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (info.st_size != PW_STATE_FILE_SIZE && ftruncate(fd, PW_STATE_FILE_SIZE) != 0)) {
+        PW_LOG_ERROR("Error sizing state file %s: %d (%s)", path, errno, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    void *mapping = mmap(NULL, PW_STATE_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        PW_LOG_ERROR("Error mapping state file %s: %d (%s)", path, errno, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    PWStateFile *file = calloc(1, sizeof(*file));
+    if (!file) {
+        munmap(mapping, PW_STATE_FILE_SIZE);
+        close(fd);
+        return NULL;
+    }
+    file->fd = fd;
+    file->slots = mapping;
+    pthread_mutex_init(&file->lock, NULL);
+    return file;
+}
+
+void PWStateFileClose(PWStateFile *file) {
+    if (!file) {
+        return;
+    }
+    munmap((void *)file->slots, PW_STATE_FILE_SIZE);
+    close(file->fd);
+    pthread_mutex_destroy(&file->lock);
+    free(file);
+}
+
+/// Index of the newest valid slot, or -1. Caller holds the lock.
+static int PWStateFileNewest(const PWStateFile *file, PWStateFileSlot *newest) {
+    int found = -1;
+    uint64_t best = 0;
+    for (size_t i = 0; i < PW_STATE_FILE_SLOTS; i++) {
+        PWStateFileSlot slot;
+        uint64_t sequence = PWStateFileReadSlot(file, i, &slot);
+        if (sequence > best) {
+            best = sequence;
+            found = (int)i;
+            *newest = slot;
+        }
+    }
+    return found;
+}
+
+bool PWStateFileLoad(PWStateFile *file, PWPersistedState *state) {
+    PWStateFileSlot newest;
+    pthread_mutex_lock(&file->lock);
+    int index = PWStateFileNewest(file, &newest);
+    pthread_mutex_unlock(&file->lock);
+    if (index < 0) {
+        return false;
+    }
+    *state = newest.state;
+    return true;
+}
+
+bool PWStateFileSave(PWStateFile *file, const PWPersistedState *state) {
+    pthread_mutex_lock(&file->lock);
+    PWStateFileSlot newest;
+    int index = PWStateFileNewest(file, &newest);
+
+    // Never touch the slot a crash would fall back to
+    size_t target = index < 0 ? 0 : (size_t)(index + 1) % PW_STATE_FILE_SLOTS;
+    PWStateFileSlot slot;
+    memset(&slot, 0, sizeof(slot));
+    slot.magic = PW_STATE_FILE_MAGIC;
+    slot.version = PW_STATE_FILE_VERSION;
+    slot.length = sizeof(slot);
+    slot.sequence = index < 0 ? 1 : newest.sequence + 1;
+    slot.state = *state;
+    slot.checksum = PWStateFileChecksum(&slot, offsetof(PWStateFileSlot, checksum));
+    memcpy((void *)&file->slots[target], &slot, sizeof(slot));
+
+    bool synced = msync((void *)file->slots, PW_STATE_FILE_SIZE, MS_SYNC) == 0;
+    if (!synced) {
+        PW_LOG_ERROR("Error syncing state file: %d (%s)", errno, strerror(errno));
+    }
+    pthread_mutex_unlock(&file->lock);
+    return synced;
+}
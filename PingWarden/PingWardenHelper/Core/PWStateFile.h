@@ -0,0 +1,66 @@
+//
+//  PWStateFile.h
+//  PingWardenHelper
+//
+//  Crash-safe record of what clients asked the helper to enforce.
+//  The file is one page, memory-mapped, holding two checksummed slots. A save
+//  writes the older slot and syncs it, so a crash or power loss mid-write
+//  leaves the other slot intact; a load takes the newest slot that verifies.
+//  Reading it at launch costs an open, an mmap and a few loads, so a relaunched
+//  helper enforces before any client reconnects.
+//
+//  Layout: two PWStateFileSlot structures at offsets 0 and 64, in the byte
+//  order of the machine that wrote them.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWStateFile_h
+#define PWStateFile_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PW_STATE_FILE_MAGIC 0x54535750u  // "PWST"
+#define PW_STATE_FILE_VERSION 1
+
+/// Loop thread opt-ins that survive a relaunch.
+typedef enum {
+    PWStateOptionRealtime = 1u << 0,     // PWRealtimeEnable on the loop thread
+    PWStateOptionLockMemory = 1u << 1,   // PWEnforcerSetMemoryLocked
+} PWStateOption;
+
+/// What the helper should enforce.
+typedef struct {
+    uint32_t allowMask;    // policy table, one bit per slot: set if the interface may be UP
+    uint32_t targetCount;  // table size the mask was written for
+    uint32_t options;      // PWStateOption bits
+    uint64_t savedAt;      // wall clock nanoseconds since the epoch, for diagnostics
+} PWPersistedState;
+
+typedef struct PWStateFile PWStateFile;
+
+/// Open (creating if needed, mode 0600) and map the state file at path. The
+/// directory must exist. Returns NULL on failure.
+PWStateFile *PWStateFileOpen(const char *path);
+
+void PWStateFileClose(PWStateFile *file);
+
+/// The newest slot whose checksum verifies. Returns false for a new file or if
+/// both slots are damaged; state is left untouched then. Thread-safe.
+bool PWStateFileLoad(PWStateFile *file, PWPersistedState *state);
+
+/// Write state to the older slot and sync it to disk. Blocks for the sync, so
+/// never call it from the enforcement thread. Thread-safe.
+bool PWStateFileSave(PWStateFile *file, const PWPersistedState *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWStateFile_h */
@@ -0,0 +1,99 @@
+//
+//  PWStatusPage.c
+//  PingWardenHelper
+//
+//  Read-only status page the helper publishes for the app and the widget.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWStatusPage.h"
+#include "PWLog.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+struct PWStatusPage {
+    int fd;
+    PWStatusPageLayout *layout;
+};
+
+PWStatusPage *PWStatusPageCreate(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        PW_LOG_ERROR("Error opening status page %s: %d (%s)", path, errno, strerror(errno));
+        return NULL;
+    }
+    // Whatever the umask, clients must be able to read it; nobody else may write it
+    struct stat info;
+    if (fchmod(fd, 0644) != 0 || fstat(fd, &info) != 0 ||
+        (info.st_size != PW_STATUS_PAGE_SIZE && ftruncate(fd, PW_STATUS_PAGE_SIZE) != 0)) {
+        PW_LOG_ERROR("Error preparing status page %s: %d (%s)", path, errno, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    void *mapping = mmap(NULL, PW_STATUS_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        PW_LOG_ERROR("Error mapping status page %s: %d (%s)", path, errno, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    PWStatusPage *page = calloc(1, sizeof(*page));
+    if (!page) {
+        munmap(mapping, PW_STATUS_PAGE_SIZE);
+        close(fd);
+        return NULL;
+    }
+    page->fd = fd;
+    page->layout = mapping;
+
+    PWStatusPageLayout *layout = page->layout;
+    if (atomic_load_explicit(&layout->magic, memory_order_relaxed) != PW_STATUS_PAGE_MAGIC ||
+        layout->version != PW_STATUS_PAGE_VERSION || layout->length != sizeof(PWStatusPageLayout)) {
+        // Readers check the magic first, so clear it before touching anything else
+        atomic_store_explicit(&layout->magic, 0, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        memset((uint8_t *)mapping + sizeof(layout->magic), 0, PW_STATUS_PAGE_SIZE - sizeof(layout->magic));
+        layout->version = PW_STATUS_PAGE_VERSION;
+        layout->length = sizeof(PWStatusPageLayout);
+        atomic_store_explicit(&layout->magic, PW_STATUS_PAGE_MAGIC, memory_order_release);
+    } else if (atomic_load_explicit(&layout->sequence, memory_order_relaxed) & 1) {
+        // The previous helper died mid-publish; step past the odd sequence
+        atomic_fetch_add_explicit(&layout->sequence, 1, memory_order_release);
+    }
+    return page;
+}
+
+void PWStatusPageDestroy(PWStatusPage *page) {
+    if (!page) {
+        return;
+    }
+    munmap(page->layout, PW_STATUS_PAGE_SIZE);
+    close(page->fd);
+    free(page);
+}
+
+void PWStatusPagePublish(PWStatusPage *page, const PWStatusSnapshot *snapshot) {
+    PWStatusPageLayout *layout = page->layout;
+    uint64_t sequence = atomic_load_explicit(&layout->sequence, memory_order_relaxed);
+
+    uint64_t words[PW_STATUS_PAGE_WORDS];
+    memcpy(words, snapshot, sizeof(*snapshot));
+    uint64_t number = sequence / 2 + 1;
+    memcpy((uint8_t *)words + offsetof(PWStatusSnapshot, sequence), &number, sizeof(number));
+
+    // Odd while the payload is in flux, as in PWStormDetectorRecord
+    atomic_store_explicit(&layout->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (size_t i = 0; i < PW_STATUS_PAGE_WORDS; i++) {
+        atomic_store_explicit(&layout->payload[i], words[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&layout->sequence, sequence + 2, memory_order_release);
+}
+
+void *PWStatusPageGetAddress(const PWStatusPage *page) {
+    return page->layout;
+}
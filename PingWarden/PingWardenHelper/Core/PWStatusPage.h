@@ -0,0 +1,163 @@
+//
+//  PWStatusPage.h
+//  PingWardenHelper
+//
+//  Read-only status page the helper publishes for the app and the widget.
+//  The enforcement thread writes the desired and actual state of every
+//  interface, the intervention counters and the last intervention time into
+//  a memory-mapped file under a seqlock. Clients map the file once and then
+//  read it at any rate with plain loads: no XPC message, no helper wakeup and
+//  no system call.
+//
+//  The reader is entirely inline so the app and the widget can use it through
+//  their bridging headers without linking the enforcement core; the writer
+//  lives in PWStatusPage.c.
+//
+//  Layout: one PWStatusPageLayout at offset 0 of a PW_STATUS_PAGE_SIZE file, in
+//  the byte order of the machine that wrote it.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWStatusPage_h
+#define PWStatusPage_h
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PW_STATUS_PAGE_MAGIC 0x53535750u  // "PWSS"
+#define PW_STATUS_PAGE_VERSION 1
+#define PW_STATUS_PAGE_SIZE 4096
+#define PW_STATUS_PAGE_MAX_TARGETS 8
+// Attempts a read makes while the writer keeps publishing before it gives up
+#define PW_STATUS_PAGE_READ_ATTEMPTS 64
+
+/// One interface of the helper's policy table.
+typedef struct {
+    char ifname[16];         // IFNAMSIZ
+    bool present;            // the interface exists
+    bool allowUp;            // desired state: may be UP
+    bool flagsKnown;         // flags holds a value the loop has seen
+    uint32_t flags;          // actual interface flags, as of the loop's latest message, read or write
+    uint64_t interventions;  // by this helper process
+} PWStatusTarget;
+
+/// Everything a client needs to draw its state.
+typedef struct {
+    uint64_t sequence;            // publishes so far, 1-based; unchanged means nothing changed
+    int64_t writerPid;            // helper process that published
+    uint32_t running;             // 1 while the enforcement loop runs; a crashed helper leaves it set
+    uint32_t targetCount;
+    PWStatusTarget targets[PW_STATUS_PAGE_MAX_TARGETS];
+    uint64_t interventions;          // by this helper process, every interface
+    uint64_t lifetimeInterventions;  // across every helper process (PWLifetime), 0 if unavailable
+    uint64_t lastInterventionAt;     // wall clock nanoseconds since the epoch, 0 if none yet
+    uint64_t updatedAt;              // wall clock nanoseconds of this publish
+} PWStatusSnapshot;
+
+#define PW_STATUS_PAGE_WORDS (sizeof(PWStatusSnapshot) / sizeof(uint64_t))
+
+/// The mapped file. The payload is the snapshot's bytes as 64-bit words, so both
+/// sides copy it with relaxed atomic loads and stores under the sequence.
+typedef struct {
+    _Atomic(uint32_t) magic;     // stored last when the page is initialised
+    uint16_t version;
+    uint16_t length;             // sizeof(PWStatusPageLayout)
+    atomic_uint_fast64_t sequence;  // odd while the writer is publishing
+    atomic_uint_fast64_t payload[PW_STATUS_PAGE_WORDS];
+} PWStatusPageLayout;
+
+_Static_assert(sizeof(PWStatusSnapshot) % sizeof(uint64_t) == 0, "the snapshot is copied in whole words");
+_Static_assert(sizeof(PWStatusPageLayout) <= PW_STATUS_PAGE_SIZE, "the layout fits in the page");
+
+// MARK: - Reading
+
+/// Map the status page at path read-only. Returns NULL if it does not exist (the
+/// helper has never run) or cannot be mapped. The mapping stays valid across helper
+/// restarts, which reuse the file. Release it with PWStatusPageUnmap.
+static inline const void *PWStatusPageMap(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= PW_STATUS_PAGE_SIZE) {
+        mapping = mmap(NULL, PW_STATUS_PAGE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    return mapping == MAP_FAILED ? NULL : mapping;
+}
+
+static inline void PWStatusPageUnmap(const void *mapping) {
+    if (mapping) {
+        munmap((void *)mapping, PW_STATUS_PAGE_SIZE);
+    }
+}
+
+/// Copy a consistent snapshot out of a mapping from PWStatusPageMap. Plain loads
+/// only; never blocks the writer. Returns false if nothing has been published yet,
+/// the page is from another version, or the writer kept it busy for every attempt.
+static inline bool PWStatusPageRead(const void *mapping, PWStatusSnapshot *snapshot) {
+    const PWStatusPageLayout *page = (const PWStatusPageLayout *)mapping;
+    if (atomic_load_explicit(&page->magic, memory_order_acquire) != PW_STATUS_PAGE_MAGIC ||
+        page->version != PW_STATUS_PAGE_VERSION || page->length != sizeof(PWStatusPageLayout)) {
+        return false;
+    }
+    uint64_t words[PW_STATUS_PAGE_WORDS];
+    for (int attempt = 0; attempt < PW_STATUS_PAGE_READ_ATTEMPTS; attempt++) {
+        uint64_t before = atomic_load_explicit(&page->sequence, memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (before & 1) {
+            continue;
+        }
+        for (size_t i = 0; i < PW_STATUS_PAGE_WORDS; i++) {
+            words[i] = atomic_load_explicit(&page->payload[i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&page->sequence, memory_order_relaxed) == before) {
+            memcpy(snapshot, words, sizeof(*snapshot));
+            return true;
+        }
+    }
+    return false;
+}
+
+// MARK: - Writing
+
+typedef struct PWStatusPage PWStatusPage;
+
+/// Open (creating if needed, mode 0644 so clients can read it) and map the status
+/// page at path for writing. An existing page keeps its sequence, so clients mapped
+/// to it see the new helper's publishes. The directory must exist. Returns NULL on failure.
+PWStatusPage *PWStatusPageCreate(const char *path);
+
+/// Unmap. The file stays for clients; the last publish should say running = 0.
+void PWStatusPageDestroy(PWStatusPage *page);
+
+/// Publish snapshot, numbering it (snapshot->sequence is ignored). Single writer:
+/// only one thread may publish. Relaxed stores into the mapping, no system calls.
+void PWStatusPagePublish(PWStatusPage *page, const PWStatusSnapshot *snapshot);
+
+/// The writable mapping, for locking it with the rest of the enforcement loop's working set.
+void *PWStatusPageGetAddress(const PWStatusPage *page);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWStatusPage_h */
@@ -0,0 +1,172 @@
+//
+//  PWStorm.c
+//  PingWardenHelper
+//
+//  Streaming intervention-rate estimator and storm detector.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWStorm.h"
+
+_Static_assert((PW_STORM_EPISODE_CAPACITY & (PW_STORM_EPISODE_CAPACITY - 1)) == 0,
+               "PW_STORM_EPISODE_CAPACITY must be a power of two");
+_Static_assert(1000000000ull % PW_STORM_WINDOW_NANOS == 0, "windows must divide a second");
+
+#define PW_STORM_WINDOWS_PER_SECOND (1000000000ull / PW_STORM_WINDOW_NANOS)
+
+// Token bucket in its GCRA form: one token per interval, and an intervention
+// conforms while it is at most tolerance ahead of the schedule (a full bucket
+// absorbs PW_STORM_BURST back to back)
+#define PW_STORM_INTERVAL_NANOS (1000000000ull / PW_STORM_SUSTAINED_PER_SECOND)
+#define PW_STORM_TOLERANCE_NANOS ((PW_STORM_BURST - 1) * PW_STORM_INTERVAL_NANOS)
+
+// MARK: - Rate
+
+/// Fold every window that ended by now into the EWMA: the open window's count,
+/// then a zero for each empty window since.
+static uint64_t PWStormAdvance(uint64_t rateMilli, uint64_t *windowStart, uint32_t *windowCount, uint64_t now) {
+    if (now < *windowStart + PW_STORM_WINDOW_NANOS) {
+        return rateMilli;
+    }
+    uint64_t windows = (now - *windowStart) / PW_STORM_WINDOW_NANOS;
+    uint64_t sample = (uint64_t)*windowCount * PW_STORM_WINDOWS_PER_SECOND * 1000;
+    rateMilli = rateMilli - (rateMilli >> PW_STORM_EWMA_SHIFT) + (sample >> PW_STORM_EWMA_SHIFT);
+    for (uint64_t i = 1; i < windows && rateMilli; i++) {
+        uint64_t decay = rateMilli >> PW_STORM_EWMA_SHIFT;
+        rateMilli -= decay ? decay : rateMilli;
+    }
+    *windowStart += windows * PW_STORM_WINDOW_NANOS;
+    *windowCount = 0;
+    return rateMilli;
+}
+
+static double PWStormWindowRate(uint32_t windowCount) {
+    return (double)windowCount * PW_STORM_WINDOWS_PER_SECOND;
+}
+
+// MARK: - Recording
+
+static void PWStormPublishEpisode(PWStormDetector *detector, uint64_t sequence, uint64_t lastAt) {
+    PWStormEpisodeSlot *slot = &detector->slots[sequence & (PW_STORM_EPISODE_CAPACITY - 1)];
+
+    // Mark the slot as in flux before touching the payload
+    atomic_store_explicit(&slot->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->startedAt, detector->runStartedAt, memory_order_relaxed);
+    atomic_store_explicit(&slot->lastAt, lastAt, memory_order_relaxed);
+    atomic_store_explicit(&slot->endsBy, detector->readyAt, memory_order_relaxed);
+    atomic_store_explicit(&slot->interventions, detector->runInterventions, memory_order_relaxed);
+    atomic_store_explicit(&slot->peakWindowCount, detector->runPeakWindowCount, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->sequence, sequence, memory_order_release);
+    atomic_store_explicit(&detector->head, sequence, memory_order_release);
+}
+
+void PWStormDetectorRecord(PWStormDetector *detector, uint64_t timestamp) {
+    uint64_t version = atomic_load_explicit(&detector->version, memory_order_relaxed);
+    atomic_store_explicit(&detector->version, version + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    uint64_t windowStart = atomic_load_explicit(&detector->windowStart, memory_order_relaxed);
+    uint32_t windowCount = (uint32_t)atomic_load_explicit(&detector->windowCount, memory_order_relaxed);
+    uint64_t rateMilli = PWStormAdvance(atomic_load_explicit(&detector->rateMilli, memory_order_relaxed),
+                                        &windowStart, &windowCount, timestamp);
+    windowCount++;
+    atomic_store_explicit(&detector->rateMilli, rateMilli, memory_order_relaxed);
+    atomic_store_explicit(&detector->windowStart, windowStart, memory_order_relaxed);
+    atomic_store_explicit(&detector->windowCount, windowCount, memory_order_relaxed);
+    if (windowCount > atomic_load_explicit(&detector->peakWindowCount, memory_order_relaxed)) {
+        atomic_store_explicit(&detector->peakWindowCount, windowCount, memory_order_relaxed);
+    }
+
+    // A full bucket ends any episode and starts a new run
+    if (detector->readyAt <= timestamp) {
+        detector->storming = false;
+        detector->readyAt = timestamp;
+        detector->runStartedAt = timestamp;
+        detector->runInterventions = 0;
+        detector->runPeakWindowCount = 0;
+    }
+    detector->runInterventions++;
+    if (windowCount > detector->runPeakWindowCount) {
+        detector->runPeakWindowCount = windowCount;
+    }
+
+    uint64_t sequence = atomic_load_explicit(&detector->head, memory_order_relaxed);
+    if (detector->readyAt - timestamp <= PW_STORM_TOLERANCE_NANOS) {
+        detector->readyAt += PW_STORM_INTERVAL_NANOS;
+    } else if (!detector->storming) {
+        // Bucket empty: the whole run since it was last full is the episode
+        detector->storming = true;
+        sequence++;
+    }
+    if (detector->storming) {
+        PWStormPublishEpisode(detector, sequence, timestamp);
+    }
+
+    atomic_store_explicit(&detector->version, version + 2, memory_order_release);
+}
+
+// MARK: - Reading
+
+void PWStormDetectorGetStats(const PWStormDetector *detector, uint64_t now, PWStormStats *stats) {
+    uint64_t before, after, rateMilli, windowStart;
+    uint32_t windowCount, peakWindowCount;
+    do {
+        before = atomic_load_explicit(&detector->version, memory_order_acquire);
+        rateMilli = atomic_load_explicit(&detector->rateMilli, memory_order_relaxed);
+        windowStart = atomic_load_explicit(&detector->windowStart, memory_order_relaxed);
+        windowCount = (uint32_t)atomic_load_explicit(&detector->windowCount, memory_order_relaxed);
+        peakWindowCount = (uint32_t)atomic_load_explicit(&detector->peakWindowCount, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&detector->version, memory_order_relaxed);
+    } while (before != after || (before & 1));
+
+    stats->rate = PWStormAdvance(rateMilli, &windowStart, &windowCount, now) / 1000.0;
+    stats->peakRate = PWStormWindowRate(peakWindowCount);
+    stats->episodes = atomic_load_explicit(&detector->head, memory_order_acquire);
+
+    PWStormEpisode newest;
+    stats->storming = PWStormDetectorCopyEpisodes(detector, now, &newest, 1) == 1 && newest.active;
+}
+
+size_t PWStormDetectorCopyEpisodes(const PWStormDetector *detector, uint64_t now,
+                                   PWStormEpisode *episodes, size_t capacity) {
+    uint64_t head = atomic_load_explicit(&detector->head, memory_order_acquire);
+    if (!head || !capacity) {
+        return 0;
+    }
+    uint64_t retained = head < PW_STORM_EPISODE_CAPACITY ? head : PW_STORM_EPISODE_CAPACITY;
+    uint64_t wanted = retained < capacity ? retained : capacity;
+
+    size_t count = 0;
+    for (uint64_t sequence = head - wanted + 1; sequence <= head; sequence++) {
+        const PWStormEpisodeSlot *slot = &detector->slots[sequence & (PW_STORM_EPISODE_CAPACITY - 1)];
+
+        uint64_t before = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        uint64_t startedAt = atomic_load_explicit(&slot->startedAt, memory_order_relaxed);
+        uint64_t lastAt = atomic_load_explicit(&slot->lastAt, memory_order_relaxed);
+        uint64_t endsBy = atomic_load_explicit(&slot->endsBy, memory_order_relaxed);
+        uint64_t interventions = atomic_load_explicit(&slot->interventions, memory_order_relaxed);
+        uint32_t peakWindowCount = (uint32_t)atomic_load_explicit(&slot->peakWindowCount, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+
+        // Overwritten by a newer lap or mid-update: skip it rather than wait
+        if (before != sequence || after != sequence) {
+            continue;
+        }
+        episodes[count++] = (PWStormEpisode){
+            .sequence = sequence,
+            .startedAt = startedAt,
+            .durationNanos = lastAt - startedAt,
+            .interventions = interventions,
+            .peakRate = PWStormWindowRate(peakWindowCount),
+            .active = now < endsBy,
+        };
+    }
+    return count;
+}
@@ -0,0 +1,103 @@
+//
+//  PWStorm.h
+//  PingWardenHelper
+//
+//  Streaming intervention-rate estimator and storm detector.
+//  A token bucket decides when interventions arrive faster than the system
+//  normally raises AWDL; each such burst is recorded as an episode (start,
+//  duration, count, peak rate) in a small ring. An EWMA over fixed windows
+//  tracks the current rate. Recording is integer arithmetic and plain stores,
+//  so it runs on the enforcement thread; any thread may read.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWStorm_h
+#define PWStorm_h
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Interventions per second the bucket refills at: a steady rate this low is never a storm
+#define PW_STORM_SUSTAINED_PER_SECOND 2
+// Interventions above the sustained rate the bucket absorbs before a storm starts
+#define PW_STORM_BURST 10
+// Rate window; the EWMA folds in one window at a time
+#define PW_STORM_WINDOW_NANOS 100000000ull
+// EWMA weight of each window is 2^-PW_STORM_EWMA_SHIFT (about a 0.8 s time constant)
+#define PW_STORM_EWMA_SHIFT 3
+// Episodes retained; must be a power of two
+#define PW_STORM_EPISODE_CAPACITY 32
+
+/// One burst, as read back from the detector.
+typedef struct {
+    uint64_t sequence;       // 1-based, never reused
+    uint64_t startedAt;      // PWMonotonicNanos() of the burst's first intervention
+    uint64_t durationNanos;  // first to latest intervention
+    uint64_t interventions;  // interventions in the burst
+    double peakRate;         // busiest window in the burst, interventions per second
+    bool active;             // still in progress: the bucket has not refilled yet
+} PWStormEpisode;
+
+typedef struct {
+    double rate;        // EWMA interventions per second
+    double peakRate;    // busiest window ever, interventions per second
+    uint64_t episodes;  // bursts recorded
+    bool storming;      // an episode is in progress
+} PWStormStats;
+
+typedef struct {
+    // Per-slot sequence doubles as a seqlock: 0 while the slot is being written
+    atomic_uint_fast64_t sequence;
+    atomic_uint_fast64_t startedAt;
+    atomic_uint_fast64_t lastAt;
+    atomic_uint_fast64_t endsBy;
+    atomic_uint_fast64_t interventions;
+    atomic_uint_fast32_t peakWindowCount;
+} PWStormEpisodeSlot;
+
+/// Zero-initialised memory is an idle detector.
+/// Single writer: only one thread may call PWStormDetectorRecord.
+typedef struct {
+    // Writer state
+    uint64_t readyAt;            // when the bucket is full again (GCRA theoretical arrival time)
+    uint64_t runStartedAt;       // first intervention since the bucket was last full
+    uint64_t runInterventions;
+    uint32_t runPeakWindowCount;
+    bool storming;
+
+    // Published for readers; version is odd while the writer updates them
+    atomic_uint_fast64_t version;
+    atomic_uint_fast64_t rateMilli;        // EWMA as of windowStart, interventions per 1000 s
+    atomic_uint_fast64_t windowStart;
+    atomic_uint_fast32_t windowCount;      // interventions in the open window
+    atomic_uint_fast32_t peakWindowCount;
+
+    atomic_uint_fast64_t head;  // sequence of the newest episode
+    PWStormEpisodeSlot slots[PW_STORM_EPISODE_CAPACITY];
+} PWStormDetector;
+
+/// Account for one intervention at timestamp (PWMonotonicNanos()). Timestamps must
+/// not go backwards. Must only be called from the writer thread.
+void PWStormDetectorRecord(PWStormDetector *detector, uint64_t timestamp);
+
+/// Rates and episode count as of now. Thread-safe.
+void PWStormDetectorGetStats(const PWStormDetector *detector, uint64_t now, PWStormStats *stats);
+
+/// Copy up to capacity of the most recent episodes, oldest first, as of now.
+/// Thread-safe and never blocks the writer. Returns the number copied.
+size_t PWStormDetectorCopyEpisodes(const PWStormDetector *detector, uint64_t now,
+                                   PWStormEpisode *episodes, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWStorm_h */
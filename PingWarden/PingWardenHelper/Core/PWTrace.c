@@ -0,0 +1,86 @@
+//
+//  PWTrace.c
+//  PingWardenHelper
+//
+//  Fixed-size single-producer ring of binary trace records.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWTrace.h"
+
+_Static_assert((PW_TRACE_RING_CAPACITY & (PW_TRACE_RING_CAPACITY - 1)) == 0,
+               "PW_TRACE_RING_CAPACITY must be a power of two");
+
+void PWTraceRingPush(PWTraceRing *ring, PWTraceEvent event, uint64_t timestamp, uint64_t arg0, uint64_t arg1) {
+    uint64_t sequence = atomic_load_explicit(&ring->head, memory_order_relaxed) + 1;
+    PWTraceSlot *slot = &ring->slots[sequence & (PW_TRACE_RING_CAPACITY - 1)];
+
+    // Mark the slot as in flux before touching the payload
+    atomic_store_explicit(&slot->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->timestamp, timestamp, memory_order_relaxed);
+    atomic_store_explicit(&slot->event, (uint32_t)event, memory_order_relaxed);
+    atomic_store_explicit(&slot->arg0, arg0, memory_order_relaxed);
+    atomic_store_explicit(&slot->arg1, arg1, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->sequence, sequence, memory_order_release);
+    atomic_store_explicit(&ring->head, sequence, memory_order_release);
+}
+
+uint64_t PWTraceRingHead(const PWTraceRing *ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire);
+}
+
+size_t PWTraceRingRead(const PWTraceRing *ring, uint64_t cursor, PWTraceRecord *records, size_t capacity) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (cursor >= head) {
+        return 0;
+    }
+    uint64_t oldest = head > PW_TRACE_RING_CAPACITY ? head - PW_TRACE_RING_CAPACITY + 1 : 1;
+    uint64_t sequence = cursor + 1 > oldest ? cursor + 1 : oldest;
+
+    size_t count = 0;
+    for (; sequence <= head && count < capacity; sequence++) {
+        const PWTraceSlot *slot = &ring->slots[sequence & (PW_TRACE_RING_CAPACITY - 1)];
+
+        uint64_t before = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        PWTraceRecord record = {
+            .sequence = sequence,
+            .timestamp = atomic_load_explicit(&slot->timestamp, memory_order_relaxed),
+            .event = (PWTraceEvent)atomic_load_explicit(&slot->event, memory_order_relaxed),
+            .arg0 = atomic_load_explicit(&slot->arg0, memory_order_relaxed),
+            .arg1 = atomic_load_explicit(&slot->arg1, memory_order_relaxed),
+        };
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+
+        // Overwritten by a newer lap (or mid-write): that record is gone
+        if (before != sequence || after != sequence) {
+            continue;
+        }
+        records[count++] = record;
+    }
+    return count;
+}
+
+const char *PWTraceEventName(PWTraceEvent event) {
+    static const char *const names[PWTraceEventCount] = {
+        [PWTraceEventWakeup] = "wakeup",
+        [PWTraceEventLinkInfo] = "link",
+        [PWTraceEventArrival] = "arrival",
+        [PWTraceEventDeparture] = "departure",
+        [PWTraceEventOverflow] = "overflow",
+        [PWTraceEventResync] = "resync",
+        [PWTraceEventIntervention] = "intervention",
+        [PWTraceEventWriteFailed] = "write-failed",
+        [PWTraceEventControl] = "control",
+        [PWTraceEventApplied] = "applied",
+    };
+    if ((unsigned int)event >= PWTraceEventCount || !names[event]) {
+        return "unknown";
+    }
+    return names[event];
+}
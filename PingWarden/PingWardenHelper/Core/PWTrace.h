@@ -0,0 +1,86 @@
+//
+//  PWTrace.h
+//  PingWardenHelper
+//
+//  Fixed-size single-producer ring of binary trace records.
+//  Stands in for log lines on the enforcement thread: a record is an event id,
+//  a monotonic timestamp and two integer arguments, written with plain stores
+//  and formatted only when someone dumps the ring. Old records are overwritten
+//  once the ring wraps.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWTrace_h
+#define PWTrace_h
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Must be a power of two
+#define PW_TRACE_RING_CAPACITY 1024
+
+/// What a record describes, and what its arguments mean.
+typedef enum {
+    PWTraceEventWakeup = 1,       // poll returned: routing socket readable (0/1), mailbox readable (0/1)
+    PWTraceEventLinkInfo,         // link message for a table entry: slot, flags
+    PWTraceEventArrival,          // interface (re)appeared: slot, ifindex
+    PWTraceEventDeparture,        // interface went away: slot, old ifindex
+    PWTraceEventOverflow,         // the kernel dropped messages: overflows so far, 0
+    PWTraceEventResync,           // flags read directly: slot, flags
+    PWTraceEventIntervention,     // interface brought back DOWN: slot, receive -> SIOCSIFFLAGS nanoseconds
+    PWTraceEventWriteFailed,      // SIOCSIFFLAGS or SIOCGIFFLAGS failed: slot, errno
+    PWTraceEventControl,          // allow/block state applied: allow mask, superseded commands
+    PWTraceEventApplied,          // state change wrote the interface: slot, flags written
+    PWTraceEventCount
+} PWTraceEvent;
+
+/// One record, as read back from the ring.
+typedef struct {
+    uint64_t sequence;   // 1-based, never reused; the cursor for the next fetch
+    uint64_t timestamp;  // PWMonotonicNanos()
+    PWTraceEvent event;
+    uint64_t arg0;
+    uint64_t arg1;
+} PWTraceRecord;
+
+typedef struct {
+    // Per-slot sequence doubles as a seqlock: 0 while the slot is being written
+    atomic_uint_fast64_t sequence;
+    atomic_uint_fast64_t timestamp;
+    atomic_uint_fast32_t event;
+    atomic_uint_fast64_t arg0;
+    atomic_uint_fast64_t arg1;
+} PWTraceSlot;
+
+/// Zero-initialised memory is an empty ring.
+typedef struct {
+    atomic_uint_fast64_t head;  // sequence of the newest published record
+    PWTraceSlot slots[PW_TRACE_RING_CAPACITY];
+} PWTraceRing;
+
+/// Append a record. Must only be called from the producer thread.
+void PWTraceRingPush(PWTraceRing *ring, PWTraceEvent event, uint64_t timestamp, uint64_t arg0, uint64_t arg1);
+
+/// Sequence of the newest record, or 0 if nothing was pushed yet. Thread-safe.
+uint64_t PWTraceRingHead(const PWTraceRing *ring);
+
+/// Copy up to capacity records with a sequence greater than cursor, oldest first.
+/// Records that were already overwritten are skipped. Thread-safe and wait-free
+/// with respect to the producer.
+size_t PWTraceRingRead(const PWTraceRing *ring, uint64_t cursor, PWTraceRecord *records, size_t capacity);
+
+/// Short stable name for an event id ("intervention"), or "unknown".
+const char *PWTraceEventName(PWTraceEvent event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWTrace_h */
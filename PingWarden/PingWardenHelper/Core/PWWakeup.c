@@ -0,0 +1,150 @@
+//
+//  PWWakeup.c
+//  PingWardenHelper
+//
+//  Pollable cross-thread wakeup for the enforcement loop.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#include "PWWakeup.h"
+#include "PWLog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <sys/event.h>
+#elif defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+// Invalid file descriptor sentinel
+#define INVALID_FD (-1)
+
+#if defined(__APPLE__)
+// Identifier of the single EVFILT_USER event registered on the kqueue
+#define PW_WAKEUP_IDENT 1
+#endif
+
+bool PWWakeupInit(PWWakeup *wakeup) {
+    atomic_init(&wakeup->pending, false);
+#if defined(__APPLE__)
+    wakeup->fd = kqueue();
+    if (wakeup->fd < 0) {
+        PW_LOG_ERROR("Error creating kqueue: %d (%s)", errno, strerror(errno));
+        wakeup->fd = INVALID_FD;
+        return false;
+    }
+    // EV_CLEAR: retrieving the event resets it, so the kqueue stops polling readable
+    struct kevent kev;
+    EV_SET(&kev, PW_WAKEUP_IDENT, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, NULL);
+    if (kevent(wakeup->fd, &kev, 1, NULL, 0, NULL) < 0) {
+        PW_LOG_ERROR("Error registering EVFILT_USER: %d (%s)", errno, strerror(errno));
+        PWWakeupDestroy(wakeup);
+        return false;
+    }
+#elif defined(__linux__)
+    wakeup->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup->fd < 0) {
+        PW_LOG_ERROR("Error creating eventfd: %d (%s)", errno, strerror(errno));
+        wakeup->fd = INVALID_FD;
+        return false;
+    }
+#else
+    int fds[2];
+    if (0 != pipe(fds)) {
+        PW_LOG_ERROR("Error creating pipe: %d (%s)", errno, strerror(errno));
+        wakeup->fd = INVALID_FD;
+        wakeup->writeFd = INVALID_FD;
+        return false;
+    }
+    wakeup->fd = fds[0];
+    wakeup->writeFd = fds[1];
+    if (fcntl(wakeup->fd, F_SETFL, O_NONBLOCK) < 0) {
+        PW_LOG_ERROR("Error setting nonblock on pipe read fd: %d (%s)", errno, strerror(errno));
+        PWWakeupDestroy(wakeup);
+        return false;
+    }
+#endif
+    return true;
+}
+
+void PWWakeupDestroy(PWWakeup *wakeup) {
+    if (wakeup->fd != INVALID_FD) {
+        close(wakeup->fd);
+        wakeup->fd = INVALID_FD;
+    }
+#if !defined(__APPLE__) && !defined(__linux__)
+    if (wakeup->writeFd != INVALID_FD) {
+        close(wakeup->writeFd);
+        wakeup->writeFd = INVALID_FD;
+    }
+#endif
+}
+
+bool PWWakeupSignal(PWWakeup *wakeup) {
+    // Someone already signalled and the loop has not consumed it yet
+    if (atomic_exchange(&wakeup->pending, true)) {
+        return true;
+    }
+
+    // Retry up to 3 times on EINTR
+    for (int retry = 0; retry < 3; retry++) {
+#if defined(__APPLE__)
+        struct kevent kev;
+        EV_SET(&kev, PW_WAKEUP_IDENT, EVFILT_USER, 0, NOTE_TRIGGER, 0, NULL);
+        if (kevent(wakeup->fd, &kev, 1, NULL, 0, NULL) == 0) {
+            return true;
+        }
+#elif defined(__linux__)
+        uint64_t one = 1;
+        if (write(wakeup->fd, &one, sizeof(one)) == sizeof(one)) {
+            return true;
+        }
+#else
+        char byte = 0;
+        if (write(wakeup->writeFd, &byte, 1) == 1) {
+            return true;
+        }
+#endif
+        if (errno != EINTR) {
+            break;
+        }
+        PW_LOG_DEBUG("Wakeup interrupted, retrying (attempt %d)", retry + 1);
+    }
+
+    PW_LOG_ERROR("Error signalling enforcement loop: %d (%s)", errno, strerror(errno));
+    atomic_store(&wakeup->pending, false);
+    return false;
+}
+
+void PWWakeupConsume(PWWakeup *wakeup) {
+    // Drain the descriptor first, then re-arm. A signal landing in between sees
+    // pending still set and skips its syscall, which is fine: the caller reads
+    // the state it announced right after this returns.
+#if defined(__APPLE__)
+    struct kevent kev;
+    const struct timespec zero = { 0, 0 };
+    while (kevent(wakeup->fd, NULL, 0, &kev, 1, &zero) < 0 && errno == EINTR) {
+    }
+#elif defined(__linux__)
+    uint64_t value;
+    while (read(wakeup->fd, &value, sizeof(value)) < 0 && errno == EINTR) {
+    }
+#else
+    char buf[64];
+    for (;;) {
+        ssize_t len = read(wakeup->fd, buf, sizeof(buf));
+        if (len > 0 || (len < 0 && errno == EINTR)) {
+            continue;
+        }
+        break;
+    }
+#endif
+    atomic_store(&wakeup->pending, false);
+}
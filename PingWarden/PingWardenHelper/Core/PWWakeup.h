@@ -0,0 +1,51 @@
+//
+//  PWWakeup.h
+//  PingWardenHelper
+//
+//  Pollable cross-thread wakeup for the enforcement loop.
+//  EVFILT_USER on a kqueue on Darwin, an eventfd on Linux, and a pipe
+//  elsewhere. Signals that arrive before the loop consumes them collapse
+//  into a single wakeup.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#ifndef PWWakeup_h
+#define PWWakeup_h
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    /// Readable (POLLIN) while a signal is pending.
+    int fd;
+#if !defined(__APPLE__) && !defined(__linux__)
+    int writeFd;
+#endif
+    /// Set by the first signal after a consume; later signals skip the syscall.
+    atomic_bool pending;
+} PWWakeup;
+
+/// Create the descriptor(s). Returns false and leaves fd invalid on failure.
+bool PWWakeupInit(PWWakeup *wakeup);
+
+/// Close the descriptor(s). Safe on a wakeup whose init failed.
+void PWWakeupDestroy(PWWakeup *wakeup);
+
+/// Make fd readable. Thread-safe; at most one syscall per consume.
+bool PWWakeupSignal(PWWakeup *wakeup);
+
+/// Reset fd to unreadable. Call from the waiting thread *before* reading the
+/// state the signal announced, so a signal racing with the read is not lost.
+void PWWakeupConsume(PWWakeup *wakeup);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWWakeup_h */
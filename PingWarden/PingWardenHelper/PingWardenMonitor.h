@@ -13,28 +13,112 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-/// Monitors and controls the AWDL (awdl0) network interface.
+/// Monitors and controls the AWDL (awdl0) network interface and its companion llw0.
 /// Uses AF_ROUTE socket for kernel-level monitoring with <1ms response time.
-/// When awdlEnabled is NO, any attempt by the system to bring awdl0 UP
+/// When an interface is not allowed UP, any attempt by the system to bring it UP
 /// is immediately countered by bringing it back DOWN.
 @interface PingWardenMonitor : NSObject
 
 /// When YES, AWDL is allowed to be up (normal operation).
 /// When NO, AWDL is kept down (blocking mode).
-/// Setting this property immediately applies the desired state.
+/// Setting this property immediately applies the desired state; other interfaces keep theirs.
+/// Like the rest of the policy and the opt-ins below, it is persisted and restored at launch.
 @property (nonatomic) BOOL awdlEnabled;
 
+/// Called after interventions, on a private serial queue. Bursts are coalesced into one
+/// call; use -interventionEventsAfterCursor:latestSequence: to see what happened.
+@property (atomic, copy, nullable) dispatch_block_t interventionHandler;
+
+/// YES while the enforcement thread runs with realtime scheduling (see Core/PWRealtime.h)
+@property (readonly) BOOL realtimeSchedulingEnabled;
+
+/// Opt in or out of realtime scheduling for the enforcement thread. Applied now if the
+/// thread is running, otherwise when it starts.
+/// @return NO if the kernel refused the policy; the thread keeps its previous one
+- (BOOL)setRealtimeSchedulingEnabled:(BOOL)enabled;
+
+/// YES while the enforcement loop's working set is locked in RAM (see Core/PWMemory.h)
+@property (readonly) BOOL memoryLockingEnabled;
+
+/// Lock or unlock the enforcement loop's working set: the enforcer, the routing socket's
+/// buffers and the loop thread's prefaulted stack. Applied now if the thread is running,
+/// otherwise when it starts.
+/// @return NO if the kernel refused to lock the pages; nothing stays locked
+- (BOOL)setMemoryLockingEnabled:(BOOL)enabled;
+
+/// Allow every interface UP without persisting it, for a deliberate exit: the helper will not
+/// be around to keep them DOWN, but a relaunch enforces what clients last asked for.
+/// Saves already queued land first; later changes are no longer saved. Synchronous: returns
+/// YES once the enforcement loop has applied it, NO if it could not within a second.
+- (BOOL)restoreInterfacesForExit;
+
+/// Launch instrumentation, in the format documented on
+/// -[PingWardenHelperProtocol getStartupStatisticsWithReply:]
+- (NSDictionary<NSString *, NSNumber *> *)startupStatistics;
+
+/// Intervention statistics across every helper process, in the format documented on
+/// -[PingWardenHelperProtocol getLifetimeStatisticsWithReply:]
+- (NSDictionary<NSString *, id> *)lifetimeStatistics;
+
 /// Stop the monitoring thread and cleanup all resources.
 /// Should be called before the helper exits.
 - (void)invalidate;
 
-/// Get the total number of AWDL interventions (how many times we blocked AWDL from coming up)
+/// The policy table in slot order, in the format documented on
+/// -[PingWardenHelperProtocol getInterfacePolicyWithReply:]
+- (NSArray<NSDictionary<NSString *, id> *> *)interfacePolicy;
+
+/// Change the allowed state of the named interfaces in one atomic update; others keep theirs.
+/// @param policy Interface name -> YES to allow UP, NO to keep DOWN
+/// @return NO, changing nothing, if a name is not in the table
+- (BOOL)setInterfacePolicy:(NSDictionary<NSString *, NSNumber *> *)policy;
+
+/// Get the total number of interventions (how many times we blocked AWDL or llw0 from coming up)
 /// This counter persists for the lifetime of the helper process
 - (NSInteger)getInterventionCount;
 
 /// Reset the intervention counter to zero
 - (void)resetInterventionCount;
 
+/// Reaction-time histograms for every intervention since the helper started,
+/// in the format documented on -[PingWardenHelperProtocol getAWDLReactionHistogramWithReply:]
+- (NSDictionary<NSString *, id> *)reactionTimeHistogram;
+
+/// Raise a blocked interface rounds times (1...1000) and time the loop lowering it again, in the
+/// format documented on -[PingWardenHelperProtocol runSelfTestOnInterface:rounds:withReply:].
+/// Blocks the caller for up to a second per round; never call it on the enforcement thread.
+- (NSDictionary<NSString *, id> *)selfTestOnInterface:(NSString *)name rounds:(NSUInteger)rounds;
+
+/// Routing socket overflow and resync counters, in the format documented on
+/// -[PingWardenHelperProtocol getEventSourceCountersWithReply:]
+- (NSDictionary<NSString *, NSNumber *> *)eventSourceCounters;
+
+/// Working set residency and the enforcement thread's page faults, in the format documented on
+/// -[PingWardenHelperProtocol getEnforcementMemoryStatsWithReply:]
+- (NSDictionary<NSString *, NSNumber *> *)memoryStatistics;
+
+/// Intervention rate and recent storm episodes, in the format documented on
+/// -[PingWardenHelperProtocol getInterventionStormsWithReply:]
+- (NSDictionary<NSString *, id> *)stormStatistics;
+
+/// Interventions with a sequence greater than cursor, oldest first, in the format documented on
+/// -[PingWardenHelperProtocol getAWDLInterventionEventsAfterCursor:withReply:]
+/// @param latestSequence Set to the newest recorded sequence
+- (NSArray<NSDictionary<NSString *, NSNumber *> *> *)interventionEventsAfterCursor:(uint64_t)cursor
+                                                                     latestSequence:(uint64_t *)latestSequence;
+
+/// Sequence of the newest intervention event, 0 if there has been none
+- (uint64_t)latestInterventionSequence;
+
+/// Enforcement loop trace records with a sequence greater than cursor, oldest first, in the
+/// format documented on -[PingWardenHelperProtocol getEnforcementTraceAfterCursor:withReply:]
+/// @param latestSequence Set to the newest recorded sequence
+- (NSArray<NSArray<NSNumber *> *> *)traceRecordsAfterCursor:(uint64_t)cursor latestSequence:(uint64_t *)latestSequence;
+
+/// Everything above in one dictionary, plus the interfaces' flags read now, in the format
+/// documented on -[PingWardenHelperProtocol getHelperSnapshotWithReply:] except "version"
+- (NSDictionary<NSString *, id> *)helperSnapshot;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -3,6 +3,7 @@
 //  PingWardenHelper
 //
 //  Core AWDL monitoring using AF_ROUTE socket.
+//  The enforcement loop itself lives in the platform-neutral Core/PWEnforcer.
 //  Based on james-howard/AWDLControl and jamestut/awdlkiller.
 //
 //  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
@@ -12,111 +13,159 @@
 #import "PingWardenMonitor.h"
 
 #import <os/log.h>
-#import <sys/types.h>
-#import <sys/ioctl.h>
-#import <sys/socket.h>
 #import <net/if.h>
-#import <net/if_dl.h>
-#import <net/route.h>
-#import <unistd.h>
-#import <poll.h>
-#import <errno.h>
-#import <err.h>
-#import <fcntl.h>
-#import <string.h>
+#import <os/lock.h>
+#import <sys/socket.h>
+#import <pthread.h>
 #import <stdatomic.h>
+#import <sys/stat.h>
+
+#import "Core/PWClock.h"
+#import "Core/PWEnforcer.h"
+#import "Core/PWInterfaceFlags.h"
+#import "Core/PWLifetime.h"
+#import "Core/PWRealtime.h"
+#import "Core/PWSelfTest.h"
+#import "Core/PWStateFile.h"
+#import "Core/PWStatusPage.h"
 
 #define LOG OS_LOG_DEFAULT
 
-static const char *TARGETIFNAM = "awdl0";
+// Policy table, in slot order: AWDL itself and the low-latency WLAN interface
+// Apple Wireless Direct Link brings up alongside it
+static const char *const kTargetInterfaces[] = { "awdl0", "llw0" };
+enum { kAWDLSlot = 0, kTargetInterfaceCount = sizeof(kTargetInterfaces) / sizeof(kTargetInterfaces[0]) };
 
-// Static assertion to ensure TARGETIFNAM fits in IFNAMSIZ
+// Static assertion to ensure the table fits the enforcer and the names fit in IFNAMSIZ
 // IFNAMSIZ is typically 16 on macOS/BSD
-_Static_assert(sizeof("awdl0") <= IFNAMSIZ, "TARGETIFNAM must fit in IFNAMSIZ");
-
-// Routing messages can contain rt_msghdr + if_msghdr + multiple sockaddr structures
-// Use a generous buffer size to handle all message types safely
-#define RTMSG_BUFFER_SIZE 512
-
-// Invalid file descriptor sentinel
-#define INVALID_FD (-1)
+_Static_assert(kTargetInterfaceCount <= PW_ENFORCER_MAX_TARGETS, "too many target interfaces");
+_Static_assert(sizeof("awdl0") <= IFNAMSIZ && sizeof("llw0") <= IFNAMSIZ, "target names must fit in IFNAMSIZ");
+
+// Developer switch for recording routing storms:
+// sudo defaults write /Library/Preferences/com.amesvt.pingwarden.helper EventCapturePath /path/to/file.pwcap
+static NSString *const kHelperPreferencesDomain = @"com.amesvt.pingwarden.helper";
+static NSString *const kEventCapturePathKey = @"EventCapturePath";
+// Routing socket receive buffer in bytes; the core's default when unset
+static NSString *const kEventReceiveBufferSizeKey = @"EventReceiveBufferSize";
+
+// What clients asked for, kept across relaunches and crashes (see Core/PWStateFile.h)
+static const char *const kStateDirectory = "/Library/Application Support/PingWarden";
+static const char *const kStateFilePath = "/Library/Application Support/PingWarden/HelperState";
+// Intervention statistics across every helper process (see Core/PWLifetime.h)
+static const char *const kLifetimeFilePath = "/Library/Application Support/PingWarden/Counters";
+// Writeback interval for the counter file; a crash loses nothing, a power cut at most this much
+static const int64_t kLifetimeFlushInterval = 60 * NSEC_PER_SEC;
+// How long a deliberate exit waits for the loop to raise the interfaces
+static const uint64_t kExitRestoreTimeoutNanos = NSEC_PER_SEC;
+// World-readable page the app and the widget map for live status (see Core/PWStatusPage.h)
+static const char *const kStatusPagePath = "/Library/Application Support/PingWarden/Status";
+
+// Budget for the opt-in time-constraint policy: a drain plus one SIOCSIFFLAGS
+static const PWRealtimeConfig kRealtimeConfig = PW_REALTIME_CONFIG_DEFAULT;
 
 @interface PingWardenMonitor () {
-    // Pipe file descriptors for internal state change communication
-    int _msgfds[2];
+    // Platform-neutral enforcement loop (AF_ROUTE source + ioctl actuator)
+    PWEnforcer *_enforcer;
 
-    BOOL _exit;
     // Thread-safe flag for tracking background thread state
     // Use atomic_bool to prevent data races between main thread and pollIoctl thread
     atomic_bool _threadRunning;
 
     dispatch_semaphore_t _ioctlThreadExitSemaphore;
-    
-    // Counter for AWDL interventions (how many times we brought it down)
-    atomic_int _interventionCount;
+
+    // Coalesces intervention notifications from the loop thread
+    dispatch_queue_t _interventionQueue;
+    dispatch_source_t _interventionSource;
+
+    // Guards the loop thread handle and the realtime and memory locking opt-ins,
+    // which both the loop thread (at start) and XPC callers (at any time) apply
+    os_unfair_lock _realtimeLock;
+    pthread_t _loopThread;
+    BOOL _loopThreadRunning;
+    BOOL _realtimeSchedulingEnabled;
+    BOOL _memoryLockingEnabled;
+
+    // SO_RCVBUF the kernel granted the routing socket
+    int _receiveBufferBytes;
+
+    // Persisted desired state; saves run in order on _stateQueue so the newest wins.
+    // _persistLock orders each snapshot with its enqueue, and once _exitRestoring is
+    // set no snapshot is taken, so the allow-all exit policy never reaches the disk
+    PWStateFile *_stateFile;
+    dispatch_queue_t _stateQueue;
+    os_unfair_lock _persistLock;
+    BOOL _exitRestoring;
+    BOOL _restoredState;
+    // Monotonic time the kernel started the helper, 0 if unknown
+    uint64_t _processStartedAt;
+
+    // Lifetime counters, written by the loop thread and read here without it; flushed on _stateQueue
+    PWLifetime *_lifetime;
+    dispatch_source_t _lifetimeFlushTimer;
+
+    // Published by the loop thread after every change; clients read it without XPC
+    PWStatusPage *_statusPage;
 }
 
 /// Background thread watching AWDL state
 @property NSThread *ioctlThread;
 
-/// Socket to perform ioctl to set interface flags
-@property int iocfd;
-
-/// Socket to monitor network interface changes (AF_ROUTE)
-@property int rtfd;
-
 @end
 
+/// Runs on the enforcement thread: no Objective-C messaging, just a coalescing dispatch source poke
+static void PWMonitorInterventionCallback(void *context) {
+    dispatch_source_merge_data((__bridge dispatch_source_t)context, 1);
+}
+
 @implementation PingWardenMonitor
 
 - (instancetype)init {
     if (self = [super init]) {
-        // Initialize file descriptors to invalid state for proper cleanup
-        _rtfd = INVALID_FD;
-        _iocfd = INVALID_FD;
-        _msgfds[0] = INVALID_FD;
-        _msgfds[1] = INVALID_FD;
         atomic_store(&_threadRunning, false);
-        
-        // Initialize intervention counter
-        atomic_store(&_interventionCount, 0);
-
-        // Start off allowing AWDL to be active
-        _awdlEnabled = YES;
-
-        // Socket to monitor network interface changes
-        _rtfd = socket(AF_ROUTE, SOCK_RAW, 0);
-        if (_rtfd < 0) {
-            os_log_error(LOG, "Error creating AF_ROUTE socket: %d (%s)", errno, strerror(errno));
-            [self cleanupFileDescriptors];
+        _realtimeLock = OS_UNFAIR_LOCK_INIT;
+        _persistLock = OS_UNFAIR_LOCK_INIT;
+
+        PWEventSource *source = PWRouteSocketSourceCreate();
+        if (!source) {
+            os_log_error(LOG, "Failed to create AF_ROUTE event source");
             return nil;
         }
-        if (fcntl(_rtfd, F_SETFL, O_NONBLOCK) < 0) {
-            os_log_error(LOG, "Error setting nonblock on AF_ROUTE socket: %d (%s)", errno, strerror(errno));
-            [self cleanupFileDescriptors];
+        [self applyReceiveBufferSizeToSource:source];
+        PWActuator *actuator = PWIoctlActuatorCreate();
+        if (!actuator) {
+            os_log_error(LOG, "Failed to create ioctl actuator");
+            source->destroy(source);
             return nil;
         }
 
-        // Socket to perform ioctl to set interface flags
-        _iocfd = socket(AF_INET, SOCK_DGRAM, 0);
-        if (_iocfd < 0) {
-            os_log_error(LOG, "Error creating AF_INET socket: %d (%s)", errno, strerror(errno));
-            [self cleanupFileDescriptors];
+        // Takes ownership of source and actuator, even on failure.
+        // Every interface in the table starts off allowed to be active
+        _enforcer = PWEnforcerCreateWithTargets(kTargetInterfaces, kTargetInterfaceCount, source, actuator);
+        if (!_enforcer) {
+            os_log_error(LOG, "Failed to create enforcement core");
             return nil;
         }
 
-        // Pipe for communication from main thread to ioctl thread
-        if (0 != pipe(_msgfds)) {
-            os_log_error(LOG, "Error creating pipe: %d (%s)", errno, strerror(errno));
-            [self cleanupFileDescriptors];
-            return nil;
-        }
-        // Set pipe to non-blocking
-        if (fcntl(_msgfds[0], F_SETFL, O_NONBLOCK) < 0) {
-            os_log_error(LOG, "Error setting nonblock on pipe read fd: %d (%s)", errno, strerror(errno));
-            [self cleanupFileDescriptors];
-            return nil;
-        }
+        [self startEventCaptureIfRequested];
+        // Before the loop starts, so its first iteration already enforces the restored state
+        [self restorePersistedState];
+        [self openLifetimeCounters];
+        [self openStatusPage];
+
+        _interventionQueue = dispatch_queue_create("com.amesvt.pingwarden.helper.interventions",
+                                                   DISPATCH_QUEUE_SERIAL);
+        _interventionSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_DATA_ADD, 0, 0, _interventionQueue);
+        __weak typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(_interventionSource, ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            dispatch_block_t handler = strongSelf.interventionHandler;
+            if (handler) {
+                handler();
+            }
+        });
+        dispatch_resume(_interventionSource);
+        PWEnforcerSetInterventionCallback(_enforcer, PWMonitorInterventionCallback,
+                                          (__bridge void *)_interventionSource);
 
         // Start background thread
         _ioctlThreadExitSemaphore = dispatch_semaphore_create(0);
@@ -126,279 +175,363 @@ _Static_assert(sizeof("awdl0") <= IFNAMSIZ, "TARGETIFNAM must fit in IFNAMSIZ");
         [_ioctlThread start];
 
         os_log(LOG, "PingWardenMonitor initialized successfully");
+        [self logStartupLatencyWhenEnforced];
     }
     return self;
 }
 
-/// Clean up file descriptors on error or dealloc
-- (void)cleanupFileDescriptors {
-    if (_iocfd != INVALID_FD) {
-        close(_iocfd);
-        _iocfd = INVALID_FD;
+#pragma mark - Persisted State
+
+/// Open the state file and post what it holds to the loop's mailbox. Runs before any
+/// client can connect; a missing or damaged file leaves every interface allowed.
+- (void)restorePersistedState {
+    if (!PWProcessStartNanos(&_processStartedAt)) {
+        _processStartedAt = 0;
+    }
+    _stateQueue = dispatch_queue_create("com.amesvt.pingwarden.helper.state", DISPATCH_QUEUE_SERIAL);
+
+    if (mkdir(kStateDirectory, 0755) != 0 && errno != EEXIST) {
+        os_log_error(LOG, "Failed to create %{public}s: %d", kStateDirectory, errno);
+        return;
+    }
+    _stateFile = PWStateFileOpen(kStateFilePath);
+    if (!_stateFile) {
+        return;
     }
-    if (_rtfd != INVALID_FD) {
-        close(_rtfd);
-        _rtfd = INVALID_FD;
+    PWPersistedState state;
+    if (!PWStateFileLoad(_stateFile, &state)) {
+        os_log(LOG, "No persisted state, starting with every interface allowed");
+        return;
     }
-    if (_msgfds[0] != INVALID_FD) {
-        close(_msgfds[0]);
-        _msgfds[0] = INVALID_FD;
+    if (state.targetCount != kTargetInterfaceCount) {
+        os_log_error(LOG, "Ignoring persisted state for a %u-interface table", state.targetCount);
+        return;
     }
-    if (_msgfds[1] != INVALID_FD) {
-        close(_msgfds[1]);
-        _msgfds[1] = INVALID_FD;
+
+    uint32_t everySlot = (1u << kTargetInterfaceCount) - 1;
+    if (!PWEnforcerSetPolicy(_enforcer, state.allowMask & everySlot, everySlot)) {
+        os_log_error(LOG, "Failed to post persisted state to enforcement loop");
+        return;
     }
+    // Applied by the loop thread when it starts
+    _realtimeSchedulingEnabled = (state.options & PWStateOptionRealtime) != 0;
+    _memoryLockingEnabled = (state.options & PWStateOptionLockMemory) != 0;
+    _restoredState = YES;
+    os_log(LOG, "Restored persisted state: allow mask 0x%x, options 0x%x", state.allowMask & everySlot, state.options);
 }
 
-/// Bring the interface up or down. Must be run only on ioctlThread.
-- (void)ifconfig:(BOOL)up {
-    NSAssert([NSThread currentThread] == _ioctlThread, @"ifconfig: must run on ioctlThread");
+/// Save the current policy and opt-ins. Asynchronous: the sync to disk never delays a reply.
+- (void)persistState {
+    if (!_stateFile || !_enforcer) {
+        return;
+    }
+    // Captured now, not when the save runs, so an exit restore in between cannot
+    // change what is saved; the queue is serial, so the newest snapshot lands last
+    os_unfair_lock_lock(&_persistLock);
+    if (_exitRestoring) {
+        os_unfair_lock_unlock(&_persistLock);
+        return;
+    }
+    os_unfair_lock_lock(&_realtimeLock);
+    uint32_t options = (_realtimeSchedulingEnabled ? PWStateOptionRealtime : 0) |
+                       (_memoryLockingEnabled ? PWStateOptionLockMemory : 0);
+    os_unfair_lock_unlock(&_realtimeLock);
+    PWPersistedState state = {
+        .allowMask = PWEnforcerGetPolicy(_enforcer),
+        .targetCount = kTargetInterfaceCount,
+        .options = options,
+        .savedAt = (uint64_t)([NSDate date].timeIntervalSince1970 * NSEC_PER_SEC),
+    };
+    PWStateFile *stateFile = _stateFile;
+    dispatch_async(_stateQueue, ^{
+        if (!PWStateFileSave(stateFile, &state)) {
+            os_log_error(LOG, "Failed to persist state");
+        }
+    });
+    os_unfair_lock_unlock(&_persistLock);
+}
 
-    struct ifreq ifr = {0};
-    strlcpy(ifr.ifr_name, TARGETIFNAM, IFNAMSIZ);
+/// Map the lifetime counter file and hand it to the loop. Without it the helper still
+/// enforces; it just keeps no statistics beyond its own lifetime.
+- (void)openLifetimeCounters {
+    _lifetime = PWLifetimeOpen(kLifetimeFilePath);
+    if (!_lifetime) {
+        os_log_error(LOG, "Lifetime counters unavailable");
+        return;
+    }
+    PWEnforcerSetLifetime(_enforcer, _lifetime);
+
+    PWLifetime *lifetime = _lifetime;
+    _lifetimeFlushTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _stateQueue);
+    dispatch_source_set_timer(_lifetimeFlushTimer, dispatch_time(DISPATCH_TIME_NOW, kLifetimeFlushInterval),
+                              kLifetimeFlushInterval, 5 * NSEC_PER_SEC);
+    dispatch_source_set_event_handler(_lifetimeFlushTimer, ^{
+        PWLifetimeFlush(lifetime);
+    });
+    dispatch_resume(_lifetimeFlushTimer);
+}
 
-    if (ioctl(_iocfd, SIOCGIFFLAGS, &ifr) < 0) {
-        os_log_error(LOG, "Error getting current interface flags: %d (%s)", errno, strerror(errno));
+/// Map the status page and hand it to the loop. Without it clients fall back to XPC.
+- (void)openStatusPage {
+    _statusPage = PWStatusPageCreate(kStatusPagePath);
+    if (!_statusPage) {
+        os_log_error(LOG, "Status page unavailable");
         return;
     }
+    PWEnforcerSetStatusPage(_enforcer, _statusPage);
+}
 
-    if ((ifr.ifr_flags & IFF_UP) && !up) {
-        // Interface is UP but we want it DOWN
-        ifr.ifr_flags &= ~IFF_UP;
-        if (ioctl(_iocfd, SIOCSIFFLAGS, &ifr) < 0) {
-            os_log_error(LOG, "Error bringing interface down: %d (%s)", errno, strerror(errno));
-        } else {
-            os_log_debug(LOG, "Brought awdl0 DOWN");
-        }
-    } else if (!(ifr.ifr_flags & IFF_UP) && up) {
-        // Interface is DOWN but we want it UP
-        ifr.ifr_flags |= IFF_UP;
-        if (ioctl(_iocfd, SIOCSIFFLAGS, &ifr) < 0) {
-            os_log_error(LOG, "Error bringing interface up: %d (%s)", errno, strerror(errno));
-        } else {
-            os_log_debug(LOG, "Brought awdl0 UP");
+/// Log how long after process start the restored state reached the interfaces.
+- (void)logStartupLatencyWhenEnforced {
+    if (!_restoredState) {
+        return;
+    }
+    __weak typeof(self) weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(1.0 * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSDictionary<NSString *, NSNumber *> *startup = [weakSelf startupStatistics];
+        if (startup[@"processStartToFirstEnforcementNanos"].unsignedLongLongValue) {
+            os_log(LOG, "Enforcing restored state %.2f ms after process start",
+                   startup[@"processStartToFirstEnforcementNanos"].doubleValue / 1e6);
         }
+    });
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)startupStatistics {
+    if (!_enforcer) {
+        return @{};
+    }
+    PWControlStats control;
+    PWEnforcerGetControlStats(_enforcer, &control);
+    uint64_t latency = 0;
+    if (_processStartedAt && control.firstAppliedAt > _processStartedAt) {
+        latency = control.firstAppliedAt - _processStartedAt;
+    }
+    return @{
+        @"restoredState": @(_restoredState),
+        @"stateFileAvailable": @(_stateFile != NULL),
+        @"processStartToFirstEnforcementNanos": @(latency),
+        @"uptimeNanos": @(_processStartedAt ? PWMonotonicNanos() - _processStartedAt : 0),
+    };
+}
+
+- (NSDictionary<NSString *, id> *)lifetimeStatistics {
+    if (!_lifetime) {
+        return @{};
+    }
+    // Straight from the mapping; the enforcement thread is not involved
+    PWLifetimeStats stats;
+    PWLifetimeGetStats(_lifetime, &stats);
+    NSMutableArray<NSDictionary<NSString *, NSNumber *> *> *days = [NSMutableArray arrayWithCapacity:stats.dayCount];
+    for (size_t i = 0; i < stats.dayCount; i++) {
+        [days addObject:@{
+            @"day": @(stats.days[i].day),
+            @"interventions": @(stats.days[i].interventions),
+        }];
+    }
+    return @{
+        @"createdAt": @((double)stats.createdAt / NSEC_PER_SEC),
+        @"launches": @(stats.launches),
+        @"interventions": @(stats.interventions),
+        @"lastInterventionAt": @((double)stats.lastInterventionAt / NSEC_PER_SEC),
+        @"maxBurstRate": @(stats.maxBurstRate),
+        @"maxBurstAt": @((double)stats.maxBurstAt / NSEC_PER_SEC),
+        @"upNanos": @(stats.upNanos),
+        @"days": days,
+    };
+}
+
+- (BOOL)restoreInterfacesForExit {
+    // Not persisted: a relaunch should enforce what clients last asked for. Stop taking
+    // snapshots before the policy changes, and let the queued ones reach the disk.
+    os_unfair_lock_lock(&_persistLock);
+    _exitRestoring = YES;
+    os_unfair_lock_unlock(&_persistLock);
+    if (_stateQueue) {
+        dispatch_sync(_stateQueue, ^{});
+    }
+    uint32_t everySlot = (1u << kTargetInterfaceCount) - 1;
+    if (!_enforcer || !PWEnforcerSetPolicy(_enforcer, everySlot, everySlot)) {
+        os_log_error(LOG, "Failed to restore interfaces before exit");
+        return NO;
+    }
+    // The caller invalidates and exits next; return only once the loop has raised them
+    if (!atomic_load(&_threadRunning) || !PWEnforcerAwaitControl(_enforcer, kExitRestoreTimeoutNanos)) {
+        os_log_error(LOG, "Interfaces were not restored before exit");
+        return NO;
+    }
+    os_log(LOG, "Interfaces restored for exit");
+    return YES;
+}
+
+/// Record every routing message to the file named by the EventCapturePath preference, if set.
+/// Replay captures with scripts/enforcement_replay.c.
+- (void)startEventCaptureIfRequested {
+    NSString *path = CFBridgingRelease(CFPreferencesCopyValue((__bridge CFStringRef)kEventCapturePathKey,
+                                                              (__bridge CFStringRef)kHelperPreferencesDomain,
+                                                              kCFPreferencesAnyUser, kCFPreferencesAnyHost));
+    if (![path isKindOfClass:[NSString class]] || path.length == 0) {
+        return;
+    }
+    if (PWEnforcerStartCapture(_enforcer, path.fileSystemRepresentation)) {
+        os_log(LOG, "Capturing routing messages to %{public}@", path);
+    } else {
+        os_log_error(LOG, "Failed to start routing message capture at %{public}@", path);
+    }
+}
+
+/// Size the routing socket's receive buffer from the EventReceiveBufferSize preference,
+/// or keep the core's default, and remember what the kernel granted.
+- (void)applyReceiveBufferSizeToSource:(PWEventSource *)source {
+    NSNumber *requested = CFBridgingRelease(CFPreferencesCopyValue((__bridge CFStringRef)kEventReceiveBufferSizeKey,
+                                                                   (__bridge CFStringRef)kHelperPreferencesDomain,
+                                                                   kCFPreferencesAnyUser, kCFPreferencesAnyHost));
+    if ([requested isKindOfClass:[NSNumber class]] && requested.intValue > 0) {
+        _receiveBufferBytes = PWEventSourceSetReceiveBufferSize(source, requested.intValue);
+    } else {
+        int size = 0;
+        socklen_t length = sizeof(size);
+        _receiveBufferBytes = getsockopt(source->fd, SOL_SOCKET, SO_RCVBUF, &size, &length) == 0 ? size : -1;
+    }
+    os_log(LOG, "Routing socket receive buffer: %d bytes", _receiveBufferBytes);
+}
+
+/// Release the enforcement core and its sockets
+- (void)destroyEnforcer {
+    // Let pending saves reach the disk first
+    if (_stateQueue) {
+        dispatch_sync(_stateQueue, ^{});
+    }
+    if (_enforcer) {
+        PWEnforcerDestroy(_enforcer);
+        _enforcer = NULL;
     }
-    // else: interface is already in desired state, do nothing
 }
 
 /// Main method for the background ioctlThread.
-/// Watches AWDL interface state and brings it up/down as needed.
+/// Runs the enforcement loop, which watches AWDL state and brings it up/down as needed.
 - (void)pollIoctl {
     os_log(LOG, "pollIoctl thread started");
 
-    BOOL quit = NO;
-    BOOL enable = _awdlEnabled;
-
-    while (!quit) {
-        struct pollfd fds[] = {
-            {
-                .fd = _rtfd,
-                .events = POLLIN,
-                .revents = 0
-            },
-            {
-                .fd = _msgfds[0],
-                .events = POLLIN,
-                .revents = 0
-            }
-        };
-
-        // Block until we get a routing message or internal message
-        if (poll(fds, 2, -1) < 1) {
-            if (errno == EINTR) {
-                continue;
-            }
-            os_log_error(LOG, "Poll error: %d (%s)", errno, strerror(errno));
-            break;
-        }
+    // Fault in the stack the loop will use, so the first intervention does not pay for it
+    PWEnforcerPrepareThread(_enforcer);
 
-        // Check for routing table changes (interface state changes)
-        if (fds[0].revents) {
-            os_log_debug(LOG, "Network route changed");
-            int ifflag = 0;
-            // Use larger buffer to handle all routing message types
-            // Messages can include sockaddr structures appended after headers
-            uint8_t rtmsgbuff[RTMSG_BUFFER_SIZE] = {0};
-
-            for (ssize_t len = 0; !quit;) {
-                len = read(_rtfd, rtmsgbuff, sizeof(rtmsgbuff));
-                if (len < 0) {
-                    if (errno == EINTR) {
-                        continue;
-                    } else if (errno == EAGAIN) {
-                        break;
-                    }
-                    os_log_error(LOG, "Error reading AF_ROUTE socket: %d (%s)", errno, strerror(errno));
-                    break;  // Exit loop on unexpected errors
-                }
-                if (len == 0) {
-                    break;  // Socket closed
-                }
-
-                // Validate message length before casting
-                if (len < (ssize_t)sizeof(struct rt_msghdr)) {
-                    os_log_debug(LOG, "Routing message too short: %zd bytes (min %zu)", len, sizeof(struct rt_msghdr));
-                    continue;
-                }
-
-                struct rt_msghdr *rtmsg = (void *)rtmsgbuff;
-
-                // Additional validation: check rtm_msglen matches actual data
-                if (rtmsg->rtm_msglen > len || rtmsg->rtm_msglen < sizeof(struct rt_msghdr)) {
-                    os_log_debug(LOG, "Invalid rtm_msglen: %hu (actual read: %zd)", rtmsg->rtm_msglen, len);
-                    continue;
-                }
-
-                if (rtmsg->rtm_type != RTM_IFINFO) {
-                    continue;
-                }
-
-                // Validate we have enough data for if_msghdr
-                if (len < (ssize_t)sizeof(struct if_msghdr)) {
-                    os_log_debug(LOG, "IFINFO message too short: %zd bytes (min %zu)", len, sizeof(struct if_msghdr));
-                    continue;
-                }
-
-                // Get interface ID for awdl0
-                static int consecutiveIfFailures = 0;
-                unsigned int ifidx = if_nametoindex(TARGETIFNAM);
-                if (!ifidx) {
-                    consecutiveIfFailures++;
-                    os_log_error(LOG, "Error getting interface index for %s (%d consecutive failures)",
-                                 TARGETIFNAM, consecutiveIfFailures);
-                    if (consecutiveIfFailures > 10) {
-                        os_log_error(LOG, "Too many failures getting interface - AWDL may not exist on this system");
-                        // Don't quit, just log - interface might become available later
-                    }
-                    continue;
-                }
-                consecutiveIfFailures = 0;  // Reset on success
-
-                struct if_msghdr *ifmsg = (void *)rtmsg;
-                if ((unsigned int)ifmsg->ifm_index != ifidx) {
-                    // Not the interface we're watching
-                    continue;
-                }
-
-                ifflag = ifmsg->ifm_flags;
-            }
+    os_unfair_lock_lock(&_realtimeLock);
+    _loopThread = pthread_self();
+    _loopThreadRunning = YES;
+    if (_realtimeSchedulingEnabled && !PWRealtimeEnable(_loopThread, &kRealtimeConfig)) {
+        _realtimeSchedulingEnabled = NO;
+    }
+    if (_memoryLockingEnabled && !PWEnforcerSetMemoryLocked(_enforcer, true)) {
+        _memoryLockingEnabled = NO;
+    }
+    os_unfair_lock_unlock(&_realtimeLock);
 
-            // If AWDL was brought UP by the system but we want it DOWN
-            // Use the ifconfig method to ensure proper thread-safety checks
-            if ((ifflag & IFF_UP) && !enable) {
-                // Increment intervention counter (thread-safe atomic operation)
-                int count = atomic_fetch_add(&_interventionCount, 1) + 1;
-                os_log(LOG, "AWDL intervention #%d - System tried to bring interface UP, blocking it", count);
-                [self ifconfig:NO];
-            }
-        }
+    PWEnforcerRun(_enforcer);
 
-        // Check for internal messages (enable/disable/quit)
-        if (fds[1].revents) {
-            char msg = 0;
-            for (ssize_t len = 0; !quit;) {
-                len = read(_msgfds[0], &msg, 1);
-                if (len < 0) {
-                    if (errno == EINTR) {
-                        continue;
-                    } else if (errno == EAGAIN) {
-                        break;
-                    }
-                    os_log_error(LOG, "Error reading message pipe: %d (%s)", errno, strerror(errno));
-                    break;  // Exit loop on unexpected errors
-                }
-                if (len == 0) {
-                    break;  // Pipe closed
-                }
-
-                switch (msg) {
-                    case 'Q':
-                        os_log(LOG, "Received quit message");
-                        quit = YES;
-                        break;
-                    case 'U':
-                        os_log(LOG, "Bringing AWDL interface UP (enabling)");
-                        enable = YES;
-                        [self ifconfig:YES];
-                        break;
-                    case 'D':
-                        os_log(LOG, "Bringing AWDL interface DOWN (disabling)");
-                        enable = NO;
-                        [self ifconfig:NO];
-                        break;
-                    default:
-                        os_log_debug(LOG, "Unknown message: %c", msg);
-                        break;
-                }
-            }
-        }
+    os_unfair_lock_lock(&_realtimeLock);
+    // The locked stack belongs to this thread; release it before the thread goes away
+    if (_memoryLockingEnabled) {
+        PWEnforcerSetMemoryLocked(_enforcer, false);
     }
+    _loopThreadRunning = NO;
+    os_unfair_lock_unlock(&_realtimeLock);
 
     atomic_store(&_threadRunning, false);
     dispatch_semaphore_signal(_ioctlThreadExitSemaphore);
     os_log(LOG, "pollIoctl thread exiting");
 }
 
-/// Write a single byte to the message pipe with retry logic
-- (BOOL)writeMessageToPipe:(const char *)msg {
-    if (_msgfds[1] == INVALID_FD) {
-        os_log_error(LOG, "Cannot write to pipe: fd is invalid");
-        return NO;
+- (BOOL)awdlEnabled {
+    // The enforcer's mailbox is the single source of truth for every interface's policy
+    return _enforcer ? (PWEnforcerGetPolicy(_enforcer) >> kAWDLSlot) & 1 : YES;
+}
+
+- (void)setAwdlEnabled:(BOOL)awdlEnabled {
+    if (!_enforcer || !PWEnforcerSetPolicy(_enforcer, awdlEnabled ? 1u << kAWDLSlot : 0, 1u << kAWDLSlot)) {
+        os_log_error(LOG, "Failed to send %s message to enforcement loop", awdlEnabled ? "enable" : "disable");
+        return;
     }
+    [self persistState];
+}
 
-    // Retry up to 3 times on EINTR
-    for (int retry = 0; retry < 3; retry++) {
-        ssize_t written = write(_msgfds[1], msg, 1);
-        if (written == 1) {
-            return YES;
-        }
-        if (written < 0) {
-            if (errno == EINTR) {
-                os_log_debug(LOG, "Write interrupted, retrying (attempt %d)", retry + 1);
-                continue;
-            }
-            os_log_error(LOG, "Error writing to message pipe: %d (%s)", errno, strerror(errno));
-            return NO;
-        }
-        // written == 0 means nothing was written
-        os_log_info(LOG, "Partial write to message pipe: wrote %zd bytes", written);
+- (BOOL)realtimeSchedulingEnabled {
+    os_unfair_lock_lock(&_realtimeLock);
+    BOOL enabled = _realtimeSchedulingEnabled;
+    os_unfair_lock_unlock(&_realtimeLock);
+    return enabled;
+}
+
+- (BOOL)setRealtimeSchedulingEnabled:(BOOL)enabled {
+    os_unfair_lock_lock(&_realtimeLock);
+    BOOL success = YES;
+    if (_loopThreadRunning && enabled != _realtimeSchedulingEnabled) {
+        success = enabled ? PWRealtimeEnable(_loopThread, &kRealtimeConfig)
+                          : PWRealtimeDisable(_loopThread);
     }
-    os_log_error(LOG, "Failed to write message after 3 retries");
-    return NO;
+    if (success) {
+        _realtimeSchedulingEnabled = enabled;
+    }
+    os_unfair_lock_unlock(&_realtimeLock);
+    if (success) {
+        [self persistState];
+    }
+    return success;
 }
 
-- (void)setAwdlEnabled:(BOOL)awdlEnabled {
-    _awdlEnabled = awdlEnabled;
-    const char *msg = awdlEnabled ? "U" : "D";
-    if (![self writeMessageToPipe:msg]) {
-        os_log_error(LOG, "Failed to send %s message to pipe", awdlEnabled ? "enable" : "disable");
+- (BOOL)memoryLockingEnabled {
+    os_unfair_lock_lock(&_realtimeLock);
+    BOOL enabled = _memoryLockingEnabled;
+    os_unfair_lock_unlock(&_realtimeLock);
+    return enabled;
+}
+
+- (BOOL)setMemoryLockingEnabled:(BOOL)enabled {
+    os_unfair_lock_lock(&_realtimeLock);
+    BOOL success = YES;
+    if (_loopThreadRunning && enabled != _memoryLockingEnabled) {
+        success = PWEnforcerSetMemoryLocked(_enforcer, enabled);
+    }
+    if (success) {
+        _memoryLockingEnabled = enabled;
     }
+    os_unfair_lock_unlock(&_realtimeLock);
+    if (success) {
+        [self persistState];
+    }
+    return success;
 }
 
 - (void)invalidate {
     os_log(LOG, "PingWardenMonitor invalidating...");
 
     // Only send quit if thread is running (atomic read)
-    if (atomic_load(&_threadRunning) && _msgfds[1] != INVALID_FD) {
-        // Send quit message to background thread with retry
-        if (![self writeMessageToPipe:"Q"]) {
-            os_log_error(LOG, "Failed to send quit message to pipe - thread may not exit cleanly");
+    if (atomic_load(&_threadRunning) && _enforcer) {
+        if (!PWEnforcerStop(_enforcer)) {
+            os_log_error(LOG, "Failed to send quit message - thread may not exit cleanly");
         }
 
         // Wait for background thread to exit (with timeout)
-        // Use a shorter initial timeout, then check if thread is still running
         dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(5.0 * NSEC_PER_SEC));
         long result = dispatch_semaphore_wait(_ioctlThreadExitSemaphore, timeout);
         if (result != 0) {
             os_log_error(LOG, "Timeout waiting for pollIoctl thread to exit");
             // Mark thread as not running to prevent further issues (atomic write)
             atomic_store(&_threadRunning, false);
+            // The loop may still be using the enforcer; leak it rather than free under it,
+            // along with the dispatch source its callback pokes
+            _enforcer = NULL;
+            _lifetime = NULL;
+            _statusPage = NULL;
+            (void)CFBridgingRetain(_interventionSource);
         }
     }
 
-    // Clean up file descriptors after thread exits
-    [self cleanupFileDescriptors];
+    // Clean up the enforcement core after thread exits
+    [self destroyEnforcer];
+    if (_interventionSource) {
+        dispatch_source_cancel(_interventionSource);
+    }
 
     os_log(LOG, "PingWardenMonitor invalidated");
 }
@@ -408,19 +541,337 @@ _Static_assert(sizeof("awdl0") <= IFNAMSIZ, "TARGETIFNAM must fit in IFNAMSIZ");
     if (atomic_load(&_threadRunning)) {
         [self invalidate];
     } else {
-        [self cleanupFileDescriptors];
+        [self destroyEnforcer];
+    }
+    if (_lifetimeFlushTimer) {
+        dispatch_source_cancel(_lifetimeFlushTimer);
+        dispatch_sync(_stateQueue, ^{});
+    }
+    if (_lifetime) {
+        PWLifetimeClose(_lifetime);
+        _lifetime = NULL;
+    }
+    if (_statusPage) {
+        PWStatusPageDestroy(_statusPage);
+        _statusPage = NULL;
+    }
+    if (_stateFile) {
+        PWStateFileClose(_stateFile);
+        _stateFile = NULL;
+    }
+}
+
+#pragma mark - Interface Policy
+
+- (NSArray<NSDictionary<NSString *, id> *> *)interfacePolicy {
+    NSMutableArray<NSDictionary<NSString *, id> *> *table = [NSMutableArray arrayWithCapacity:kTargetInterfaceCount];
+    if (!_enforcer) {
+        return table;
+    }
+    PWTargetStats stats;
+    for (size_t slot = 0; PWEnforcerGetTargetStats(_enforcer, slot, &stats); slot++) {
+        [table addObject:@{
+            @"name": @(stats.ifname),
+            @"allowed": @(stats.allowUp),
+            @"ifindex": @(stats.ifindex),
+            @"interventions": @(stats.interventions),
+            @"resyncInterventions": @(stats.resyncInterventions),
+        }];
+    }
+    return table;
+}
+
+- (BOOL)setInterfacePolicy:(NSDictionary<NSString *, NSNumber *> *)policy {
+    if (!_enforcer) {
+        return NO;
+    }
+    uint32_t allowMask = 0;
+    uint32_t changeMask = 0;
+    for (NSString *name in policy) {
+        int slot = [name isKindOfClass:[NSString class]] ? PWEnforcerFindTarget(_enforcer, name.UTF8String) : -1;
+        if (slot < 0 || ![policy[name] isKindOfClass:[NSNumber class]]) {
+            os_log_error(LOG, "Rejecting interface policy: %{public}@ is not in the table", name);
+            return NO;
+        }
+        changeMask |= 1u << slot;
+        allowMask |= policy[name].boolValue ? 1u << slot : 0;
     }
+    // One mailbox update, so the loop never sees half of the change
+    if (!PWEnforcerSetPolicy(_enforcer, allowMask, changeMask)) {
+        os_log_error(LOG, "Failed to send interface policy to enforcement loop");
+        return NO;
+    }
+    [self persistState];
+    return YES;
 }
 
 #pragma mark - Intervention Counter
 
 - (NSInteger)getInterventionCount {
-    return atomic_load(&_interventionCount);
+    return _enforcer ? (NSInteger)PWEnforcerGetInterventionCount(_enforcer) : 0;
 }
 
 - (void)resetInterventionCount {
-    atomic_store(&_interventionCount, 0);
+    if (_enforcer) {
+        PWEnforcerResetInterventionCount(_enforcer);
+        // An empty command wakes the loop so the status page republishes the zeroed counters
+        PWEnforcerSetPolicy(_enforcer, 0, 0);
+    }
     os_log(LOG, "Intervention counter reset to 0");
 }
 
+#pragma mark - Reaction Times
+
+static NSDictionary<NSString *, id> *PWHistogramSnapshotDictionary(const PWHistogramSnapshot *snapshot) {
+    NSMutableArray<NSArray<NSNumber *> *> *buckets = [NSMutableArray array];
+    for (size_t i = 0; i < PW_HISTOGRAM_BUCKET_COUNT; i++) {
+        if (snapshot->counts[i]) {
+            [buckets addObject:@[@(PWHistogramBucketUpperBound(i)), @(snapshot->counts[i])]];
+        }
+    }
+    return @{
+        @"count": @(snapshot->total),
+        @"p50": @(PWHistogramValueAtPercentile(snapshot, 50.0)),
+        @"p99": @(PWHistogramValueAtPercentile(snapshot, 99.0)),
+        @"max": @(snapshot->max),
+        @"buckets": buckets,
+    };
+}
+
+- (NSDictionary<NSString *, id> *)reactionTimeHistogram {
+    static NSString *const stageKeys[PWReactionStageCount] = {
+        [PWReactionStageDecision] = @"receiveToDecision",
+        [PWReactionStageActuation] = @"decisionToActuation",
+        [PWReactionStageTotal] = @"receiveToActuation",
+    };
+
+    NSMutableDictionary<NSString *, id> *histogram = [NSMutableDictionary dictionary];
+    if (!_enforcer) {
+        return histogram;
+    }
+    // Copied from the loop's live counters; the enforcement thread is not involved
+    PWHistogramSnapshot snapshot;
+    for (PWReactionStage stage = 0; stage < PWReactionStageCount; stage++) {
+        PWEnforcerCopyReactionHistogram(_enforcer, stage, &snapshot);
+        histogram[stageKeys[stage]] = PWHistogramSnapshotDictionary(&snapshot);
+    }
+    PWEnforcerCopyWakeupHistogram(_enforcer, &snapshot);
+    histogram[@"eventToWakeup"] = PWHistogramSnapshotDictionary(&snapshot);
+    return histogram;
+}
+
+#pragma mark - Self-Test
+
+- (NSDictionary<NSString *, id> *)selfTestOnInterface:(NSString *)name rounds:(NSUInteger)rounds {
+    if (!_enforcer) {
+        return @{ @"error": @"The monitor is not running" };
+    }
+    int slot = PWEnforcerFindTarget(_enforcer, name.UTF8String);
+    PWTargetStats stats;
+    if (slot < 0 || !PWEnforcerGetTargetStats(_enforcer, (size_t)slot, &stats)) {
+        return @{ @"error": [NSString stringWithFormat:@"%@ is not in the table", name] };
+    }
+    if (stats.allowUp) {
+        return @{ @"error": [NSString stringWithFormat:@"%@ is allowed UP; block it first", name] };
+    }
+    if (stats.ifindex == 0) {
+        return @{ @"error": [NSString stringWithFormat:@"%@ does not exist", name] };
+    }
+
+    uint32_t count = (uint32_t)MIN(MAX(rounds, (NSUInteger)1), (NSUInteger)PW_SELF_TEST_MAX_ROUNDS);
+    PWSelfTestSample *samples = calloc(count, sizeof(*samples));
+    if (!samples) {
+        return @{ @"error": @"Out of memory" };
+    }
+    PWSelfTestResult result;
+    os_log(LOG, "Self-test: raising %{public}@ %u times", name, count);
+    BOOL completed = PWSelfTestRun(_enforcer, (size_t)slot, count, samples, &result);
+
+    NSMutableArray<NSArray<NSNumber *> *> *sampleList = [NSMutableArray arrayWithCapacity:result.rounds];
+    for (uint32_t i = 0; i < result.rounds; i++) {
+        uint64_t seen = samples[i].seenAt > samples[i].raisedAt ? samples[i].seenAt - samples[i].raisedAt : 0;
+        uint64_t down = samples[i].downAt ? samples[i].downAt - samples[i].raisedAt : 0;
+        [sampleList addObject:@[@(seen), @(down)]];
+    }
+    free(samples);
+    os_log(LOG, "Self-test: %{public}@ lowered %u of %u raises", name, result.lowered, result.rounds);
+
+    NSMutableDictionary<NSString *, id> *reply = [@{
+        @"rounds": @(result.rounds),
+        @"lowered": @(result.lowered),
+        @"raiseToSeen": PWHistogramSnapshotDictionary(&result.raiseToSeen),
+        @"raiseToDown": PWHistogramSnapshotDictionary(&result.raiseToDown),
+        @"samples": sampleList,
+    } mutableCopy];
+    if (!completed) {
+        reply[@"error"] = [NSString stringWithFormat:@"Stopped after %u of %u raises; see the helper log",
+                                                     result.rounds, count];
+    }
+    return reply;
+}
+
+#pragma mark - Overflow Recovery
+
+- (NSDictionary<NSString *, NSNumber *> *)eventSourceCounters {
+    if (!_enforcer) {
+        return @{};
+    }
+    PWResyncStats stats;
+    PWEnforcerGetResyncStats(_enforcer, &stats);
+    return @{
+        @"overflows": @(stats.overflows),
+        @"resyncs": @(stats.resyncs),
+        @"resyncInterventions": @(stats.resyncInterventions),
+        @"receiveBufferBytes": @(_receiveBufferBytes),
+    };
+}
+
+#pragma mark - Memory Residency
+
+- (NSDictionary<NSString *, NSNumber *> *)memoryStatistics {
+    if (!_enforcer) {
+        return @{};
+    }
+    PWMemoryStats stats;
+    PWEnforcerGetMemoryStats(_enforcer, &stats);
+    return @{
+        @"locked": @(stats.locked),
+        @"lockedBytes": @(stats.lockedBytes),
+        @"prefaultedBytes": @(stats.prefaultedBytes),
+        @"faultsAvailable": @(stats.faultsAvailable),
+        @"faultsPerThread": @(stats.faultsPerThread),
+        @"minorFaults": @(stats.minorFaults),
+        @"majorFaults": @(stats.majorFaults),
+    };
+}
+
+#pragma mark - Storms
+
+- (NSDictionary<NSString *, id> *)stormStatistics {
+    if (!_enforcer) {
+        return @{};
+    }
+    PWStormStats stats;
+    PWEnforcerGetStormStats(_enforcer, &stats);
+    PWStormEpisode episodes[PW_STORM_EPISODE_CAPACITY];
+    size_t count = PWEnforcerCopyStormEpisodes(_enforcer, episodes, PW_STORM_EPISODE_CAPACITY);
+
+    NSMutableArray<NSDictionary<NSString *, NSNumber *> *> *recent = [NSMutableArray arrayWithCapacity:count];
+    for (size_t i = 0; i < count; i++) {
+        [recent addObject:@{
+            @"sequence": @(episodes[i].sequence),
+            @"startedAt": @(episodes[i].startedAt),
+            @"durationNanos": @(episodes[i].durationNanos),
+            @"interventions": @(episodes[i].interventions),
+            @"peakRate": @(episodes[i].peakRate),
+            @"active": @(episodes[i].active),
+        }];
+    }
+    return @{
+        @"rate": @(stats.rate),
+        @"peakRate": @(stats.peakRate),
+        @"episodeCount": @(stats.episodes),
+        @"storming": @(stats.storming),
+        @"episodes": recent,
+        @"nowNanos": @(PWMonotonicNanos()),
+    };
+}
+
+#pragma mark - Intervention Events
+
+- (NSArray<NSDictionary<NSString *, NSNumber *> *> *)interventionEventsAfterCursor:(uint64_t)cursor
+                                                                     latestSequence:(uint64_t *)latestSequence {
+    *latestSequence = 0;
+    if (!_enforcer) {
+        return @[];
+    }
+
+    // Read straight from the loop's ring; no locks, no round trip through the loop thread
+    PWInterventionEvent events[PW_EVENT_RING_CAPACITY];
+    size_t count = PWEnforcerCopyInterventionEvents(_enforcer, cursor, events, PW_EVENT_RING_CAPACITY);
+
+    NSMutableArray<NSDictionary<NSString *, NSNumber *> *> *result = [NSMutableArray arrayWithCapacity:count];
+    for (size_t i = 0; i < count; i++) {
+        [result addObject:@{
+            @"sequence": @(events[i].sequence),
+            @"timestamp": @(events[i].timestamp),
+            @"flags": @(events[i].flags),
+            @"trigger": @(events[i].trigger),
+            @"interface": @(events[i].target),
+        }];
+    }
+    *latestSequence = PWEnforcerGetLatestInterventionSequence(_enforcer);
+    return result;
+}
+
+- (uint64_t)latestInterventionSequence {
+    return _enforcer ? PWEnforcerGetLatestInterventionSequence(_enforcer) : 0;
+}
+
+#pragma mark - Trace
+
+- (NSArray<NSArray<NSNumber *> *> *)traceRecordsAfterCursor:(uint64_t)cursor latestSequence:(uint64_t *)latestSequence {
+    *latestSequence = 0;
+    if (!_enforcer) {
+        return @[];
+    }
+
+    // Formatted here, on the caller's thread; the loop only ever stored integers
+    PWTraceRecord *records = malloc(sizeof(PWTraceRecord) * PW_TRACE_RING_CAPACITY);
+    if (!records) {
+        return @[];
+    }
+    size_t count = PWEnforcerCopyTrace(_enforcer, cursor, records, PW_TRACE_RING_CAPACITY);
+
+    NSMutableArray<NSArray<NSNumber *> *> *result = [NSMutableArray arrayWithCapacity:count];
+    for (size_t i = 0; i < count; i++) {
+        [result addObject:@[
+            @(records[i].sequence),
+            @(records[i].timestamp),
+            @(records[i].event),
+            @(records[i].arg0),
+            @(records[i].arg1),
+        ]];
+    }
+    free(records);
+    *latestSequence = PWEnforcerGetLatestTraceSequence(_enforcer);
+    return result;
+}
+
+#pragma mark - Snapshot
+
+- (NSDictionary<NSString *, id> *)helperSnapshot {
+    if (!_enforcer) {
+        return @{};
+    }
+    // Fresh SIOCGIFFLAGS reads on a socket of our own, not the loop's cached flags or its
+    // actuator: the health check wants the kernel's word, and the loop must not be involved
+    int fd = PWInterfaceFlagsOpenSocket();
+    NSArray<NSDictionary<NSString *, id> *> *policy = [self interfacePolicy];
+    NSMutableArray<NSDictionary<NSString *, id> *> *interfaces = [NSMutableArray arrayWithCapacity:policy.count];
+    for (NSDictionary<NSString *, id> *entry in policy) {
+        NSMutableDictionary<NSString *, id> *interface = [entry mutableCopy];
+        uint32_t flags;
+        if (fd >= 0 && PWInterfaceFlagsGet(fd, [entry[@"name"] UTF8String], &flags)) {
+            interface[@"flags"] = @(flags);
+        }
+        [interfaces addObject:interface];
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    return @{
+        @"awdlEnabled": @(self.awdlEnabled),
+        @"interventionCount": @([self getInterventionCount]),
+        @"interfaces": interfaces,
+        @"reactionTimes": [self reactionTimeHistogram],
+        @"eventSource": [self eventSourceCounters],
+        @"storms": [self stormStatistics],
+        @"memory": [self memoryStatistics],
+        @"startup": [self startupStatistics],
+        @"lifetime": [self lifetimeStatistics],
+    };
+}
+
 @end
@@ -0,0 +1,38 @@
+//
+//  PingWardenUpdatePublisher.h
+//  PingWardenHelper
+//
+//  Pushes intervention batches and state changes to registered XPC clients.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "PingWardenMonitor.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Tracks clients registered through -registerForUpdatesAfterCursor:... and pushes
+/// PingWardenHelperClientProtocol calls to them. Each client keeps its own cursor and
+/// flush rate; interventions that arrive faster than that rate are batched.
+@interface PingWardenUpdatePublisher : NSObject
+
+- (instancetype)initWithMonitor:(PingWardenMonitor *)monitor NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Start pushing to connection. Sends the current AWDL state and anything after cursor right away.
+- (void)registerConnection:(NSXPCConnection *)connection
+               afterCursor:(uint64_t)cursor
+       maxFlushesPerSecond:(double)maxFlushesPerSecond;
+
+/// Forget connection; call from its invalidation handler.
+- (void)removeConnection:(NSXPCConnection *)connection;
+
+/// Tell every registered client about a desired-state change.
+- (void)publishAWDLEnabled:(BOOL)enabled;
+
+@end
+
+NS_ASSUME_NONNULL_END
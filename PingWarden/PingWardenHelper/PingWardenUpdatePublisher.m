@@ -0,0 +1,180 @@
+//
+//  PingWardenUpdatePublisher.m
+//  PingWardenHelper
+//
+//  Pushes intervention batches and state changes to registered XPC clients.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#import "PingWardenUpdatePublisher.h"
+
+#import <os/log.h>
+
+#import "../Common/HelperProtocol.h"
+#import "Core/PWClock.h"
+
+#define LOG OS_LOG_DEFAULT
+
+// Used when a client passes 0; fast enough for the UI, slow enough to batch storms
+static const double DEFAULT_MAX_FLUSHES_PER_SECOND = 10.0;
+static const double MIN_MAX_FLUSHES_PER_SECOND = 0.1;
+static const double MAX_MAX_FLUSHES_PER_SECOND = 1000.0;
+
+#pragma mark - Subscription
+
+/// Per-client push state. Only touched on the publisher's queue.
+@interface PingWardenUpdateSubscription : NSObject
+
+@property (strong) NSXPCConnection *connection;
+@property uint64_t cursor;
+@property uint64_t minFlushIntervalNanos;
+@property uint64_t lastFlushAt;
+@property BOOL flushScheduled;
+
+@end
+
+@implementation PingWardenUpdateSubscription
+@end
+
+#pragma mark - PingWardenUpdatePublisher
+
+@interface PingWardenUpdatePublisher ()
+
+@property (strong) PingWardenMonitor *monitor;
+@property (strong) dispatch_queue_t queue;
+@property (strong) NSMutableArray<PingWardenUpdateSubscription *> *subscriptions;
+
+@end
+
+@implementation PingWardenUpdatePublisher
+
+- (instancetype)initWithMonitor:(PingWardenMonitor *)monitor {
+    if (self = [super init]) {
+        _monitor = monitor;
+        _queue = dispatch_queue_create("com.amesvt.pingwarden.helper.updates", DISPATCH_QUEUE_SERIAL);
+        _subscriptions = [NSMutableArray array];
+
+        __weak typeof(self) weakSelf = self;
+        monitor.interventionHandler = ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (!strongSelf) {
+                return;
+            }
+            dispatch_async(strongSelf.queue, ^{
+                for (PingWardenUpdateSubscription *subscription in strongSelf.subscriptions) {
+                    [strongSelf scheduleFlush:subscription];
+                }
+            });
+        };
+    }
+    return self;
+}
+
+- (id<PingWardenHelperClientProtocol>)clientForSubscription:(PingWardenUpdateSubscription *)subscription {
+    return [subscription.connection remoteObjectProxyWithErrorHandler:^(NSError *error) {
+        // The connection's invalidation handler removes the subscription
+        os_log_debug(LOG, "Push to client failed: %{public}@", error.localizedDescription);
+    }];
+}
+
+- (void)registerConnection:(NSXPCConnection *)connection
+               afterCursor:(uint64_t)cursor
+       maxFlushesPerSecond:(double)maxFlushesPerSecond {
+    double rate = maxFlushesPerSecond > 0 ? maxFlushesPerSecond : DEFAULT_MAX_FLUSHES_PER_SECOND;
+    rate = MIN(MAX(rate, MIN_MAX_FLUSHES_PER_SECOND), MAX_MAX_FLUSHES_PER_SECOND);
+    BOOL enabled = self.monitor.awdlEnabled;
+
+    dispatch_async(self.queue, ^{
+        PingWardenUpdateSubscription *subscription = nil;
+        for (PingWardenUpdateSubscription *existing in self.subscriptions) {
+            if (existing.connection == connection) {
+                subscription = existing;
+                break;
+            }
+        }
+        if (!subscription) {
+            subscription = [PingWardenUpdateSubscription new];
+            subscription.connection = connection;
+            [self.subscriptions addObject:subscription];
+        }
+
+        uint64_t latestSequence = [self.monitor latestInterventionSequence];
+        // A cursor from before a helper restart is meaningless; start over
+        subscription.cursor = cursor <= latestSequence ? cursor : 0;
+        subscription.minFlushIntervalNanos = (uint64_t)(NSEC_PER_SEC / rate);
+        subscription.lastFlushAt = 0;
+
+        os_log(LOG, "Client PID %d registered for updates (cursor %llu, %.1f flushes/s, %lu client(s))",
+               connection.processIdentifier, subscription.cursor, rate,
+               (unsigned long)self.subscriptions.count);
+
+        [[self clientForSubscription:subscription] helperDidChangeAWDLEnabled:enabled];
+        [self scheduleFlush:subscription];
+    });
+}
+
+- (void)removeConnection:(NSXPCConnection *)connection {
+    dispatch_async(self.queue, ^{
+        NSUInteger index = [self.subscriptions indexOfObjectPassingTest:^BOOL(PingWardenUpdateSubscription *subscription,
+                                                                             NSUInteger idx, BOOL *stop) {
+            return subscription.connection == connection;
+        }];
+        if (index != NSNotFound) {
+            [self.subscriptions removeObjectAtIndex:index];
+            os_log_debug(LOG, "Client unregistered, %lu remaining", (unsigned long)self.subscriptions.count);
+        }
+    });
+}
+
+- (void)publishAWDLEnabled:(BOOL)enabled {
+    dispatch_async(self.queue, ^{
+        for (PingWardenUpdateSubscription *subscription in self.subscriptions) {
+            [[self clientForSubscription:subscription] helperDidChangeAWDLEnabled:enabled];
+        }
+    });
+}
+
+#pragma mark - Flushing (publisher queue only)
+
+/// Flush now if the client's rate allows it, otherwise once it does. At most one flush
+/// is pending per client, so a storm costs one batch per interval.
+- (void)scheduleFlush:(PingWardenUpdateSubscription *)subscription {
+    if (subscription.flushScheduled) {
+        return;
+    }
+
+    uint64_t now = PWMonotonicNanos();
+    uint64_t due = subscription.lastFlushAt + subscription.minFlushIntervalNanos;
+    if (subscription.lastFlushAt == 0 || due <= now) {
+        [self flush:subscription];
+        return;
+    }
+
+    subscription.flushScheduled = YES;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(due - now)), self.queue, ^{
+        subscription.flushScheduled = NO;
+        if ([self.subscriptions containsObject:subscription]) {
+            [self flush:subscription];
+        }
+    });
+}
+
+- (void)flush:(PingWardenUpdateSubscription *)subscription {
+    uint64_t latestSequence = 0;
+    NSArray<NSDictionary<NSString *, NSNumber *> *> *events =
+        [self.monitor interventionEventsAfterCursor:subscription.cursor latestSequence:&latestSequence];
+    if (events.count == 0) {
+        return;
+    }
+
+    subscription.cursor = events.lastObject[@"sequence"].unsignedLongLongValue;
+    subscription.lastFlushAt = PWMonotonicNanos();
+    [[self clientForSubscription:subscription] helperDidRecordInterventions:events
+                                                             latestSequence:latestSequence
+                                                                   nowNanos:subscription.lastFlushAt
+                                                          interventionCount:[self.monitor getInterventionCount]];
+}
+
+@end
@@ -16,6 +16,8 @@
 
 #import "../Common/HelperProtocol.h"
 #import "PingWardenMonitor.h"
+#import "PingWardenUpdatePublisher.h"
+#import "Core/PWClock.h"
 
 #define LOG OS_LOG_DEFAULT
 #define HELPER_VERSION @"2.1.2"
@@ -64,6 +66,7 @@ static BOOL isProperlyCodeSigned(void) {
 @interface PingWardenService : NSObject <PingWardenHelperProtocol, NSXPCListenerDelegate>
 
 @property (strong) PingWardenMonitor *monitor;
+@property (strong) PingWardenUpdatePublisher *publisher;
 
 @end
 
@@ -76,6 +79,7 @@ static BOOL isProperlyCodeSigned(void) {
             os_log_error(LOG, "Failed to initialize PingWardenMonitor");
             return nil;
         }
+        self.publisher = [[PingWardenUpdatePublisher alloc] initWithMonitor:self.monitor];
     }
     return self;
 }
@@ -112,6 +116,11 @@ static BOOL isProperlyCodeSigned(void) {
 
     // Reply immediately - the state change command has been sent
     reply(success);
+
+    // Let every registered client (app, widget) see the change without polling
+    if (success) {
+        [self.publisher publishAWDLEnabled:enable];
+    }
 }
 
 - (void)getAWDLStatusWithReply:(void (^)(NSString *))reply {
@@ -137,6 +146,128 @@ static BOOL isProperlyCodeSigned(void) {
     reply(YES);
 }
 
+- (void)getAWDLReactionHistogramWithReply:(void (^)(NSDictionary<NSString *, id> *))reply {
+    NSDictionary<NSString *, id> *histogram = [self.monitor reactionTimeHistogram];
+    os_log_debug(LOG, "getAWDLReactionHistogram: %lu stages", (unsigned long)histogram.count);
+    reply(histogram);
+}
+
+- (void)getAWDLInterventionEventsAfterCursor:(uint64_t)cursor
+                                   withReply:(void (^)(NSArray<NSDictionary<NSString *, NSNumber *> *> *, uint64_t, uint64_t, NSInteger))reply {
+    uint64_t latestSequence = 0;
+    NSArray<NSDictionary<NSString *, NSNumber *> *> *events = [self.monitor interventionEventsAfterCursor:cursor
+                                                                                           latestSequence:&latestSequence];
+    os_log_debug(LOG, "getAWDLInterventionEvents after %llu: %lu events", cursor, (unsigned long)events.count);
+    reply(events, latestSequence, PWMonotonicNanos(), [self.monitor getInterventionCount]);
+}
+
+- (void)getEventSourceCountersWithReply:(void (^)(NSDictionary<NSString *, NSNumber *> *))reply {
+    NSDictionary<NSString *, NSNumber *> *counters = [self.monitor eventSourceCounters];
+    os_log_debug(LOG, "getEventSourceCounters: %{public}@", counters);
+    reply(counters);
+}
+
+- (void)getInterventionStormsWithReply:(void (^)(NSDictionary<NSString *, id> *))reply {
+    NSDictionary<NSString *, id> *storms = [self.monitor stormStatistics];
+    os_log_debug(LOG, "getInterventionStorms: %{public}@ episodes", storms[@"episodeCount"]);
+    reply(storms);
+}
+
+- (void)getInterfacePolicyWithReply:(void (^)(NSArray<NSDictionary<NSString *, id> *> *))reply {
+    NSArray<NSDictionary<NSString *, id> *> *table = [self.monitor interfacePolicy];
+    os_log_debug(LOG, "getInterfacePolicy: %lu interfaces", (unsigned long)table.count);
+    reply(table);
+}
+
+- (void)setInterfacePolicy:(NSDictionary<NSString *, NSNumber *> *)policy withReply:(void (^)(BOOL))reply {
+    os_log(LOG, "setInterfacePolicy: %{public}@", policy);
+    BOOL awdlEnabledBefore = self.monitor.awdlEnabled;
+    BOOL success = [self.monitor setInterfacePolicy:policy];
+    reply(success);
+
+    BOOL awdlEnabled = self.monitor.awdlEnabled;
+    if (success && awdlEnabled != awdlEnabledBefore) {
+        [self.publisher publishAWDLEnabled:awdlEnabled];
+    }
+}
+
+- (void)setRealtimeSchedulingEnabled:(BOOL)enable withReply:(void (^)(BOOL))reply {
+    BOOL success = [self.monitor setRealtimeSchedulingEnabled:enable];
+    os_log(LOG, "setRealtimeSchedulingEnabled: %d (success: %d)", enable, success);
+    reply(success);
+}
+
+- (void)setMemoryLockingEnabled:(BOOL)enable withReply:(void (^)(BOOL))reply {
+    BOOL success = [self.monitor setMemoryLockingEnabled:enable];
+    os_log(LOG, "setMemoryLockingEnabled: %d (success: %d)", enable, success);
+    reply(success);
+}
+
+- (void)getEnforcementMemoryStatsWithReply:(void (^)(NSDictionary<NSString *, NSNumber *> *))reply {
+    NSDictionary<NSString *, NSNumber *> *stats = [self.monitor memoryStatistics];
+    os_log_debug(LOG, "getEnforcementMemoryStats: %{public}@", stats);
+    reply(stats);
+}
+
+- (void)getEnforcementTraceAfterCursor:(uint64_t)cursor
+                             withReply:(void (^)(NSArray<NSArray<NSNumber *> *> *, uint64_t, uint64_t))reply {
+    uint64_t latestSequence = 0;
+    NSArray<NSArray<NSNumber *> *> *records = [self.monitor traceRecordsAfterCursor:cursor latestSequence:&latestSequence];
+    os_log_debug(LOG, "getEnforcementTrace after %llu: %lu records", cursor, (unsigned long)records.count);
+    reply(records, latestSequence, PWMonotonicNanos());
+}
+
+- (void)getStartupStatisticsWithReply:(void (^)(NSDictionary<NSString *, NSNumber *> *))reply {
+    NSDictionary<NSString *, NSNumber *> *stats = [self.monitor startupStatistics];
+    os_log_debug(LOG, "getStartupStatistics: %{public}@", stats);
+    reply(stats);
+}
+
+- (void)getLifetimeStatisticsWithReply:(void (^)(NSDictionary<NSString *, id> *))reply {
+    NSDictionary<NSString *, id> *stats = [self.monitor lifetimeStatistics];
+    os_log_debug(LOG, "getLifetimeStatistics: %{public}@ interventions", stats[@"interventions"]);
+    reply(stats);
+}
+
+- (void)getHelperSnapshotWithReply:(void (^)(NSDictionary<NSString *, id> *))reply {
+    NSMutableDictionary<NSString *, id> *snapshot = [[self.monitor helperSnapshot] mutableCopy];
+    snapshot[@"version"] = HELPER_VERSION;
+    os_log_debug(LOG, "getHelperSnapshot: %lu keys", (unsigned long)snapshot.count);
+    reply(snapshot);
+}
+
+- (void)runSelfTestOnInterface:(NSString *)interfaceName
+                        rounds:(NSUInteger)rounds
+                     withReply:(void (^)(NSDictionary<NSString *, id> *))reply {
+    // Rounds take up to a second each: keep them off the connection's queue, and run one
+    // test at a time so two clients never raise the same interface against each other
+    static dispatch_queue_t selfTestQueue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        selfTestQueue = dispatch_queue_create("com.amesvt.pingwarden.helper.selfTest", DISPATCH_QUEUE_SERIAL);
+    });
+    PingWardenMonitor *monitor = self.monitor;
+    dispatch_async(selfTestQueue, ^{
+        NSDictionary<NSString *, id> *result = [monitor selfTestOnInterface:interfaceName rounds:rounds];
+        os_log_debug(LOG, "runSelfTest %{public}@: %{public}@ of %{public}@ lowered",
+                     interfaceName, result[@"lowered"], result[@"rounds"]);
+        reply(result);
+    });
+}
+
+- (void)registerForUpdatesAfterCursor:(uint64_t)cursor
+                  maxFlushesPerSecond:(double)maxFlushesPerSecond
+                            withReply:(void (^)(BOOL))reply {
+    NSXPCConnection *connection = [NSXPCConnection currentConnection];
+    if (!connection) {
+        os_log_error(LOG, "registerForUpdates called outside an XPC connection");
+        reply(NO);
+        return;
+    }
+    [self.publisher registerConnection:connection afterCursor:cursor maxFlushesPerSecond:maxFlushesPerSecond];
+    reply(YES);
+}
+
 #pragma mark - Lifecycle
 
 - (void)cancelExitTimer {
@@ -178,8 +309,9 @@ static BOOL isProperlyCodeSigned(void) {
 
                 os_log(LOG, "Grace period expired, restoring AWDL and exiting");
 
-                // Restore AWDL to enabled state before exiting
-                [strongSelf.monitor setAwdlEnabled:YES];
+                // Restore AWDL to enabled state before exiting; the persisted state keeps
+                // what clients asked for, so a relaunch enforces it again at once
+                [strongSelf.monitor restoreInterfacesForExit];
                 [strongSelf.monitor invalidate];
 
                 // Give a moment for cleanup, then exit
@@ -213,6 +345,7 @@ static BOOL isProperlyCodeSigned(void) {
     });
 
     __weak typeof(self) weakSelf = self;
+    __weak NSXPCConnection *weakConn = conn;
 
     conn.interruptionHandler = ^{
         os_log(LOG, "XPC connection interrupted");
@@ -221,6 +354,11 @@ static BOOL isProperlyCodeSigned(void) {
     conn.invalidationHandler = ^{
         os_log(LOG, "XPC connection invalidated");
 
+        NSXPCConnection *invalidated = weakConn;
+        if (invalidated) {
+            [weakSelf.publisher removeConnection:invalidated];
+        }
+
         // Use dispatch_async to avoid deadlock
         dispatch_async(connectionCountQueue, ^{
             activeConnectionCount--;
@@ -236,6 +374,8 @@ static BOOL isProperlyCodeSigned(void) {
 
     conn.exportedInterface = [NSXPCInterface interfaceWithProtocol:@protocol(PingWardenHelperProtocol)];
     conn.exportedObject = self;
+    // Clients that register for updates export the reverse interface on the same connection
+    conn.remoteObjectInterface = [NSXPCInterface interfaceWithProtocol:@protocol(PingWardenHelperClientProtocol)];
     [conn resume];
 
     return YES;
@@ -262,7 +402,7 @@ static dispatch_source_t setupSignalHandler(PingWardenService *service) {
         dispatch_source_set_event_handler(signalSource, ^{
             os_log(LOG, "Received SIGTERM via dispatch, performing graceful shutdown");
             if (service && service.monitor) {
-                [service.monitor setAwdlEnabled:YES];
+                [service.monitor restoreInterfacesForExit];
                 [service.monitor invalidate];
             }
             os_log(LOG, "PingWardenHelper exiting due to SIGTERM");
@@ -282,21 +422,23 @@ static dispatch_source_t setupSignalHandler(PingWardenService *service) {
 
 int main(int argc, const char * argv[]) {
     @autoreleasepool {
-        BOOL isSigned = isProperlyCodeSigned();
-        os_log(LOG, "PingWardenHelper v%{public}@ starting (%{public}s)",
-               HELPER_VERSION, isSigned ? "signed" : "unsigned/ad-hoc");
+        os_log(LOG, "PingWardenHelper v%{public}@ starting", HELPER_VERSION);
 
         // Initialize thread-safe queue for connection counting
         connectionCountQueue = dispatch_queue_create("com.amesvt.pingwarden.helper.connectionCount",
                                                      DISPATCH_QUEUE_SERIAL);
 
-        // Initialize the service
+        // Initialize the service first: the monitor restores the persisted state, and the
+        // code signing check below can take tens of milliseconds
         PingWardenService *service = [PingWardenService new];
         if (!service) {
             os_log_error(LOG, "Failed to create PingWardenService, exiting");
             return EXIT_FAILURE;
         }
 
+        BOOL isSigned = isProperlyCodeSigned();
+        os_log(LOG, "Helper binary is %{public}s", isSigned ? "signed" : "unsigned/ad-hoc");
+
         // Create XPC listener for our Mach service
         // The service name must match the MachServices key in the plist
         NSXPCListener *listener = [[NSXPCListener alloc] initWithMachServiceName:@"com.amesvt.pingwarden.xpc"];
@@ -0,0 +1,112 @@
+//
+//  HelperStatusPage.swift
+//  PingWardenWidget
+//
+//  Live helper status read from the page it publishes, without XPC.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+import Foundation
+
+struct HelperStatus: Equatable {
+    struct Interface: Equatable {
+        let name: String
+        /// The interface exists.
+        let isPresent: Bool
+        /// Desired state: false while the helper keeps it down.
+        let allowUp: Bool
+        /// Interface flags as the helper last saw them; nil before it has seen any.
+        let flags: UInt32?
+        /// By the running helper process.
+        let interventions: UInt64
+
+        var isUp: Bool? {
+            flags.map { $0 & UInt32(IFF_UP) != 0 }
+        }
+    }
+
+    /// Publishes so far; unchanged means nothing changed.
+    let sequence: UInt64
+    let helperPID: pid_t
+    /// True while the enforcement loop runs. A crashed helper leaves it set until launchd restarts it.
+    let isRunning: Bool
+    let interfaces: [Interface]
+    /// By the running helper process, every interface.
+    let interventions: UInt64
+    /// Across every helper process; 0 if the helper keeps no counter file.
+    let lifetimeInterventions: UInt64
+    let lastInterventionAt: Date?
+    let updatedAt: Date
+
+    /// True while the helper is running and keeping AWDL down.
+    var isBlockingAWDL: Bool {
+        isRunning && interfaces.first { $0.name == "awdl0" }.map { !$0.allowUp } == true
+    }
+
+    init(snapshot: PWStatusSnapshot) {
+        func date(_ nanos: UInt64) -> Date? {
+            nanos == 0 ? nil : Date(timeIntervalSince1970: TimeInterval(nanos) / 1_000_000_000)
+        }
+        var targets = snapshot.targets
+        let count = min(Int(snapshot.targetCount), Int(PW_STATUS_PAGE_MAX_TARGETS))
+        let interfaces = withUnsafeBytes(of: &targets) { raw in
+            raw.bindMemory(to: PWStatusTarget.self).prefix(count).map { target -> Interface in
+                var ifname = target.ifname
+                let name = withUnsafeBytes(of: &ifname) { bytes in
+                    String(decoding: bytes.prefix { $0 != 0 }, as: UTF8.self)
+                }
+                return Interface(
+                    name: name,
+                    isPresent: target.present,
+                    allowUp: target.allowUp,
+                    flags: target.flagsKnown ? target.flags : nil,
+                    interventions: target.interventions
+                )
+            }
+        }
+        sequence = snapshot.sequence
+        helperPID = pid_t(truncatingIfNeeded: snapshot.writerPid)
+        isRunning = snapshot.running != 0
+        self.interfaces = interfaces
+        interventions = snapshot.interventions
+        lifetimeInterventions = snapshot.lifetimeInterventions
+        lastInterventionAt = date(snapshot.lastInterventionAt)
+        updatedAt = date(snapshot.updatedAt) ?? .distantPast
+    }
+}
+
+/// Maps the helper's status page once and copies snapshots out of it with plain loads.
+/// Reads cost no system call and never wake the helper, so callers may poll freely.
+/// Note: This file should be kept in sync with PingWarden/Core/HelperStatusPage.swift
+final class HelperStatusPage {
+    static let shared = HelperStatusPage()
+
+    /// Written by the helper (kStatusPagePath in PingWardenMonitor.m), readable by everyone.
+    static let path = "/Library/Application Support/PingWarden/Status"
+
+    private let lock = NSLock()
+    private var mapping: UnsafeRawPointer?
+
+    deinit {
+        PWStatusPageUnmap(mapping)
+    }
+
+    /// The helper's latest status, or nil if it has never published one (not installed,
+    /// never run, or a different page version). The file is mapped on first success and
+    /// the mapping stays valid across helper restarts.
+    func read() -> HelperStatus? {
+        lock.lock()
+        if mapping == nil {
+            mapping = PWStatusPageMap(Self.path)
+        }
+        let mapping = self.mapping
+        lock.unlock()
+
+        guard let mapping else { return nil }
+        var snapshot = PWStatusSnapshot()
+        guard PWStatusPageRead(mapping, &snapshot) else { return nil }
+        return HelperStatus(snapshot: snapshot)
+    }
+}
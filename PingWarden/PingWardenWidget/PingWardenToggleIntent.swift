@@ -30,8 +30,10 @@ struct ToggleAWDLMonitoringIntent: AppIntent {
     static var openAppWhenRun: Bool = false
 
     func perform() async throws -> some IntentResult {
-        // Toggle the current state
-        let currentState = PingWardenPreferences.shared.isMonitoringEnabled
+        // Toggle the state the widget shows: the helper's, read from its status page
+        // without an XPC round trip, or the shared preference when it is not running
+        let currentState = HelperStatusPage.shared.read().flatMap { $0.isRunning ? $0.isBlockingAWDL : nil }
+            ?? PingWardenPreferences.shared.isMonitoringEnabled
         let newState = !currentState
         log.info("Toggling monitoring from \(currentState) to \(newState)")
 
@@ -0,0 +1,11 @@
+//
+//  PingWardenWidget-Bridging-Header.h
+//  PingWardenWidget
+//
+//  Bridging header to expose the helper's status page reader to Swift.
+//
+//  Copyright (c) 2025-2026 Oliver Ames. All rights reserved.
+//  Licensed under the MIT License.
+//
+
+#import "../PingWardenHelper/Core/PWStatusPage.h"
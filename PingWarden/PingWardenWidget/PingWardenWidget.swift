@@ -21,7 +21,9 @@ struct PingWardenWidget: ControlWidget {
     var body: some ControlWidgetConfiguration {
         StaticControlConfiguration(kind: Self.kind) {
             ControlWidgetButton(action: ToggleAWDLMonitoringIntent()) {
-                let isOn = PingWardenPreferences.shared.effectiveMonitoringEnabled || PingWardenPreferences.shared.isMonitoringEnabled
+                // What the helper is enforcing right now, when it is running; otherwise the shared preference
+                let isOn = HelperStatusPage.shared.read().flatMap { $0.isRunning ? $0.isBlockingAWDL : nil }
+                    ?? (PingWardenPreferences.shared.effectiveMonitoringEnabled || PingWardenPreferences.shared.isMonitoringEnabled)
                 Label(
                     isOn ? "AWDL Blocked" : "AWDL Allowed",
                     systemImage: isOn ? "antenna.radiowaves.left.and.right.slash" : "antenna.radiowaves.left.and.right"
@@ -35,6 +35,64 @@ enum CoreLogicSmoke {
         assertNearlyEqual(XPCReconnectPolicy.delayForAttempt(3), 4.0, "Third retry delay should be 4 seconds")
         assertNearlyEqual(XPCReconnectPolicy.delayForAttempt(0), 0.0, "Non-positive attempts should return zero")
 
+        let reaction = ReactionTimeHistogram(dictionary: [
+            "receiveToActuation": [
+                "count": NSNumber(value: 3 as UInt64),
+                "p50": NSNumber(value: 63_500 as UInt64),
+                "p99": NSNumber(value: 100_400 as UInt64),
+                "max": NSNumber(value: 160_400 as UInt64),
+                "buckets": [[NSNumber(value: 63_999 as UInt64), NSNumber(value: 2 as UInt64)],
+                            [NSNumber(value: 163_839 as UInt64), NSNumber(value: 1 as UInt64)]]
+            ] as [String: Any]
+        ])
+        assertEqual(reaction.receiveToActuation.count, 3, "Reaction histogram should parse the sample count")
+        assertEqual(reaction.receiveToActuation.p99Nanos, 100_400, "Reaction histogram should parse p99")
+        assertEqual(reaction.receiveToActuation.buckets.count, 2, "Reaction histogram should parse buckets")
+        assertEqual(reaction.receiveToActuation.buckets[1].count, 1, "Bucket counts should be preserved")
+        assertEqual(reaction.receiveToDecision, .empty, "Missing stages should parse as empty")
+        assertEqual(ReactionTimeHistogram(dictionary: [:]), .empty, "Empty reply should parse as empty")
+        assertEqual(ReactionTimeHistogram.formatNanos(850), "850ns", "Sub-microsecond durations use ns")
+        assertEqual(ReactionTimeHistogram.formatNanos(63_500), "63.5µs", "Sub-millisecond durations use µs")
+        assertEqual(ReactionTimeHistogram.formatNanos(4_200_000), "4.20ms", "Longer durations use ms")
+
+        let fetchedAt = Date(timeIntervalSince1970: 1_000_000)
+        let batch = InterventionEventBatch(
+            rawEvents: [
+                ["sequence": 4, "timestamp": 10_000_000_000, "flags": 0x8843, "trigger": 0],
+                ["sequence": 5, "timestamp": 10_500_000_000, "flags": 0x8843, "trigger": 1],
+                ["sequence": 6, "timestamp": 14_000_000_000, "flags": 0x8843, "trigger": 0]
+            ],
+            cursor: 3,
+            latestSequence: 6,
+            nowNanos: 15_000_000_000,
+            interventionCount: 6,
+            receivedAt: fetchedAt
+        )
+        assertEqual(batch.nextCursor, 6, "Next cursor should be the newest event")
+        assertEqual(batch.events[0].date, fetchedAt.addingTimeInterval(-5), "Event time should be relative to helper now")
+        assertEqual(batch.events[1].trigger, .arrival, "Trigger should parse")
+        let clusters = batch.clusters(within: 2)
+        assertEqual(clusters.count, 2, "Events within the window should cluster")
+        assertEqual(clusters[0].count, 2, "First cluster should hold both close events")
+        assertEqual(clusters[1].date, fetchedAt.addingTimeInterval(-1), "Cluster should be dated at its first event")
+
+        let caughtUp = InterventionEventBatch(rawEvents: [], cursor: 6, latestSequence: 6, nowNanos: 0, interventionCount: 6)
+        assertEqual(caughtUp.nextCursor, 6, "Empty batch should keep the cursor")
+        let restarted = InterventionEventBatch(rawEvents: [], cursor: 6, latestSequence: 1, nowNanos: 0, interventionCount: 1)
+        assertEqual(restarted.nextCursor, 0, "Helper restart should reset the cursor")
+        let resent = InterventionEventBatch(
+            rawEvents: [["sequence": 1, "timestamp": 0], ["sequence": 2, "timestamp": 0]],
+            cursor: 6,
+            latestSequence: 2,
+            nowNanos: 0,
+            interventionCount: 2
+        )
+        assertEqual(resent.nextCursor, 2, "Restarted helper's resent events should advance the cursor")
+
+        assertEqual(batch.continuing(from: 4).events.map(\.sequence), [5, 6], "Overlap with a fetch should be dropped")
+        assertEqual(batch.continuing(from: 6).events.count, 0, "Fully seen batch should be empty")
+        assertEqual(resent.continuing(from: 6).events.count, 2, "Restarted sequence should be kept whole")
+
         print("core_logic_smoke.swift: all assertions passed")
     }
 
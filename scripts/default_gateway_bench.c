@@ -0,0 +1,356 @@
+//
+//  default_gateway_bench.c
+//  PingWarden
+//
+//  Compares the dashboard's two ways of finding the local gateway. The old
+//  path spawned `/usr/sbin/route -n get default` and searched its output for
+//  "gateway:" every time the dashboard was created or rebuilt its targets.
+//  The new path is PWDefaultGateway.h: one routing-table query (RTM_GET on
+//  Darwin, an RTM_GETROUTE dump on Linux). On Linux the spawn is
+//  `ip route show default`, the nearest equivalent.
+//
+//  With --live (Linux only, needs root; run it inside a throwaway network
+//  namespace: sudo unshare -n ./default_gateway_bench --live) it also moves
+//  the default route between two gateways on a veth pair ROUNDS times and
+//  reports how long after each change the route-change socket woke a poll()
+//  and a fresh query returned the new gateway, the path the dashboard uses.
+//
+//  Usage: default_gateway_bench [--live] [ROUNDS]
+//
+//  Build from the repository root with the same flags as the smoke test:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWarden/Core
+//     scripts/default_gateway_bench.c -o /tmp/default_gateway_bench
+//
+
+#include "PWDefaultGateway.h"
+
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <net/route.h>
+#include <linux/if_link.h>
+#include <linux/veth.h>
+#endif
+
+#define NATIVE_ITERATIONS 10000
+#define DEFAULT_ROUNDS 200
+
+#if defined(__APPLE__)
+#define ROUTE_TOOL "/usr/sbin/route"
+#define ROUTE_ARGUMENTS "route", "-n", "get", "default"
+#define ROUTE_GATEWAY_PREFIX "gateway:"
+#else
+#define ROUTE_TOOL "/sbin/ip"
+#define ROUTE_ARGUMENTS "ip", "route", "show", "default"
+#define ROUTE_GATEWAY_PREFIX "via"
+#endif
+
+extern char **environ;
+
+static uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compareU64(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t *)lhs, b = *(const uint64_t *)rhs;
+    return (a > b) - (a < b);
+}
+
+static void fail(const char *what) {
+    fprintf(stderr, "%s failed: %s\n", what, strerror(errno));
+    exit(1);
+}
+
+static void report(const char *name, uint64_t *samples, long count) {
+    qsort(samples, (size_t)count, sizeof(uint64_t), compareU64);
+    printf("%-30s p50=%10.1fus p99=%10.1fus max=%10.1fus\n", name,
+           samples[count / 2] / 1000.0, samples[count * 99 / 100] / 1000.0, samples[count - 1] / 1000.0);
+}
+
+/// The old path: spawn the route tool and take the word after the gateway prefix.
+static bool spawnRouteTool(char *gateway, size_t size) {
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) {
+        return false;
+    }
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, pipeFds[0]);
+    char *const argv[] = { ROUTE_ARGUMENTS, NULL };
+    pid_t pid;
+    int error = posix_spawn(&pid, ROUTE_TOOL, &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipeFds[1]);
+    if (error != 0) {
+        close(pipeFds[0]);
+        errno = error;
+        return false;
+    }
+
+    char output[4096];
+    size_t length = 0;
+    ssize_t n;
+    while ((n = read(pipeFds[0], output + length, sizeof(output) - 1 - length)) > 0) {
+        length += (size_t)n;
+    }
+    output[length] = '\0';
+    close(pipeFds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+
+    gateway[0] = '\0';
+    const char *found = strstr(output, ROUTE_GATEWAY_PREFIX);
+    if (found) {
+        found += strlen(ROUTE_GATEWAY_PREFIX);
+        found += strspn(found, " \t");
+        size_t word = strcspn(found, " \t\n");
+        snprintf(gateway, size, "%.*s", (int)word, found);
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+#if defined(__linux__)
+
+// MARK: - Live route changes (Linux)
+
+#define LIVE_IFNAME "pwgw0"
+#define LIVE_PEER_IFNAME "pwgw1"
+#define LIVE_ADDRESS "10.77.0.1"
+#define LIVE_NETMASK "255.255.255.0"
+
+typedef struct {
+    struct nlmsghdr header;
+    struct ifinfomsg info;
+    uint8_t attributes[512];
+} LinkRequest;
+
+static struct rtattr *appendAttribute(struct nlmsghdr *nlh, unsigned short type, const void *data, size_t length) {
+    struct rtattr *rta = (struct rtattr *)((uint8_t *)nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+    rta->rta_type = type;
+    rta->rta_len = (unsigned short)RTA_LENGTH(length);
+    if (length) {
+        memcpy(RTA_DATA(rta), data, length);
+    }
+    nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+    return rta;
+}
+
+static void closeNest(struct nlmsghdr *nlh, struct rtattr *nest) {
+    nest->rta_len = (unsigned short)((uint8_t *)nlh + nlh->nlmsg_len - (uint8_t *)nest);
+}
+
+/// Send one RTM_NEWLINK/RTM_DELLINK request and wait for its acknowledgement.
+static bool sendLinkRequest(LinkRequest *request) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        return false;
+    }
+    request->header.nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+    bool ok = send(fd, request, request->header.nlmsg_len, 0) == (ssize_t)request->header.nlmsg_len;
+    uint32_t reply[1024];
+    ssize_t len = ok ? recv(fd, reply, sizeof(reply), 0) : -1;
+    const struct nlmsghdr *nlh = (const struct nlmsghdr *)reply;
+    ok = len >= (ssize_t)NLMSG_LENGTH(sizeof(struct nlmsgerr)) && nlh->nlmsg_type == NLMSG_ERROR &&
+         ((const struct nlmsgerr *)NLMSG_DATA(nlh))->error == 0;
+    close(fd);
+    return ok;
+}
+
+static bool createVethPair(const char *name, const char *peer) {
+    LinkRequest request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.header.nlmsg_type = RTM_NEWLINK;
+    request.header.nlmsg_flags = NLM_F_CREATE | NLM_F_EXCL;
+    appendAttribute(&request.header, IFLA_IFNAME, name, strlen(name) + 1);
+    struct rtattr *linkInfo = appendAttribute(&request.header, IFLA_LINKINFO, NULL, 0);
+    appendAttribute(&request.header, IFLA_INFO_KIND, "veth", 4);
+    struct rtattr *infoData = appendAttribute(&request.header, IFLA_INFO_DATA, NULL, 0);
+    struct ifinfomsg peerInfo = { .ifi_family = AF_UNSPEC };
+    struct rtattr *peerAttr = appendAttribute(&request.header, VETH_INFO_PEER, &peerInfo, sizeof(peerInfo));
+    appendAttribute(&request.header, IFLA_IFNAME, peer, strlen(peer) + 1);
+    closeNest(&request.header, peerAttr);
+    closeNest(&request.header, infoData);
+    closeNest(&request.header, linkInfo);
+    return sendLinkRequest(&request);
+}
+
+static bool deleteLink(const char *name) {
+    LinkRequest request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.header.nlmsg_type = RTM_DELLINK;
+    appendAttribute(&request.header, IFLA_IFNAME, name, strlen(name) + 1);
+    return sendLinkRequest(&request);
+}
+
+static void setAddress(struct sockaddr *sa, const char *address) {
+    struct sockaddr_in *sin = (struct sockaddr_in *)sa;
+    memset(sin, 0, sizeof(*sin));
+    sin->sin_family = AF_INET;
+    inet_pton(AF_INET, address, &sin->sin_addr);
+}
+
+/// Give ifname an address and bring it (and its peer) UP, so a gateway on its subnet is reachable.
+static void configureInterface(int fd, const char *ifname, const char *peer) {
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    memcpy(ifr.ifr_name, ifname, strlen(ifname));
+    setAddress(&ifr.ifr_addr, LIVE_ADDRESS);
+    if (ioctl(fd, SIOCSIFADDR, &ifr) < 0) {
+        fail("SIOCSIFADDR");
+    }
+    setAddress(&ifr.ifr_netmask, LIVE_NETMASK);
+    if (ioctl(fd, SIOCSIFNETMASK, &ifr) < 0) {
+        fail("SIOCSIFNETMASK");
+    }
+    const char *names[] = { ifname, peer };
+    for (size_t i = 0; i < 2; i++) {
+        memset(&ifr, 0, sizeof(ifr));
+        memcpy(ifr.ifr_name, names[i], strlen(names[i]));
+        if (ioctl(fd, SIOCGIFFLAGS, &ifr) < 0) {
+            fail("SIOCGIFFLAGS");
+        }
+        ifr.ifr_flags |= IFF_UP;
+        if (ioctl(fd, SIOCSIFFLAGS, &ifr) < 0) {
+            fail("SIOCSIFFLAGS");
+        }
+    }
+}
+
+/// Add or delete "default via gateway" (SIOCADDRT/SIOCDELRT).
+static bool changeDefaultRoute(int fd, unsigned long request, const char *gateway) {
+    struct rtentry route;
+    memset(&route, 0, sizeof(route));
+    setAddress(&route.rt_dst, "0.0.0.0");
+    setAddress(&route.rt_genmask, "0.0.0.0");
+    setAddress(&route.rt_gateway, gateway);
+    route.rt_flags = RTF_UP | RTF_GATEWAY;
+    return ioctl(fd, request, &route) == 0;
+}
+
+/// Wait for the change socket to report a change and a fresh query to return expected.
+static bool awaitGateway(int changeFd, const char *expected, uint64_t *wakeups) {
+    struct pollfd pfd = { .fd = changeFd, .events = POLLIN };
+    for (;;) {
+        if (poll(&pfd, 1, 1000) <= 0) {
+            return false;
+        }
+        ++*wakeups;
+        if (PWRouteChangeDrain(changeFd) == 0) {
+            continue;
+        }
+        // An empty expectation means no default route at all
+        PWDefaultGateway gateway;
+        bool found = PWDefaultGatewayRead(&gateway);
+        if (strcmp(found ? gateway.address : "", expected) == 0) {
+            return true;
+        }
+    }
+}
+
+static void runLive(long rounds) {
+    static const char *gateways[] = { "10.77.0.2", "10.77.0.3" };
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        fail("socket");
+    }
+    if (!createVethPair(LIVE_IFNAME, LIVE_PEER_IFNAME)) {
+        fail("creating veth pair (needs root)");
+    }
+    configureInterface(fd, LIVE_IFNAME, LIVE_PEER_IFNAME);
+
+    int changeFd = PWRouteChangeOpenSocket();
+    if (changeFd < 0) {
+        fail("opening the route-change socket");
+    }
+    PWRouteChangeDrain(changeFd);
+    uint64_t *samples = calloc((size_t)rounds, sizeof(uint64_t));
+    uint64_t wakeups = 0;
+    const char *current = NULL;
+    for (long i = 0; i < rounds; i++) {
+        const char *next = gateways[i % 2];
+        uint64_t start = monotonicNanos();
+        if ((current && !changeDefaultRoute(fd, SIOCDELRT, current)) || !changeDefaultRoute(fd, SIOCADDRT, next)) {
+            fail("moving the default route");
+        }
+        if (!awaitGateway(changeFd, next, &wakeups)) {
+            fprintf(stderr, "round %ld: the gateway never became %s\n", i + 1, next);
+            exit(1);
+        }
+        samples[i] = monotonicNanos() - start;
+        current = next;
+    }
+
+    // Losing the route must be noticed too: the dashboard drops its local target
+    if (!changeDefaultRoute(fd, SIOCDELRT, current) || !awaitGateway(changeFd, "", &wakeups)) {
+        fprintf(stderr, "removing the default route went unnoticed\n");
+        exit(1);
+    }
+    printf("live: %ld gateway moves, %llu wakeups\n", rounds, (unsigned long long)wakeups);
+    report("change -> new gateway read", samples, rounds);
+    free(samples);
+    close(changeFd);
+    deleteLink(LIVE_IFNAME);
+    close(fd);
+}
+
+#endif
+
+int main(int argc, char *argv[]) {
+    bool live = argc >= 2 && strcmp(argv[1], "--live") == 0;
+    long rounds = argc >= 2 + live ? strtol(argv[1 + live], NULL, 10) : DEFAULT_ROUNDS;
+    if (rounds < 1 || rounds > NATIVE_ITERATIONS) {
+        rounds = rounds < 1 ? 1 : NATIVE_ITERATIONS;
+    }
+
+    if (live) {
+#if defined(__linux__)
+        runLive(rounds);
+        return 0;
+#else
+        fprintf(stderr, "--live is only available on Linux\n");
+        return 2;
+#endif
+    }
+
+    PWDefaultGateway gateway;
+    if (!PWDefaultGatewayRead(&gateway)) {
+        fail("reading the default route");
+    }
+    printf("default gateway %s via %s\n", gateway.address[0] ? gateway.address : "(none)",
+           gateway.ifname[0] ? gateway.ifname : "?");
+
+    uint64_t *samples = calloc(NATIVE_ITERATIONS, sizeof(uint64_t));
+    for (long i = 0; i < NATIVE_ITERATIONS; i++) {
+        uint64_t start = monotonicNanos();
+        PWDefaultGatewayRead(&gateway);
+        samples[i] = monotonicNanos() - start;
+    }
+    report("routing table query", samples, NATIVE_ITERATIONS);
+
+    char spawned[INET_ADDRSTRLEN + 16] = "";
+    for (long i = 0; i < rounds; i++) {
+        uint64_t start = monotonicNanos();
+        if (!spawnRouteTool(spawned, sizeof(spawned))) {
+            fail("spawning " ROUTE_TOOL);
+        }
+        samples[i] = monotonicNanos() - start;
+    }
+    if (strcmp(spawned, gateway.address) != 0) {
+        fprintf(stderr, "%s reports %s, the routing table %s\n", ROUTE_TOOL, spawned, gateway.address);
+        return 1;
+    }
+    report("spawn " ROUTE_TOOL, samples, rounds);
+    free(samples);
+    return 0;
+}
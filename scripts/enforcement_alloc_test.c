@@ -0,0 +1,458 @@
+//
+//  enforcement_alloc_test.c
+//  PingWarden
+//
+//  Checks that the enforcement loop's steady state never touches the heap.
+//  A counting allocator hook sees every malloc/calloc/realloc in the process;
+//  after a warm-up, a storm of link messages is fed through the real loop
+//  (platform source and parser, decision path, actuator, ring, storm detector
+//  intervention callback, lifetime counters and status page) and the test
+//  fails if a single allocation happened while it ran. Reaction-time percentiles for the storm are printed
+//  alongside.
+//
+//  By default the storm arrives over a socketpair in the platform's message
+//  format against a fake actuator, so no privileges are needed. With --live
+//  IFNAME the platform's real source and ioctl actuator are used and IFNAME is
+//  raised ROUNDS times instead. On Linux, run that inside a throwaway network
+//  namespace: sudo unshare -n ./enforcement_alloc_test --live lo
+//
+//  Usage: enforcement_alloc_test [--live IFNAME] [ROUNDS]
+//
+//  Build from the repository root with the same flags as the smoke test:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWardenHelper/Core
+//     PingWarden/PingWardenHelper/Core/*.c scripts/enforcement_alloc_test.c
+//     -lpthread -o /tmp/enforcement_alloc_test
+//
+
+#include "PWBackend.h"
+#include "PWEnforcer.h"
+#include "PWLifetime.h"
+#include "PWStatusPage.h"
+
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <net/route.h>
+#define PWSourceCreateWithDescriptor PWRouteSocketSourceCreateWithDescriptor
+#else
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#define PWSourceCreateWithDescriptor PWNetlinkSourceCreateWithDescriptor
+#endif
+
+#define DEFAULT_ROUNDS 5000
+#define WARMUP_ROUNDS 50
+// Unrelated link messages queued ahead of each raise of the target
+#define CHURN_PER_ROUND 16
+#define TARGET_IFNAME "pwalloc0"
+#define TARGET_IFINDEX 4242
+#define CHURN_IFINDEX 4243
+
+// MARK: - Counting allocator
+
+static atomic_bool counting;
+static atomic_uint_fast64_t allocations;
+
+static inline void countAllocation(void) {
+    if (atomic_load_explicit(&counting, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    }
+}
+
+#if defined(__APPLE__)
+
+// libmalloc reports every zone operation to this hook (it is what MallocStackLogging uses)
+typedef void (malloc_logger_t)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3,
+                               uintptr_t result, uint32_t num_hot_frames_to_skip);
+extern malloc_logger_t *malloc_logger;
+#define MALLOC_LOG_TYPE_ALLOCATE 2
+
+static void countingLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3,
+                           uintptr_t result, uint32_t skip) {
+    (void)arg1; (void)arg2; (void)arg3; (void)result; (void)skip;
+    if (type & MALLOC_LOG_TYPE_ALLOCATE) {
+        countAllocation();
+    }
+}
+
+static bool installAllocatorHook(void) {
+    malloc_logger = countingLogger;
+    return true;
+}
+
+#elif defined(__GLIBC__)
+
+// Interpose the allocation entry points and forward to glibc's own
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+void *malloc(size_t size) {
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    countAllocation();
+    return __libc_realloc(ptr, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+    countAllocation();
+    void *ptr = __libc_memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+
+static bool installAllocatorHook(void) {
+    return true;
+}
+
+#else
+
+static bool installAllocatorHook(void) {
+    return false;
+}
+
+#endif
+
+// MARK: - Helpers
+
+static void assertTrue(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "Assertion failed: %s\n", message);
+        exit(1);
+    }
+}
+
+static uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void *runEnforcer(void *context) {
+    PWEnforcerRun(context);
+    return NULL;
+}
+
+static atomic_uint_fast64_t callbacks;
+
+static void countCallback(void *context) {
+    (void)context;
+    atomic_fetch_add_explicit(&callbacks, 1, memory_order_relaxed);
+}
+
+/// Spin until the enforcer has made target interventions. Busy-waits so the
+/// waiting side allocates nothing either.
+static bool waitForInterventions(PWEnforcer *enforcer, uint64_t target) {
+    uint64_t start = monotonicNanos();
+    while (PWEnforcerGetInterventionCount(enforcer) < target) {
+        if (monotonicNanos() - start > 1000000000ull) {
+            return false;
+        }
+        sched_yield();
+    }
+    return true;
+}
+
+/// Spin until the loop has applied every allow/block command posted so far.
+static void waitForControl(PWEnforcer *enforcer) {
+    PWControlStats control;
+    do {
+        sched_yield();
+        PWEnforcerGetControlStats(enforcer, &control);
+    } while (control.applied != control.commands);
+}
+
+// MARK: - Fake actuator
+
+typedef struct {
+    PWActuator base;
+    atomic_uint_fast32_t flags;
+} FakeActuator;
+
+static bool fakeGetFlags(PWActuator *actuator, const char *ifname, uint32_t *flags) {
+    (void)ifname;
+    *flags = (uint32_t)atomic_load(&((FakeActuator *)actuator)->flags);
+    return true;
+}
+
+static bool fakeSetFlags(PWActuator *actuator, const char *ifname, uint32_t flags) {
+    (void)ifname;
+    atomic_store(&((FakeActuator *)actuator)->flags, flags);
+    return true;
+}
+
+static void fakeDestroy(PWActuator *actuator) {
+    free(actuator);
+}
+
+// MARK: - Message storm
+
+/// Encode a link message as the kernel would deliver it. Returns its length.
+static size_t encodeLink(unsigned int ifindex, uint32_t flags, uint8_t *buf, size_t size) {
+    memset(buf, 0, size);
+#if defined(__APPLE__)
+    struct if_msghdr *ifm = (void *)buf;
+    size_t len = sizeof(*ifm) + 20;  // plus a sockaddr_dl
+    ifm->ifm_msglen = (unsigned short)len;
+    ifm->ifm_version = RTM_VERSION;
+    ifm->ifm_type = RTM_IFINFO;
+    ifm->ifm_index = (unsigned short)ifindex;
+    ifm->ifm_flags = (int)flags;
+    return len;
+#else
+    struct nlmsghdr *nlh = (void *)buf;
+    nlh->nlmsg_type = RTM_NEWLINK;
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg) + RTA_SPACE(IFNAMSIZ) + RTA_SPACE(4) * 8);
+    struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+    ifi->ifi_index = (int)ifindex;
+    ifi->ifi_flags = flags;
+    ifi->ifi_change = IFF_UP;
+    return NLMSG_ALIGN(nlh->nlmsg_len);
+#endif
+}
+
+/// Announce the target so the enforcer learns its index without a real interface.
+static size_t encodeArrival(uint8_t *buf, size_t size) {
+    memset(buf, 0, size);
+#if defined(__APPLE__)
+    struct if_announcemsghdr *ifan = (void *)buf;
+    ifan->ifan_msglen = sizeof(*ifan);
+    ifan->ifan_version = RTM_VERSION;
+    ifan->ifan_type = RTM_IFANNOUNCE;
+    ifan->ifan_index = TARGET_IFINDEX;
+    ifan->ifan_what = IFAN_ARRIVAL;
+    strncpy(ifan->ifan_name, TARGET_IFNAME, IFNAMSIZ - 1);
+    return sizeof(*ifan);
+#else
+    struct nlmsghdr *nlh = (void *)buf;
+    nlh->nlmsg_type = RTM_NEWLINK;
+    struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+    ifi->ifi_index = TARGET_IFINDEX;
+    ifi->ifi_change = ~0U;
+    struct rtattr *rta = IFLA_RTA(ifi);
+    rta->rta_type = IFLA_IFNAME;
+    rta->rta_len = RTA_LENGTH(sizeof(TARGET_IFNAME));
+    memcpy(RTA_DATA(rta), TARGET_IFNAME, sizeof(TARGET_IFNAME));
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(*ifi)) + RTA_ALIGN(rta->rta_len);
+    return NLMSG_ALIGN(nlh->nlmsg_len);
+#endif
+}
+
+static void sendMessage(int fd, const uint8_t *message, size_t len) {
+    assertTrue(write(fd, message, len) == (ssize_t)len, "queue message");
+}
+
+// MARK: - Runs
+
+static void report(PWEnforcer *enforcer, const char *name, long rounds, uint64_t allocated) {
+    PWHistogramSnapshot reaction;
+    PWEnforcerCopyReactionHistogram(enforcer, PWReactionStageTotal, &reaction);
+    printf("%s: %ld interventions, %llu allocations; receive->ioctl p50=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus\n",
+           name, rounds, (unsigned long long)allocated,
+           PWHistogramValueAtPercentile(&reaction, 50) / 1000.0,
+           PWHistogramValueAtPercentile(&reaction, 99) / 1000.0,
+           PWHistogramValueAtPercentile(&reaction, 99.9) / 1000.0, reaction.max / 1000.0);
+}
+
+/// Feed the loop link-message storms over a socketpair, each ending in a raise of the target.
+static void runScriptedStorm(long rounds) {
+    int pair[2];
+    assertTrue(socketpair(AF_UNIX, SOCK_DGRAM, 0, pair) == 0, "socketpair");
+    int bufferSize = 4 * 1024 * 1024;
+    setsockopt(pair[0], SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    setsockopt(pair[1], SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+    fcntl(pair[0], F_SETFL, O_NONBLOCK);
+
+    FakeActuator *actuator = calloc(1, sizeof(*actuator));
+    actuator->base.getFlags = fakeGetFlags;
+    actuator->base.setFlags = fakeSetFlags;
+    actuator->base.destroy = fakeDestroy;
+    PWEnforcer *enforcer = PWEnforcerCreate(TARGET_IFNAME, PWSourceCreateWithDescriptor(pair[0]), &actuator->base);
+    assertTrue(enforcer != NULL, "enforcer creation");
+    PWEnforcerSetInterventionCallback(enforcer, countCallback, NULL);
+
+    char lifetimePath[] = "/tmp/enforcement_alloc_test.XXXXXX";
+    char statusPath[] = "/tmp/enforcement_alloc_test.XXXXXX";
+    int lifetimeFd = mkstemp(lifetimePath);
+    int statusFd = mkstemp(statusPath);
+    assertTrue(lifetimeFd >= 0 && statusFd >= 0, "temporary files");
+    close(lifetimeFd);
+    close(statusFd);
+    PWLifetime *lifetime = PWLifetimeOpen(lifetimePath);
+    PWStatusPage *statusPage = PWStatusPageCreate(statusPath);
+    assertTrue(lifetime != NULL && statusPage != NULL, "lifetime counters and status page");
+    PWEnforcerSetLifetime(enforcer, lifetime);
+    PWEnforcerSetStatusPage(enforcer, statusPage);
+
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runEnforcer, enforcer) == 0, "loop thread start");
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block request");
+    // Applying the state re-resolves names, which would forget an index learnt from a message
+    waitForControl(enforcer);
+
+    uint8_t arrival[256], churn[256], raise[256];
+    size_t arrivalLength = encodeArrival(arrival, sizeof(arrival));
+    size_t raiseLength = encodeLink(TARGET_IFINDEX, IFF_UP | IFF_RUNNING, raise, sizeof(raise));
+    sendMessage(pair[1], arrival, arrivalLength);
+
+    uint64_t expected = 0;
+    uint64_t allocated = 0;
+    for (long round = 0; round < WARMUP_ROUNDS + rounds; round++) {
+        if (round == WARMUP_ROUNDS) {
+            PWEnforcerResetInterventionCount(enforcer);
+            expected = 0;
+            atomic_store(&counting, true);
+        }
+        for (int i = 0; i < CHURN_PER_ROUND; i++) {
+            size_t length = encodeLink(CHURN_IFINDEX + (unsigned int)i, (i & 1) ? IFF_UP : 0, churn, sizeof(churn));
+            sendMessage(pair[1], churn, length);
+        }
+        atomic_store(&actuator->flags, IFF_UP | IFF_RUNNING);
+        sendMessage(pair[1], raise, raiseLength);
+        assertTrue(waitForInterventions(enforcer, ++expected), "every raise is lowered");
+    }
+    atomic_store(&counting, false);
+    allocated = atomic_load(&allocations);
+
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    assertTrue(pthread_join(thread, NULL) == 0, "loop thread exit");
+    assertTrue(atomic_load(&callbacks) >= (uint64_t)rounds, "the callback runs for every intervention");
+    report(enforcer, "scripted storm", rounds, allocated);
+    PWEnforcerDestroy(enforcer);
+    PWStatusPageDestroy(statusPage);
+    PWLifetimeClose(lifetime);
+    unlink(statusPath);
+    unlink(lifetimePath);
+    close(pair[1]);
+
+    assertTrue(allocated == 0, "steady-state interventions must not allocate");
+}
+
+static bool readFlags(int fd, const char *ifname, short *flags) {
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    if (ioctl(fd, SIOCGIFFLAGS, &ifr) < 0) {
+        return false;
+    }
+    *flags = ifr.ifr_flags;
+    return true;
+}
+
+static bool writeFlags(int fd, const char *ifname, short flags) {
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    ifr.ifr_flags = flags;
+    return ioctl(fd, SIOCSIFFLAGS, &ifr) == 0;
+}
+
+/// Raise a real interface and let the platform backend lower it each time.
+static void runLiveStorm(const char *ifname, long rounds) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    short flags = 0;
+    assertTrue(fd >= 0 && readFlags(fd, ifname, &flags), "live interface must exist");
+
+    PWEnforcer *enforcer = PWEnforcerCreate(ifname, PWDefaultEventSourceCreate(), PWIoctlActuatorCreate());
+    assertTrue(enforcer != NULL, "live enforcer creation (needs root)");
+    PWEnforcerSetInterventionCallback(enforcer, countCallback, NULL);
+
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runEnforcer, enforcer) == 0, "loop thread start");
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block request");
+    // The interface may already be DOWN (as lo is in a new namespace); wait for the command itself
+    waitForControl(enforcer);
+    assertTrue(readFlags(fd, ifname, &flags) && !(flags & IFF_UP), "interface is blocked");
+
+    uint64_t expected = PWEnforcerGetInterventionCount(enforcer);
+    uint64_t allocated = 0;
+    for (long round = 0; round < WARMUP_ROUNDS + rounds; round++) {
+        if (round == WARMUP_ROUNDS) {
+            PWEnforcerResetInterventionCount(enforcer);
+            expected = 0;
+            atomic_store(&counting, true);
+        }
+        assertTrue(writeFlags(fd, ifname, (short)(flags | IFF_UP)), "raise interface (needs root)");
+        assertTrue(waitForInterventions(enforcer, ++expected), "every raise is lowered");
+        // The kernel may still be delivering the DOWN; let it settle so raises stay distinct
+        while (readFlags(fd, ifname, &flags) && (flags & IFF_UP)) {
+            sched_yield();
+        }
+        expected = PWEnforcerGetInterventionCount(enforcer);
+    }
+    atomic_store(&counting, false);
+    allocated = atomic_load(&allocations);
+
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    assertTrue(pthread_join(thread, NULL) == 0, "loop thread exit");
+    char name[64];
+    snprintf(name, sizeof(name), "live %s", ifname);
+    report(enforcer, name, rounds, allocated);
+    PWEnforcerDestroy(enforcer);
+    close(fd);
+
+    assertTrue(allocated == 0, "steady-state interventions must not allocate");
+}
+
+int main(int argc, char *argv[]) {
+    const char *liveIfname = NULL;
+    long rounds = DEFAULT_ROUNDS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--live") == 0 && i + 1 < argc) {
+            liveIfname = argv[++i];
+        } else {
+            rounds = strtol(argv[i], NULL, 10);
+        }
+    }
+    if (rounds < 1) {
+        fprintf(stderr, "usage: enforcement_alloc_test [--live IFNAME] [ROUNDS]\n");
+        return 2;
+    }
+    if (!installAllocatorHook()) {
+        printf("skipped: no allocator hook for this C library\n");
+        return 0;
+    }
+    // A hook that misses allocations would pass vacuously
+    atomic_store(&counting, true);
+    void *volatile probe = malloc(16);
+    free(probe);
+    atomic_store(&counting, false);
+    assertTrue(atomic_exchange(&allocations, 0) == 1, "the allocator hook sees malloc");
+
+    if (liveIfname) {
+        runLiveStorm(liveIfname, rounds);
+    } else {
+        runScriptedStorm(rounds);
+    }
+    printf("Allocation test passed\n");
+    return 0;
+}
@@ -0,0 +1,221 @@
+//
+//  enforcement_control_bench.c
+//  PingWarden
+//
+//  Measures command-to-actuation latency of the enforcement loop's control
+//  mailbox under toggle bursts. A burst posts K alternating
+//  PWEnforcerSetAllowUp calls back to back, as the widget and Game Mode
+//  detector can when the user flips state quickly. We report interface writes
+//  per burst and the time from the last command until the loop has applied
+//  it (observed by spinning on PWEnforcerGetControlStats). As a
+//  reference, the same K commands are also issued one at a time, waiting for
+//  each to be applied; that is what a per-command channel costs.
+//
+//  The fake actuator spins for ACTUATION_NANOS per write to stand in for
+//  SIOCSIFFLAGS on a real interface (about 30us on lo in the live smoke test);
+//  pass a different value in microseconds as the first argument.
+//
+//  Build from the repository root with the same flags as the smoke test:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWardenHelper/Core
+//     PingWarden/PingWardenHelper/Core/*.c scripts/enforcement_control_bench.c
+//     -lpthread -o /tmp/enforcement_control_bench
+//
+
+#include "PWBackend.h"
+#include "PWEnforcer.h"
+
+#include <net/if.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#define LOOPBACK_IFNAME "lo0"
+#else
+#define LOOPBACK_IFNAME "lo"
+#endif
+
+#define ITERATIONS 2000
+
+static uint64_t actuationNanos = 30000;
+
+static uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compareU64(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t *)lhs, b = *(const uint64_t *)rhs;
+    return (a > b) - (a < b);
+}
+
+// MARK: - Silent source and timing actuator
+
+typedef struct {
+    PWEventSource base;
+    int writeFd;
+} SilentSource;
+
+static bool silentDrain(PWEventSource *source, PWLinkEventHandler handler, void *context) {
+    (void)source; (void)handler; (void)context;
+    return true;
+}
+
+static void silentDestroy(PWEventSource *source) {
+    SilentSource *self = (SilentSource *)source;
+    close(self->base.fd);
+    close(self->writeFd);
+    free(self);
+}
+
+/// A source that never fires, so every wakeup is a control wakeup.
+static PWEventSource *silentSourceCreate(void) {
+    SilentSource *self = calloc(1, sizeof(*self));
+    int fds[2];
+    if (!self || pipe(fds) != 0) {
+        perror("pipe");
+        exit(1);
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    self->base.fd = fds[0];
+    self->base.drain = silentDrain;
+    self->base.destroy = silentDestroy;
+    self->writeFd = fds[1];
+    return &self->base;
+}
+
+typedef struct {
+    PWActuator base;
+    atomic_uint flags;
+    atomic_uint setCount;
+} CountingActuator;
+
+static bool countingGetFlags(PWActuator *actuator, const char *ifname, uint32_t *flags) {
+    (void)ifname;
+    *flags = atomic_load(&((CountingActuator *)actuator)->flags);
+    return true;
+}
+
+static bool countingSetFlags(PWActuator *actuator, const char *ifname, uint32_t flags) {
+    (void)ifname;
+    CountingActuator *self = (CountingActuator *)actuator;
+    uint64_t until = monotonicNanos() + actuationNanos;
+    while (monotonicNanos() < until) {
+    }
+    atomic_store(&self->flags, flags);
+    atomic_fetch_add(&self->setCount, 1);
+    return true;
+}
+
+static void countingDestroy(PWActuator *actuator) {
+    free(actuator);
+}
+
+// MARK: - Benchmark
+
+static void *runEnforcer(void *enforcer) {
+    PWEnforcerRun(enforcer);
+    return NULL;
+}
+
+/// Spin until the loop has applied every posted command; returns when it saw that.
+static uint64_t waitUntilApplied(PWEnforcer *enforcer) {
+    uint64_t deadline = monotonicNanos() + 1000000000ull;
+    PWControlStats control;
+    for (;;) {
+        PWEnforcerGetControlStats(enforcer, &control);
+        uint64_t now = monotonicNanos();
+        if (control.applied == control.commands) {
+            return now;
+        }
+        if (now > deadline) {
+            fprintf(stderr, "timed out waiting for the loop to apply a command\n");
+            exit(1);
+        }
+        // Let the loop run if it shares our CPU
+        sched_yield();
+    }
+}
+
+static void runBursts(int burstSize, bool sequential) {
+    CountingActuator *actuator = calloc(1, sizeof(*actuator));
+    actuator->base.getFlags = countingGetFlags;
+    actuator->base.setFlags = countingSetFlags;
+    actuator->base.destroy = countingDestroy;
+    atomic_init(&actuator->flags, IFF_UP);
+
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, silentSourceCreate(), &actuator->base);
+    if (!enforcer) {
+        fprintf(stderr, "enforcer creation failed\n");
+        exit(1);
+    }
+    pthread_t thread;
+    pthread_create(&thread, NULL, runEnforcer, enforcer);
+
+    uint64_t *lastToApplied = calloc(ITERATIONS, sizeof(uint64_t));
+    uint64_t *firstToSettled = calloc(ITERATIONS, sizeof(uint64_t));
+    unsigned int setsBefore = atomic_load(&actuator->setCount);
+    bool up = true;
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        // An odd number of flips always ends opposite to where the burst started
+        bool target = !up;
+        uint64_t first = monotonicNanos();
+        uint64_t last = first;
+        for (int k = 0; k < burstSize; k++) {
+            bool state = (k % 2 == 0) ? target : up;
+            last = monotonicNanos();
+            PWEnforcerSetAllowUp(enforcer, state);
+            if (sequential) {
+                waitUntilApplied(enforcer);
+            }
+        }
+        uint64_t appliedAt = waitUntilApplied(enforcer);
+        if (((atomic_load(&actuator->flags) & IFF_UP) != 0) != target) {
+            fprintf(stderr, "burst of %d left the interface in the wrong state\n", burstSize);
+            exit(1);
+        }
+        lastToApplied[i] = appliedAt - last;
+        firstToSettled[i] = appliedAt - first;
+        up = target;
+    }
+
+    unsigned int writes = atomic_load(&actuator->setCount) - setsBefore;
+    PWEnforcerStop(enforcer);
+    pthread_join(thread, NULL);
+
+    qsort(lastToApplied, ITERATIONS, sizeof(uint64_t), compareU64);
+    qsort(firstToSettled, ITERATIONS, sizeof(uint64_t), compareU64);
+    printf("burst=%-3d %-10s writes/burst=%-5.2f last-command->applied p50=%.1fus p99=%.1fus  "
+           "burst->settled p50=%.1fus p99=%.1fus\n",
+           burstSize, sequential ? "one-by-one" : "coalesced",
+           (double)writes / ITERATIONS,
+           lastToApplied[ITERATIONS / 2] / 1000.0, lastToApplied[ITERATIONS * 99 / 100] / 1000.0,
+           firstToSettled[ITERATIONS / 2] / 1000.0, firstToSettled[ITERATIONS * 99 / 100] / 1000.0);
+
+    free(lastToApplied);
+    free(firstToSettled);
+    PWEnforcerDestroy(enforcer);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 2) {
+        actuationNanos = strtoull(argv[1], NULL, 10) * 1000;
+    }
+    printf("simulated actuation cost: %.1fus per write\n", actuationNanos / 1000.0);
+    static const int burstSizes[] = { 1, 3, 9, 33 };
+    for (size_t i = 0; i < sizeof(burstSizes) / sizeof(burstSizes[0]); i++) {
+        if (burstSizes[i] > 1) {
+            runBursts(burstSizes[i], true);
+        }
+        runBursts(burstSizes[i], false);
+    }
+    return 0;
+}
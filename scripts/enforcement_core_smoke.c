@@ -0,0 +1,1766 @@
+//
+//  enforcement_core_smoke.c
+//  PingWarden
+//
+//  Smoke tests for the portable enforcement core (PingWardenHelper/Core).
+//  Runs the real loop against a scripted event source and a fake actuator.
+//
+//  With --live IFNAME [ITERATIONS [CAPTURE]] it instead drives the platform
+//  backend against a real interface and reports reaction times, then replays
+//  the run's capture (kept at CAPTURE if given) and checks the interventions
+//  match. On Linux, run it inside a throwaway network namespace:
+//  sudo unshare -n ./enforcement_core_smoke --live lo
+//
+
+#include "PWClock.h"
+#include "PWEnforcer.h"
+#include "PWInterfaceFlags.h"
+#include "PWLifetime.h"
+#include "PWStateFile.h"
+#include "PWStatusPage.h"
+
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <net/if.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/veth.h>
+#endif
+
+#if defined(__APPLE__)
+#define LOOPBACK_IFNAME "lo0"
+#else
+#define LOOPBACK_IFNAME "lo"
+#endif
+
+static void assertTrue(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "Assertion failed: %s\n", message);
+        exit(1);
+    }
+}
+
+static void assertEqualU64(uint64_t actual, uint64_t expected, const char *message) {
+    if (actual != expected) {
+        fprintf(stderr, "Assertion failed: %s\nExpected: %llu\nActual: %llu\n",
+                message, (unsigned long long)expected, (unsigned long long)actual);
+        exit(1);
+    }
+}
+
+static uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// MARK: - Scripted event source
+
+typedef struct {
+    PWEventSource base;
+    int writeFd;
+    atomic_uint_fast64_t emittedAt;  // PWMonotonicNanos() of the last scriptedEmit
+    atomic_bool overflowNext;        // report dropped messages on the next drain
+} ScriptedSource;
+
+static bool scriptedDrain(PWEventSource *source, PWLinkEventHandler handler, void *context) {
+    source->lastArrivalAt = atomic_load(&((ScriptedSource *)source)->emittedAt);
+    if (atomic_exchange(&((ScriptedSource *)source)->overflowNext, false)) {
+        source->stats.overflows++;
+    }
+    PWLinkEvent event;
+    while (read(source->fd, &event, sizeof(event)) == (ssize_t)sizeof(event)) {
+        handler(context, &event);
+    }
+    return true;
+}
+
+static void scriptedDestroy(PWEventSource *source) {
+    ScriptedSource *self = (ScriptedSource *)source;
+    close(self->base.fd);
+    close(self->writeFd);
+    free(self);
+}
+
+static ScriptedSource *scriptedSourceCreate(void) {
+    ScriptedSource *self = calloc(1, sizeof(*self));
+    int fds[2];
+    assertTrue(self && pipe(fds) == 0, "scripted source pipe");
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    self->base.fd = fds[0];
+    self->base.drain = scriptedDrain;
+    self->base.destroy = scriptedDestroy;
+    self->writeFd = fds[1];
+    return self;
+}
+
+/// Deliver a batch of events so they are read in a single drain.
+static void scriptedEmit(ScriptedSource *source, const PWLinkEvent *events, size_t count) {
+    ssize_t size = (ssize_t)(count * sizeof(PWLinkEvent));
+    atomic_store(&source->emittedAt, PWMonotonicNanos());
+    assertTrue(write(source->writeFd, events, (size_t)size) == size, "scripted source write");
+}
+
+// MARK: - Fake actuator
+
+typedef struct {
+    PWActuator base;
+    atomic_uint flags;
+    atomic_uint getCount;
+    atomic_uint setCount;
+    atomic_uint failSets;   // fail this many upcoming setFlags calls
+} FakeActuator;
+
+static bool fakeGetFlags(PWActuator *actuator, const char *ifname, uint32_t *flags) {
+    (void)ifname;
+    FakeActuator *self = (FakeActuator *)actuator;
+    atomic_fetch_add(&self->getCount, 1);
+    *flags = atomic_load(&self->flags);
+    return true;
+}
+
+static bool fakeSetFlags(PWActuator *actuator, const char *ifname, uint32_t flags) {
+    (void)ifname;
+    FakeActuator *self = (FakeActuator *)actuator;
+    unsigned int failSets = atomic_load(&self->failSets);
+    if (failSets > 0) {
+        atomic_store(&self->failSets, failSets - 1);
+        atomic_fetch_add(&self->setCount, 1);
+        errno = EBUSY;
+        return false;
+    }
+    atomic_store(&self->flags, flags);
+    atomic_fetch_add(&self->setCount, 1);
+    return true;
+}
+
+static void fakeDestroy(PWActuator *actuator) {
+    free(actuator);
+}
+
+static FakeActuator *fakeActuatorCreate(uint32_t initialFlags) {
+    FakeActuator *self = calloc(1, sizeof(*self));
+    assertTrue(self != NULL, "fake actuator allocation");
+    self->base.getFlags = fakeGetFlags;
+    self->base.setFlags = fakeSetFlags;
+    self->base.destroy = fakeDestroy;
+    atomic_init(&self->flags, initialFlags);
+    return self;
+}
+
+// MARK: - Histogram
+
+static void runHistogramTests(void) {
+    static PWHistogram histogram;
+    static PWHistogramSnapshot snapshot;
+
+    // Small values are exact; larger ones keep ~3% relative precision
+    for (uint64_t value = 0; value < 64; value++) {
+        assertEqualU64(PWHistogramBucketLowerBound(PWHistogramBucketIndex(value)), value, "small values are exact");
+    }
+    for (uint64_t value = 64; value < (1ull << 40); value = value * 3 / 2 + 7) {
+        size_t index = PWHistogramBucketIndex(value);
+        assertTrue(PWHistogramBucketLowerBound(index) <= value && value <= PWHistogramBucketUpperBound(index),
+                   "value lies within its bucket");
+        assertTrue(PWHistogramBucketUpperBound(index) - PWHistogramBucketLowerBound(index) <= value / 32,
+                   "bucket width stays within ~3% of the value");
+    }
+    for (size_t index = 1; index < PW_HISTOGRAM_BUCKET_COUNT; index++) {
+        assertEqualU64(PWHistogramBucketLowerBound(index), PWHistogramBucketUpperBound(index - 1) + 1,
+                       "buckets are contiguous");
+    }
+    assertEqualU64(PWHistogramBucketIndex(UINT64_MAX), PW_HISTOGRAM_BUCKET_COUNT - 1, "huge values are clamped");
+
+    PWHistogramCopy(&histogram, &snapshot);
+    assertEqualU64(PWHistogramValueAtPercentile(&snapshot, 50), 0, "empty histogram reports zero");
+
+    // 1..1000us in 1us steps
+    for (uint64_t us = 1; us <= 1000; us++) {
+        PWHistogramRecord(&histogram, us * 1000);
+    }
+    PWHistogramCopy(&histogram, &snapshot);
+    assertEqualU64(snapshot.total, 1000, "every record is counted");
+    assertEqualU64(snapshot.max, 1000000, "maximum is exact");
+    uint64_t p50 = PWHistogramValueAtPercentile(&snapshot, 50);
+    uint64_t p99 = PWHistogramValueAtPercentile(&snapshot, 99);
+    assertTrue(p50 >= 500000 && p50 <= 500000 + 500000 / 32, "p50 within bucket precision");
+    assertTrue(p99 >= 990000 && p99 <= 990000 + 990000 / 32, "p99 within bucket precision");
+    assertEqualU64(PWHistogramValueAtPercentile(&snapshot, 100), 1000000, "p100 is the maximum");
+}
+
+// MARK: - Event ring
+
+#define RING_STRESS_EVENTS 2000000u
+
+static void *ringStressProducer(void *context) {
+    PWEventRing *ring = context;
+    for (uint64_t sequence = 1; sequence <= RING_STRESS_EVENTS; sequence++) {
+        PWEventRingPush(ring, sequence * 7, (uint32_t)sequence, PWInterventionTriggerLinkUp, 0);
+    }
+    return NULL;
+}
+
+static void runEventRingTests(void) {
+    static PWEventRing ring;
+    PWInterventionEvent events[PW_EVENT_RING_CAPACITY];
+
+    assertEqualU64(PWEventRingRead(&ring, 0, events, PW_EVENT_RING_CAPACITY), 0, "empty ring reads nothing");
+
+    PWEventRingPush(&ring, 100, IFF_UP, PWInterventionTriggerLinkUp, 0);
+    PWEventRingPush(&ring, 200, IFF_UP | IFF_RUNNING, PWInterventionTriggerArrival, 0);
+    PWEventRingPush(&ring, 300, IFF_UP, PWInterventionTriggerLinkUp, 0);
+    assertEqualU64(PWEventRingHead(&ring), 3, "head tracks the newest sequence");
+
+    size_t count = PWEventRingRead(&ring, 1, events, PW_EVENT_RING_CAPACITY);
+    assertEqualU64(count, 2, "cursor skips events already seen");
+    assertEqualU64(events[0].sequence, 2, "events come back oldest first");
+    assertEqualU64(events[0].timestamp, 200, "timestamp round-trips");
+    assertEqualU64(events[0].flags, IFF_UP | IFF_RUNNING, "flags round-trip");
+    assertEqualU64(events[0].trigger, PWInterventionTriggerArrival, "trigger round-trips");
+    assertEqualU64(PWEventRingRead(&ring, 3, events, PW_EVENT_RING_CAPACITY), 0, "caught-up cursor reads nothing");
+    assertEqualU64(PWEventRingRead(&ring, 0, events, 1), 1, "reads stop at the caller's capacity");
+
+    // After wrapping, only the newest PW_EVENT_RING_CAPACITY events remain
+    for (uint64_t i = 0; i < PW_EVENT_RING_CAPACITY * 2; i++) {
+        PWEventRingPush(&ring, 1000 + i, IFF_UP, PWInterventionTriggerLinkUp, 0);
+    }
+    count = PWEventRingRead(&ring, 1, events, PW_EVENT_RING_CAPACITY);
+    assertEqualU64(count, PW_EVENT_RING_CAPACITY, "a lapped cursor gets the retained window");
+    assertEqualU64(events[0].sequence, PWEventRingHead(&ring) - PW_EVENT_RING_CAPACITY + 1,
+                   "a lapped cursor resumes at the oldest retained event");
+
+    // A reader racing the producer must never see a torn event
+    static PWEventRing stressRing;
+    pthread_t producer;
+    assertTrue(pthread_create(&producer, NULL, ringStressProducer, &stressRing) == 0, "ring producer start");
+    uint64_t cursor = 0, seen = 0;
+    while (cursor < RING_STRESS_EVENTS) {
+        count = PWEventRingRead(&stressRing, cursor, events, PW_EVENT_RING_CAPACITY);
+        for (size_t i = 0; i < count; i++) {
+            assertTrue(events[i].sequence > cursor, "sequences only move forward");
+            assertEqualU64(events[i].timestamp, events[i].sequence * 7, "timestamp belongs to its sequence");
+            assertEqualU64(events[i].flags, (uint32_t)events[i].sequence, "flags belong to their sequence");
+            cursor = events[i].sequence;
+        }
+        seen += count;
+    }
+    pthread_join(producer, NULL);
+    assertTrue(seen > 0, "the reader saw events while racing the producer");
+}
+
+// MARK: - Trace ring
+
+static void runTraceTests(void) {
+    static PWTraceRing ring;
+    static PWTraceRecord records[PW_TRACE_RING_CAPACITY];
+
+    assertEqualU64(PWTraceRingRead(&ring, 0, records, PW_TRACE_RING_CAPACITY), 0, "empty trace reads nothing");
+
+    PWTraceRingPush(&ring, PWTraceEventWakeup, 100, 1, 0);
+    PWTraceRingPush(&ring, PWTraceEventLinkInfo, 100, 0, IFF_UP);
+    PWTraceRingPush(&ring, PWTraceEventIntervention, 150, 0, 50);
+    assertEqualU64(PWTraceRingHead(&ring), 3, "trace head tracks the newest sequence");
+
+    size_t count = PWTraceRingRead(&ring, 1, records, PW_TRACE_RING_CAPACITY);
+    assertEqualU64(count, 2, "trace cursor skips records already seen");
+    assertEqualU64(records[0].event, PWTraceEventLinkInfo, "event id round-trips");
+    assertEqualU64(records[0].arg1, IFF_UP, "arguments round-trip");
+    assertEqualU64(records[1].timestamp, 150, "trace timestamp round-trips");
+    assertTrue(strcmp(PWTraceEventName(records[1].event), "intervention") == 0, "event names are stable");
+    assertTrue(strcmp(PWTraceEventName((PWTraceEvent)999), "unknown") == 0, "unknown ids have a name");
+
+    for (uint64_t i = 0; i < PW_TRACE_RING_CAPACITY * 2; i++) {
+        PWTraceRingPush(&ring, PWTraceEventLinkInfo, 1000 + i, 0, i);
+    }
+    count = PWTraceRingRead(&ring, 0, records, PW_TRACE_RING_CAPACITY);
+    assertEqualU64(count, PW_TRACE_RING_CAPACITY, "a wrapped trace keeps the newest records");
+    assertEqualU64(records[count - 1].arg1, PW_TRACE_RING_CAPACITY * 2 - 1, "the newest record is last");
+}
+
+/// The newest trace record of event, or false if the trace holds none.
+static bool findLatestTrace(PWEnforcer *enforcer, PWTraceEvent event, PWTraceRecord *found) {
+    static PWTraceRecord records[PW_TRACE_RING_CAPACITY];
+    size_t count = PWEnforcerCopyTrace(enforcer, 0, records, PW_TRACE_RING_CAPACITY);
+    while (count-- > 0) {
+        if (records[count].event == event) {
+            *found = records[count];
+            return true;
+        }
+    }
+    return false;
+}
+
+// MARK: - Storm detector
+
+#define MS 1000000ull
+
+/// Record count interventions spacing apart, starting at start.
+static void stormBurst(PWStormDetector *detector, uint64_t start, uint64_t spacing, int count) {
+    for (int i = 0; i < count; i++) {
+        PWStormDetectorRecord(detector, start + (uint64_t)i * spacing);
+    }
+}
+
+static void runStormTests(void) {
+    static PWStormDetector detector;
+    PWStormStats stats;
+    PWStormEpisode episodes[PW_STORM_EPISODE_CAPACITY];
+    uint64_t t0 = 1000 * 1000 * MS;
+
+    PWStormDetectorGetStats(&detector, t0, &stats);
+    assertTrue(stats.rate == 0 && stats.episodes == 0 && !stats.storming, "idle detector reports nothing");
+
+    // A steady rate below the sustained limit never starts an episode
+    stormBurst(&detector, t0, 1000 * MS, 30);
+    PWStormDetectorGetStats(&detector, t0 + 29000 * MS, &stats);
+    assertEqualU64(stats.episodes, 0, "one intervention per second is not a storm");
+    assertTrue(stats.rate > 0 && stats.rate < 2, "EWMA follows a steady rate");
+
+    // 50 per second: the bucket absorbs PW_STORM_BURST, the next one starts the episode
+    uint64_t t1 = t0 + 60000 * MS;
+    stormBurst(&detector, t1, 20 * MS, PW_STORM_BURST);
+    PWStormDetectorGetStats(&detector, t1 + 200 * MS, &stats);
+    assertEqualU64(stats.episodes, 0, "a burst within the bucket is absorbed");
+    stormBurst(&detector, t1 + PW_STORM_BURST * 20 * MS, 20 * MS, 40 - PW_STORM_BURST);
+    uint64_t last = t1 + 39 * 20 * MS;
+    PWStormDetectorGetStats(&detector, last, &stats);
+    assertEqualU64(stats.episodes, 1, "outrunning the bucket starts an episode");
+    assertTrue(stats.storming, "the episode is in progress");
+    assertTrue(stats.rate > 20, "EWMA climbs towards the burst rate");
+    assertEqualU64(PWStormDetectorCopyEpisodes(&detector, last, episodes, PW_STORM_EPISODE_CAPACITY), 1,
+                   "one episode retained");
+    assertEqualU64(episodes[0].startedAt, t1, "the episode starts at the run's first intervention");
+    assertEqualU64(episodes[0].durationNanos, 39 * 20 * MS, "duration spans first to latest intervention");
+    assertEqualU64(episodes[0].interventions, 40, "the absorbed burst counts towards the episode");
+    assertTrue(episodes[0].peakRate == 50, "peak rate is the busiest window");
+    assertTrue(episodes[0].active, "active until the bucket refills");
+
+    // Once the bucket has refilled the episode is over and the rate decays
+    uint64_t quiet = last + (PW_STORM_BURST + 1) * (1000 * MS / PW_STORM_SUSTAINED_PER_SECOND);
+    PWStormDetectorGetStats(&detector, quiet, &stats);
+    assertTrue(!stats.storming, "a refilled bucket ends the episode");
+    assertTrue(stats.rate < 1, "EWMA decays while quiet");
+    assertTrue(stats.peakRate == 50, "peak rate survives the decay");
+    PWStormDetectorCopyEpisodes(&detector, quiet, episodes, 1);
+    assertTrue(!episodes[0].active, "the finished episode is no longer active");
+
+    // Only the newest PW_STORM_EPISODE_CAPACITY episodes are kept, oldest first
+    uint64_t t2 = quiet;
+    for (int i = 0; i < PW_STORM_EPISODE_CAPACITY + 8; i++) {
+        stormBurst(&detector, t2, MS, PW_STORM_BURST + 5);
+        t2 += 60000 * MS;
+    }
+    size_t count = PWStormDetectorCopyEpisodes(&detector, t2, episodes, PW_STORM_EPISODE_CAPACITY);
+    assertEqualU64(count, PW_STORM_EPISODE_CAPACITY, "the episode buffer is bounded");
+    assertEqualU64(episodes[0].sequence, PW_STORM_EPISODE_CAPACITY + 9 - PW_STORM_EPISODE_CAPACITY + 1,
+                   "the oldest retained episode comes first");
+    assertEqualU64(episodes[count - 1].interventions, PW_STORM_BURST + 5, "each episode keeps its own count");
+    assertEqualU64(PWStormDetectorCopyEpisodes(&detector, t2, episodes, 2), 2, "reads stop at the caller's capacity");
+    assertEqualU64(episodes[1].sequence, PW_STORM_EPISODE_CAPACITY + 9, "a short read returns the newest episodes");
+}
+
+// MARK: - Capture format
+
+static void runCaptureTests(void) {
+    char path[] = "/tmp/enforcement_core_smoke.XXXXXX";
+    int fd = mkstemp(path);
+    assertTrue(fd >= 0, "capture temp file");
+    close(fd);
+
+    PWCapture *capture = PWCaptureCreate(path, PW_CAPTURE_FORMAT_NATIVE, "awdl0", 7);
+    assertTrue(capture != NULL, "capture creation");
+    uint64_t drainAt = PWMonotonicNanos() + 1000000;
+    PWCaptureAppendControl(capture, drainAt - 500, false);
+    PWCaptureBeginDrain(capture, drainAt);
+    PWCaptureAppendMessages(capture, "abc", 3);
+    PWCaptureAppendMessages(capture, "defg", 4);
+    PWCaptureBeginDrain(capture, drainAt + 300);
+    static uint8_t large[1000];
+    PWCaptureAppendMessages(capture, large, sizeof(large));
+    PWCaptureBeginDrain(capture, drainAt + 600);
+    PWCaptureAppendOverflow(capture);
+    PWCaptureAppendMessages(capture, "h", 1);
+    PWCaptureDestroy(capture);
+
+    PWCaptureReader *reader = PWCaptureReaderOpen(path);
+    assertTrue(reader != NULL, "capture opens");
+    const PWCaptureFileHeader *header = PWCaptureReaderHeader(reader);
+    assertEqualU64(header->format, PW_CAPTURE_FORMAT_NATIVE, "header records the format");
+    assertEqualU64(header->ifindex, 7, "header records the target index");
+    assertTrue(strcmp(header->ifname, "awdl0") == 0, "header records the target name");
+
+    PWCaptureRecord record;
+    assertTrue(PWCaptureReaderNext(reader, &record), "control record");
+    assertEqualU64(record.kind, PWCaptureRecordControl, "control kind");
+    assertEqualU64(record.timestamp, drainAt - 500, "control timestamp round-trips");
+    assertTrue(record.length == 1 && record.data[0] == 0, "control records the block state");
+    assertTrue(PWCaptureReaderNext(reader, &record), "first read");
+    assertEqualU64(record.kind, PWCaptureRecordDrain, "first read of a drain starts it");
+    assertTrue(record.length == 3 && memcmp(record.data, "abc", 3) == 0, "message bytes round-trip");
+    assertTrue(PWCaptureReaderNext(reader, &record), "second read");
+    assertEqualU64(record.kind, PWCaptureRecordDrainContinued, "later reads continue the drain");
+    assertEqualU64(record.timestamp, drainAt, "reads share their drain's timestamp");
+    assertTrue(PWCaptureReaderNext(reader, &record), "next drain");
+    assertEqualU64(record.kind, PWCaptureRecordDrain, "a new drain starts a new group");
+    assertEqualU64(record.timestamp, drainAt + 300, "drain timestamp round-trips");
+    assertEqualU64(record.length, sizeof(large), "multi-byte lengths round-trip");
+    assertTrue(PWCaptureReaderNext(reader, &record), "overflowed drain");
+    assertTrue(record.kind == PWCaptureRecordDrain && record.length == 0, "an overflow first in a drain starts it empty");
+    assertTrue(PWCaptureReaderNext(reader, &record), "overflow record");
+    assertEqualU64(record.kind, PWCaptureRecordOverflow, "overflow kind");
+    assertEqualU64(record.timestamp, drainAt + 600, "overflow shares its drain's timestamp");
+    assertTrue(PWCaptureReaderNext(reader, &record), "read after the overflow");
+    assertEqualU64(record.kind, PWCaptureRecordDrainContinued, "reads after an overflow continue the drain");
+    assertTrue(!PWCaptureReaderNext(reader, &record), "end of capture");
+    PWCaptureReaderRewind(reader);
+    assertTrue(PWCaptureReaderNext(reader, &record) && record.kind == PWCaptureRecordControl, "rewind");
+    PWCaptureReaderClose(reader);
+
+    // A cut-off record is reported as the end, not read past
+    struct stat info;
+    assertTrue(stat(path, &info) == 0 && truncate(path, info.st_size - 1) == 0, "truncate capture");
+    reader = PWCaptureReaderOpen(path);
+    size_t records = 0;
+    while (PWCaptureReaderNext(reader, &record)) {
+        records++;
+    }
+    assertEqualU64(records, 6, "truncated record is dropped");
+    PWCaptureReaderClose(reader);
+
+    // Another platform's capture cannot go through this platform's parser
+    capture = PWCaptureCreate(path, PW_CAPTURE_FORMAT_NATIVE == PWCaptureFormatNetlink ? PWCaptureFormatRouteSocket
+                                                                                       : PWCaptureFormatNetlink,
+                              LOOPBACK_IFNAME, 1);
+    PWCaptureDestroy(capture);
+    reader = PWCaptureReaderOpen(path);
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, NULL, &fakeActuatorCreate(IFF_UP)->base);
+    assertTrue(enforcer != NULL, "replay-only enforcer needs no source");
+    PWReplayStats stats;
+    assertTrue(!PWEnforcerReplay(enforcer, reader, PWReplaySpeedMaximum, &stats), "foreign format is refused");
+    PWEnforcerDestroy(enforcer);
+    PWCaptureReaderClose(reader);
+    unlink(path);
+}
+
+// MARK: - Loop thread helpers
+
+static void *runEnforcer(void *enforcer) {
+    PWEnforcerRun(enforcer);
+    return NULL;
+}
+
+/// As the helper runs it: stack prefaulted and fault counting on before the loop.
+static void *runPreparedEnforcer(void *enforcer) {
+    PWEnforcerPrepareThread(enforcer);
+    PWEnforcerRun(enforcer);
+    return NULL;
+}
+
+/// Wait up to one second for the loop thread to reach an expected counter value.
+static bool waitForCount(atomic_uint *counter, unsigned int expected) {
+    uint64_t deadline = monotonicNanos() + 1000000000ull;
+    while (monotonicNanos() < deadline) {
+        if (atomic_load(counter) >= expected) {
+            return true;
+        }
+        usleep(100);
+    }
+    return false;
+}
+
+/// Give the loop a moment to consume anything still queued.
+static void settle(void) {
+    usleep(20000);
+}
+
+static void countIntervention(void *context) {
+    atomic_fetch_add((atomic_uint *)context, 1);
+}
+
+static void runScriptedTests(void) {
+    unsigned int target = if_nametoindex(LOOPBACK_IFNAME);
+    assertTrue(target != 0, "loopback interface must exist");
+
+    ScriptedSource *source = scriptedSourceCreate();
+    FakeActuator *actuator = fakeActuatorCreate(IFF_UP);
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, &source->base, &actuator->base);
+    assertTrue(enforcer != NULL, "enforcer creation");
+    static atomic_uint callbacks;
+    PWEnforcerSetInterventionCallback(enforcer, countIntervention, &callbacks);
+
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runEnforcer, enforcer) == 0, "loop thread start");
+
+    // Switching to block mode brings the interface down immediately
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block request");
+    assertTrue(waitForCount(&actuator->setCount, 1), "block request should bring interface down");
+    assertTrue(!(atomic_load(&actuator->flags) & IFF_UP), "interface should be down after block request");
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 0, "explicit block is not an intervention");
+
+    // System raises the interface: the loop must lower it and count an intervention
+    atomic_store(&actuator->flags, IFF_UP);
+    PWLinkEvent raised = { .type = PWLinkEventInfo, .ifindex = target, .flags = IFF_UP };
+    scriptedEmit(source, &raised, 1);
+    assertTrue(waitForCount(&actuator->setCount, 2), "raised interface should be lowered");
+    assertTrue(!(atomic_load(&actuator->flags) & IFF_UP), "interface should be down after intervention");
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 1, "one intervention expected");
+    assertEqualU64(atomic_load(&actuator->getCount), 1, "intervention writes the routing message flags without re-reading");
+
+    // The trace carries what the log lines used to: the message, then the intervention
+    PWTraceRecord link, intervention, control;
+    assertTrue(findLatestTrace(enforcer, PWTraceEventLinkInfo, &link), "link message is traced");
+    assertTrue(findLatestTrace(enforcer, PWTraceEventIntervention, &intervention), "intervention is traced");
+    assertTrue(findLatestTrace(enforcer, PWTraceEventControl, &control), "state change is traced");
+    assertEqualU64(link.arg0, 0, "link record names the table slot");
+    assertEqualU64(link.arg1, IFF_UP, "link record carries the reported flags");
+    assertTrue(intervention.sequence > link.sequence && link.sequence > control.sequence, "trace is in loop order");
+    assertEqualU64(intervention.arg1, intervention.timestamp - link.timestamp, "intervention records its reaction time");
+    assertEqualU64(control.arg0, 0, "control record carries the allow mask");
+
+    // Events for other interfaces are ignored
+    PWLinkEvent other = { .type = PWLinkEventInfo, .ifindex = target + 1000, .flags = IFF_UP };
+    scriptedEmit(source, &other, 1);
+    settle();
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 1, "other interfaces must not trigger");
+
+    // Only the final state of a drain counts
+    PWLinkEvent upThenDown[] = {
+        { .type = PWLinkEventInfo, .ifindex = target, .flags = IFF_UP },
+        { .type = PWLinkEventInfo, .ifindex = target, .flags = 0 },
+    };
+    scriptedEmit(source, upThenDown, 2);
+    settle();
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 1, "superseded UP must not trigger");
+
+    // Link messages are filtered against the cached index, never by name lookup
+    PWIfindexCacheStats cache;
+    PWEnforcerGetIfindexCacheStats(enforcer, &cache);
+    assertEqualU64(cache.lookups, 2, "index resolved at creation and on the block request only");
+    assertEqualU64(cache.lookupsAvoided, 4, "every link message skips the name lookup");
+
+    // Departure invalidates the cache: stale UPs for the old index are ignored
+    PWLinkEvent departed = { .type = PWLinkEventDeparture, .ifindex = target };
+    strncpy(departed.ifname, LOOPBACK_IFNAME, IFNAMSIZ - 1);
+    PWLinkEvent departedThenUp[] = { departed, raised };
+    scriptedEmit(source, departedThenUp, 2);
+    settle();
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 1, "departed interface must not trigger");
+
+    // Arrival under a new index re-targets the cache without a lookup
+    unsigned int reborn = target + 500;
+    PWLinkEvent arrived = { .type = PWLinkEventArrival, .ifindex = reborn };
+    strncpy(arrived.ifname, LOOPBACK_IFNAME, IFNAMSIZ - 1);
+    PWLinkEvent rebornUp = { .type = PWLinkEventInfo, .ifindex = reborn, .flags = IFF_UP };
+    PWLinkEvent arrivedThenUp[] = { arrived, rebornUp };
+    unsigned int setsBeforeArrival = atomic_load(&actuator->setCount);
+    atomic_store(&actuator->flags, IFF_UP);
+    scriptedEmit(source, arrivedThenUp, 2);
+    assertTrue(waitForCount(&actuator->setCount, setsBeforeArrival + 1), "re-arrived interface should be lowered");
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 2, "re-arrived interface is enforced");
+    PWEnforcerGetIfindexCacheStats(enforcer, &cache);
+    assertEqualU64(cache.lookups, 2, "announcements update the cache without lookups");
+    assertEqualU64(cache.cacheUpdates, 3, "initial fill, departure and arrival update the cache");
+
+    // Several UP notifications for one transition collapse into a single write
+    PWLinkEvent upBurst[] = {
+        { .type = PWLinkEventInfo, .ifindex = reborn, .flags = IFF_UP },
+        { .type = PWLinkEventInfo, .ifindex = reborn, .flags = IFF_UP | IFF_RUNNING },
+        { .type = PWLinkEventInfo, .ifindex = reborn, .flags = IFF_UP | IFF_RUNNING | IFF_MULTICAST },
+    };
+    unsigned int getsBeforeBurst = atomic_load(&actuator->getCount);
+    unsigned int setsBeforeBurst = atomic_load(&actuator->setCount);
+    atomic_store(&actuator->flags, IFF_UP | IFF_RUNNING | IFF_MULTICAST);
+    scriptedEmit(source, upBurst, 3);
+    assertTrue(waitForCount(&actuator->setCount, setsBeforeBurst + 1), "UP burst should be lowered");
+    settle();
+    assertEqualU64(atomic_load(&actuator->setCount), setsBeforeBurst + 1, "UP burst costs exactly one write");
+    assertEqualU64(atomic_load(&actuator->getCount), getsBeforeBurst, "UP burst needs no read");
+    assertEqualU64(atomic_load(&actuator->flags), IFF_RUNNING | IFF_MULTICAST, "only IFF_UP is cleared from the cached flags");
+
+    // A failed single write falls back to read-modify-write
+    unsigned int setsBeforeFailure = atomic_load(&actuator->setCount);
+    atomic_store(&actuator->failSets, 1);
+    atomic_store(&actuator->flags, IFF_UP);
+    scriptedEmit(source, &rebornUp, 1);
+    assertTrue(waitForCount(&actuator->setCount, setsBeforeFailure + 2), "failed write should be retried");
+    assertTrue(!(atomic_load(&actuator->flags) & IFF_UP), "interface should be down after fallback");
+    assertEqualU64(atomic_load(&actuator->getCount), getsBeforeBurst + 1, "fallback re-reads the flags once");
+
+    PWActuationStats actuation;
+    PWEnforcerGetActuationStats(enforcer, &actuation);
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 4, "burst and fallback are one intervention each");
+    assertEqualU64(actuation.fastPathWrites, 3, "interventions with fresh flags take the single-write path");
+    assertEqualU64(actuation.fallbackWrites, 1, "only the failed write falls back");
+    assertEqualU64(actuation.coalescedNotifications, 2, "extra UP notifications in the burst are coalesced");
+
+    // Every intervention lands in each reaction-time stage
+    PWHistogramSnapshot reaction;
+    for (PWReactionStage stage = 0; stage < PWReactionStageCount; stage++) {
+        PWEnforcerCopyReactionHistogram(enforcer, stage, &reaction);
+        assertEqualU64(reaction.total, 4, "one reaction sample per intervention");
+    }
+    assertTrue(reaction.max > 0, "total reaction time is measured from the wakeup");
+    PWHistogramSnapshot wakeup;
+    PWEnforcerCopyWakeupHistogram(enforcer, &wakeup);
+    assertTrue(wakeup.total >= 4, "drains of a source with arrival times record wakeup latency");
+    assertTrue(wakeup.max < 1000000000ull, "wakeup latency is measured from the emit");
+
+    // Each intervention is also on the event ring, with what triggered it
+    PWInterventionEvent timeline[8];
+    assertEqualU64(PWEnforcerCopyInterventionEvents(enforcer, 0, timeline, 8), 4, "one ring event per intervention");
+    assertEqualU64(atomic_load(&callbacks), 4, "clients are notified once per intervention");
+    assertEqualU64(timeline[0].trigger, PWInterventionTriggerLinkUp, "system raise is a link-up trigger");
+    assertEqualU64(timeline[1].trigger, PWInterventionTriggerArrival, "re-arrival is an arrival trigger");
+    assertEqualU64(timeline[2].flags, IFF_UP | IFF_RUNNING | IFF_MULTICAST, "event records the final drain flags");
+    assertTrue(timeline[0].timestamp < timeline[3].timestamp, "event timestamps are monotonic");
+    assertEqualU64(PWEnforcerCopyInterventionEvents(enforcer, timeline[3].sequence, timeline, 8), 0,
+                   "nothing new after the last cursor");
+    PWStormStats storm;
+    PWEnforcerGetStormStats(enforcer, &storm);
+    assertTrue(storm.peakRate > 0, "interventions feed the rate estimator");
+    assertEqualU64(storm.episodes, 0, "a handful of interventions is not a storm");
+
+    // The kernel dropped the UP: the overflowed drain re-reads the flags and still lowers it
+    unsigned int getsBeforeOverflow = atomic_load(&actuator->getCount);
+    atomic_store(&actuator->flags, IFF_UP);
+    atomic_store(&source->overflowNext, true);
+    scriptedEmit(source, &other, 1);
+    assertTrue(waitForCount(&callbacks, 5), "an UP lost to an overflow is still lowered");
+    assertTrue(!(atomic_load(&actuator->flags) & IFF_UP), "interface should be down after the resync");
+    assertEqualU64(atomic_load(&actuator->getCount), getsBeforeOverflow + 1, "an overflow costs one flags read");
+    PWResyncStats resync;
+    PWEnforcerGetResyncStats(enforcer, &resync);
+    assertEqualU64(resync.overflows, 1, "the overflow is counted");
+    assertEqualU64(resync.resyncs, 1, "one resync per overflowed drain");
+    assertEqualU64(resync.resyncInterventions, 1, "the resync revealed the UP");
+    assertEqualU64(PWEnforcerCopyInterventionEvents(enforcer, timeline[3].sequence, timeline, 8), 1,
+                   "resync intervention is on the ring");
+    assertEqualU64(timeline[0].trigger, PWInterventionTriggerResync, "resync intervention has its own trigger");
+
+    // Both writes failing lowers nothing: traced and counted, never recorded as an intervention
+    unsigned int setsBeforeRefusal = atomic_load(&actuator->setCount);
+    atomic_store(&actuator->failSets, 2);
+    atomic_store(&actuator->flags, IFF_UP);
+    scriptedEmit(source, &raised, 1);
+    assertTrue(waitForCount(&actuator->setCount, setsBeforeRefusal + 2), "both write paths are tried");
+    settle();
+    assertTrue(atomic_load(&actuator->flags) & IFF_UP, "a refused write leaves the interface UP");
+    PWEnforcerGetActuationStats(enforcer, &actuation);
+    assertEqualU64(actuation.failedWrites, 1, "the failed intervention is counted");
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 5, "a failed write is not an intervention");
+    assertEqualU64(atomic_load(&callbacks), 5, "clients are not told of a failed write");
+    assertEqualU64(PWEnforcerCopyInterventionEvents(enforcer, 0, timeline, 8), 5, "a failed write is not on the ring");
+    PWEnforcerCopyReactionHistogram(enforcer, PWReactionStageTotal, &reaction);
+    assertEqualU64(reaction.total, 5, "a failed write has no reaction time");
+    PWTraceRecord failure;
+    assertTrue(findLatestTrace(enforcer, PWTraceEventWriteFailed, &failure) && failure.arg1 == EBUSY,
+               "the failed write is traced with its errno");
+    PWTraceRecord lastIntervention;
+    assertTrue(findLatestTrace(enforcer, PWTraceEventIntervention, &lastIntervention) &&
+               lastIntervention.sequence < failure.sequence, "no intervention is traced for it");
+    atomic_store(&actuator->flags, 0);
+
+    // Allow mode restores the interface and stops enforcing
+    unsigned int setsBeforeAllow = atomic_load(&actuator->setCount);
+    assertTrue(PWEnforcerSetAllowUp(enforcer, true), "allow request");
+    assertTrue(waitForCount(&actuator->setCount, setsBeforeAllow + 1), "allow request should bring interface up");
+    assertTrue(atomic_load(&actuator->flags) & IFF_UP, "interface should be up after allow request");
+    scriptedEmit(source, &raised, 1);
+    settle();
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 5, "allow mode must not intervene");
+
+    PWEnforcerResetInterventionCount(enforcer);
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 0, "reset clears the counter");
+
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    assertTrue(pthread_join(thread, NULL) == 0, "loop thread exit");
+    PWEnforcerDestroy(enforcer);
+}
+
+// MARK: - Control mailbox
+
+#define CONTROL_WRITERS 4
+#define CONTROL_TOGGLES_PER_WRITER 20000
+
+static void *toggleRepeatedly(void *enforcer) {
+    for (int i = 0; i < CONTROL_TOGGLES_PER_WRITER; i++) {
+        PWEnforcerSetAllowUp(enforcer, i % 2 == 0);
+    }
+    return NULL;
+}
+
+static void runControlTests(void) {
+    ScriptedSource *source = scriptedSourceCreate();
+    FakeActuator *actuator = fakeActuatorCreate(IFF_UP);
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, &source->base, &actuator->base);
+    assertTrue(enforcer != NULL, "enforcer creation");
+
+    // Commands posted before the loop wakes collapse into the newest one
+    for (int i = 0; i < 9; i++) {
+        assertTrue(PWEnforcerSetAllowUp(enforcer, i % 2 == 1), "queued toggle");
+    }
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "final block request");
+
+    PWControlStats control;
+    PWEnforcerGetControlStats(enforcer, &control);
+    assertEqualU64(control.firstAppliedAt, 0, "nothing is applied before the loop runs");
+
+    uint64_t loopStartedAt = monotonicNanos();
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runEnforcer, enforcer) == 0, "loop thread start");
+    assertTrue(waitForCount(&actuator->setCount, 1), "toggle burst should be applied");
+    settle();
+    assertTrue(!(atomic_load(&actuator->flags) & IFF_UP), "newest request wins");
+    assertEqualU64(atomic_load(&actuator->setCount), 1, "toggle burst costs one write");
+    assertEqualU64(atomic_load(&actuator->getCount), 1, "toggle burst costs one read");
+
+    PWEnforcerGetControlStats(enforcer, &control);
+    assertEqualU64(control.commands, 10, "every command is counted");
+    assertEqualU64(control.actuations, 1, "superseded commands are never applied");
+    // A state posted before the loop starts (as a restored one is) is its first act
+    assertTrue(control.firstAppliedAt >= loopStartedAt, "first application is timestamped");
+    uint64_t firstAppliedAt = control.firstAppliedAt;
+
+    // Racing writers: whatever interleaving happens, the last command decides
+    pthread_t writers[CONTROL_WRITERS];
+    for (int i = 0; i < CONTROL_WRITERS; i++) {
+        assertTrue(pthread_create(&writers[i], NULL, toggleRepeatedly, enforcer) == 0, "writer start");
+    }
+    for (int i = 0; i < CONTROL_WRITERS; i++) {
+        pthread_join(writers[i], NULL);
+    }
+    assertTrue(PWEnforcerSetAllowUp(enforcer, true), "allow after race");
+    uint64_t deadline = monotonicNanos() + 1000000000ull;
+    do {
+        PWEnforcerGetControlStats(enforcer, &control);
+        if (control.commands == 11 + CONTROL_WRITERS * CONTROL_TOGGLES_PER_WRITER &&
+            (atomic_load(&actuator->flags) & IFF_UP)) {
+            break;
+        }
+        usleep(100);
+    } while (monotonicNanos() < deadline);
+    settle();
+    PWEnforcerGetControlStats(enforcer, &control);
+    assertTrue(atomic_load(&actuator->flags) & IFF_UP, "final command wins after racing writers");
+    assertEqualU64(control.commands, 11 + CONTROL_WRITERS * CONTROL_TOGGLES_PER_WRITER, "no command is lost");
+    assertTrue(control.actuations < control.commands / 2, "racing toggles are coalesced");
+    assertEqualU64(control.firstAppliedAt, firstAppliedAt, "only the first application is timestamped");
+
+    // Awaiting a command returns only once the interface reflects it, as an exit restore needs
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block before restore");
+    assertTrue(PWEnforcerAwaitControl(enforcer, 1000000000ull), "block is awaited");
+    assertTrue(!(atomic_load(&actuator->flags) & IFF_UP), "awaited block is applied");
+    assertTrue(PWEnforcerSetAllowUp(enforcer, true), "restore before exit");
+    assertTrue(PWEnforcerAwaitControl(enforcer, 1000000000ull), "restore is awaited");
+    assertTrue(atomic_load(&actuator->flags) & IFF_UP, "awaited restore is applied");
+
+    // A state posted just before stop shares its mailbox word and is applied before the loop exits
+    unsigned int setsBeforeStop = atomic_load(&actuator->setCount);
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block before stop");
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    assertTrue(pthread_join(thread, NULL) == 0, "loop thread exit");
+    assertTrue(!(atomic_load(&actuator->flags) & IFF_UP), "state posted before stop is applied before exit");
+    assertEqualU64(atomic_load(&actuator->setCount), setsBeforeStop + 1, "stop itself applies nothing");
+    PWEnforcerGetControlStats(enforcer, &control);
+    assertEqualU64(control.applied, control.commands, "stop is not counted as a command");
+    assertTrue(PWEnforcerSetAllowUp(enforcer, true), "command after exit");
+    assertTrue(!PWEnforcerAwaitControl(enforcer, 1000000ull), "awaiting a stopped loop times out");
+    PWEnforcerDestroy(enforcer);
+}
+
+// MARK: - State file
+
+/// Flip one byte of the state file behind the mapping's back, as a torn write would.
+static void corruptStateFile(const char *path, off_t offset) {
+    int fd = open(path, O_RDWR);
+    assertTrue(fd >= 0, "state file reopen");
+    uint8_t byte;
+    assertTrue(pread(fd, &byte, 1, offset) == 1, "state file read");
+    byte ^= 0x5A;
+    assertTrue(pwrite(fd, &byte, 1, offset) == 1, "state file corruption");
+    close(fd);
+}
+
+static void runInterfaceFlagsTests(void) {
+    int fd = PWInterfaceFlagsOpenSocket();
+    assertTrue(fd >= 0, "flags socket");
+    uint32_t flags = 0;
+    assertTrue(PWInterfaceFlagsGet(fd, LOOPBACK_IFNAME, &flags), "loopback flags read");
+    assertTrue(flags & IFF_LOOPBACK, "loopback reports IFF_LOOPBACK");
+    uint32_t again = 0;
+    assertTrue(PWInterfaceFlagsRead(LOOPBACK_IFNAME, &again) && again == flags, "one-shot read agrees");
+    errno = 0;
+    assertTrue(!PWInterfaceFlagsGet(fd, "pwnosuch0", &flags), "a missing interface has no flags");
+    assertTrue(errno == ENXIO || errno == ENODEV, "a missing interface reports ENXIO or ENODEV");
+    close(fd);
+
+    PWInterfaceInfo interfaces[64];
+    int count = PWInterfaceFlagsList(interfaces, 64);
+    assertTrue(count > 0, "getifaddrs lists interfaces");
+    bool found = false;
+    for (int i = 0; i < count && i < 64; i++) {
+        for (int j = 0; j < i; j++) {
+            assertTrue(strcmp(interfaces[i].ifname, interfaces[j].ifname) != 0, "each interface is listed once");
+        }
+        if (strcmp(interfaces[i].ifname, LOOPBACK_IFNAME) == 0) {
+            found = true;
+            assertEqualU64(interfaces[i].flags & 0xffff, again, "getifaddrs and SIOCGIFFLAGS agree");
+        }
+    }
+    assertTrue(found, "getifaddrs lists the loopback interface");
+    assertTrue(PWInterfaceFlagsList(interfaces, 0) == count, "the count does not depend on capacity");
+
+    char text[128];
+    PWInterfaceFlagsFormat(IFF_UP | IFF_LOOPBACK | IFF_RUNNING, text, sizeof(text));
+    char expected[64];
+    snprintf(expected, sizeof(expected), "%x<UP,LOOPBACK,RUNNING>", (unsigned int)(IFF_UP | IFF_LOOPBACK | IFF_RUNNING));
+    assertTrue(strcmp(text, expected) == 0, "flags format like ifconfig");
+    PWInterfaceFlagsFormat(0, text, sizeof(text));
+    assertTrue(strcmp(text, "0<>") == 0, "no flags format as empty brackets");
+    char tiny[6];
+    size_t length = PWInterfaceFlagsFormat(IFF_UP | IFF_LOOPBACK | IFF_RUNNING, tiny, sizeof(tiny));
+    assertTrue(length == strlen(expected) && strlen(tiny) == sizeof(tiny) - 1, "a short buffer truncates safely");
+}
+
+static void runStateFileTests(void) {
+    char path[] = "/tmp/enforcement_core_smoke.XXXXXX";
+    int fd = mkstemp(path);
+    assertTrue(fd >= 0, "state temp file");
+    close(fd);
+
+    PWStateFile *file = PWStateFileOpen(path);
+    assertTrue(file != NULL, "state file open");
+    PWPersistedState state = { .allowMask = 0x7 };
+    assertTrue(!PWStateFileLoad(file, &state), "a new state file holds nothing");
+    assertEqualU64(state.allowMask, 0x7, "a failed load leaves the state alone");
+
+    PWPersistedState first = { .allowMask = 0x2, .targetCount = 2, .options = PWStateOptionRealtime, .savedAt = 11 };
+    PWPersistedState second = { .allowMask = 0x0, .targetCount = 2, .options = PWStateOptionLockMemory, .savedAt = 22 };
+    assertTrue(PWStateFileSave(file, &first), "first save");
+    assertTrue(PWStateFileSave(file, &second), "second save");
+    assertTrue(PWStateFileLoad(file, &state), "saved state loads");
+    assertEqualU64(state.savedAt, 22, "the newest save wins");
+    assertEqualU64(state.options, PWStateOptionLockMemory, "options round-trip");
+    PWStateFileClose(file);
+
+    // A crash mid-write damages only the slot being written; the other one still verifies
+    file = PWStateFileOpen(path);
+    assertTrue(file != NULL, "state file reopen after close");
+    assertTrue(PWStateFileLoad(file, &state) && state.savedAt == 22, "state survives a relaunch");
+    corruptStateFile(path, 64 + 20);
+    assertTrue(PWStateFileLoad(file, &state), "a damaged newest slot falls back");
+    assertEqualU64(state.savedAt, 11, "the fallback is the previous save");
+    assertEqualU64(state.allowMask, 0x2, "the fallback carries its own mask");
+    corruptStateFile(path, 20);
+    assertTrue(!PWStateFileLoad(file, &state), "two damaged slots load nothing");
+
+    assertTrue(PWStateFileSave(file, &second), "save over damaged slots");
+    assertTrue(PWStateFileLoad(file, &state) && state.savedAt == 22, "a fresh save recovers the file");
+
+    // The helper snapshots the policy when it queues a save, so an exit restore that
+    // runs before the save cannot put its allow-all policy on disk
+    ScriptedSource *source = scriptedSourceCreate();
+    FakeActuator *actuator = fakeActuatorCreate(IFF_UP);
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, &source->base, &actuator->base);
+    assertTrue(enforcer != NULL, "enforcer creation");
+    assertTrue(PWEnforcerSetPolicy(enforcer, 0, 0x1), "client blocks");
+    PWPersistedState queued = { .allowMask = PWEnforcerGetPolicy(enforcer), .targetCount = 1, .savedAt = 33 };
+    assertTrue(PWEnforcerSetPolicy(enforcer, 0x1, 0x1), "exit restore");
+    assertEqualU64(PWEnforcerGetPolicy(enforcer), 0x1, "the exit restore allows every slot");
+    assertTrue(PWStateFileSave(file, &queued), "queued save runs after the exit restore");
+    assertTrue(PWStateFileLoad(file, &state) && state.savedAt == 33, "queued save loads");
+    assertEqualU64(state.allowMask, 0, "a relaunch enforces the policy from before the exit restore");
+    PWEnforcerDestroy(enforcer);
+    PWStateFileClose(file);
+    unlink(path);
+
+    // Launch latency is measured from the kernel's start stamp
+    uint64_t startedAt = 0;
+    assertTrue(PWProcessStartNanos(&startedAt), "process start time is readable");
+    assertTrue(startedAt <= PWMonotonicNanos(), "the process started in the past");
+    assertTrue(PWMonotonicNanos() - startedAt < 600ull * 1000000000ull, "the process started recently");
+}
+
+// MARK: - Lifetime counters
+
+#define NANOS_PER_DAY (86400ull * 1000000000ull)
+
+static void runLifetimeTests(void) {
+    char path[] = "/tmp/enforcement_core_smoke.XXXXXX";
+    int fd = mkstemp(path);
+    assertTrue(fd >= 0, "counter temp file");
+    close(fd);
+
+    PWLifetime *lifetime = PWLifetimeOpen(path);
+    assertTrue(lifetime != NULL, "counter file open");
+    PWLifetimeStats stats;
+    PWLifetimeGetStats(lifetime, &stats);
+    assertEqualU64(stats.launches, 1, "opening counts a launch");
+    assertEqualU64(stats.interventions, 0, "a new file has no interventions");
+    assertEqualU64(stats.dayCount, 0, "a new file has no days");
+    assertTrue(stats.createdAt > 0, "a new file records when it was created");
+
+    uint64_t today = PWWallClockNanos() / NANOS_PER_DAY;
+    PWLifetimeRecordIntervention(lifetime, (today - 1) * NANOS_PER_DAY + 5);
+    PWLifetimeRecordIntervention(lifetime, today * NANOS_PER_DAY + 7);
+    PWLifetimeRecordIntervention(lifetime, today * NANOS_PER_DAY + 9);
+    PWLifetimeRecordBurst(lifetime, 5, 123);
+    PWLifetimeRecordBurst(lifetime, 3, 456);
+    PWLifetimeAddUpTime(lifetime, 1000);
+    PWLifetimeAddUpTime(lifetime, 500);
+    PWLifetimeClose(lifetime);
+
+    // Everything survives a relaunch
+    lifetime = PWLifetimeOpen(path);
+    assertTrue(lifetime != NULL, "counter file reopen");
+    PWLifetimeGetStats(lifetime, &stats);
+    assertEqualU64(stats.launches, 2, "relaunches are counted");
+    assertEqualU64(stats.interventions, 3, "interventions survive a relaunch");
+    assertEqualU64(stats.lastInterventionAt, today * NANOS_PER_DAY + 9, "newest intervention time survives");
+    assertTrue(stats.maxBurstRate == 5.0 * (1e9 / PW_STORM_WINDOW_NANOS), "burst peak only rises");
+    assertEqualU64(stats.maxBurstAt, 123, "burst peak keeps the time it was reached");
+    assertEqualU64(stats.upNanos, 1500, "UP time accumulates");
+    assertEqualU64(stats.dayCount, 2, "one bucket per day");
+    assertEqualU64(stats.days[0].day, today, "newest day first");
+    assertEqualU64(stats.days[0].interventions, 2, "today's bucket");
+    assertEqualU64(stats.days[1].day, today - 1, "then yesterday");
+    assertEqualU64(stats.days[1].interventions, 1, "yesterday's bucket");
+
+    // A day PW_LIFETIME_DAY_COUNT later reuses yesterday's bucket from zero
+    PWLifetimeRecordIntervention(lifetime, (today - 1 + PW_LIFETIME_DAY_COUNT) * NANOS_PER_DAY);
+    PWLifetimeGetStats(lifetime, &stats);
+    assertEqualU64(stats.dayCount, 2, "the old day is replaced, not added");
+    assertEqualU64(stats.days[0].day, today - 1 + PW_LIFETIME_DAY_COUNT, "the new day is newest");
+    assertEqualU64(stats.days[0].interventions, 1, "the new day starts from zero");
+    assertEqualU64(stats.interventions, 4, "the lifetime total keeps counting");
+    PWLifetimeClose(lifetime);
+
+    // A damaged header starts the file over instead of reporting garbage
+    corruptStateFile(path, 0);
+    lifetime = PWLifetimeOpen(path);
+    assertTrue(lifetime != NULL, "damaged counter file opens");
+    PWLifetimeGetStats(lifetime, &stats);
+    assertEqualU64(stats.launches, 1, "a damaged file is reset");
+    assertEqualU64(stats.interventions, 0, "a damaged file loses its counts");
+
+    // The loop feeds it: an intervention, the burst window and the time the interface was UP
+    unsigned int target = if_nametoindex(LOOPBACK_IFNAME);
+    ScriptedSource *source = scriptedSourceCreate();
+    FakeActuator *actuator = fakeActuatorCreate(IFF_UP);
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, &source->base, &actuator->base);
+    assertTrue(enforcer != NULL, "enforcer creation");
+    PWEnforcerSetLifetime(enforcer, lifetime);
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runEnforcer, enforcer) == 0, "loop thread start");
+
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block request");
+    assertTrue(waitForCount(&actuator->setCount, 1), "block request should bring interface down");
+    PWLifetimeGetStats(lifetime, &stats);
+    assertTrue(stats.upNanos > 0, "lowering an UP interface closes its UP interval");
+    uint64_t upBefore = stats.upNanos;
+
+    atomic_store(&actuator->flags, IFF_UP);
+    PWLinkEvent raised = { .type = PWLinkEventInfo, .ifindex = target, .flags = IFF_UP };
+    scriptedEmit(source, &raised, 1);
+    assertTrue(waitForCount(&actuator->setCount, 2), "raised interface should be lowered");
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    assertTrue(pthread_join(thread, NULL) == 0, "loop thread exit");
+
+    PWLifetimeGetStats(lifetime, &stats);
+    assertEqualU64(stats.interventions, PWEnforcerGetInterventionCount(enforcer), "every intervention is counted");
+    assertEqualU64(stats.dayCount, 1, "interventions land in today's bucket");
+    assertTrue(stats.maxBurstRate > 0, "the burst window is recorded");
+    assertTrue(stats.upNanos > upBefore, "the raise until the intervention counts as UP time");
+    PWEnforcerDestroy(enforcer);
+    PWLifetimeClose(lifetime);
+    unlink(path);
+}
+
+// MARK: - Status page
+
+/// Wait up to one second for the page to show at least expected interventions.
+static bool waitForStatus(const void *mapping, uint64_t expected, PWStatusSnapshot *snapshot) {
+    uint64_t deadline = monotonicNanos() + 1000000000ull;
+    while (monotonicNanos() < deadline) {
+        if (PWStatusPageRead(mapping, snapshot) && snapshot->interventions >= expected) {
+            return true;
+        }
+        usleep(100);
+    }
+    return false;
+}
+
+typedef struct {
+    PWStatusPage *page;
+    atomic_bool stop;
+    uint64_t published;
+} StatusWriter;
+
+/// Publishes snapshots whose every counter holds the same number, so a torn read shows.
+static void *publishUniformStatus(void *context) {
+    StatusWriter *writer = context;
+    PWStatusSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.targetCount = PW_STATUS_PAGE_MAX_TARGETS;
+    while (!atomic_load(&writer->stop)) {
+        uint64_t n = ++writer->published;
+        for (size_t i = 0; i < PW_STATUS_PAGE_MAX_TARGETS; i++) {
+            snapshot.targets[i].interventions = n;
+            snapshot.targets[i].flags = (uint32_t)n;
+        }
+        snapshot.interventions = snapshot.lifetimeInterventions = snapshot.lastInterventionAt = snapshot.updatedAt = n;
+        PWStatusPagePublish(writer->page, &snapshot);
+    }
+    return NULL;
+}
+
+static void runStatusPageTests(void) {
+    char path[] = "/tmp/enforcement_core_smoke.XXXXXX";
+    int fd = mkstemp(path);
+    assertTrue(fd >= 0, "status page temp file");
+    close(fd);
+
+    PWStatusPage *page = PWStatusPageCreate(path);
+    assertTrue(page != NULL, "status page creation");
+    struct stat info;
+    assertTrue(stat(path, &info) == 0 && (info.st_mode & 0777) == 0644, "clients can read the status page");
+    const void *mapping = PWStatusPageMap(path);
+    assertTrue(mapping != NULL, "status page maps read-only");
+    PWStatusSnapshot snapshot;
+    assertTrue(!PWStatusPageRead(mapping, &snapshot), "nothing to read before the first publish");
+
+    PWStatusSnapshot published;
+    memset(&published, 0, sizeof(published));
+    published.sequence = 99;
+    published.writerPid = 1234;
+    published.running = 1;
+    published.targetCount = 1;
+    strcpy(published.targets[0].ifname, "awdl0");
+    published.targets[0].flags = IFF_UP;
+    published.interventions = 7;
+    PWStatusPagePublish(page, &published);
+    assertTrue(PWStatusPageRead(mapping, &snapshot), "published snapshot reads back");
+    assertEqualU64(snapshot.sequence, 1, "publishes are numbered by the page");
+    assertEqualU64((uint64_t)snapshot.writerPid, 1234, "writer pid round-trips");
+    assertTrue(strcmp(snapshot.targets[0].ifname, "awdl0") == 0, "interface name round-trips");
+    assertEqualU64(snapshot.interventions, 7, "counters round-trip");
+
+    // Readers never see a half-written snapshot
+    StatusWriter writer = { .page = page };
+    atomic_init(&writer.stop, false);
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, publishUniformStatus, &writer) == 0, "status writer start");
+    uint64_t reads = 0, lastSequence = 0;
+    uint64_t deadline = monotonicNanos() + 200000000ull;
+    while (monotonicNanos() < deadline) {
+        // Sequence 1 is the snapshot published above, before the writer started
+        if (!PWStatusPageRead(mapping, &snapshot) || snapshot.sequence == 1) {
+            continue;
+        }
+        reads++;
+        uint64_t n = snapshot.interventions;
+        assertTrue(snapshot.lifetimeInterventions == n && snapshot.lastInterventionAt == n && snapshot.updatedAt == n,
+                   "status page read is not torn");
+        for (size_t i = 0; i < PW_STATUS_PAGE_MAX_TARGETS; i++) {
+            assertTrue(snapshot.targets[i].interventions == n && snapshot.targets[i].flags == (uint32_t)n,
+                       "status page targets are not torn");
+        }
+        assertTrue(snapshot.sequence >= lastSequence, "sequence never goes backwards");
+        lastSequence = snapshot.sequence;
+    }
+    atomic_store(&writer.stop, true);
+    assertTrue(pthread_join(thread, NULL) == 0, "status writer exit");
+    assertTrue(reads > 0, "reads succeed while the writer publishes");
+    PWStatusPageDestroy(page);
+
+    // A relaunched helper reuses the file, so existing mappings keep working
+    page = PWStatusPageCreate(path);
+    assertTrue(page != NULL, "status page reopens");
+    assertTrue(PWStatusPageRead(mapping, &snapshot), "old mapping still reads");
+    uint64_t sequenceBefore = snapshot.sequence;
+
+    // The loop publishes the table after starting, after commands and after drains
+    unsigned int target = if_nametoindex(LOOPBACK_IFNAME);
+    ScriptedSource *source = scriptedSourceCreate();
+    FakeActuator *actuator = fakeActuatorCreate(IFF_UP);
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, &source->base, &actuator->base);
+    assertTrue(enforcer != NULL, "enforcer creation");
+    PWEnforcerSetStatusPage(enforcer, page);
+    assertTrue(pthread_create(&thread, NULL, runEnforcer, enforcer) == 0, "loop thread start");
+
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block request");
+    assertTrue(waitForCount(&actuator->setCount, 1), "block request should bring interface down");
+    atomic_store(&actuator->flags, IFF_UP);
+    PWLinkEvent raised = { .type = PWLinkEventInfo, .ifindex = target, .flags = IFF_UP };
+    scriptedEmit(source, &raised, 1);
+    assertTrue(waitForStatus(mapping, 1, &snapshot), "the intervention reaches the status page");
+    assertTrue(snapshot.sequence > sequenceBefore, "the relaunched writer continues the sequence");
+    assertEqualU64((uint64_t)snapshot.writerPid, (uint64_t)getpid(), "the page names its writer");
+    assertEqualU64(snapshot.running, 1, "the loop is running");
+    assertEqualU64(snapshot.targetCount, 1, "one interface in the table");
+    assertTrue(strcmp(snapshot.targets[0].ifname, LOOPBACK_IFNAME) == 0, "the table names the interface");
+    assertTrue(snapshot.targets[0].present, "the interface is present");
+    assertTrue(!snapshot.targets[0].allowUp, "the desired state is blocked");
+    assertTrue(snapshot.targets[0].flagsKnown && !(snapshot.targets[0].flags & IFF_UP), "the actual state is DOWN");
+    assertEqualU64(snapshot.targets[0].interventions, 1, "per-interface count");
+    assertTrue(snapshot.lastInterventionAt > 0 && snapshot.lastInterventionAt <= snapshot.updatedAt,
+               "the last intervention is stamped");
+
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    assertTrue(pthread_join(thread, NULL) == 0, "loop thread exit");
+    assertTrue(PWStatusPageRead(mapping, &snapshot), "the page outlives the loop");
+    assertEqualU64(snapshot.running, 0, "a stopped loop says so");
+    PWEnforcerDestroy(enforcer);
+    PWStatusPageDestroy(page);
+    PWStatusPageUnmap(mapping);
+    unlink(path);
+}
+
+// MARK: - Policy table
+
+#define TABLE_IFNAME "pwtable0"
+#define TABLE_INDEX 300  // above the direct-mapped range, so the scan path is covered too
+
+/// Two interfaces with their own flag words: slot 0 is the loopback, slot 1 TABLE_IFNAME.
+typedef struct {
+    PWActuator base;
+    atomic_uint flags[2];
+    atomic_uint setCount[2];
+} TableActuator;
+
+static atomic_uint *tableFlags(PWActuator *actuator, const char *ifname) {
+    return &((TableActuator *)actuator)->flags[strcmp(ifname, LOOPBACK_IFNAME) != 0];
+}
+
+static bool tableGetFlags(PWActuator *actuator, const char *ifname, uint32_t *flags) {
+    *flags = atomic_load(tableFlags(actuator, ifname));
+    return true;
+}
+
+static bool tableSetFlags(PWActuator *actuator, const char *ifname, uint32_t flags) {
+    atomic_store(tableFlags(actuator, ifname), flags);
+    atomic_fetch_add(&((TableActuator *)actuator)->setCount[strcmp(ifname, LOOPBACK_IFNAME) != 0], 1);
+    return true;
+}
+
+static void runPolicyTableTests(void) {
+    unsigned int loopback = if_nametoindex(LOOPBACK_IFNAME);
+    ScriptedSource *source = scriptedSourceCreate();
+    TableActuator *actuator = calloc(1, sizeof(*actuator));
+    assertTrue(actuator != NULL, "table actuator allocation");
+    actuator->base.getFlags = tableGetFlags;
+    actuator->base.setFlags = tableSetFlags;
+    actuator->base.destroy = fakeDestroy;
+    atomic_store(&actuator->flags[0], IFF_UP);
+
+    const char *names[] = { LOOPBACK_IFNAME, TABLE_IFNAME };
+    assertTrue(PWEnforcerCreateWithTargets(names, 0, NULL, NULL) == NULL, "an empty table is rejected");
+    const char *duplicates[] = { LOOPBACK_IFNAME, LOOPBACK_IFNAME };
+    assertTrue(PWEnforcerCreateWithTargets(duplicates, 2, NULL, &fakeActuatorCreate(0)->base) == NULL,
+               "duplicate interfaces are rejected");
+    PWEnforcer *enforcer = PWEnforcerCreateWithTargets(names, 2, &source->base, &actuator->base);
+    assertTrue(enforcer != NULL, "two-interface enforcer creation");
+    assertEqualU64(PWEnforcerGetTargetCount(enforcer), 2, "both interfaces are in the table");
+    assertEqualU64(PWEnforcerFindTarget(enforcer, TABLE_IFNAME), 1, "slots follow creation order");
+    assertTrue(PWEnforcerFindTarget(enforcer, "pwmissing0") < 0, "unknown interfaces have no slot");
+    assertEqualU64(PWEnforcerGetPolicy(enforcer), 3, "every interface starts allowed");
+
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runEnforcer, enforcer) == 0, "loop thread start");
+
+    // Blocking only the absent interface touches nothing
+    assertTrue(PWEnforcerSetPolicy(enforcer, 0, 1u << 1), "block slot 1");
+    settle();
+    assertEqualU64(PWEnforcerGetPolicy(enforcer), 1, "only slot 1 changed");
+    assertEqualU64(atomic_load(&actuator->setCount[0]) + atomic_load(&actuator->setCount[1]), 0,
+                   "allowed and absent interfaces need no write");
+
+    // It arrives UP: lowered and counted against its own entry only
+    PWLinkEvent arrived = { .type = PWLinkEventArrival, .ifindex = TABLE_INDEX };
+    strncpy(arrived.ifname, TABLE_IFNAME, IFNAMSIZ - 1);
+    PWLinkEvent arrivedUp[] = {
+        arrived,
+        { .type = PWLinkEventInfo, .ifindex = TABLE_INDEX, .flags = IFF_UP },
+        { .type = PWLinkEventInfo, .ifindex = loopback, .flags = IFF_UP },
+    };
+    atomic_store(&actuator->flags[1], IFF_UP);
+    scriptedEmit(source, arrivedUp, 3);
+    assertTrue(waitForCount(&actuator->setCount[1], 1), "blocked interface is lowered on arrival");
+    settle();
+    assertEqualU64(atomic_load(&actuator->setCount[0]), 0, "allowed interface in the same drain is left alone");
+    PWTargetStats stats;
+    assertTrue(PWEnforcerGetTargetStats(enforcer, 1, &stats), "slot 1 stats");
+    assertEqualU64(stats.ifindex, TABLE_INDEX, "arrival fills the entry's index");
+    assertEqualU64(stats.interventions, 1, "intervention counted for the lowered interface");
+    assertTrue(!stats.allowUp && stats.lastInterventionAt > 0, "entry reports its policy and last intervention");
+    assertTrue(PWEnforcerGetTargetStats(enforcer, 0, &stats), "slot 0 stats");
+    assertEqualU64(stats.interventions, 0, "nothing counted for the allowed interface");
+    assertTrue(!PWEnforcerGetTargetStats(enforcer, 2, &stats), "slots past the table are rejected");
+
+    // One update blocks both; a drain raising both costs one write each and one ring event each
+    PWControlStats control;
+    PWEnforcerGetControlStats(enforcer, &control);
+    assertTrue(PWEnforcerSetPolicy(enforcer, 0, 3), "block both");
+    assertTrue(waitForCount(&actuator->setCount[0], 1), "loopback is lowered by the policy change");
+    settle();
+    PWControlStats afterBlock;
+    PWEnforcerGetControlStats(enforcer, &afterBlock);
+    assertEqualU64(afterBlock.actuations, control.actuations + 1, "a table update is applied as one command");
+    atomic_store(&actuator->flags[0], IFF_UP);
+    atomic_store(&actuator->flags[1], IFF_UP | IFF_RUNNING);
+    // The state change re-resolved the names, which found no real TABLE_IFNAME; announce it again
+    PWLinkEvent bothUp[] = {
+        arrived,
+        { .type = PWLinkEventInfo, .ifindex = TABLE_INDEX, .flags = IFF_UP | IFF_RUNNING },
+        { .type = PWLinkEventInfo, .ifindex = loopback, .flags = IFF_UP },
+    };
+    PWIfindexCacheStats cacheBefore, cacheAfter;
+    PWEnforcerGetIfindexCacheStats(enforcer, &cacheBefore);
+    scriptedEmit(source, bothUp, 3);
+    assertTrue(waitForCount(&actuator->setCount[0], 2) && waitForCount(&actuator->setCount[1], 2),
+               "both interfaces are lowered in one drain");
+    PWEnforcerGetIfindexCacheStats(enforcer, &cacheAfter);
+    assertEqualU64(cacheAfter.lookups, cacheBefore.lookups, "messages are matched through the table, not by name");
+    assertEqualU64(PWEnforcerGetInterventionCount(enforcer), 3, "the total covers every interface");
+
+    PWInterventionEvent timeline[4];
+    assertEqualU64(PWEnforcerCopyInterventionEvents(enforcer, 0, timeline, 4), 3, "one ring event per intervention");
+    assertEqualU64(timeline[0].target, 1, "arrival intervention names slot 1");
+    assertEqualU64(timeline[1].target + timeline[2].target, 1, "the double drain names both slots");
+    assertEqualU64(timeline[1].flags | timeline[2].flags, IFF_UP | IFF_RUNNING, "each event keeps its own flags");
+
+    PWEnforcerResetInterventionCount(enforcer);
+    assertTrue(PWEnforcerGetTargetStats(enforcer, 1, &stats) && stats.interventions == 0,
+               "reset clears the per-interface counters");
+
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    assertTrue(pthread_join(thread, NULL) == 0, "loop thread exit");
+    PWEnforcerDestroy(enforcer);
+}
+
+// MARK: - Live backend
+
+static int compareU64(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t *)lhs, b = *(const uint64_t *)rhs;
+    return (a > b) - (a < b);
+}
+
+static bool readFlags(int fd, const char *ifname, short *flags) {
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    if (ioctl(fd, SIOCGIFFLAGS, &ifr) < 0) {
+        return false;
+    }
+    *flags = ifr.ifr_flags;
+    return true;
+}
+
+static bool writeFlags(int fd, const char *ifname, short flags) {
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    ifr.ifr_flags = flags;
+    return ioctl(fd, SIOCSIFFLAGS, &ifr) == 0;
+}
+
+/// Replay a live run's capture against a fake actuator and check the decision path
+/// makes the same interventions it made live.
+static void replayLiveCapture(const char *capturePath, uint32_t initialFlags, uint64_t liveInterventions,
+                              const PWInterventionEvent *liveEvents, size_t liveEventCount) {
+    PWCaptureReader *reader = PWCaptureReaderOpen(capturePath);
+    assertTrue(reader != NULL, "live capture opens");
+    PWEnforcer *replay = PWEnforcerCreate(PWCaptureReaderHeader(reader)->ifname, NULL,
+                                          &fakeActuatorCreate(initialFlags)->base);
+    assertTrue(replay != NULL, "replay enforcer creation");
+
+    PWReplayStats stats;
+    assertTrue(PWEnforcerReplay(replay, reader, PWReplaySpeedMaximum, &stats), "replay of the live capture");
+    assertEqualU64(PWEnforcerGetInterventionCount(replay), liveInterventions, "replay intervenes as often as live");
+
+    PWInterventionEvent *events = calloc(PW_EVENT_RING_CAPACITY, sizeof(PWInterventionEvent));
+    size_t count = PWEnforcerCopyInterventionEvents(replay, 0, events, PW_EVENT_RING_CAPACITY);
+    assertEqualU64(count, liveEventCount, "replay keeps as many events as live");
+    for (size_t i = 0; i < count; i++) {
+        assertEqualU64(events[i].flags, liveEvents[i].flags, "replayed intervention flags match live");
+        assertEqualU64(events[i].trigger, liveEvents[i].trigger, "replayed intervention trigger matches live");
+    }
+    printf("live %s: replayed %llu drains, %llu messages in %.1fus, %llu identical interventions\n",
+           PWCaptureReaderHeader(reader)->ifname, (unsigned long long)stats.drains,
+           (unsigned long long)stats.messages, stats.elapsedNanos / 1000.0, (unsigned long long)liveInterventions);
+
+    free(events);
+    PWEnforcerDestroy(replay);
+    PWCaptureReaderClose(reader);
+}
+
+/// Raise ifname repeatedly and measure how long the loop takes to lower it again.
+/// The run is captured to capturePath (a temporary file if NULL) and replayed.
+static void runLiveTest(const char *ifname, int iterations, const char *capturePath) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    short flags = 0;
+    assertTrue(fd >= 0 && readFlags(fd, ifname, &flags), "live interface must exist");
+    uint32_t initialFlags = (uint16_t)flags;
+
+    char tempPath[] = "/tmp/enforcement_core_smoke.XXXXXX";
+    if (!capturePath) {
+        int tempFd = mkstemp(tempPath);
+        assertTrue(tempFd >= 0, "capture temp file");
+        close(tempFd);
+    }
+
+    PWEnforcer *enforcer = PWEnforcerCreate(ifname, PWDefaultEventSourceCreate(), PWIoctlActuatorCreate());
+    assertTrue(enforcer != NULL, "live enforcer creation (needs root)");
+    assertTrue(PWEnforcerStartCapture(enforcer, capturePath ? capturePath : tempPath), "live capture");
+
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runPreparedEnforcer, enforcer) == 0, "loop thread start");
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block request");
+    settle();
+    assertTrue(PWEnforcerSetMemoryLocked(enforcer, true), "lock the loop's working set (needs root)");
+    PWMemoryStats memoryBefore;
+    PWEnforcerGetMemoryStats(enforcer, &memoryBefore);
+    PWActuationStats baseline;
+    PWEnforcerGetActuationStats(enforcer, &baseline);
+
+    uint64_t *samples = calloc((size_t)iterations, sizeof(uint64_t));
+    // Raise -> loop running, from the wakeup time each ring event records. The
+    // kernel socket carries no arrival time, so this is the live wakeup latency.
+    static PWHistogram wakeups;
+    uint64_t cursor = 0;
+    for (int i = 0; i < iterations; i++) {
+        assertTrue(readFlags(fd, ifname, &flags) && !(flags & IFF_UP), "interface should start down");
+
+        uint64_t start = monotonicNanos();
+        uint64_t raisedAt = PWMonotonicNanos();
+        assertTrue(writeFlags(fd, ifname, (short)(flags | IFF_UP)), "raise interface (needs root)");
+
+        bool lowered = false;
+        while (monotonicNanos() - start < 1000000000ull) {
+            if (readFlags(fd, ifname, &flags) && !(flags & IFF_UP)) {
+                lowered = true;
+                break;
+            }
+        }
+        samples[i] = monotonicNanos() - start;
+        assertTrue(lowered, "enforcer should lower the interface within one second");
+        settle();
+
+        PWInterventionEvent events[8];
+        size_t count = PWEnforcerCopyInterventionEvents(enforcer, cursor, events, 8);
+        for (size_t e = 0; e < count; e++) {
+            if (events[e].timestamp >= raisedAt) {
+                PWHistogramRecord(&wakeups, events[e].timestamp - raisedAt);
+                break;
+            }
+        }
+        if (count > 0) {
+            cursor = events[count - 1].sequence;
+        }
+    }
+
+    assertTrue(PWEnforcerGetInterventionCount(enforcer) >= (uint64_t)iterations, "every raise is an intervention");
+
+    qsort(samples, (size_t)iterations, sizeof(uint64_t), compareU64);
+    uint64_t interventions = PWEnforcerGetInterventionCount(enforcer);
+    PWActuationStats actuation;
+    PWEnforcerGetActuationStats(enforcer, &actuation);
+    printf("live %s: %d raises, reaction min=%.1fus p50=%.1fus max=%.1fus interventions=%llu "
+           "ioctls/intervention=%.2f\n",
+           ifname, iterations,
+           samples[0] / 1000.0, samples[iterations / 2] / 1000.0, samples[iterations - 1] / 1000.0,
+           (unsigned long long)interventions,
+           (double)(actuation.actuatorCalls - baseline.actuatorCalls) / (double)interventions);
+
+    static const char *stageNames[PWReactionStageCount] = { "receive->decision", "decision->ioctl", "receive->ioctl" };
+    for (PWReactionStage stage = 0; stage < PWReactionStageCount; stage++) {
+        PWHistogramSnapshot reaction;
+        PWEnforcerCopyReactionHistogram(enforcer, stage, &reaction);
+        assertEqualU64(reaction.total, interventions, "every intervention records its reaction time");
+        printf("live %s: %-17s p50=%.1fus p99=%.1fus max=%.1fus\n", ifname, stageNames[stage],
+               PWHistogramValueAtPercentile(&reaction, 50) / 1000.0,
+               PWHistogramValueAtPercentile(&reaction, 99) / 1000.0, reaction.max / 1000.0);
+    }
+    PWHistogramSnapshot wakeup;
+    PWHistogramCopy(&wakeups, &wakeup);
+    assertTrue(wakeup.total > 0, "raises wake the loop");
+    printf("live %s: %-17s p50=%.1fus p99=%.1fus max=%.1fus\n", ifname, "raise->wakeup",
+           PWHistogramValueAtPercentile(&wakeup, 50) / 1000.0,
+           PWHistogramValueAtPercentile(&wakeup, 99) / 1000.0, wakeup.max / 1000.0);
+    free(samples);
+
+    PWMemoryStats memory;
+    PWEnforcerGetMemoryStats(enforcer, &memory);
+    assertTrue(memory.faultsAvailable, "the live loop's faults are counted");
+    printf("live %s: loop %s faults during raises minor=%llu major=%llu (%.0f KB prefaulted, %.0f KB locked)\n",
+           ifname, memory.faultsPerThread ? "thread" : "process",
+           (unsigned long long)(memory.minorFaults - memoryBefore.minorFaults),
+           (unsigned long long)(memory.majorFaults - memoryBefore.majorFaults),
+           memory.prefaultedBytes / 1024.0, memory.lockedBytes / 1024.0);
+
+    // Back-to-back raises are exactly the storm the detector exists for
+    PWStormStats storm;
+    PWEnforcerGetStormStats(enforcer, &storm);
+    PWStormEpisode episode;
+    size_t episodeCount = PWEnforcerCopyStormEpisodes(enforcer, &episode, 1);
+    assertTrue(iterations <= PW_STORM_BURST || storm.episodes > 0, "a raise storm is detected");
+    printf("live %s: storm episodes=%llu peak=%.0f/s", ifname, (unsigned long long)storm.episodes, storm.peakRate);
+    if (episodeCount) {
+        printf(" latest: %llu interventions in %.1fms", (unsigned long long)episode.interventions,
+               episode.durationNanos / 1e6);
+    }
+    printf("\n");
+
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    pthread_join(thread, NULL);
+    PWInterventionEvent *liveEvents = calloc(PW_EVENT_RING_CAPACITY, sizeof(PWInterventionEvent));
+    size_t liveEventCount = PWEnforcerCopyInterventionEvents(enforcer, 0, liveEvents, PW_EVENT_RING_CAPACITY);
+    // Destroying the enforcer flushes and closes the capture
+    PWEnforcerDestroy(enforcer);
+    close(fd);
+
+    replayLiveCapture(capturePath ? capturePath : tempPath, initialFlags, interventions, liveEvents, liveEventCount);
+    free(liveEvents);
+    if (!capturePath) {
+        unlink(tempPath);
+    }
+}
+
+#if defined(__linux__)
+
+// MARK: - Netlink filter (Linux, live)
+
+typedef struct {
+    struct nlmsghdr header;
+    struct ifinfomsg info;
+    uint8_t attributes[512];
+} LinkRequest;
+
+static struct rtattr *appendAttribute(struct nlmsghdr *nlh, unsigned short type, const void *data, size_t length) {
+    struct rtattr *rta = (struct rtattr *)((uint8_t *)nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+    rta->rta_type = type;
+    rta->rta_len = (unsigned short)RTA_LENGTH(length);
+    if (length) {
+        memcpy(RTA_DATA(rta), data, length);
+    }
+    nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+    return rta;
+}
+
+static void closeNest(struct nlmsghdr *nlh, struct rtattr *nest) {
+    nest->rta_len = (unsigned short)((uint8_t *)nlh + nlh->nlmsg_len - (uint8_t *)nest);
+}
+
+/// Send one RTM_NEWLINK/RTM_DELLINK request and wait for its acknowledgement.
+static bool sendLinkRequest(LinkRequest *request) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        return false;
+    }
+    request->header.nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+    bool ok = send(fd, request, request->header.nlmsg_len, 0) == (ssize_t)request->header.nlmsg_len;
+    uint32_t reply[1024];
+    ssize_t len = ok ? recv(fd, reply, sizeof(reply), 0) : -1;
+    const struct nlmsghdr *nlh = (const struct nlmsghdr *)reply;
+    ok = len >= (ssize_t)NLMSG_LENGTH(sizeof(struct nlmsgerr)) && nlh->nlmsg_type == NLMSG_ERROR &&
+         ((const struct nlmsgerr *)NLMSG_DATA(nlh))->error == 0;
+    close(fd);
+    return ok;
+}
+
+static bool createVethPair(const char *name, const char *peer) {
+    LinkRequest request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.header.nlmsg_type = RTM_NEWLINK;
+    request.header.nlmsg_flags = NLM_F_CREATE | NLM_F_EXCL;
+    appendAttribute(&request.header, IFLA_IFNAME, name, strlen(name) + 1);
+    struct rtattr *linkInfo = appendAttribute(&request.header, IFLA_LINKINFO, NULL, 0);
+    appendAttribute(&request.header, IFLA_INFO_KIND, "veth", 4);
+    struct rtattr *infoData = appendAttribute(&request.header, IFLA_INFO_DATA, NULL, 0);
+    struct ifinfomsg peerInfo = { .ifi_family = AF_UNSPEC };
+    struct rtattr *peerAttr = appendAttribute(&request.header, VETH_INFO_PEER, &peerInfo, sizeof(peerInfo));
+    appendAttribute(&request.header, IFLA_IFNAME, peer, strlen(peer) + 1);
+    closeNest(&request.header, peerAttr);
+    closeNest(&request.header, infoData);
+    closeNest(&request.header, linkInfo);
+    return sendLinkRequest(&request);
+}
+
+static bool deleteLink(const char *name) {
+    LinkRequest request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.header.nlmsg_type = RTM_DELLINK;
+    appendAttribute(&request.header, IFLA_IFNAME, name, strlen(name) + 1);
+    return sendLinkRequest(&request);
+}
+
+/// Watch an interface that does not exist yet, then check the kernel filter lets its
+/// arrival and UP through while a busy neighbour never wakes the loop.
+static void runFilterTest(void) {
+    static const char *target = "pwfilter0";
+    static const char *peer = "pwfilter1";
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    assertTrue(fd >= 0, "ioctl socket");
+
+    PWEnforcer *enforcer = PWEnforcerCreate(target, PWDefaultEventSourceCreate(), PWIoctlActuatorCreate());
+    assertTrue(enforcer != NULL, "filter enforcer creation");
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runEnforcer, enforcer) == 0, "loop thread start");
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block request");
+    settle();
+
+    PWIfindexCacheStats cache;
+    PWEnforcerGetIfindexCacheStats(enforcer, &cache);
+    assertEqualU64(cache.filterUpdates, 1, "an absent target still gets a registrations-only filter");
+
+    // The registration carries a new index and must pass the old filter
+    assertTrue(createVethPair(target, peer), "create veth pair (needs root)");
+    settle();
+    PWEnforcerGetIfindexCacheStats(enforcer, &cache);
+    assertEqualU64(cache.filterUpdates, 2, "arrival regenerates the filter for the new index");
+
+    short flags = 0;
+    assertTrue(readFlags(fd, target, &flags) && writeFlags(fd, target, (short)(flags | IFF_UP)), "raise target");
+    bool lowered = false;
+    for (int i = 0; i < 1000 && !lowered; i++) {
+        usleep(1000);
+        lowered = readFlags(fd, target, &flags) && !(flags & IFF_UP);
+    }
+    assertTrue(lowered, "the watched interface's UP passes the filter");
+
+    // The peer's notifications are dropped in the kernel
+    settle();
+    PWIfindexCacheStats before;
+    PWEnforcerGetIfindexCacheStats(enforcer, &before);
+    for (int i = 0; i < 50; i++) {
+        assertTrue(readFlags(fd, peer, &flags) && writeFlags(fd, peer, (short)(flags ^ IFF_UP)), "toggle peer");
+    }
+    settle();
+    PWEnforcerGetIfindexCacheStats(enforcer, &cache);
+    assertEqualU64(cache.lookupsAvoided - before.lookupsAvoided, 0, "unwatched link messages never reach the loop");
+
+    assertTrue(deleteLink(target), "delete veth pair");
+    settle();
+    PWEnforcerGetIfindexCacheStats(enforcer, &cache);
+    assertEqualU64(cache.filterUpdates, 3, "departure narrows the filter back to registrations");
+    printf("filter %s: arrival, UP and departure passed; 50 neighbour changes filtered\n", target);
+
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    pthread_join(thread, NULL);
+    PWEnforcerDestroy(enforcer);
+    close(fd);
+}
+
+// MARK: - Receive overflow (Linux, live)
+
+/// ioctl actuator that can stall the loop inside its next write, so link messages
+/// pile up in the socket the way they do when a storm outruns the loop.
+typedef struct {
+    PWActuator base;
+    PWActuator *inner;
+    atomic_bool holdNext;
+    atomic_bool held;
+} GateActuator;
+
+static bool gateGetFlags(PWActuator *actuator, const char *ifname, uint32_t *flags) {
+    GateActuator *self = (GateActuator *)actuator;
+    return self->inner->getFlags(self->inner, ifname, flags);
+}
+
+static bool gateSetFlags(PWActuator *actuator, const char *ifname, uint32_t flags) {
+    GateActuator *self = (GateActuator *)actuator;
+    bool ok = self->inner->setFlags(self->inner, ifname, flags);
+    if (atomic_exchange(&self->holdNext, false)) {
+        atomic_store(&self->held, true);
+        while (atomic_load(&self->held)) {
+            usleep(100);
+        }
+    }
+    return ok;
+}
+
+static void gateDestroy(PWActuator *actuator) {
+    GateActuator *self = (GateActuator *)actuator;
+    self->inner->destroy(self->inner);
+    free(self);
+}
+
+/// Overflow a deliberately tiny receive buffer while the loop is stalled, ending the
+/// storm with the interface UP, and check the loop notices and lowers it anyway.
+static void runOverflowTest(const char *ifname) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    assertTrue(fd >= 0, "ioctl socket");
+    PWEventSource *source = PWDefaultEventSourceCreate();
+    assertTrue(source != NULL, "overflow source creation");
+    // The kernel clamps this to its minimum, room for a few link messages
+    int granted = PWEventSourceSetReceiveBufferSize(source, 1);
+    assertTrue(granted > 0 && granted < 16384, "receive buffer shrinks");
+
+    GateActuator *actuator = calloc(1, sizeof(*actuator));
+    assertTrue(actuator != NULL, "gate actuator allocation");
+    actuator->inner = PWIoctlActuatorCreate();
+    actuator->base.getFlags = gateGetFlags;
+    actuator->base.setFlags = gateSetFlags;
+    actuator->base.destroy = gateDestroy;
+    PWEnforcer *enforcer = PWEnforcerCreate(ifname, source, &actuator->base);
+    assertTrue(enforcer != NULL, "overflow enforcer creation");
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runEnforcer, enforcer) == 0, "loop thread start");
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block request");
+    settle();
+
+    // The loop lowers this raise, then stalls inside the write
+    short flags = 0;
+    atomic_store(&actuator->holdNext, true);
+    assertTrue(readFlags(fd, ifname, &flags) && writeFlags(fd, ifname, (short)(flags | IFF_UP)), "raise");
+    for (int i = 0; i < 10000 && !atomic_load(&actuator->held); i++) {
+        usleep(100);
+    }
+    assertTrue(atomic_load(&actuator->held), "loop stalls in the gated write");
+
+    // An odd number of toggles from DOWN ends UP; the last ones cannot fit in the buffer
+    int toggles = 201;
+    for (int i = 0; i < toggles; i++) {
+        assertTrue(readFlags(fd, ifname, &flags) && writeFlags(fd, ifname, (short)(flags ^ IFF_UP)), "toggle");
+    }
+    assertTrue(readFlags(fd, ifname, &flags) && (flags & IFF_UP), "storm leaves the interface UP");
+    atomic_store(&actuator->held, false);
+
+    bool lowered = false;
+    for (int i = 0; i < 1000 && !lowered; i++) {
+        usleep(1000);
+        lowered = readFlags(fd, ifname, &flags) && !(flags & IFF_UP);
+    }
+    assertTrue(lowered, "the interface is lowered after the overflow");
+    settle();
+
+    PWResyncStats resync;
+    PWEnforcerGetResyncStats(enforcer, &resync);
+    assertTrue(resync.overflows >= 1, "the overflow is detected");
+    assertTrue(resync.resyncs >= resync.overflows, "every overflow is followed by a resync");
+    printf("overflow %s: %d toggles into a %d-byte buffer, overflows=%llu resyncs=%llu resync-interventions=%llu\n",
+           ifname, toggles, granted, (unsigned long long)resync.overflows, (unsigned long long)resync.resyncs,
+           (unsigned long long)resync.resyncInterventions);
+
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    pthread_join(thread, NULL);
+    PWEnforcerDestroy(enforcer);
+    close(fd);
+}
+
+#endif /* __linux__ */
+
+// MARK: - Memory residency
+
+static void runMemoryTests(void) {
+    uint8_t pattern[3 * 4096 + 17];
+    for (size_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (uint8_t)i;
+    }
+    PWMemoryRegion region = { pattern, sizeof(pattern) };
+    assertEqualU64(PWMemoryPrefault(&region), sizeof(pattern), "prefault reports the region's size");
+    bool intact = true;
+    for (size_t i = 0; i < sizeof(pattern); i++) {
+        intact = intact && pattern[i] == (uint8_t)i;
+    }
+    assertTrue(intact, "prefaulting leaves the contents alone");
+
+    PWFaultCounts before, after;
+    assertTrue(PWMemoryGetFaultCounts(PWMemoryCurrentThreadId(), &before), "fault counters are readable");
+    PWMemoryRegion stack;
+    PWMemoryPrefaultStack(PW_MEMORY_STACK_PREFAULT_BYTES, &stack);
+    assertEqualU64(stack.length, PW_MEMORY_STACK_PREFAULT_BYTES, "the whole stack allowance is touched");
+    assertTrue((uint8_t *)stack.address < (uint8_t *)&region, "the prefaulted stack lies below the caller");
+    assertTrue(PWMemoryGetFaultCounts(PWMemoryCurrentThreadId(), &after), "fault counters are readable again");
+    assertTrue(after.minorFaults >= before.minorFaults && after.majorFaults >= before.majorFaults,
+               "fault counters never go backwards");
+
+    ScriptedSource *source = scriptedSourceCreate();
+    FakeActuator *actuator = fakeActuatorCreate(IFF_UP);
+    atomic_uint interventions = 0;
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, &source->base, &actuator->base);
+    assertTrue(enforcer != NULL, "enforcer creation");
+    PWEnforcerSetInterventionCallback(enforcer, countIntervention, &interventions);
+    PWMemoryStats stats;
+    PWEnforcerGetMemoryStats(enforcer, &stats);
+    assertTrue(stats.prefaultedBytes > 0 && !stats.locked && !stats.faultsAvailable,
+               "the enforcer is prefaulted at creation and counts faults only once prepared");
+
+    pthread_t thread;
+    assertTrue(pthread_create(&thread, NULL, runPreparedEnforcer, enforcer) == 0, "loop thread start");
+    assertTrue(PWEnforcerSetAllowUp(enforcer, false), "block request");
+    settle();
+    PWEnforcerGetMemoryStats(enforcer, &stats);
+    assertTrue(stats.faultsAvailable, "the prepared loop thread's faults are counted");
+    assertEqualU64(stats.faultsPerThread, PW_MEMORY_FAULTS_PER_THREAD, "fault scope matches the platform");
+    assertTrue(stats.prefaultedBytes > PW_MEMORY_STACK_PREFAULT_BYTES, "the loop's stack is prefaulted too");
+
+    // mlock needs root (or CAP_IPC_LOCK); the CI runner has it, a developer shell may not
+    bool canLock = geteuid() == 0;
+    if (canLock) {
+        assertTrue(PWEnforcerSetMemoryLocked(enforcer, true), "the working set locks");
+        PWEnforcerGetMemoryStats(enforcer, &stats);
+        assertTrue(stats.locked && stats.lockedBytes > PW_MEMORY_STACK_PREFAULT_BYTES,
+                   "the enforcer and the loop's stack are locked");
+        assertTrue(PWEnforcerSetMemoryLocked(enforcer, true), "locking twice is harmless");
+    }
+
+    atomic_store(&actuator->flags, IFF_UP);
+    PWLinkEvent up = { .type = PWLinkEventInfo, .ifindex = if_nametoindex(LOOPBACK_IFNAME), .flags = IFF_UP };
+    scriptedEmit(source, &up, 1);
+    assertTrue(waitForCount(&interventions, 1), "a locked loop still intervenes");
+
+    if (canLock) {
+        assertTrue(PWEnforcerSetMemoryLocked(enforcer, false), "the working set unlocks");
+        PWEnforcerGetMemoryStats(enforcer, &stats);
+        assertTrue(!stats.locked && stats.lockedBytes == 0, "nothing stays locked");
+    }
+
+    assertTrue(PWEnforcerStop(enforcer), "stop request");
+    assertTrue(pthread_join(thread, NULL) == 0, "loop thread exit");
+    PWEnforcerDestroy(enforcer);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "--live") == 0) {
+        int iterations = argc >= 4 ? atoi(argv[3]) : 100;
+        runLiveTest(argv[2], iterations > 0 ? iterations : 100, argc >= 5 ? argv[4] : NULL);
+#if defined(__linux__)
+        runFilterTest();
+        runOverflowTest(argv[2]);
+#endif
+        printf("enforcement_core_smoke.c: live assertions passed\n");
+        return 0;
+    }
+
+    runHistogramTests();
+    runEventRingTests();
+    runTraceTests();
+    runStormTests();
+    runCaptureTests();
+    runScriptedTests();
+    runControlTests();
+    runPolicyTableTests();
+    runMemoryTests();
+    runInterfaceFlagsTests();
+    runStateFileTests();
+    runLifetimeTests();
+    runStatusPageTests();
+    printf("enforcement_core_smoke.c: all assertions passed\n");
+    return 0;
+}
@@ -0,0 +1,311 @@
+//
+//  enforcement_drain_bench.c
+//  PingWarden
+//
+//  Compares single-message and batched drains of the platform event source
+//  (AF_ROUTE on Darwin, rtnetlink on Linux) against recorded message bursts.
+//  Each burst is queued on a datagram socket, one kernel message per datagram,
+//  then drained once; we report syscalls, messages per wakeup and the time
+//  from "burst queued" to "final target state known". A second pass drives
+//  the real decision path and reports interface index cache counters.
+//
+//  Build from the repository root with the same flags as the smoke test:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWardenHelper/Core
+//     PingWarden/PingWardenHelper/Core/*.c scripts/enforcement_drain_bench.c
+//     -lpthread -o /tmp/enforcement_drain_bench
+//
+
+#include "PWBackend.h"
+#include "PWEnforcer.h"
+
+#include <sys/socket.h>
+#include <net/if.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <net/route.h>
+#define PWSourceCreateWithDescriptor PWRouteSocketSourceCreateWithDescriptor
+#else
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#define PWSourceCreateWithDescriptor PWNetlinkSourceCreateWithDescriptor
+#endif
+
+#if defined(__APPLE__)
+#define LOOPBACK_IFNAME "lo0"
+#else
+#define LOOPBACK_IFNAME "lo"
+#endif
+
+// Bursts name the watched interface with index 0; it is replaced at run time by
+// the loopback index so the real enforcer's index cache recognises it.
+#define TARGET_IFINDEX 0
+#define ITERATIONS 500
+
+static unsigned int targetIndex;
+
+static uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// MARK: - Recorded bursts
+
+typedef enum { StepLink, StepAddress, StepRoute } StepKind;
+
+typedef struct {
+    StepKind kind;
+    unsigned int ifindex;
+    uint32_t flags;
+    int repeat;
+} BurstStep;
+
+typedef struct {
+    const char *name;
+    const BurstStep *steps;
+    size_t count;
+} Burst;
+
+// Wi-Fi roam: en0 bounces, routes and addresses are torn down and re-added,
+// and AWDL is raised twice while the new association settles.
+static const BurstStep wifiRoam[] = {
+    { StepRoute, 4, 0, 40 },
+    { StepAddress, 4, 0, 12 },
+    { StepLink, 4, 0, 2 },
+    { StepLink, 4, IFF_UP, 2 },
+    { StepLink, TARGET_IFINDEX, IFF_UP, 1 },
+    { StepRoute, 4, 0, 60 },
+    { StepAddress, 4, 0, 12 },
+    { StepLink, TARGET_IFINDEX, 0, 1 },
+    { StepRoute, 4, 0, 30 },
+    { StepLink, TARGET_IFINDEX, IFF_UP, 1 },
+    { StepAddress, 4, 0, 20 },
+};
+
+// VPN connect: utun interfaces appear and a full route table is pushed.
+static const BurstStep vpnConnect[] = {
+    { StepLink, 20, IFF_UP, 4 },
+    { StepLink, 21, IFF_UP, 4 },
+    { StepAddress, 20, 0, 10 },
+    { StepRoute, 20, 0, 150 },
+    { StepLink, TARGET_IFINDEX, IFF_UP, 2 },
+    { StepRoute, 21, 0, 20 },
+};
+
+// Container churn: hundreds of veth link changes with one AWDL raise at the end.
+static const BurstStep vethChurn[] = {
+    { StepLink, 100, IFF_UP, 120 },
+    { StepLink, 101, 0, 120 },
+    { StepLink, 102, IFF_UP, 120 },
+    { StepLink, TARGET_IFINDEX, IFF_UP, 1 },
+};
+
+#define BURST(name, steps) { name, steps, sizeof(steps) / sizeof(steps[0]) }
+
+static const Burst bursts[] = {
+    BURST("wifi-roam", wifiRoam),
+    BURST("vpn-connect", vpnConnect),
+    BURST("veth-churn", vethChurn),
+};
+
+// MARK: - Platform message encoding
+
+/// Encode one step as the kernel would deliver it. Returns the message length.
+static size_t encodeStep(const BurstStep *step, uint8_t *buf, size_t size) {
+    memset(buf, 0, size);
+#if defined(__APPLE__)
+    size_t len;
+    if (step->kind == StepLink) {
+        struct if_msghdr *ifm = (void *)buf;
+        len = sizeof(*ifm) + 20;  // plus a sockaddr_dl
+        ifm->ifm_type = RTM_IFINFO;
+        ifm->ifm_index = (unsigned short)(step->ifindex == TARGET_IFINDEX ? targetIndex : step->ifindex);
+        ifm->ifm_flags = (int)step->flags;
+    } else {
+        struct rt_msghdr *rtm = (void *)buf;
+        len = sizeof(*rtm) + 3 * 16;  // plus destination, gateway and netmask
+        rtm->rtm_type = step->kind == StepRoute ? RTM_ADD : RTM_NEWADDR;
+        rtm->rtm_index = (unsigned short)step->ifindex;
+    }
+    ((struct rt_msghdr *)buf)->rtm_msglen = (unsigned short)len;
+    ((struct rt_msghdr *)buf)->rtm_version = RTM_VERSION;
+    return len;
+#else
+    struct nlmsghdr *nlh = (void *)buf;
+    if (step->kind == StepLink) {
+        nlh->nlmsg_type = RTM_NEWLINK;
+        struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+        ifi->ifi_index = (int)(step->ifindex == TARGET_IFINDEX ? targetIndex : step->ifindex);
+        ifi->ifi_flags = step->flags;
+        nlh->nlmsg_len = NLMSG_LENGTH(sizeof(*ifi) + RTA_SPACE(IFNAMSIZ) + RTA_SPACE(4) * 8);
+    } else {
+        nlh->nlmsg_type = step->kind == StepRoute ? RTM_NEWROUTE : RTM_NEWADDR;
+        nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg) + RTA_SPACE(16) * 3);
+    }
+    return NLMSG_ALIGN(nlh->nlmsg_len);
+#endif
+}
+
+// MARK: - Decision stand-in
+
+typedef struct {
+    uint32_t finalFlags;
+    bool sawTarget;
+} Decision;
+
+static void recordEvent(void *context, const PWLinkEvent *event) {
+    Decision *decision = context;
+    if (event->ifindex == targetIndex) {
+        decision->finalFlags = event->flags;
+        decision->sawTarget = true;
+    }
+}
+
+// MARK: - Benchmark
+
+static int compareU64(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t *)lhs, b = *(const uint64_t *)rhs;
+    return (a > b) - (a < b);
+}
+
+static size_t queueBurst(int fd, const Burst *burst, uint32_t *expectedFlags) {
+    uint8_t message[512];
+    size_t queued = 0;
+    for (size_t i = 0; i < burst->count; i++) {
+        const BurstStep *step = &burst->steps[i];
+        size_t len = encodeStep(step, message, sizeof(message));
+        for (int r = 0; r < step->repeat; r++) {
+            if (write(fd, message, len) != (ssize_t)len) {
+                perror("write burst");
+                exit(1);
+            }
+            queued++;
+        }
+        if (step->kind == StepLink && step->ifindex == TARGET_IFINDEX) {
+            *expectedFlags = step->flags;
+        }
+    }
+    return queued;
+}
+
+static PWEventSource *createBurstSource(int *writeFd) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_DGRAM, 0, pair) != 0) {
+        perror("socketpair");
+        exit(1);
+    }
+    int bufferSize = 4 * 1024 * 1024;
+    setsockopt(pair[0], SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    setsockopt(pair[1], SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+    fcntl(pair[0], F_SETFL, O_NONBLOCK);
+
+    *writeFd = pair[1];
+    return PWSourceCreateWithDescriptor(pair[0]);
+}
+
+static void runBurst(const Burst *burst, PWDrainMode mode) {
+    int writeFd;
+    PWEventSource *source = createBurstSource(&writeFd);
+    source->drainMode = mode;
+
+    uint64_t *samples = calloc(ITERATIONS, sizeof(uint64_t));
+    size_t messagesPerBurst = 0;
+    for (int i = 0; i < ITERATIONS; i++) {
+        uint32_t expectedFlags = 0;
+        messagesPerBurst = queueBurst(writeFd, burst, &expectedFlags);
+
+        Decision decision = { 0 };
+        uint64_t start = monotonicNanos();
+        source->drain(source, recordEvent, &decision);
+        samples[i] = monotonicNanos() - start;
+
+        if (!decision.sawTarget || decision.finalFlags != expectedFlags) {
+            fprintf(stderr, "%s: wrong final target state\n", burst->name);
+            exit(1);
+        }
+    }
+
+    PWDrainStats stats = source->stats;
+    qsort(samples, ITERATIONS, sizeof(uint64_t), compareU64);
+    printf("%-12s %-8s msgs/burst=%-4zu syscalls/wakeup=%-7.1f msgs/wakeup=%-6.1f msgs/syscall=%-6.1f "
+           "time-to-action p50=%.1fus p99=%.1fus\n",
+           burst->name, mode == PWDrainModeBatched ? "batched" : "single",
+           messagesPerBurst,
+           (double)stats.syscalls / (double)stats.wakeups,
+           (double)stats.messages / (double)stats.wakeups,
+           (double)stats.messages / (double)stats.syscalls,
+           samples[ITERATIONS / 2] / 1000.0, samples[ITERATIONS * 99 / 100] / 1000.0);
+
+    free(samples);
+    source->destroy(source);
+    close(writeFd);
+}
+
+// MARK: - Interface index cache under storm
+
+static bool nullGetFlags(PWActuator *actuator, const char *ifname, uint32_t *flags) {
+    (void)actuator; (void)ifname;
+    *flags = 0;
+    return true;
+}
+
+static bool nullSetFlags(PWActuator *actuator, const char *ifname, uint32_t flags) {
+    (void)actuator; (void)ifname; (void)flags;
+    return true;
+}
+
+static void nullDestroy(PWActuator *actuator) {
+    free(actuator);
+}
+
+/// Drive the real decision path and count the name lookups it needed.
+static void runCacheStorm(const Burst *burst) {
+    int writeFd;
+    PWEventSource *source = createBurstSource(&writeFd);
+    PWActuator *actuator = calloc(1, sizeof(*actuator));
+    actuator->getFlags = nullGetFlags;
+    actuator->setFlags = nullSetFlags;
+    actuator->destroy = nullDestroy;
+
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, source, actuator);
+    uint64_t start = monotonicNanos();
+    for (int i = 0; i < ITERATIONS; i++) {
+        uint32_t expectedFlags = 0;
+        queueBurst(writeFd, burst, &expectedFlags);
+        source->drain(source, PWEnforcerHandleLinkEvent, enforcer);
+        PWEnforcerFinishDrain(enforcer);
+    }
+    uint64_t elapsed = monotonicNanos() - start;
+
+    PWIfindexCacheStats cache;
+    PWEnforcerGetIfindexCacheStats(enforcer, &cache);
+    printf("%-12s ifindex cache: lookups=%llu avoided=%llu updates=%llu (%.1fus per burst)\n",
+           burst->name, (unsigned long long)cache.lookups, (unsigned long long)cache.lookupsAvoided,
+           (unsigned long long)cache.cacheUpdates, elapsed / 1000.0 / ITERATIONS);
+
+    PWEnforcerDestroy(enforcer);
+    close(writeFd);
+}
+
+int main(void) {
+    targetIndex = if_nametoindex(LOOPBACK_IFNAME);
+    if (!targetIndex) {
+        fprintf(stderr, "loopback interface %s not found\n", LOOPBACK_IFNAME);
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(bursts) / sizeof(bursts[0]); i++) {
+        runBurst(&bursts[i], PWDrainModeSingle);
+        runBurst(&bursts[i], PWDrainModeBatched);
+    }
+    for (size_t i = 0; i < sizeof(bursts) / sizeof(bursts[0]); i++) {
+        runCacheStorm(&bursts[i]);
+    }
+    return 0;
+}
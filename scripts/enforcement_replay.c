@@ -0,0 +1,160 @@
+//
+//  enforcement_replay.c
+//  PingWarden
+//
+//  Replays a routing event capture (PWCapture.h) through the platform parser
+//  and the enforcer's decision path, with no sockets and a recording
+//  actuator. Prints decision throughput and a digest of every actuator call
+//  the decisions produced; two builds of the loop that print the same digest
+//  for a capture made the same interventions in the same order.
+//
+//  Captures come from the helper (EventCapturePath preference, see README) or
+//  from enforcement_core_smoke --live IFNAME ITERATIONS CAPTURE.
+//
+//  Usage: enforcement_replay [--recorded-speed] [--repeat N] [--expect DIGEST] CAPTURE
+//
+//  Build from the repository root with the same flags as the smoke test:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWardenHelper/Core
+//     PingWarden/PingWardenHelper/Core/*.c scripts/enforcement_replay.c
+//     -lpthread -o /tmp/enforcement_replay
+//
+
+#include "PWCapture.h"
+#include "PWEnforcer.h"
+
+#include <net/if.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// MARK: - Recording actuator
+
+typedef struct {
+    PWActuator base;
+    uint32_t flags;
+    uint64_t calls;
+    uint64_t digest;  // FNV-1a over (call kind, flags) of every call
+} RecordingActuator;
+
+static void recordCall(RecordingActuator *self, uint8_t kind, uint32_t flags) {
+    uint8_t bytes[5] = { kind, (uint8_t)flags, (uint8_t)(flags >> 8), (uint8_t)(flags >> 16), (uint8_t)(flags >> 24) };
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        self->digest = (self->digest ^ bytes[i]) * 0x100000001b3ull;
+    }
+    self->calls++;
+}
+
+static bool recordingGetFlags(PWActuator *actuator, const char *ifname, uint32_t *flags) {
+    (void)ifname;
+    RecordingActuator *self = (RecordingActuator *)actuator;
+    recordCall(self, 'g', self->flags);
+    *flags = self->flags;
+    return true;
+}
+
+static bool recordingSetFlags(PWActuator *actuator, const char *ifname, uint32_t flags) {
+    (void)ifname;
+    RecordingActuator *self = (RecordingActuator *)actuator;
+    recordCall(self, 's', flags);
+    self->flags = flags;
+    return true;
+}
+
+static void recordingDestroy(PWActuator *actuator) {
+    free(actuator);
+}
+
+// MARK: - Replay
+
+static void usage(void) {
+    fprintf(stderr, "usage: enforcement_replay [--recorded-speed] [--repeat N] [--expect DIGEST] CAPTURE\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[]) {
+    PWReplaySpeed speed = PWReplaySpeedMaximum;
+    long repeat = 1;
+    const char *expected = NULL;
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--recorded-speed") == 0) {
+            speed = PWReplaySpeedRecorded;
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc) {
+            expected = argv[++i];
+        } else if (!path && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            usage();
+        }
+    }
+    if (!path || repeat < 1) {
+        usage();
+    }
+
+    PWCaptureReader *reader = PWCaptureReaderOpen(path);
+    if (!reader) {
+        fprintf(stderr, "cannot read capture %s\n", path);
+        return 1;
+    }
+    const PWCaptureFileHeader *header = PWCaptureReaderHeader(reader);
+
+    // The interface starts UP, as it is before the helper blocks it
+    RecordingActuator *actuator = calloc(1, sizeof(*actuator));
+    actuator->base.getFlags = recordingGetFlags;
+    actuator->base.setFlags = recordingSetFlags;
+    actuator->base.destroy = recordingDestroy;
+    actuator->flags = IFF_UP | IFF_RUNNING;
+    actuator->digest = 0xcbf29ce484222325ull;
+    PWEnforcer *enforcer = PWEnforcerCreate(header->ifname, NULL, &actuator->base);
+    if (!enforcer) {
+        fprintf(stderr, "enforcer creation failed\n");
+        return 1;
+    }
+
+    PWReplayStats total = { 0 };
+    for (long pass = 0; pass < repeat; pass++) {
+        PWReplayStats stats;
+        PWCaptureReaderRewind(reader);
+        if (!PWEnforcerReplay(enforcer, reader, speed, &stats)) {
+            fprintf(stderr, "capture format %u cannot be replayed on this platform\n", header->format);
+            return 1;
+        }
+        total.drains += stats.drains;
+        total.reads += stats.reads;
+        total.messages += stats.messages;
+        total.controls += stats.controls;
+        total.overflows += stats.overflows;
+        total.elapsedNanos += stats.elapsedNanos;
+    }
+
+    double seconds = total.elapsedNanos / 1e9;
+    PWHistogramSnapshot decision;
+    PWEnforcerCopyReactionHistogram(enforcer, PWReactionStageDecision, &decision);
+    printf("%s: %s index %u, %ld pass(es) at %s speed\n", path, header->ifname, header->ifindex, repeat,
+           speed == PWReplaySpeedMaximum ? "maximum" : "recorded");
+    printf("replayed %llu drains, %llu reads, %llu messages, %llu state changes, %llu overflows in %.3fms\n",
+           (unsigned long long)total.drains, (unsigned long long)total.reads,
+           (unsigned long long)total.messages, (unsigned long long)total.controls,
+           (unsigned long long)total.overflows, total.elapsedNanos / 1e6);
+    printf("throughput %.0f messages/s, %.0f drains/s; receive->decision p50=%.2fus p99=%.2fus\n",
+           seconds > 0 ? total.messages / seconds : 0.0, seconds > 0 ? total.drains / seconds : 0.0,
+           PWHistogramValueAtPercentile(&decision, 50) / 1000.0,
+           PWHistogramValueAtPercentile(&decision, 99) / 1000.0);
+
+    char digest[17];
+    snprintf(digest, sizeof(digest), "%016llx", (unsigned long long)actuator->digest);
+    printf("interventions=%llu actuator-calls=%llu digest=%s\n",
+           (unsigned long long)PWEnforcerGetInterventionCount(enforcer),
+           (unsigned long long)actuator->calls, digest);
+
+    PWEnforcerDestroy(enforcer);
+    PWCaptureReaderClose(reader);
+
+    if (expected && strcmp(expected, digest) != 0) {
+        fprintf(stderr, "digest mismatch: expected %s, got %s\n", expected, digest);
+        return 1;
+    }
+    return 0;
+}
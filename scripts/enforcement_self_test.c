@@ -0,0 +1,235 @@
+//
+//  enforcement_self_test.c
+//  PingWarden
+//
+//  Runs the helper's enforcement self-test (Core/PWSelfTest.h) outside the
+//  helper: the platform's real event source and ioctl actuator keep IFNAME
+//  DOWN while this thread raises it ROUNDS times, and the distribution of
+//  raise -> loop saw it UP and raise -> DOWN again is printed. Exits non-zero
+//  if the loop missed a single raise, so CI can gate on it, or if IFNAME is
+//  not UP after the exit sequence the helper uses: restore, await it, stop.
+//
+//  On Linux with no IFNAME a throwaway dummy interface is created (a veth pair
+//  where the kernel has no dummy driver) and removed afterwards. Run it inside
+//  a throwaway network namespace: sudo unshare -n ./enforcement_self_test
+//  On macOS pass an interface that is safe to take DOWN.
+//
+//  Usage: enforcement_self_test [IFNAME] [ROUNDS]
+//
+//  Build from the repository root with the same flags as the smoke test:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWardenHelper/Core
+//     PingWarden/PingWardenHelper/Core/*.c scripts/enforcement_self_test.c
+//     -lpthread -o /tmp/enforcement_self_test
+//
+
+#include "PWBackend.h"
+#include "PWEnforcer.h"
+#include "PWInterfaceFlags.h"
+#include "PWSelfTest.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/veth.h>
+#endif
+
+#define DEFAULT_ROUNDS 200
+#define TEMPORARY_IFNAME "pwself0"
+#define TEMPORARY_PEER_IFNAME "pwself1"
+
+static void fail(const char *what) {
+    fprintf(stderr, "%s failed: %s\n", what, strerror(errno));
+    exit(1);
+}
+
+static void *runEnforcer(void *enforcer) {
+    PWEnforcerRun(enforcer);
+    return NULL;
+}
+
+static void report(const char *name, const PWHistogramSnapshot *snapshot) {
+    printf("%-14s n=%-5llu p50=%8.1fus p99=%8.1fus max=%8.1fus\n", name, (unsigned long long)snapshot->total,
+           PWHistogramValueAtPercentile(snapshot, 50.0) / 1000.0, PWHistogramValueAtPercentile(snapshot, 99.0) / 1000.0,
+           snapshot->max / 1000.0);
+}
+
+#if defined(__linux__)
+
+// MARK: - Temporary interface (Linux)
+
+typedef struct {
+    struct nlmsghdr header;
+    struct ifinfomsg info;
+    uint8_t attributes[512];
+} LinkRequest;
+
+static struct rtattr *appendAttribute(struct nlmsghdr *nlh, unsigned short type, const void *data, size_t length) {
+    struct rtattr *rta = (struct rtattr *)((uint8_t *)nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+    rta->rta_type = type;
+    rta->rta_len = (unsigned short)RTA_LENGTH(length);
+    if (length) {
+        memcpy(RTA_DATA(rta), data, length);
+    }
+    nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+    return rta;
+}
+
+static void closeNest(struct nlmsghdr *nlh, struct rtattr *nest) {
+    nest->rta_len = (unsigned short)((uint8_t *)nlh + nlh->nlmsg_len - (uint8_t *)nest);
+}
+
+/// Send one RTM_NEWLINK/RTM_DELLINK request and wait for its acknowledgement.
+static bool sendLinkRequest(LinkRequest *request) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        return false;
+    }
+    request->header.nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+    bool ok = send(fd, request, request->header.nlmsg_len, 0) == (ssize_t)request->header.nlmsg_len;
+    uint32_t reply[1024];
+    ssize_t len = ok ? recv(fd, reply, sizeof(reply), 0) : -1;
+    const struct nlmsghdr *nlh = (const struct nlmsghdr *)reply;
+    ok = len >= (ssize_t)NLMSG_LENGTH(sizeof(struct nlmsgerr)) && nlh->nlmsg_type == NLMSG_ERROR &&
+         ((const struct nlmsgerr *)NLMSG_DATA(nlh))->error == 0;
+    if (!ok && len > 0 && nlh->nlmsg_type == NLMSG_ERROR) {
+        errno = -((const struct nlmsgerr *)NLMSG_DATA(nlh))->error;
+    }
+    close(fd);
+    return ok;
+}
+
+/// A dummy interface, or a veth pair if the kernel has no dummy driver.
+static bool createTemporaryInterface(const char *name, const char *peer) {
+    LinkRequest request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.header.nlmsg_type = RTM_NEWLINK;
+    request.header.nlmsg_flags = NLM_F_CREATE | NLM_F_EXCL;
+    appendAttribute(&request.header, IFLA_IFNAME, name, strlen(name) + 1);
+    struct rtattr *linkInfo = appendAttribute(&request.header, IFLA_LINKINFO, NULL, 0);
+    appendAttribute(&request.header, IFLA_INFO_KIND, "dummy", 5);
+    closeNest(&request.header, linkInfo);
+    if (sendLinkRequest(&request)) {
+        printf("created dummy interface %s\n", name);
+        return true;
+    }
+
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.header.nlmsg_type = RTM_NEWLINK;
+    request.header.nlmsg_flags = NLM_F_CREATE | NLM_F_EXCL;
+    appendAttribute(&request.header, IFLA_IFNAME, name, strlen(name) + 1);
+    linkInfo = appendAttribute(&request.header, IFLA_LINKINFO, NULL, 0);
+    appendAttribute(&request.header, IFLA_INFO_KIND, "veth", 4);
+    struct rtattr *infoData = appendAttribute(&request.header, IFLA_INFO_DATA, NULL, 0);
+    struct ifinfomsg peerInfo = { .ifi_family = AF_UNSPEC };
+    struct rtattr *peerAttr = appendAttribute(&request.header, VETH_INFO_PEER, &peerInfo, sizeof(peerInfo));
+    appendAttribute(&request.header, IFLA_IFNAME, peer, strlen(peer) + 1);
+    closeNest(&request.header, peerAttr);
+    closeNest(&request.header, infoData);
+    closeNest(&request.header, linkInfo);
+    if (sendLinkRequest(&request)) {
+        printf("created veth interface %s (no dummy driver)\n", name);
+        return true;
+    }
+    return false;
+}
+
+static bool deleteInterface(const char *name) {
+    LinkRequest request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.header.nlmsg_type = RTM_DELLINK;
+    appendAttribute(&request.header, IFLA_IFNAME, name, strlen(name) + 1);
+    return sendLinkRequest(&request);
+}
+
+#endif
+
+int main(int argc, char *argv[]) {
+    const char *ifname = argc >= 2 ? argv[1] : NULL;
+    long rounds = argc >= 3 ? strtol(argv[2], NULL, 10) : DEFAULT_ROUNDS;
+    if (rounds < 1 || rounds > PW_SELF_TEST_MAX_ROUNDS) {
+        rounds = rounds < 1 ? 1 : PW_SELF_TEST_MAX_ROUNDS;
+    }
+
+    bool temporary = false;
+    if (!ifname) {
+#if defined(__linux__)
+        if (!createTemporaryInterface(TEMPORARY_IFNAME, TEMPORARY_PEER_IFNAME)) {
+            fail("creating " TEMPORARY_IFNAME " (needs root)");
+        }
+        ifname = TEMPORARY_IFNAME;
+        temporary = true;
+#else
+        fprintf(stderr, "usage: %s IFNAME [ROUNDS]\n", argv[0]);
+        return 2;
+#endif
+    }
+
+    PWEnforcer *enforcer = PWEnforcerCreate(ifname, PWDefaultEventSourceCreate(), PWIoctlActuatorCreate());
+    if (!enforcer) {
+        fail("creating the enforcer");
+    }
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, runEnforcer, enforcer) != 0) {
+        fail("starting the loop thread");
+    }
+    if (!PWEnforcerSetAllowUp(enforcer, false)) {
+        fail("blocking the interface");
+    }
+
+    PWSelfTestSample *samples = calloc((size_t)rounds, sizeof(*samples));
+    PWSelfTestResult result;
+    bool completed = samples && PWSelfTestRun(enforcer, 0, (uint32_t)rounds, samples, &result);
+
+    // Leave as the helper does on a deliberate exit: restore, wait for it, stop
+    bool restored = PWEnforcerSetAllowUp(enforcer, true) && PWEnforcerAwaitControl(enforcer, 1000000000ull);
+    PWEnforcerStop(enforcer);
+    pthread_join(thread, NULL);
+    PWEnforcerDestroy(enforcer);
+    uint32_t exitFlags = 0;
+    restored = restored && PWInterfaceFlagsRead(ifname, &exitFlags) && (exitFlags & IFF_UP);
+#if defined(__linux__)
+    if (temporary && !deleteInterface(ifname)) {
+        fprintf(stderr, "deleting %s failed: %s\n", ifname, strerror(errno));
+    }
+#endif
+    if (!completed) {
+        fprintf(stderr, "self-test on %s did not complete\n", ifname);
+        return 1;
+    }
+    if (!restored) {
+        fprintf(stderr, "%s was not UP after the exit restore and stop\n", ifname);
+        return 1;
+    }
+
+    // The slowest raises, to tell a scheduling hiccup from a missed message
+    uint64_t slowest = 0;
+    uint32_t slowestRound = 0;
+    for (uint32_t i = 0; i < result.rounds; i++) {
+        if (samples[i].downAt && samples[i].downAt - samples[i].raisedAt > slowest) {
+            slowest = samples[i].downAt - samples[i].raisedAt;
+            slowestRound = i;
+        }
+    }
+    free(samples);
+
+    printf("%s: %u of %u raises lowered, UP after the exit restore\n", ifname, result.lowered, result.rounds);
+    report("raise -> seen", &result.raiseToSeen);
+    report("raise -> DOWN", &result.raiseToDown);
+    printf("slowest round %u: %.1fus\n", slowestRound + 1, slowest / 1000.0);
+    if (result.lowered != result.rounds) {
+        fprintf(stderr, "the loop missed %u raises\n", result.rounds - result.lowered);
+        return 1;
+    }
+    return 0;
+}
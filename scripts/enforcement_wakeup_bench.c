@@ -0,0 +1,225 @@
+//
+//  enforcement_wakeup_bench.c
+//  PingWarden
+//
+//  Measures how long the enforcement loop takes to start running after an
+//  event is queued, with and without realtime scheduling (PWRealtime.c), on
+//  an idle machine and under synthetic CPU load (two spinning threads per
+//  CPU, standing in for a game). Events are timestamped by a generator
+//  thread and read back through PWEventSource.lastArrivalAt, so the numbers
+//  come from the enforcer's own wakeup-latency histogram.
+//
+//  Realtime scheduling needs root (CAP_SYS_NICE on Linux); without it the
+//  realtime rows are skipped. Build from the repository root:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWardenHelper/Core
+//     PingWarden/PingWardenHelper/Core/*.c scripts/enforcement_wakeup_bench.c
+//     -lpthread -o /tmp/enforcement_wakeup_bench
+//
+
+#include "PWBackend.h"
+#include "PWClock.h"
+#include "PWEnforcer.h"
+#include "PWRealtime.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#define LOOPBACK_IFNAME "lo0"
+#else
+#define LOOPBACK_IFNAME "lo"
+#endif
+
+#define EVENTS 2000
+#define EVENT_INTERVAL_NANOS 1000000ull
+#define LOAD_THREADS_PER_CPU 2
+
+// MARK: - Timestamped source
+
+typedef struct {
+    PWEventSource base;
+    int writeFd;
+} TimestampSource;
+
+/// Each message is the PWMonotonicNanos() at which it was queued.
+static bool timestampDrain(PWEventSource *source, PWLinkEventHandler handler, void *context) {
+    (void)handler; (void)context;
+    uint64_t queuedAt[64];
+    ssize_t len;
+    while ((len = read(source->fd, queuedAt, sizeof(queuedAt))) > 0) {
+        if (!source->lastArrivalAt && len >= (ssize_t)sizeof(uint64_t)) {
+            source->lastArrivalAt = queuedAt[0];
+        }
+    }
+    return true;
+}
+
+static void timestampDestroy(PWEventSource *source) {
+    TimestampSource *self = (TimestampSource *)source;
+    close(self->base.fd);
+    close(self->writeFd);
+    free(self);
+}
+
+static TimestampSource *timestampSourceCreate(void) {
+    TimestampSource *self = calloc(1, sizeof(*self));
+    int fds[2];
+    if (!self || pipe(fds) != 0) {
+        perror("pipe");
+        exit(1);
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    self->base.fd = fds[0];
+    self->base.drain = timestampDrain;
+    self->base.destroy = timestampDestroy;
+    self->writeFd = fds[1];
+    return self;
+}
+
+// MARK: - Null actuator
+
+static bool nullGetFlags(PWActuator *actuator, const char *ifname, uint32_t *flags) {
+    (void)actuator; (void)ifname;
+    *flags = 0;
+    return true;
+}
+
+static bool nullSetFlags(PWActuator *actuator, const char *ifname, uint32_t flags) {
+    (void)actuator; (void)ifname; (void)flags;
+    return true;
+}
+
+static void nullDestroy(PWActuator *actuator) {
+    free(actuator);
+}
+
+// MARK: - Load and generator threads
+
+static atomic_bool loadRunning;
+
+static void *spin(void *unused) {
+    (void)unused;
+    volatile uint64_t counter = 0;
+    while (atomic_load_explicit(&loadRunning, memory_order_relaxed)) {
+        counter++;
+    }
+    return NULL;
+}
+
+static void *runEnforcer(void *enforcer) {
+    PWEnforcerRun(enforcer);
+    return NULL;
+}
+
+static void sleepNanos(uint64_t nanos) {
+    struct timespec ts = { (time_t)(nanos / 1000000000ull), (long)(nanos % 1000000000ull) };
+    nanosleep(&ts, NULL);
+}
+
+/// Queue EVENTS timestamped messages, one per EVENT_INTERVAL_NANOS.
+static void *generate(void *source) {
+    int fd = ((TimestampSource *)source)->writeFd;
+    for (int i = 0; i < EVENTS; i++) {
+        uint64_t queuedAt = PWMonotonicNanos();
+        if (write(fd, &queuedAt, sizeof(queuedAt)) != sizeof(queuedAt)) {
+            perror("write event");
+            exit(1);
+        }
+        sleepNanos(EVENT_INTERVAL_NANOS);
+    }
+    return NULL;
+}
+
+static bool generatorIsRealtime = true;
+
+// MARK: - Benchmark
+
+/// Returns false if realtime mode was requested but refused.
+static bool runCase(bool loaded, bool realtime) {
+    TimestampSource *source = timestampSourceCreate();
+    PWActuator *actuator = calloc(1, sizeof(*actuator));
+    actuator->getFlags = nullGetFlags;
+    actuator->setFlags = nullSetFlags;
+    actuator->destroy = nullDestroy;
+    PWEnforcer *enforcer = PWEnforcerCreate(LOOPBACK_IFNAME, &source->base, actuator);
+    if (!enforcer) {
+        fprintf(stderr, "enforcer creation failed\n");
+        exit(1);
+    }
+
+    pthread_t loop;
+    pthread_create(&loop, NULL, runEnforcer, enforcer);
+    if (realtime) {
+        PWRealtimeConfig config = PW_REALTIME_CONFIG_DEFAULT;
+#if defined(__linux__)
+        config.cpu = 0;
+#endif
+        if (!PWRealtimeEnable(loop, &config)) {
+            PWEnforcerStop(enforcer);
+            pthread_join(loop, NULL);
+            PWEnforcerDestroy(enforcer);
+            return false;
+        }
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int loadThreads = loaded ? (int)(cpus > 0 ? cpus : 1) * LOAD_THREADS_PER_CPU : 0;
+    pthread_t *load = calloc((size_t)(loadThreads > 0 ? loadThreads : 1), sizeof(pthread_t));
+    atomic_store(&loadRunning, true);
+    for (int i = 0; i < loadThreads; i++) {
+        pthread_create(&load[i], NULL, spin, NULL);
+    }
+
+    // The generator must stay punctual under load, or its own delays would be
+    // charged to the loop; it runs above the loop's realtime priority. Threads
+    // inherit their creator's policy, so only this one is promoted.
+    pthread_t generator;
+    pthread_create(&generator, NULL, generate, source);
+    PWRealtimeConfig generatorConfig = PW_REALTIME_CONFIG_DEFAULT;
+    generatorConfig.priority = 60;
+    if (generatorIsRealtime && !PWRealtimeEnable(generator, &generatorConfig)) {
+        printf("note: generator runs without realtime priority; loaded timings include its own delays\n");
+        generatorIsRealtime = false;
+    }
+    pthread_join(generator, NULL);
+
+    atomic_store(&loadRunning, false);
+    for (int i = 0; i < loadThreads; i++) {
+        pthread_join(load[i], NULL);
+    }
+    free(load);
+
+    PWEnforcerStop(enforcer);
+    pthread_join(loop, NULL);
+
+    PWHistogramSnapshot wakeup;
+    PWEnforcerCopyWakeupHistogram(enforcer, &wakeup);
+    printf("%-7s %-9s load-threads=%-3d wakeups=%-5llu event->wakeup p50=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus\n",
+           loaded ? "loaded" : "idle", realtime ? "realtime" : "default", loadThreads,
+           (unsigned long long)wakeup.total,
+           PWHistogramValueAtPercentile(&wakeup, 50) / 1000.0,
+           PWHistogramValueAtPercentile(&wakeup, 99) / 1000.0,
+           PWHistogramValueAtPercentile(&wakeup, 99.9) / 1000.0,
+           wakeup.max / 1000.0);
+
+    PWEnforcerDestroy(enforcer);
+    return true;
+}
+
+int main(void) {
+    bool realtimeAvailable = true;
+    for (int loaded = 0; loaded <= 1; loaded++) {
+        runCase(loaded, false);
+        if (realtimeAvailable && !runCase(loaded, true)) {
+            printf("realtime mode refused (needs root or CAP_SYS_NICE); skipping realtime cases\n");
+            realtimeAvailable = false;
+        }
+    }
+    return 0;
+}
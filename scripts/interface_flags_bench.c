@@ -0,0 +1,153 @@
+//
+//  interface_flags_bench.c
+//  PingWarden
+//
+//  Compares the app's two ways of learning whether an interface is UP. The old
+//  path spawned /sbin/ifconfig IFNAME, read its output through a pipe and
+//  searched it for "<UP"; the health check, the diagnostics export and every
+//  iteration of the response-time test paid for that. The new path is
+//  PWInterfaceFlags.h: one SIOCGIFFLAGS on a datagram socket (kept open, or
+//  opened per call as occasional callers do), or a getifaddrs walk that
+//  returns every interface at once.
+//
+//  Usage: interface_flags_bench [IFNAME] [SPAWNS]
+//
+//  Build from the repository root with the same flags as the smoke test:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWardenHelper/Core
+//     scripts/interface_flags_bench.c -o /tmp/interface_flags_bench
+//
+
+#include "PWInterfaceFlags.h"
+
+#include <sys/wait.h>
+#include <spawn.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__APPLE__)
+#define LOOPBACK_IFNAME "lo0"
+#else
+#define LOOPBACK_IFNAME "lo"
+#endif
+
+#define NATIVE_ITERATIONS 100000
+#define LIST_ITERATIONS 10000
+#define DEFAULT_SPAWNS 200
+
+extern char **environ;
+
+static uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compareU64(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t *)lhs, b = *(const uint64_t *)rhs;
+    return (a > b) - (a < b);
+}
+
+static void fail(const char *what) {
+    fprintf(stderr, "%s failed: %s\n", what, strerror(errno));
+    exit(1);
+}
+
+static void report(const char *name, uint64_t *samples, long count) {
+    qsort(samples, (size_t)count, sizeof(uint64_t), compareU64);
+    printf("%-30s p50=%10.1fus p99=%10.1fus max=%10.1fus\n", name,
+           samples[count / 2] / 1000.0, samples[count * 99 / 100] / 1000.0, samples[count - 1] / 1000.0);
+}
+
+/// The old path: spawn ifconfig, collect its output and look for "<UP" on the flags line.
+static bool spawnIfconfig(const char *ifname, bool *up) {
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) {
+        return false;
+    }
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, pipeFds[0]);
+    char *const argv[] = { "ifconfig", (char *)ifname, NULL };
+    pid_t pid;
+    int error = posix_spawn(&pid, "/sbin/ifconfig", &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipeFds[1]);
+    if (error != 0) {
+        close(pipeFds[0]);
+        errno = error;
+        return false;
+    }
+
+    char output[4096];
+    size_t length = 0;
+    ssize_t n;
+    while ((n = read(pipeFds[0], output + length, sizeof(output) - 1 - length)) > 0) {
+        length += (size_t)n;
+    }
+    output[length] = '\0';
+    close(pipeFds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    *up = strstr(output, "<UP") != NULL;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *ifname = argc >= 2 ? argv[1] : LOOPBACK_IFNAME;
+    long spawns = argc >= 3 ? strtol(argv[2], NULL, 10) : DEFAULT_SPAWNS;
+    if (spawns < 1 || spawns > NATIVE_ITERATIONS) {
+        spawns = spawns < 1 ? 1 : NATIVE_ITERATIONS;
+    }
+
+    uint64_t *samples = calloc(NATIVE_ITERATIONS, sizeof(uint64_t));
+    uint32_t flags = 0;
+    int fd = PWInterfaceFlagsOpenSocket();
+    if (fd < 0 || !PWInterfaceFlagsGet(fd, ifname, &flags)) {
+        fail("SIOCGIFFLAGS");
+    }
+    char text[128];
+    PWInterfaceFlagsFormat(flags, text, sizeof(text));
+    printf("%s flags=%s\n", ifname, text);
+
+    for (long i = 0; i < NATIVE_ITERATIONS; i++) {
+        uint64_t start = monotonicNanos();
+        PWInterfaceFlagsGet(fd, ifname, &flags);
+        samples[i] = monotonicNanos() - start;
+    }
+    report("SIOCGIFFLAGS, open socket", samples, NATIVE_ITERATIONS);
+    close(fd);
+
+    for (long i = 0; i < NATIVE_ITERATIONS; i++) {
+        uint64_t start = monotonicNanos();
+        PWInterfaceFlagsRead(ifname, &flags);
+        samples[i] = monotonicNanos() - start;
+    }
+    report("SIOCGIFFLAGS, socket per call", samples, NATIVE_ITERATIONS);
+
+    PWInterfaceInfo interfaces[64];
+    for (long i = 0; i < LIST_ITERATIONS; i++) {
+        uint64_t start = monotonicNanos();
+        if (PWInterfaceFlagsList(interfaces, 64) < 0) {
+            fail("getifaddrs");
+        }
+        samples[i] = monotonicNanos() - start;
+    }
+    report("getifaddrs, every interface", samples, LIST_ITERATIONS);
+
+    bool up = false;
+    for (long i = 0; i < spawns; i++) {
+        uint64_t start = monotonicNanos();
+        if (!spawnIfconfig(ifname, &up)) {
+            fail("spawning /sbin/ifconfig");
+        }
+        samples[i] = monotonicNanos() - start;
+    }
+    if (up != ((flags & IFF_UP) != 0)) {
+        fprintf(stderr, "ifconfig and SIOCGIFFLAGS disagree about %s\n", ifname);
+        return 1;
+    }
+    report("spawn /sbin/ifconfig", samples, spawns);
+    free(samples);
+    return 0;
+}
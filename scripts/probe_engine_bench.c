@@ -0,0 +1,469 @@
+//
+//  probe_engine_bench.c
+//  PingWarden
+//
+//  Loopback throughput of the app's TCP connect probes. The old path gave
+//  every probe a thread blocked in select() (the former
+//  TCPProbe.connectSingle, one task per target); the new path is
+//  PWProbeEngine: non-blocking connects
+//  multiplexed on one kqueue/epoll thread with a timer heap for deadlines.
+//  Both run PROBES connects against a local listener with WINDOW in flight
+//  and report probes per second, process CPU per probe (user + system,
+//  including the accepting threads and the kernel's handshakes) and the
+//  connect-latency distribution. Both close with an abortive reset, as the
+//  engine does, so neither runs out of ports to TIME_WAIT.
+//
+//  A callback chain then checks that a result can submit the next address
+//  in its place at capacity 1, as TCPProbe's getaddrinfo fallback does.
+//  A last pass checks deadlines: probes against a listener whose backlog is
+//  already filled by connections it never accepts never complete. Every one
+//  must be reported as timed out shortly after its deadline, or as cancelled
+//  if the engine is destroyed first.
+//
+//  Usage: probe_engine_bench [PROBES] [WINDOW]
+//
+//  Build from the repository root with the same flags as the smoke test:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWarden/Core
+//     PingWarden/PingWarden/Core/PWProbeEngine.c scripts/probe_engine_bench.c
+//     -lpthread -o /tmp/probe_engine_bench
+//
+
+#include "PWProbeEngine.h"
+
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_PROBES 20000
+#define DEFAULT_WINDOW 32
+#define ACCEPT_THREADS 4
+#define ACCEPT_LAG 512
+#define ENGINE_WIDE_WINDOW 256
+#define TIMEOUT_PROBES 64
+#define FALLBACK_ADDRESSES 8
+#define TIMEOUT_NANOS 50000000ull
+#define PROBE_TIMEOUT_NANOS 1000000000ull
+
+static int compareU64(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t *)lhs, b = *(const uint64_t *)rhs;
+    return (a > b) - (a < b);
+}
+
+static void fail(const char *what) {
+    fprintf(stderr, "%s failed: %s\n", what, strerror(errno));
+    exit(1);
+}
+
+static uint64_t cpuNanos(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return ((uint64_t)usage.ru_utime.tv_sec + (uint64_t)usage.ru_stime.tv_sec) * 1000000000ull +
+           ((uint64_t)usage.ru_utime.tv_usec + (uint64_t)usage.ru_stime.tv_usec) * 1000ull;
+}
+
+static void report(const char *name, uint64_t *latencies, long count, uint64_t wallNanos, uint64_t cpu, int threads) {
+    qsort(latencies, (size_t)count, sizeof(uint64_t), compareU64);
+    printf("%-24s %8.0f probes/s %6.1fus CPU/probe %4d threads  p50=%6.1fus p99=%7.1fus\n", name,
+           count * 1e9 / (double)wallNanos, cpu / 1000.0 / (double)count, threads,
+           latencies[count / 2] / 1000.0, latencies[count * 99 / 100] / 1000.0);
+}
+
+// MARK: - Listener
+
+typedef struct {
+    int fd;
+    atomic_bool stop;
+} Listener;
+
+static atomic_long accepted;
+
+static void *acceptLoop(void *argument) {
+    Listener *listener = argument;
+    while (!atomic_load(&listener->stop)) {
+        int fd = accept(listener->fd, NULL, NULL);
+        if (fd >= 0) {
+            close(fd);
+            atomic_fetch_add(&accepted, 1);
+        }
+    }
+    return NULL;
+}
+
+/// A connect completes without waiting for accept(), so on a small machine the probes
+/// outrun the accepting threads and overflow the accept queue, which costs each dropped
+/// handshake a one-second SYN retransmit. Hold the started-th probe until the listener
+/// is no more than ACCEPT_LAG behind; both paths pay the same.
+static void keepUpWithListener(long started) {
+    while (started - atomic_load(&accepted) > ACCEPT_LAG) {
+        sched_yield();
+    }
+}
+
+static int openListener(int backlog, struct sockaddr_in *address) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(address, 0, sizeof(*address));
+    address->sin_family = AF_INET;
+    address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(*address);
+    if (fd < 0 || bind(fd, (struct sockaddr *)address, sizeof(*address)) < 0 || listen(fd, backlog) < 0 ||
+        getsockname(fd, (struct sockaddr *)address, &length) < 0) {
+        fail("listening on loopback");
+    }
+    return fd;
+}
+
+/// Fill a listener's accept queue with connections it never accepts, so further
+/// handshakes stall. Connects until one fails to complete within 100 ms and keeps the
+/// completed ones open in fds. Returns how many there are.
+static int fillBacklog(const struct sockaddr_in *address, int *fds, int capacity) {
+    int count = 0;
+    while (count < capacity) {
+        int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (fd < 0) {
+            fail("socket");
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        bool connected = connect(fd, (const struct sockaddr *)address, sizeof(*address)) == 0;
+        if (!connected && errno == EINPROGRESS) {
+            fd_set writeSet;
+            FD_ZERO(&writeSet);
+            FD_SET(fd, &writeSet);
+            struct timeval timeout = { .tv_sec = 0, .tv_usec = 100000 };
+            int error = 0;
+            socklen_t length = sizeof(error);
+            connected = select(fd + 1, NULL, &writeSet, NULL, &timeout) > 0 &&
+                        getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0;
+        }
+        if (!connected) {
+            close(fd);
+            break;
+        }
+        fds[count++] = fd;
+    }
+    if (count == capacity) {
+        fail("listener backlog never filled");
+    }
+    return count;
+}
+
+// MARK: - Engine
+
+/// TCPProbe's fallback: each result submits the next address from inside the callback.
+typedef struct {
+    PWProbeEngine *engine;
+    struct sockaddr_in address;
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    long submitted;
+    bool turnedAway;       // a follow-up was refused for want of capacity
+    bool finished;
+} Fallback;
+
+static void fallBack(void *context, const PWProbeResult *result) {
+    Fallback *fallback = context;
+    (void)result;
+    pthread_mutex_lock(&fallback->lock);
+    if (fallback->submitted < FALLBACK_ADDRESSES) {
+        fallback->submitted++;
+        if (PWProbeEngineSubmit(fallback->engine, (const struct sockaddr *)&fallback->address,
+                                sizeof(fallback->address), PROBE_TIMEOUT_NANOS, (uint64_t)fallback->submitted)) {
+            pthread_mutex_unlock(&fallback->lock);
+            return;
+        }
+        fallback->turnedAway = true;
+    }
+    fallback->finished = true;
+    pthread_cond_signal(&fallback->done);
+    pthread_mutex_unlock(&fallback->lock);
+}
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    long completed;
+    long wakeAt;           // completions the submitting thread waits for, LONG_MAX if none
+    uint64_t *latencies;
+    PWProbeStatus *statuses;
+} Collector;
+
+static void collect(void *context, const PWProbeResult *result) {
+    Collector *collector = context;
+    collector->latencies[result->tag] = result->latencyNanos;
+    collector->statuses[result->tag] = result->status;
+    pthread_mutex_lock(&collector->lock);
+    if (++collector->completed >= collector->wakeAt) {
+        pthread_cond_signal(&collector->done);
+    }
+    pthread_mutex_unlock(&collector->lock);
+}
+
+/// Wait until count probes have completed, or a millisecond passes.
+static void awaitCompletions(Collector *collector, long count) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    pthread_mutex_lock(&collector->lock);
+    collector->wakeAt = count;
+    while (collector->completed < count &&
+           pthread_cond_timedwait(&collector->done, &collector->lock, &deadline) == 0) {
+    }
+    collector->wakeAt = LONG_MAX;
+    pthread_mutex_unlock(&collector->lock);
+}
+
+/// Submit probes as capacity frees up and wait for every result.
+static void runEngine(const char *name, const struct sockaddr_in *address, long probes, uint32_t window,
+                      uint64_t timeoutNanos, Collector *collector) {
+    collector->completed = 0;
+    collector->wakeAt = LONG_MAX;
+    PWProbeEngine *engine = PWProbeEngineCreate(window, collect, collector);
+    if (!engine) {
+        fail("creating the probe engine");
+    }
+    uint64_t startWall = PWProbeEngineNow();
+    uint64_t startCPU = cpuNanos();
+    long base = atomic_load(&accepted);
+    for (long i = 0; i < probes; i++) {
+        keepUpWithListener(i + base);
+        while (!PWProbeEngineSubmit(engine, (const struct sockaddr *)address, sizeof(*address), timeoutNanos,
+                                    (uint64_t)i)) {
+            // Full: refill half the window at once, as the app submits a round of targets
+            awaitCompletions(collector, i - window / 2);
+        }
+    }
+    pthread_mutex_lock(&collector->lock);
+    collector->wakeAt = probes;
+    while (collector->completed < probes) {
+        pthread_cond_wait(&collector->done, &collector->lock);
+    }
+    collector->wakeAt = LONG_MAX;
+    pthread_mutex_unlock(&collector->lock);
+    uint64_t wall = PWProbeEngineNow() - startWall;
+    uint64_t cpu = cpuNanos() - startCPU;
+
+    PWProbeEngineStats stats;
+    PWProbeEngineGetStats(engine, &stats);
+    PWProbeEngineDestroy(engine);
+    if (timeoutNanos == TIMEOUT_NANOS) {
+        return;
+    }
+    if (stats.connected != (uint64_t)probes) {
+        fprintf(stderr, "%s: %llu of %ld probes connected (%llu refused, %llu timed out, %llu failed)\n", name,
+                (unsigned long long)stats.connected, probes, (unsigned long long)stats.refused,
+                (unsigned long long)stats.timedOut, (unsigned long long)stats.failed);
+        exit(1);
+    }
+    report(name, collector->latencies, probes, wall, cpu, 1);
+    printf("%-24s %.2f wakeups/probe, %u in flight at most\n", "", stats.wakeups / (double)probes, stats.maxInFlight);
+}
+
+// MARK: - Blocking select() per probe (the old path)
+
+typedef struct {
+    const struct sockaddr_in *address;
+    atomic_long next;
+    long probes;
+    long base;
+    uint64_t *latencies;
+    atomic_long failures;
+} SelectWork;
+
+/// TCPProbe.connectSingle: non-blocking connect, then block in select() for the result.
+static bool connectWithSelect(const struct sockaddr_in *address) {
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    bool connected = connect(fd, (const struct sockaddr *)address, sizeof(*address)) == 0;
+    if (!connected && errno == EINPROGRESS) {
+        fd_set writeSet;
+        FD_ZERO(&writeSet);
+        FD_SET(fd, &writeSet);
+        struct timeval timeout = { .tv_sec = 1, .tv_usec = 0 };
+        int error = 0;
+        socklen_t length = sizeof(error);
+        connected = select(fd + 1, NULL, &writeSet, NULL, &timeout) > 0 &&
+                    getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0;
+    }
+    struct linger linger = { .l_onoff = 1, .l_linger = 0 };
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+    close(fd);
+    return connected;
+}
+
+static void *selectWorker(void *argument) {
+    SelectWork *work = argument;
+    for (long i; (i = atomic_fetch_add(&work->next, 1)) < work->probes;) {
+        keepUpWithListener(i + work->base);
+        uint64_t start = PWProbeEngineNow();
+        if (!connectWithSelect(work->address)) {
+            atomic_fetch_add(&work->failures, 1);
+        }
+        work->latencies[i] = PWProbeEngineNow() - start;
+    }
+    return NULL;
+}
+
+static void runSelect(const struct sockaddr_in *address, long probes, int threads, uint64_t *latencies) {
+    SelectWork work = { .address = address, .probes = probes, .base = atomic_load(&accepted), .latencies = latencies };
+    pthread_t *workers = calloc((size_t)threads, sizeof(pthread_t));
+    uint64_t startWall = PWProbeEngineNow();
+    uint64_t startCPU = cpuNanos();
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&workers[i], NULL, selectWorker, &work) != 0) {
+            fail("starting a select() worker");
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    uint64_t wall = PWProbeEngineNow() - startWall;
+    uint64_t cpu = cpuNanos() - startCPU;
+    free(workers);
+    if (atomic_load(&work.failures) > 0) {
+        fprintf(stderr, "select(): %ld of %ld probes failed\n", atomic_load(&work.failures), probes);
+        exit(1);
+    }
+    report("thread + select()", latencies, probes, wall, cpu, threads);
+}
+
+int main(int argc, char *argv[]) {
+    long probes = argc >= 2 ? strtol(argv[1], NULL, 10) : DEFAULT_PROBES;
+    long window = argc >= 3 ? strtol(argv[2], NULL, 10) : DEFAULT_WINDOW;
+    if (probes < TIMEOUT_PROBES) {
+        probes = TIMEOUT_PROBES;
+    }
+    if (window < 1 || window > 1024) {
+        window = window < 1 ? 1 : 1024;
+    }
+
+    struct sockaddr_in address;
+    Listener listener = { .fd = openListener(4096, &address) };
+    pthread_t acceptors[ACCEPT_THREADS];
+    for (int i = 0; i < ACCEPT_THREADS; i++) {
+        if (pthread_create(&acceptors[i], NULL, acceptLoop, &listener) != 0) {
+            fail("starting an accept thread");
+        }
+    }
+
+    Collector collector = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .done = PTHREAD_COND_INITIALIZER,
+        .latencies = calloc((size_t)probes, sizeof(uint64_t)),
+        .statuses = calloc((size_t)probes, sizeof(PWProbeStatus)),
+    };
+    printf("%ld loopback connects to 127.0.0.1:%d, %ld in flight\n", probes, ntohs(address.sin_port), window);
+    runSelect(&address, probes, (int)window, collector.latencies);
+    runEngine("engine", &address, probes, (uint32_t)window, PROBE_TIMEOUT_NANOS, &collector);
+    char wide[32];
+    snprintf(wide, sizeof(wide), "engine, %d in flight", ENGINE_WIDE_WINDOW);
+    runEngine(wide, &address, probes, ENGINE_WIDE_WINDOW, PROBE_TIMEOUT_NANOS, &collector);
+
+    // One more connect per accepting thread wakes it to see the stop flag
+    atomic_store(&listener.stop, true);
+    for (int i = 0; i < ACCEPT_THREADS; i++) {
+        connectWithSelect(&address);
+    }
+    for (int i = 0; i < ACCEPT_THREADS; i++) {
+        pthread_join(acceptors[i], NULL);
+    }
+    close(listener.fd);
+
+    // At capacity 1, a callback must still be able to submit the next address in its place
+    Fallback fallback = {
+        .address = address,
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .done = PTHREAD_COND_INITIALIZER,
+        .submitted = 1,
+    };
+    fallback.engine = PWProbeEngineCreate(1, fallBack, &fallback);
+    if (!fallback.engine ||
+        !PWProbeEngineSubmit(fallback.engine, (const struct sockaddr *)&address, sizeof(address), PROBE_TIMEOUT_NANOS, 1)) {
+        fail("starting the fallback chain");
+    }
+    pthread_mutex_lock(&fallback.lock);
+    while (!fallback.finished) {
+        pthread_cond_wait(&fallback.done, &fallback.lock);
+    }
+    pthread_mutex_unlock(&fallback.lock);
+    bool zeroAccepted = PWProbeEngineSubmit(fallback.engine, (const struct sockaddr *)&address, sizeof(address), 0, 0);
+    PWProbeEngineDestroy(fallback.engine);
+    if (zeroAccepted) {
+        fprintf(stderr, "a probe with no time to connect was accepted\n");
+        return 1;
+    }
+    if (fallback.turnedAway) {
+        fprintf(stderr, "a fallback submitted from the callback was turned away after %ld addresses\n",
+                fallback.submitted);
+        return 1;
+    }
+    printf("fallback: %ld of %d addresses submitted from the callback at capacity 1\n", fallback.submitted,
+           FALLBACK_ADDRESSES);
+
+    // A listener that never accepts, its backlog filled first: every handshake stalls until the deadline
+    struct sockaddr_in stalled;
+    int stalledFd = openListener(0, &stalled);
+    int backlogFds[16];
+    int backlogCount = fillBacklog(&stalled, backlogFds, 16);
+    runEngine("timeouts", &stalled, TIMEOUT_PROBES, TIMEOUT_PROBES, TIMEOUT_NANOS, &collector);
+    long timedOut = 0;
+    uint64_t lateness[TIMEOUT_PROBES];
+    for (long i = 0; i < TIMEOUT_PROBES; i++) {
+        if (collector.statuses[i] == PWProbeStatusTimedOut) {
+            lateness[timedOut++] = collector.latencies[i] - TIMEOUT_NANOS;
+        }
+    }
+    if (timedOut != TIMEOUT_PROBES) {
+        fprintf(stderr, "only %ld of %d probes against a full backlog timed out\n", timedOut, TIMEOUT_PROBES);
+        return 1;
+    }
+    qsort(lateness, (size_t)timedOut, sizeof(uint64_t), compareU64);
+    printf("timeouts: %ld of %d stalled probes timed out %.1fms late at p50, %.1fms at max\n", timedOut,
+           TIMEOUT_PROBES, lateness[timedOut / 2] / 1e6, lateness[timedOut - 1] / 1e6);
+
+    // Destroying the engine reports what is still in flight, before it returns
+    collector.completed = 0;
+    PWProbeEngine *engine = PWProbeEngineCreate(TIMEOUT_PROBES, collect, &collector);
+    for (long i = 0; i < TIMEOUT_PROBES; i++) {
+        collector.statuses[i] = PWProbeStatusConnected;
+        PWProbeEngineSubmit(engine, (const struct sockaddr *)&stalled, sizeof(stalled), PROBE_TIMEOUT_NANOS, (uint64_t)i);
+    }
+    usleep(10000);
+    PWProbeEngineDestroy(engine);
+    long cancelled = 0;
+    for (long i = 0; i < TIMEOUT_PROBES; i++) {
+        cancelled += collector.statuses[i] == PWProbeStatusCancelled;
+    }
+    for (int i = 0; i < backlogCount; i++) {
+        close(backlogFds[i]);
+    }
+    close(stalledFd);
+    if (collector.completed != TIMEOUT_PROBES || cancelled != TIMEOUT_PROBES) {
+        fprintf(stderr, "destroy reported %ld of %d probes, %ld cancelled\n", collector.completed, TIMEOUT_PROBES,
+                cancelled);
+        return 1;
+    }
+    printf("cancel: %ld of %d stalled probes reported cancelled on destroy\n", cancelled, TIMEOUT_PROBES);
+    free(collector.latencies);
+    free(collector.statuses);
+    return 0;
+}
@@ -0,0 +1,274 @@
+//
+//  status_page_bench.c
+//  PingWarden
+//
+//  Measures what it costs a client to learn the helper's status. A status page
+//  read (PWStatusPageRead on a read-only mapping, as the app and widget do) is
+//  timed with the page idle and while a writer thread republishes it as fast as
+//  it can, which is far beyond anything a real storm causes. As a reference,
+//  the same snapshot is fetched by request and reply from a server thread over
+//  a socketpair, the cheapest IPC round trip there is; on macOS it is also
+//  fetched over an anonymous XPC connection, as the app did before.
+//
+//  Usage: status_page_bench [ITERATIONS]
+//
+//  Build from the repository root with the same flags as the smoke test:
+//  cc -std=gnu11 -O2 -I PingWarden/PingWardenHelper/Core
+//     PingWarden/PingWardenHelper/Core/*.c scripts/status_page_bench.c
+//     -lpthread -o /tmp/status_page_bench
+//
+
+#include "PWStatusPage.h"
+
+#include <sys/socket.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#include <xpc/xpc.h>
+#endif
+
+#define DEFAULT_ITERATIONS 200000
+// Reads timed together, so the clock's own cost stays out of the per-read figure
+#define READS_PER_SAMPLE 64
+#define ROUND_TRIP_ITERATIONS 20000
+
+static uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compareU64(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t *)lhs, b = *(const uint64_t *)rhs;
+    return (a > b) - (a < b);
+}
+
+static void fail(const char *what) {
+    fprintf(stderr, "%s failed\n", what);
+    exit(1);
+}
+
+static void report(const char *name, uint64_t *samples, long count, double divisor) {
+    qsort(samples, (size_t)count, sizeof(uint64_t), compareU64);
+    printf("%-34s p50=%9.1fns p99=%9.1fns max=%10.1fns\n", name,
+           samples[count / 2] / divisor, samples[count * 99 / 100] / divisor, samples[count - 1] / divisor);
+}
+
+/// A snapshot shaped like the helper's: AWDL and the low-latency WLAN interface.
+static void fillSnapshot(PWStatusSnapshot *snapshot, uint64_t interventions) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->writerPid = getpid();
+    snapshot->running = 1;
+    snapshot->targetCount = 2;
+    strcpy(snapshot->targets[0].ifname, "awdl0");
+    strcpy(snapshot->targets[1].ifname, "llw0");
+    for (int i = 0; i < 2; i++) {
+        snapshot->targets[i].present = true;
+        snapshot->targets[i].flagsKnown = true;
+        snapshot->targets[i].interventions = interventions;
+    }
+    snapshot->interventions = interventions * 2;
+    snapshot->updatedAt = (uint64_t)time(NULL) * 1000000000ull;
+}
+
+// MARK: - Status page
+
+typedef struct {
+    PWStatusPage *page;
+    atomic_bool stop;
+    atomic_uint_fast64_t publishes;
+} Writer;
+
+static void *runWriter(void *context) {
+    Writer *writer = context;
+    PWStatusSnapshot snapshot;
+    uint64_t n = 0;
+    while (!atomic_load_explicit(&writer->stop, memory_order_relaxed)) {
+        fillSnapshot(&snapshot, ++n);
+        PWStatusPagePublish(writer->page, &snapshot);
+    }
+    atomic_store(&writer->publishes, n);
+    return NULL;
+}
+
+static void benchReads(const char *name, const void *mapping, long iterations) {
+    long sampleCount = iterations / READS_PER_SAMPLE;
+    uint64_t *samples = calloc((size_t)sampleCount, sizeof(uint64_t));
+    PWStatusSnapshot snapshot;
+    long failures = 0;
+    for (long i = 0; i < sampleCount; i++) {
+        uint64_t start = monotonicNanos();
+        for (int k = 0; k < READS_PER_SAMPLE; k++) {
+            failures += !PWStatusPageRead(mapping, &snapshot);
+        }
+        samples[i] = monotonicNanos() - start;
+    }
+    if (failures) {
+        printf("%s: %ld of %ld reads gave up behind the writer\n", name, failures, sampleCount * READS_PER_SAMPLE);
+    }
+    report(name, samples, sampleCount, READS_PER_SAMPLE);
+    free(samples);
+}
+
+static void benchStatusPage(long iterations) {
+    char path[] = "/tmp/status_page_bench.XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        fail("mkstemp");
+    }
+    close(fd);
+    PWStatusPage *page = PWStatusPageCreate(path);
+    const void *mapping = PWStatusPageMap(path);
+    if (!page || !mapping) {
+        fail("status page");
+    }
+    PWStatusSnapshot snapshot;
+    fillSnapshot(&snapshot, 1);
+    PWStatusPagePublish(page, &snapshot);
+
+    benchReads("status page read, idle", mapping, iterations);
+
+    Writer writer = { .page = page };
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, runWriter, &writer) != 0) {
+        fail("writer thread");
+    }
+    uint64_t start = monotonicNanos();
+    benchReads("status page read, writer spinning", mapping, iterations);
+    uint64_t elapsed = monotonicNanos() - start;
+    atomic_store(&writer.stop, true);
+    pthread_join(thread, NULL);
+    printf("%-34s %.0f publishes/s meanwhile\n", "", atomic_load(&writer.publishes) * 1e9 / (double)elapsed);
+
+    PWStatusPageUnmap(mapping);
+    PWStatusPageDestroy(page);
+    unlink(path);
+}
+
+// MARK: - Socketpair round trip
+
+static void *runServer(void *context) {
+    int fd = *(int *)context;
+    PWStatusSnapshot snapshot;
+    uint64_t n = 0;
+    char request;
+    while (read(fd, &request, 1) == 1) {
+        fillSnapshot(&snapshot, ++n);
+        if (write(fd, &snapshot, sizeof(snapshot)) != (ssize_t)sizeof(snapshot)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void benchSocketpair(void) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+        fail("socketpair");
+    }
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, runServer, &pair[1]) != 0) {
+        fail("server thread");
+    }
+    uint64_t *samples = calloc(ROUND_TRIP_ITERATIONS, sizeof(uint64_t));
+    PWStatusSnapshot snapshot;
+    for (long i = 0; i < ROUND_TRIP_ITERATIONS; i++) {
+        uint64_t start = monotonicNanos();
+        size_t received = 0;
+        if (write(pair[0], "?", 1) != 1) {
+            fail("request");
+        }
+        while (received < sizeof(snapshot)) {
+            ssize_t n = read(pair[0], (char *)&snapshot + received, sizeof(snapshot) - received);
+            if (n <= 0) {
+                fail("reply");
+            }
+            received += (size_t)n;
+        }
+        samples[i] = monotonicNanos() - start;
+    }
+    report("socketpair request/reply", samples, ROUND_TRIP_ITERATIONS, 1);
+    free(samples);
+    shutdown(pair[0], SHUT_RDWR);
+    pthread_join(thread, NULL);
+    close(pair[0]);
+    close(pair[1]);
+}
+
+// MARK: - XPC round trip
+
+#if defined(__APPLE__)
+static void benchXPC(void) {
+    dispatch_queue_t queue = dispatch_queue_create("status_page_bench.xpc", DISPATCH_QUEUE_SERIAL);
+    xpc_connection_t listener = xpc_connection_create(NULL, queue);
+    __block uint64_t n = 0;
+    xpc_connection_set_event_handler(listener, ^(xpc_object_t peer) {
+        if (xpc_get_type(peer) != XPC_TYPE_CONNECTION) {
+            return;
+        }
+        xpc_connection_set_event_handler(peer, ^(xpc_object_t message) {
+            if (xpc_get_type(message) != XPC_TYPE_DICTIONARY) {
+                return;
+            }
+            PWStatusSnapshot snapshot;
+            fillSnapshot(&snapshot, ++n);
+            xpc_object_t reply = xpc_dictionary_create_reply(message);
+            xpc_dictionary_set_data(reply, "status", &snapshot, sizeof(snapshot));
+            xpc_connection_send_message(peer, reply);
+            xpc_release(reply);
+        });
+        xpc_connection_resume(peer);
+    });
+    xpc_connection_resume(listener);
+
+    xpc_endpoint_t endpoint = xpc_endpoint_create(listener);
+    xpc_connection_t client = xpc_connection_create_from_endpoint(endpoint);
+    xpc_connection_set_event_handler(client, ^(xpc_object_t event) {
+        (void)event;
+    });
+    xpc_connection_resume(client);
+
+    uint64_t *samples = calloc(ROUND_TRIP_ITERATIONS, sizeof(uint64_t));
+    xpc_object_t request = xpc_dictionary_create(NULL, NULL, 0);
+    for (long i = 0; i < ROUND_TRIP_ITERATIONS; i++) {
+        uint64_t start = monotonicNanos();
+        xpc_object_t reply = xpc_connection_send_message_with_reply_sync(client, request);
+        size_t length = 0;
+        if (xpc_get_type(reply) != XPC_TYPE_DICTIONARY ||
+            !xpc_dictionary_get_data(reply, "status", &length) || length != sizeof(PWStatusSnapshot)) {
+            fail("XPC reply");
+        }
+        xpc_release(reply);
+        samples[i] = monotonicNanos() - start;
+    }
+    report("XPC request/reply", samples, ROUND_TRIP_ITERATIONS, 1);
+    free(samples);
+    xpc_release(request);
+    xpc_connection_cancel(client);
+    xpc_release(client);
+    xpc_release(endpoint);
+    xpc_connection_cancel(listener);
+    xpc_release(listener);
+}
+#endif
+
+int main(int argc, char *argv[]) {
+    long iterations = argc >= 2 ? strtol(argv[1], NULL, 10) : DEFAULT_ITERATIONS;
+    if (iterations < READS_PER_SAMPLE * 100) {
+        iterations = READS_PER_SAMPLE * 100;
+    }
+    printf("snapshot: %zu bytes\n", sizeof(PWStatusSnapshot));
+    benchStatusPage(iterations);
+    benchSocketpair();
+#if defined(__APPLE__)
+    benchXPC();
+#endif
+    return 0;
+}